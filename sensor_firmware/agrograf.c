@@ -5,38 +5,40 @@
  *          display OLED SSD1306, sensor de temperatura onboard e buzzer para
  *          monitorar e gerenciar setores agrícolas simulados.
  *          Inclui um servidor HTTP para visualização e controle remoto.
+ *          O núcleo 0 atende Wi-Fi/HTTP, menu serial e OLED; o núcleo 1 é dono
+ *          dos sensores, do alarme e dos atuadores (LEDs e buzzer).
  * @author Ricardo Cristiano da Silva
  * @date (03/06/2025)
  */
 
 // Inclui as bibliotecas padrão e específicas do Pico
 #include <stdio.h>          // Para entrada/saída padrão (printf, scanf)
-#include "pico/stdlib.h"     // Funções utilitárias padrão do SDK do Pico
-#include "hardware/adc.h"      // Para o conversor Analógico-Digital (joystick, sensor de temp.)
-#include "hardware/pio.h"      // Para o Programmable I/O (controlar WS2812B)
-#include "hardware/clocks.h"   // Para gerenciamento de clocks (usado pelo PIO)
-#include "ws2818b.pio.h"   // Arquivo de header gerado pelo pioasm para o WS2812B
-#include "hardware/gpio.h"     // Para controle de General Purpose Input/Output (botões)
+#include "hal.h"            // Camada de abstração de hardware (Pico W ou simulação no host)
 
 // Inclui as bibliotecas para controlar o display OLED:
 #include <string.h>         // Para manipulação de strings (strcpy, strlen)
 #include <stdlib.h>         // Funções utilitárias gerais (atoi, etc.) - Menos usado aqui
 #include <ctype.h>          // Para manipulação de caracteres (toupper, isdigit) - Menos usado aqui
-#include "pico/binary_info.h"// Para adicionar informações ao binário (usado pela lib SSD1306)
 #include "inc/ssd1306.h"     // Biblioteca principal para o display OLED SSD1306
-#include "hardware/i2c.h"      // Para comunicação I2C (usada pelo OLED)
 
-// **INCLUSÕES DO BUZZER**
-#include "hardware/pwm.h"      // Para controle de Pulse Width Modulation (usado pelo buzzer)
-
-// ===== ADIÇÕES PARA WIFI HTTP SERVER =====
-#include "pico/cyw43_arch.h" // Para arquitetura específica do chip Wi-Fi CYW43
-#include "lwip/tcp.h"          // Para funcionalidades TCP do stack lwIP
-#include "lwip/ip4_addr.h"     // Para manipulação de endereços IPv4
-// =========================================
+// ===== DIVISÃO ENTRE OS NÚCLEOS =====
+#include "scheduler.h"         // Escalonador cooperativo de tarefas
+#include "setores.h"           // Fila de comandos e snapshot dos setores entre os núcleos
+#include "http_server.h"       // Servidor HTTP (página de status gerada em partes)
+// ====================================
+#include "matriz_leds.h"       // Matriz WS2812B com quadro duplo e envio por DMA
+#include "visor.h"             // Janela da grade de setores na matriz (rolagem e zoom)
+#include "painel_oled.h"       // Painel de status dos setores no OLED
+#include "sensores_adc.h"      // Aquisição contínua e filtragem dos canais do ADC
+#include "ingestao.h"          // Fila única de leituras dos setores até o núcleo 1
+#include "fontes.h"            // Fontes de leituras: sondas I2C, UDP e replay
+#include "historico.h"         // Histórico de temperatura por setor (anéis de 3 camadas)
+#include "persistencia.h"      // Log na flash: cadastro, nomes, temperaturas e histórico
+#include "diario.h"            // Diário de eventos (anéis por núcleo, lido por /api/events)
+#include "log.h"               // Log adiado (anéis por núcleo, escrito por task_log)
 
 // Definições para a matriz de LEDs WS2812B
-#define LED_COUNT 25           // Número total de LEDs na matriz (5x5)
+#define LED_COUNT MATRIZ_LEDS_QTD // Número total de LEDs na matriz (5x5)
 #define LED_PIN 7              // Pino GPIO conectado ao DIN da matriz de LEDs
 
 // Definições para o joystick
@@ -56,37 +58,66 @@ const uint I2C_SCL = 15;       // Pino GPIO para o SCL do I2C1
 #define TEMPERATURE_UNITS 'C'  // Unidade padrão para temperatura ('C' para Celsius, 'F' para Fahrenheit)
 #define ADC_TEMP_PIN 4         // Canal ADC para o sensor de temperatura interno do RP2040
 
+// Aquisição contínua do ADC: rodízio entre joystick (canais 0 e 1) e sensor interno
+#define ADC_TAXA_HZ 3000       // Conversões por segundo, somadas (1 kS/s por canal)
+static const sensores_adc_canal_cfg_t canais_adc[] = {
+    { 0,            2, 1 },    // Joystick Y: médias de 4 (250/s), suavização leve
+    { 1,            2, 1 },    // Joystick X
+    { ADC_TEMP_PIN, 6, 3 },    // Sensor interno: médias de 64 (~16/s), constante de ~0,5 s
+};
+
+// Fontes de leituras dos setores (ver fontes.h)
+#define PORTA_UDP_LEITURAS 5005  // Porta UDP das leituras dos nós remotos
+#define PERIODO_SONDAS_MS 1000   // Ciclo de leitura das sondas I2C
+// Sondas LM75/TMP102 no barramento do OLED: endereço -> setor (ajustar à instalação).
+// As que não respondem no boot são ignoradas.
+static const fonte_i2c_sonda_t sondas_i2c[] = {
+    { 0x48, 0 }, { 0x49, 1 }, { 0x4A, 2 }, { 0x4B, 3 },
+    { 0x4C, 4 }, { 0x4D, 5 }, { 0x4E, 6 }, { 0x4F, 7 },
+};
+static fonte_i2c_t fonte_i2c = {
+    .porta = ssd1306_i2c_porta, .sondas = sondas_i2c,
+    .quantidade = count_of(sondas_i2c), .periodo_ms = PERIODO_SONDAS_MS,
+};
+static fonte_replay_t fonte_replay;
+
 // **DEFINIÇÕES DO BUZZER**
 #define BUZZER_PIN 21          // Pino GPIO conectado ao buzzer
 
+// ===== PERÍODOS DAS TAREFAS DO ESCALONADOR (ms) =====
+// Núcleo 0: Wi-Fi/HTTP e interface com o usuário
+#define PERIODO_REDE_MS      1   // Polling da pilha Wi-Fi/lwIP
+#define PERIODO_PAINEL_MS    200 // Redesenho do painel de status (apenas o que mudou)
+#define PERIODO_OLED_MS      50  // Atualização do display OLED
+#define PERIODO_SERIAL_MS    10  // Leitura não bloqueante do menu serial
+#define PERIODO_EVENTOS_MS   20  // Repasse dos eventos do núcleo 1 aos streams /events
+#define PERIODO_FONTES_MS    20  // Coleta das fontes periódicas de leituras (sondas, replay)
+#define PERIODO_PERSISTENCIA_MS 1000 // Gravação das mudanças na flash (páginas agrupadas)
+#define PERIODO_DIARIO_MS    50  // Dreno dos anéis de eventos dos núcleos para o diário
+#define PERIODO_LOG_MS       20  // Formatação e escrita das mensagens de log (até LOG_LOTE por vez)
+// Núcleo 1: sensores, alarme e atuadores
+#define PERIODO_COMANDOS_MS  1   // Aplicação dos comandos do núcleo 0 e publicação do estado
+#define PERIODO_INGESTAO_MS  5   // Aplicação das leituras das fontes (até INGESTAO_LOTE por vez)
+#define PERIODO_ADC_MS       10  // Consumo do anel do ADC (~30 amostras por execução)
+#define PERIODO_SENSOR_MS    100 // Amostragem do sensor de temperatura onboard
+#define PERIODO_ALARME_MS    10  // Avaliação do alarme (limita a latência do buzzer)
+#define PERIODO_CADASTRO_MS  70  // Leitura do joystick/botões no modo de cadastro
+#define PERIODO_VISOR_MS     150 // Rolagem/zoom da matriz pelo joystick (fora do modo de cadastro)
+#define PERIODO_LEDS_MS      100 // Atualização da matriz de LEDs
+#define PERIODO_HISTORICO_MS (HISTORICO_PERIODO_BRUTO_S * 1000) // Amostra do histórico dos setores
+// ====================================================
+
+// Painel de status no OLED
+#define PAINEL_ABERTURA_MS   3000 // Tempo da mensagem de boas-vindas antes do painel
+#define PAINEL_AMOSTRA_MS    1000 // Intervalo entre as amostras do gráfico (128 amostras ~ 2 min)
+
 // ===== DEFINIÇÕES PARA WIFI HTTP SERVER =====
 #define WIFI_SSID "Colocar o nome da sua rede WiFi aqui"      // Nome da rede Wi-Fi (SSID)
 #define WIFI_PASS "Colocar a senha da sua rede WiFi aqui"   // Senha da rede Wi-Fi
 // ===========================================
 
 // Estruturas de dados
-
-/**
- * @struct pixel_t
- * @brief Estrutura para representar a cor de um pixel RGB.
- */
-struct pixel_t {
-    uint8_t G, R, B; // Componentes Verde, Vermelho e Azul da cor (ordem G R B para WS2812B)
-};
-typedef struct pixel_t pixel_t; // Define pixel_t como um tipo
-typedef pixel_t npLED_t;       // Define npLED_t como um alias para pixel_t (específico para NeoPixel)
-
-// Array para armazenar o estado de cor de cada LED da matriz
-npLED_t leds[LED_COUNT];
-// Instância do PIO a ser usada (pio0 ou pio1)
-PIO np_pio = pio0;
-// State Machine (SM) do PIO a ser usada
-uint sm;
-
-// Matriz booleana para rastrear o estado de cadastro de cada LED (true = cadastrado)
-// Nota: `setor_cadastrado` é mais diretamente usado para a lógica de cadastro.
-// `led_states` parece ser uma redundância ou um resquício.
-bool led_states[5][5] = {false};
+// (O quadro de cores da matriz de LEDs fica em matriz_leds.c)
 
 // Protótipos das funções (declarações antecipadas)
 
@@ -95,8 +126,6 @@ void npInit(uint pin);
 void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
 void npClear();
 void npWrite();
-int getIndex(int x, int y); // Converte coordenadas (x,y) da matriz para índice linear
-void clear_led_states();     // Reseta o estado dos LEDs (matriz `led_states`)
 
 // Funções para botões
 void init_button(uint pin);
@@ -105,15 +134,50 @@ bool read_button(uint pin);
 // Funções de interface com o usuário (menus via serial)
 void show_menu();
 void show_setores_menu();
+void ui_processar_linha(char *linha); // Trata uma linha completa digitada no terminal
+
+// Funções de inicialização (core0/core1_inicializar também são usadas pelo benchmark)
+void core0_inicializar();    // OLED, fontes de leituras e escalonador do núcleo 0
+void inicializar_oled();     // I2C, SSD1306 e área de renderização (tela apagada)
+void inicializar_nomes_setores(); // Nomes padrão "Setor (x,y)"
+void core1_inicializar();    // Periféricos e escalonador do núcleo 1
 
 // Funções de gerenciamento do sistema
-void clearSystem();          // Reseta o estado geral do sistema AgroGraf
+void clearSystem();          // Reseta o estado geral do sistema AgroGraf (núcleo 1)
+void publicar_estado();      // Publica o estado dos setores para o núcleo 0
 float read_onboard_temperature(const char unit); // Lê a temperatura do sensor interno
 void listar_setores();       // Lista os setores cadastrados e suas temperaturas
-void mudar_temperatura_setor(); // Permite alterar a temperatura de um setor
+bool mudar_temperatura_setor(); // Lista os setores e solicita o índice do setor a alterar
 void update_led_colors();    // Atualiza as cores dos LEDs na matriz baseado no estado dos setores
 void desligarLedAzul();     // Restaura a cor do LED que estava sob o cursor azul
-void acionar_equipamentos_contra_incendio(); // Simula acionamento de equipamentos e reseta temperaturas altas
+void desenhar_led(int lx, int ly); // Define no quadro a cor do LED (vermelho, verde ou apagado)
+void desenhar_cursor();      // Desenha o cursor azul no LED que exibe o setor do cursor
+bool acionar_equipamentos_contra_incendio(); // Lista setores em alerta e solicita confirmação
+void resetar_setores_em_alerta(); // Volta os setores em alerta para a temperatura ambiente
+void avaliar_alarme();       // Liga/desliga o buzzer conforme o estado dos setores
+
+// Tarefas do escalonador cooperativo do núcleo 0
+void task_rede(void *ctx);
+void task_eventos(void *ctx);
+void task_fontes(void *ctx);
+void task_painel(void *ctx);
+void painel_montar_modelo(const setores_snapshot_t *estado, painel_oled_modelo_t *m); // Modelo do painel
+void task_oled(void *ctx);
+void task_serial(void *ctx);
+void task_persistencia(void *ctx);
+void task_diario(void *ctx);
+void task_log(void *ctx);
+// Tarefas do escalonador cooperativo do núcleo 1
+void core1_main();
+void task_comandos(void *ctx);
+void task_ingestao(void *ctx);
+void task_adc(void *ctx);
+void task_sensor(void *ctx);
+void task_alarme(void *ctx);
+void task_cadastro(void *ctx);
+void task_visor(void *ctx);
+void task_leds(void *ctx);
+void task_historico(void *ctx);
 
 // Funções para o Buzzer
 void pwm_init_buzzer(uint pin); // Inicializa o PWM para o buzzer
@@ -122,188 +186,181 @@ void stop_tone(uint pin);       // Para o som do buzzer
 
 // Declaração de variáveis globais
 
-#define MAX_SETORES 25         // Número máximo de setores (corresponde ao LED_COUNT)
-char nomes_setores[MAX_SETORES][30]; // Array para armazenar nomes dos setores
-float temperaturas_setores[MAX_SETORES]; // Array para armazenar temperaturas dos setores
-bool setor_cadastrado[MAX_SETORES];    // Array para rastrear se um setor está cadastrado
+// ===== MODELO DOS SETORES (PERTENCE AO NÚCLEO 1) =====
+// Estas variáveis só são lidas/escritas pelo núcleo 1. O núcleo 0 usa
+// setores_ler_snapshot() para lê-las e setores_enviar_comando() para alterá-las.
+// Indexado pelo setor (setor_indice(x, y)), sem depender da matriz de LEDs.
+// Escrito só por setores_modelo_*, que mantêm o conjunto de alarmes a cada escrita.
+setores_modelo_t modelo_setores; // Temperaturas, cadastro e alarme dos setores
 
-// Posição atual do cursor na matriz de LEDs (usado no modo de cadastro)
+// Posição atual do cursor na grade de setores (usado no modo de cadastro)
 int current_x = 0;
 int current_y = 0;
+// Janela da grade exibida na matriz de LEDs
+visor_t visor;
+// Estado anterior do botão do joystick fora do modo de cadastro (zoom do visor)
+bool botao_visor_anterior = false;
 
 // Definições de cores padrão
 uint8_t blue_r = 0, blue_g = 0, blue_b = 128;   // Cor azul para o cursor
 uint8_t green_r = 0, green_g = 128, green_b = 0; // Cor verde para setor OK
 uint8_t red_r = 128, red_g = 0, red_b = 0;     // Cor vermelha para setor em alerta
+uint8_t yellow_r = 96, yellow_g = 64, yellow_b = 0; // Cor amarela para setor em aviso
 
 // Estado do buzzer
 bool buzzer_ativo = false;
-// Escolha do usuário no menu principal
-int main_menu_choice;
+// Última leitura do sensor de temperatura onboard (atualizada por task_sensor)
+float temperatura_ambiente = 0.0f;
+
+// Estado anterior dos botões A e B no modo de cadastro (para detecção de borda)
+bool button_a_last_state = false;
+bool button_b_last_state = false;
+// Modo de cadastro via joystick ativo (cursor azul na matriz)
+bool modo_cadastro = false;
+// O modelo mudou desde a última publicação do snapshot
+bool estado_alterado = true;
+// Último estado publicado (mantido para numerar as versões)
+setores_snapshot_t estado_publicado;
+// =====================================================
+
+// ===== ESTADO LIDO PELO NÚCLEO 0 =====
+// Persistência, painel e menu serial leem o snapshot nesta única cópia: as
+// tarefas do núcleo 0 rodam uma de cada vez e nenhuma guarda a cópia entre
+// execuções (uma cópia por função custaria 768 bytes cada em 13x13).
+static setores_snapshot_t estado_nucleo0;
+
+static const setores_snapshot_t *ler_estado(void) {
+    setores_ler_snapshot(&estado_nucleo0);
+    return &estado_nucleo0;
+}
+// =====================================
+
+// ===== ESTADO DA INTERFACE SERIAL (MENU NÃO BLOQUEANTE) =====
+/**
+ * @enum ui_estado_t
+ * @brief Estados da máquina de estados do menu serial.
+ * @details Substitui as chamadas bloqueantes a `scanf`: cada estado indica
+ *          o que a próxima linha digitada pelo usuário significa.
+ */
+typedef enum {
+    UI_MENU_PRINCIPAL,   // Aguardando opção do menu principal
+    UI_CADASTRO,         // Modo de cadastro via joystick (entrada serial ignorada)
+    UI_MENU_SETORES,     // Aguardando opção do submenu de setores
+    UI_MUDAR_INDICE,     // Aguardando o índice do setor a ter a temperatura alterada
+    UI_MUDAR_VALOR,      // Aguardando a nova temperatura do setor escolhido
+    UI_ACIONAR_CONFIRMA, // Aguardando confirmação (s/n) do acionamento dos equipamentos
+    UI_AGUARDA_ENTER,    // Aguardando Enter para seguir para `ui_proximo`
+    UI_PAUSA,            // Exibindo uma mensagem até `ui_pausa_ate_us`
+    UI_ENCERRADO         // Usuário escolheu sair
+} ui_estado_t;
+
+#define UI_LINHA_MAX 32                    // Tamanho máximo de uma linha digitada
+ui_estado_t ui_estado = UI_MENU_PRINCIPAL; // Estado atual do menu
+ui_estado_t ui_proximo = UI_MENU_PRINCIPAL; // Estado seguinte após pausa/Enter
+uint64_t ui_pausa_ate_us = 0;              // Fim da pausa atual (substitui sleep_ms)
+int ui_setor_escolhido = -1;               // Setor escolhido em "Mudar temperatura"
+char ui_linha[UI_LINHA_MAX];               // Linha sendo digitada
+size_t ui_linha_len = 0;                   // Caracteres acumulados em `ui_linha`
+bool ui_ultimo_cr = false;                 // Último caractere foi '\r' (trata CR/LF)
+bool ui_cadastro_confirmado = false;       // Núcleo 1 já confirmou a entrada no modo de cadastro
+setores_bits_t ui_cadastro_anterior;      // Cadastro já exibido (para imprimir as mudanças)
+
+void ui_entrar(ui_estado_t estado);                  // Entra em um estado exibindo sua tela
+void ui_pausar(uint32_t ms, ui_estado_t proximo);    // Exibe uma mensagem por `ms` sem bloquear
+void ui_aguardar_enter(ui_estado_t proximo);         // Aguarda Enter antes de seguir
+void ui_acompanhar_cadastro();                       // Acompanha o cadastro feito pelo núcleo 1
+// ============================================================
+
+// ===== VARIÁVEIS GLOBAIS DO DISPLAY OLED =====
+ssd1306_t oled;                     // Driver do display (dono do framebuffer)
+uint8_t *const ssd = oled.ram_buffer + 1; // Framebuffer do display (ver ssd1306_framebuffer)
+struct render_area frame_area;      // Área de renderização (tela inteira)
+uint64_t painel_inicio_us;          // Fim da mensagem de boas-vindas (início do painel)
+// As páginas/colunas alteradas são rastreadas pelo próprio driver (ssd1306_flush_async)
+// =============================================
+
+// ===== ESCALONADORES COOPERATIVOS (UM POR NÚCLEO) =====
+/**
+ * @brief Índices das tarefas na tabela do núcleo 0 (ordem = prioridade).
+ */
+enum {
+    TAREFA_REDE,
+    TAREFA_EVENTOS,
+    TAREFA_FONTES,
+    TAREFA_PAINEL,
+    TAREFA_OLED,
+    TAREFA_SERIAL,
+    TAREFA_PERSISTENCIA,
+    TAREFA_DIARIO,
+    TAREFA_LOG,
+    NUM_TAREFAS
+};
 
-// ===== VARIÁVEIS GLOBAIS PARA WIFI HTTP SERVER =====
-char http_response_buffer[1536]; // Buffer para armazenar a resposta HTTP
-// ==================================================
+scheduler_task_t tarefas[NUM_TAREFAS] = {
+    [TAREFA_REDE]     = SCHEDULER_TASK("rede",     task_rede,     NULL, PERIODO_REDE_MS,     true),
+    [TAREFA_EVENTOS]  = SCHEDULER_TASK("eventos",  task_eventos,  NULL, PERIODO_EVENTOS_MS,  true),
+    [TAREFA_FONTES]   = SCHEDULER_TASK("fontes",   task_fontes,   NULL, PERIODO_FONTES_MS,   true),
+    [TAREFA_PAINEL]   = SCHEDULER_TASK("painel",   task_painel,   NULL, PERIODO_PAINEL_MS,   true),
+    [TAREFA_OLED]     = SCHEDULER_TASK("oled",     task_oled,     NULL, PERIODO_OLED_MS,     true),
+    [TAREFA_SERIAL]   = SCHEDULER_TASK("serial",   task_serial,   NULL, PERIODO_SERIAL_MS,   true),
+    [TAREFA_PERSISTENCIA] = SCHEDULER_TASK("persistencia", task_persistencia, NULL, PERIODO_PERSISTENCIA_MS, true),
+    [TAREFA_DIARIO]   = SCHEDULER_TASK("diario",   task_diario,   NULL, PERIODO_DIARIO_MS,   true),
+    [TAREFA_LOG]      = SCHEDULER_TASK("log",      task_log,      NULL, PERIODO_LOG_MS,      true),
+};
+scheduler_t scheduler;
+
+/**
+ * @brief Índices das tarefas na tabela do núcleo 1 (ordem = prioridade).
+ */
+enum {
+    TAREFA_COMANDOS,
+    TAREFA_INGESTAO,
+    TAREFA_ADC,
+    TAREFA_SENSOR,
+    TAREFA_ALARME,
+    TAREFA_CADASTRO,
+    TAREFA_VISOR,
+    TAREFA_LEDS,
+    TAREFA_HISTORICO,
+    NUM_TAREFAS_CORE1
+};
+
+scheduler_task_t tarefas_core1[NUM_TAREFAS_CORE1] = {
+    [TAREFA_COMANDOS] = SCHEDULER_TASK("comandos", task_comandos, NULL, PERIODO_COMANDOS_MS, true),
+    [TAREFA_INGESTAO] = SCHEDULER_TASK("ingestao", task_ingestao, NULL, PERIODO_INGESTAO_MS, true),
+    [TAREFA_ADC]      = SCHEDULER_TASK("adc",      task_adc,      NULL, PERIODO_ADC_MS,      true),
+    [TAREFA_SENSOR]   = SCHEDULER_TASK("sensor",   task_sensor,   NULL, PERIODO_SENSOR_MS,   true),
+    [TAREFA_ALARME]   = SCHEDULER_TASK("alarme",   task_alarme,   NULL, PERIODO_ALARME_MS,   true),
+    [TAREFA_CADASTRO] = SCHEDULER_TASK("cadastro", task_cadastro, NULL, PERIODO_CADASTRO_MS, false),
+    [TAREFA_VISOR]    = SCHEDULER_TASK("visor",    task_visor,    NULL, PERIODO_VISOR_MS,    false),
+    [TAREFA_LEDS]     = SCHEDULER_TASK("leds",     task_leds,     NULL, PERIODO_LEDS_MS,     true),
+    [TAREFA_HISTORICO] = SCHEDULER_TASK("historico", task_historico, NULL, PERIODO_HISTORICO_MS, true),
+};
+scheduler_t scheduler_core1;
+// =======================================================
 
 /**
  * @brief Reseta o sistema AgroGraf para seu estado inicial.
  * @details Limpa a matriz de LEDs, reseta os estados de cadastro e temperaturas dos setores,
- *          posiciona o cursor no centro e desliga o buzzer se estiver ativo.
+ *          posiciona o cursor no centro da grade e desliga o buzzer se estiver ativo.
+ *          Executada no núcleo 1; o núcleo 0 usa solicitar_limpeza().
  */
 void clearSystem() {
     npClear();             // Apaga todos os LEDs da matriz
-    clear_led_states();    // Reseta a matriz auxiliar `led_states` (uso questionável)
-    current_x = 2;         // Reseta o cursor para a posição central (x=2)
-    current_y = 2;         // Reseta o cursor para a posição central (y=2)
+    current_x = SETORES_COLUNAS / 2; // Reseta o cursor para o centro da grade
+    current_y = SETORES_LINHAS / 2;
     npWrite();             // Envia os dados para a matriz de LEDs (agora apagada)
 
-    // Lê a temperatura ambiente atual do sensor onboard
-    float temperatura_ambiente = read_onboard_temperature(TEMPERATURE_UNITS);
-    // Itera por todos os setores possíveis
-    for (int i = 0; i < MAX_SETORES; i++) {
-        setor_cadastrado[i] = false;               // Marca o setor como não cadastrado
-        temperaturas_setores[i] = temperatura_ambiente; // Define a temperatura do setor para a ambiente
-    }
+    // Usa a última leitura do sensor onboard (mantida por task_sensor) como temperatura ambiente
+    // Nenhum setor cadastrado, todos na temperatura ambiente
+    setores_modelo_limpar(&modelo_setores, temperatura_ambiente);
     // Se o buzzer estiver ativo, desliga-o
     if (buzzer_ativo) {
         stop_tone(BUZZER_PIN);
         buzzer_ativo = false;
+        diario_registrar(DIARIO_BUZZER, SETOR_INVALIDO, 0, 0.0f);
     }
-    printf("Sistema AgroGraf limpo.\n");
-}
-
-/**
- * @brief Constrói a página HTML de status e controle para o servidor HTTP.
- * @details Gera uma página HTML contendo o status dos setores, temperatura,
- *          estado do buzzer e links para ações como resetar alarmes e limpar o sistema.
- *          A página se auto-atualiza a cada 5 segundos.
- */
-void build_http_response() {
-    char status_info[1024] = ""; // Buffer para informações de status dos setores
-    char temp_buf[100];          // Buffer temporário para formatação de strings
-    int Sprintf_Num_Local = 0;   // Contador de bytes escritos em status_info (evita overflow)
-
-    // Adiciona cabeçalho para a lista de status dos setores
-    Sprintf_Num_Local += sprintf(status_info + Sprintf_Num_Local, "<h2>Status dos Setores:</h2><ul>");
-    // Itera por todos os setores
-    for (int i = 0; i < MAX_SETORES; i++) {
-        // Se o setor estiver cadastrado, adiciona suas informações à lista
-        if (setor_cadastrado[i]) {
-            // Verifica se há espaço suficiente no buffer status_info
-            if (Sprintf_Num_Local < sizeof(status_info) - 100) { // -100 para margem de segurança
-                // Formata a string do setor (nome, índice, temperatura, alerta)
-                sprintf(temp_buf, "<li>%s (Indice %d): %.2f C %s</li>",
-                        nomes_setores[i],
-                        i + 1, // Índice para o usuário (1-25)
-                        temperaturas_setores[i],
-                        (temperaturas_setores[i] > 100.0f) ? "<b>(ALERTA!)</b>" : ""); // Alerta se temp > 100
-                // Adiciona a string formatada ao buffer principal de status
-                Sprintf_Num_Local += sprintf(status_info + Sprintf_Num_Local, "%s", temp_buf);
-            }
-        }
-    }
-    // Fecha a lista HTML e adiciona status do buzzer
-    if (Sprintf_Num_Local < sizeof(status_info) - 80) Sprintf_Num_Local += sprintf(status_info + Sprintf_Num_Local, "</ul>");
-    if (Sprintf_Num_Local < sizeof(status_info) - 50) Sprintf_Num_Local += sprintf(status_info + Sprintf_Num_Local, "<p>Buzzer: %s</p>", buzzer_ativo ? "ATIVO" : "DESATIVADO");
-
-    // Monta a resposta HTTP completa
-    sprintf(http_response_buffer,
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nConnection: close\r\n\r\n" // Cabeçalho HTTP
-            "<!DOCTYPE html><html><head><title>AgroGraf Control</title>"
-            "<meta http-equiv='refresh' content='5'>" // Auto-refresh da página a cada 5s
-            "</head><body>"
-            "<h1>AgroGraf - Controle Remoto</h1>"
-            "%s" // Insere as informações de status dos setores aqui
-            "<h2>Acoes:</h2>"
-            "<p><a href=\"/reset_alarms\">Acionar Equipamentos (Resetar Alarmes)</a></p>" // Link para resetar alarmes
-            "<p><a href=\"/clear_system\">Limpar Sistema</a></p>"                     // Link para limpar o sistema
-            "</body></html>\r\n",
-            status_info);
-}
-
-/**
- * @brief Callback para lidar com requisições HTTP recebidas.
- * @param arg Argumento passado para o callback (não utilizado aqui).
- * @param tpcb Ponteiro para a estrutura de controle do TCP.
- * @param p Ponteiro para o buffer de pacotes (pbuf) contendo os dados recebidos.
- * @param err Código de erro (se houver).
- * @return err_t Código de erro lwIP. ERR_OK se bem sucedido.
- * @details Processa requisições GET para "/reset_alarms" e "/clear_system".
- *          Para qualquer outra requisição GET (ou a raiz "/"), envia a página de status.
- */
-static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    // Se p for NULL, significa que a conexão foi fechada pelo cliente ou houve um erro grave
-    if (p == NULL) {
-        tcp_close(tpcb); // Fecha a conexão TCP
-        return ERR_OK;
-    }
-    char *request = (char *)p->payload; // Converte o payload do pacote para string
-
-    // Verifica se a requisição contém "GET /reset_alarms"
-    if (strstr(request, "GET /reset_alarms")) {
-        acionar_equipamentos_contra_incendio(); // Chama a função para resetar alarmes
-    }
-    // Verifica se a requisição contém "GET /clear_system"
-    else if (strstr(request, "GET /clear_system")) {
-        clearSystem(); // Chama a função para limpar o sistema
-    }
-
-    // Constrói a resposta HTTP (página de status)
-    build_http_response();
-    // Envia a resposta HTTP para o cliente
-    err_t write_err = tcp_write(tpcb, http_response_buffer, strlen(http_response_buffer), TCP_WRITE_FLAG_COPY);
-    if (write_err != ERR_OK) {
-        printf("Erro ao enviar resposta HTTP: %d\n", write_err);
-    }
-    pbuf_free(p); // Libera o buffer do pacote recebido
-    return ERR_OK;
-}
-
-/**
- * @brief Callback para aceitar novas conexões TCP.
- * @param arg Argumento passado para o callback (não utilizado aqui).
- * @param newpcb Ponteiro para a nova estrutura de controle TCP da conexão aceita.
- * @param err Código de erro (se houver).
- * @return err_t Código de erro lwIP. ERR_OK se bem sucedido, ERR_MEM se faltar memória.
- */
-static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
-    // Se newpcb for NULL, pode ser um erro de falta de memória
-    if (newpcb == NULL) {
-        return ERR_MEM; // Retorna erro de memória
-    }
-    // Define a função http_callback para ser chamada quando dados forem recebidos nesta conexão
-    tcp_recv(newpcb, http_callback);
-    return ERR_OK;
-}
-
-/**
- * @brief Inicializa e inicia o servidor HTTP na porta 80.
- * @details Cria um novo PCB TCP, faz o bind para qualquer endereço IP na porta 80,
- *          coloca o servidor em modo de escuta (listen) e define o callback para aceitar conexões.
- */
-static void start_http_server(void) {
-    // Cria um novo Protocol Control Block (PCB) para TCP, aceitando qualquer tipo de IP (IPv4/IPv6)
-    struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
-    if (!pcb) {
-        printf("Erro ao criar PCB HTTP\n");
-        return;
-    }
-    // Associa (bind) o PCB a qualquer endereço IP local (IP_ANY_TYPE) na porta 80
-    err_t bind_err = tcp_bind(pcb, IP_ANY_TYPE, 80);
-    if (bind_err != ERR_OK) {
-        printf("Erro ao ligar o servidor HTTP na porta 80: %d\n", bind_err);
-        tcp_abort(pcb); // Aborta o PCB se o bind falhar
-        return;
-    }
-    // Coloca o PCB em modo de escuta (listen) para novas conexões
-    pcb = tcp_listen(pcb);
-    if (!pcb) {
-        printf("Erro ao colocar PCB em modo listen\n");
-        return;
-    }
-    // Define connection_callback para ser chamado quando uma nova conexão for estabelecida
-    tcp_accept(pcb, connection_callback);
-    printf("Servidor HTTP AgroGraf rodando na porta 80...\n");
+    estado_alterado = true; // Publica o novo estado para o núcleo 0
 }
 
 /**
@@ -317,64 +374,84 @@ void clear_screen() {
  * @brief Função principal do sistema AgroGraf.
  * @return int Código de saída do programa (0 para sucesso).
  * @details Inicializa todos os periféricos (stdio, Wi-Fi, I2C, OLED, ADC, botões, LEDs, buzzer),
- *          exibe o menu principal e processa as escolhas do usuário em um loop infinito.
+ *          exibe o menu principal e entrega o controle ao escalonador cooperativo, que
+ *          executa periodicamente as tarefas de rede, sensor, alarme, LEDs, OLED e menu serial.
  *          Gerencia o estado dos setores, temperaturas, alertas e a interface HTTP.
+ *          Com AGROGRAF_SEM_MAIN (alvo agrograf_bench) o main() é fornecido pelo benchmark.
  */
+#ifndef AGROGRAF_SEM_MAIN
 int main() {
     // Inicializa a E/S padrão (USB e/ou UART)
-    stdio_init_all();
-    sleep_ms(2000); // Pequena pausa para permitir que o terminal serial se conecte
+    hal_console_init();
+    log_init();      // Antes de qualquer LOG_*: as mensagens saem por task_log
+    ingestao_init(); // Fila de leituras: as fontes são registradas a seguir
+
+    // Estado salvo na flash: o histórico é restaurado aqui; cadastro e
+    // temperaturas, pelo núcleo 1 ao iniciar.
+    // Lança o núcleo 1, dono de sensores, alarme e atuadores, antes da pausa do
+    // terminal e da conexão Wi-Fi: setores, LEDs e alarme voltam em milissegundos
+    // após o boot. E nada que aconteça na pilha Wi-Fi/HTTP (ex.: um cliente lento
+    // ou uma rajada de requisições) atrasa o acionamento do buzzer.
+    inicializar_nomes_setores();
+    historico_init();
+    persistencia_iniciar();
+    setores_init();
+    hal_nucleo1_iniciar(core1_main);
+
+    hal_dormir_ms(2000); // Pequena pausa para permitir que o terminal serial se conecte
     clear_screen(); // Limpa a tela do terminal
 
-    // Inicializa o chip Wi-Fi CYW43xxx
-    if (cyw43_arch_init()) {
+    // Inicializa o chip Wi-Fi (modo Station)
+    if (hal_rede_iniciar()) {
         printf("Falha ao inicializar Wi-Fi\n");
     } else {
         printf("Wi-Fi inicializado.\n");
-        cyw43_arch_enable_sta_mode(); // Habilita o modo Station (cliente Wi-Fi)
         printf("Conectando ao Wi-Fi '%s'...\n", WIFI_SSID);
         // Tenta conectar à rede Wi-Fi com timeout de 20 segundos
-        if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, 20000)) {
+        if (hal_rede_conectar(WIFI_SSID, WIFI_PASS, 20000)) {
             printf("Falha ao conectar ao Wi-Fi.\n");
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1); // Acende o LED onboard do Pico W (indica erro)
+            hal_rede_led(true); // Acende o LED onboard do Pico W (indica erro)
         } else {
             printf("Conectado com sucesso ao Wi-Fi '%s'.\n", WIFI_SSID);
-            // Verifica se a interface de rede padrão está configurada
-            if (netif_default) {
-                printf("Endereco IP: %s\n", ip4addr_ntoa(netif_ip4_addr(netif_default)));
+            char ip[24];
+            if (hal_rede_ip(ip, sizeof(ip))) {
+                printf("Endereco IP: %s\n", ip);
             } else {
-                printf("Nao foi possivel obter o endereco IP (netif_default is NULL).\n");
+                printf("Nao foi possivel obter o endereco IP.\n");
             }
             // Pisca o LED onboard para indicar sucesso na conexão Wi-Fi e servidor pronto
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1); sleep_ms(250);
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0); sleep_ms(250);
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1); sleep_ms(250);
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0); sleep_ms(250);
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1); // Deixa o LED aceso
+            hal_rede_led(true); hal_dormir_ms(250);
+            hal_rede_led(false); hal_dormir_ms(250);
+            hal_rede_led(true); hal_dormir_ms(250);
+            hal_rede_led(false); hal_dormir_ms(250);
+            hal_rede_led(true); // Deixa o LED aceso
 
             start_http_server(); // Inicia o servidor HTTP
+            static fonte_udp_t fonte_udp = { .porta = PORTA_UDP_LEITURAS }; // Só registrada com a rede no ar
+            ingestao_registrar(&FONTE_UDP(&fonte_udp)); // Leituras dos nós remotos
         }
     }
 
-    // Inicializa a comunicação I2C1 na frequência de 400kHz
-    i2c_init(i2c1, 400 * 1000);
-    // Configura os pinos GPIO para a função I2C
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    // Habilita pull-ups internos para os pinos I2C
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
-    // Inicializa o display OLED SSD1306
-    ssd1306_init();
-    // Define a área de renderização para cobrir todo o display
-    struct render_area frame_area = {
-        .start_column = 0, .end_column = ssd1306_width - 1,
-        .start_page = 0, .end_page = ssd1306_n_pages - 1
-    };
-    calculate_render_area_buffer_length(&frame_area); // Calcula o tamanho do buffer necessário
-    uint8_t ssd[ssd1306_buffer_length]; // Aloca o buffer para o display
-    memset(ssd, 0, ssd1306_buffer_length); // Limpa o buffer do display (preenche com 0)
-    render_on_display(ssd, &frame_area); // Envia o buffer limpo para o display (apaga a tela)
+    core0_inicializar(); // OLED e escalonador do núcleo 0
+
+    // Exibe o menu principal e entrega o controle ao escalonador cooperativo.
+    // Nenhuma tarefa bloqueia: o menu serial é lido caractere a caractere,
+    // então a rede e o OLED continuam sendo atendidos enquanto o operador digita.
+    ui_entrar(UI_MENU_PRINCIPAL);
+    scheduler_run(&scheduler); // Retorna apenas quando o usuário escolhe "Sair"
+
+    // Desinicializa o Wi-Fi antes de sair
+    hal_rede_encerrar();
+    return 0;
+}
+#endif
+
+/**
+ * @brief Inicializa o OLED (com a mensagem de boas-vindas), as fontes de
+ *        leituras e o escalonador do núcleo 0.
+ */
+void core0_inicializar() {
+    inicializar_oled();
     // Mensagem de boas-vindas no OLED
     char *text[] = {
         "   Bem-vindos   ",
@@ -384,329 +461,558 @@ int main() {
         ssd1306_draw_string(ssd, 5, y_oled, text[i]); // Desenha a string no buffer
         y_oled += 8; // Incrementa a posição Y para a próxima linha
     }
-    render_on_display(ssd, &frame_area); // Envia o buffer com o texto para o display
+    // O texto será enviado ao display pela task_oled (apenas as páginas alteradas)
+    // e substituído pelo painel de status após PAINEL_ABERTURA_MS
+    painel_inicio_us = hal_tempo_us() + (uint64_t)PAINEL_ABERTURA_MS * 1000u;
+
+    // Fontes periódicas de leituras (o barramento I2C é o do OLED, já iniciado)
+    ingestao_registrar(&FONTE_I2C(&fonte_i2c));
+    fonte_replay.caminho = getenv("AGROGRAF_REPLAY"); // Só no build de host
+    if (fonte_replay.caminho) ingestao_registrar(&FONTE_REPLAY(&fonte_replay));
+
+    scheduler_init(&scheduler, tarefas, NUM_TAREFAS);
+}
+
+/**
+ * @brief Inicializa o I2C e o display OLED e apaga a tela.
+ */
+void inicializar_oled() {
+    // Inicializa a comunicação I2C1 a 400kHz (pinos na função I2C, com pull-ups internos)
+    hal_i2c_init(ssd1306_i2c_porta, 400 * 1000, I2C_SDA, I2C_SCL);
+    // Inicializa o display OLED SSD1306 e apaga a tela (framebuffer zerado)
+    ssd1306_display_init(&oled, ssd1306_i2c_porta, ssd1306_i2c_address);
+    // Define a área de renderização para cobrir todo o display
+    frame_area = (struct render_area){
+        .start_column = 0, .end_column = ssd1306_width - 1,
+        .start_page = 0, .end_page = ssd1306_n_pages - 1
+    };
+    calculate_render_area_buffer_length(&frame_area); // Calcula o tamanho do buffer necessário
+}
+
+/**
+ * @brief Define os nomes padrão dos setores (antes de lançar o núcleo 1; depois são apenas lidos).
+ */
+void inicializar_nomes_setores() {
+    for (int i = 0; i < MAX_SETORES; i++) {
+        // Coordenadas até 5 dígitos: o nome sempre cabe em SETOR_NOME_MAX
+        snprintf(nomes_setores[i], SETOR_NOME_MAX, "Setor (%hu,%hu)",
+                 (unsigned short)(setor_coluna((setor_id_t)i) + 1), (unsigned short)(setor_linha((setor_id_t)i) + 1));
+    }
+}
 
+// ===== NÚCLEO 1: SENSORES, ALARME E ATUADORES =====
+
+/**
+ * @brief Ponto de entrada do núcleo 1.
+ * @details Executa o escalonador do núcleo 1 até receber SETOR_CMD_ENCERRAR.
+ */
+void core1_main() {
+    hal_flash_nucleo_init(); // Permite ao núcleo 0 pausar este núcleo ao gravar a flash
+    core1_inicializar();
+    scheduler_run(&scheduler_core1);
+}
+
+/**
+ * @brief Inicializa os periféricos do núcleo 1 e publica o estado inicial.
+ * @details Inicializa ADC, botões, matriz de LEDs e buzzer e prepara o escalonador do núcleo 1.
+ */
+void core1_inicializar() {
     // Inicializa o ADC
-    adc_init();
+    hal_adc_init();
     // Configura os pinos do joystick como entradas ADC
-    adc_gpio_init(ADC_X_PIN);
-    adc_gpio_init(ADC_Y_PIN);
+    hal_adc_pino(ADC_X_PIN);
+    hal_adc_pino(ADC_Y_PIN);
     // Inicializa os botões (joystick, A e B)
     init_button(JOYSTICK_BUTTON_PIN);
     init_button(BUTTON_A);
     init_button(BUTTON_B);
-    // Inicializa a matriz de LEDs WS2812B
+    // Inicializa a matriz de LEDs WS2812B, exibindo o canto superior esquerdo da grade
     npInit(LED_PIN);
+    visor_iniciar(&visor);
     // Habilita o sensor de temperatura interno do RP2040
-    adc_set_temp_sensor_enabled(true);
-
-    // Variáveis para armazenar o estado anterior dos botões A e B (para detecção de borda)
-    bool button_a_last_state = false;
-    bool button_b_last_state = false;
-
+    hal_adc_sensor_temperatura(true);
+    // Rodízio contínuo do ADC por DMA (a partir daqui, os canais são lidos filtrados)
+    sensores_adc_iniciar(canais_adc, sizeof(canais_adc) / sizeof(canais_adc[0]), ADC_TAXA_HZ);
+    // Primeira leitura da temperatura ambiente (as seguintes são feitas por task_sensor)
+    temperatura_ambiente = read_onboard_temperature(TEMPERATURE_UNITS);
     clearSystem(); // Reseta o sistema para o estado inicial
-    // Define nomes padrão para os setores
-    for (int y_loop = 0; y_loop < 5; y_loop++) {
-        for (int x_loop = 0; x_loop < 5; x_loop++) {
-            int index = getIndex(x_loop, y_loop);
-            sprintf(nomes_setores[index], "Setor (%d,%d)", x_loop + 1, y_loop + 1);
-            // A temperatura já foi resetada para a ambiente em clearSystem()
-        }
-    }
+    // Cadastro e temperaturas gravados na flash antes do último desligamento
+    persistencia_setores_restaurados(&modelo_setores);
     // Inicializa o PWM para o buzzer
     pwm_init_buzzer(BUZZER_PIN);
 
-    // Loop principal do programa
-    while (true) {
-        cyw43_arch_poll(); // Realiza o polling necessário para a pilha Wi-Fi e lwIP
-        show_menu();       // Exibe o menu principal no terminal serial
-
-        // Lê a escolha do usuário no menu principal
-        if (scanf("%d", &main_menu_choice) != 1) {
-            main_menu_choice = 5; // Opção inválida padrão
-            // Limpa o buffer de entrada em caso de entrada não numérica
-            while (getchar() != '\n' && getchar() != EOF);
-        }
-
-        // Processa a escolha do usuário
-        switch (main_menu_choice) {
-            case 1: // Cadastrar/Descadastrar Setores
-                clear_screen();
-                printf("\nCadastramento de Setores (Joystick). Pressione botao do joystick para sair.\n");
-                
-                // Início do modo de cadastro:
-                // 1. Desenha todos os setores com seu estado atual (verde/vermelho/apagado)
-                for (int y_draw = 0; y_draw < 5; y_draw++) {
-                    for (int x_draw = 0; x_draw < 5; x_draw++) {
-                        int idx = getIndex(x_draw, y_draw);
-                        if (setor_cadastrado[idx]) { // Se setor cadastrado
-                            if (temperaturas_setores[idx] > 100.0f) npSetLED(idx, red_r, red_g, red_b); // Vermelho se alerta
-                            else npSetLED(idx, green_r, green_g, green_b); // Verde se OK
-                        } else {
-                            npSetLED(idx, 0, 0, 0); // Apagado se não cadastrado
-                        }
-                    }
-                }
-                // 2. Desenha o cursor azul por cima, na posição atual
-                npSetLED(getIndex(current_x, current_y), blue_r, blue_g, blue_b);
-                npWrite(); // Atualiza a matriz física de LEDs
-
-                // Loop do modo de cadastro de setores
-                while (true) {
-                    cyw43_arch_poll(); // Polling do Wi-Fi
-                    // Lê os valores ADC dos eixos X e Y do joystick
-                    adc_select_input(1); uint adc_x_raw = adc_read(); // ADC1 é joystick X (definido em ADC_X_PIN)
-                    adc_select_input(0); uint adc_y_raw = adc_read(); // ADC0 é joystick Y (definido em ADC_Y_PIN)
-                    int new_x = current_x, new_y = current_y; // Posições temporárias para o novo cursor
-                    int threshold = 1000; // Limiar para movimento do joystick (centro ~2048)
-
-                    // Lógica de movimento do cursor com base no joystick
-                    // Joystick X: < (2048-th) -> esquerda, > (2048+th) -> direita
-                    if (adc_x_raw < (2048 - threshold) && current_x > 0) new_x--; // Move para a esquerda
-                    if (adc_x_raw > (2048 + threshold) && current_x < 4) new_x++; // Move para a direita
-                    // Joystick Y: > (2048+th) -> cima, < (2048-th) -> baixo (invertido devido à montagem/leitura)
-                    if (adc_y_raw > (2048 + threshold) && current_y > 0) new_y--; // Move para cima
-                    if (adc_y_raw < (2048 - threshold) && current_y < 4) new_y++; // Move para baixo
-
-                    // Verifica se o Botão A foi pressionado (para cadastrar setor)
-                    bool button_a_pressed_now = read_button(BUTTON_A);
-                    if (button_a_pressed_now && !button_a_last_state) { // Detecção de borda de subida
-                        int led_index_cadastro = getIndex(current_x, current_y);
-                        led_states[current_x][current_y] = true; // Atualiza matriz `led_states`
-                        setor_cadastrado[led_index_cadastro] = true; // Marca setor como cadastrado
-                        printf("Setor (%d,%d) cadastrado.\n", current_x + 1, current_y + 1);
-                    }
-                    button_a_last_state = button_a_pressed_now; // Atualiza estado anterior do botão A
-
-                    // Verifica se o Botão B foi pressionado (para descadastrar setor)
-                    bool button_b_pressed_now = read_button(BUTTON_B);
-                    if (button_b_pressed_now && !button_b_last_state) { // Detecção de borda de subida
-                        int led_index_descadastro = getIndex(current_x, current_y);
-                        led_states[current_x][current_y] = false; // Atualiza matriz `led_states`
-                        setor_cadastrado[led_index_descadastro] = false; // Marca setor como não cadastrado
-                        printf("Setor (%d,%d) descadastrado.\n", current_x + 1, current_y + 1);
-                    }
-                    button_b_last_state = button_b_pressed_now; // Atualiza estado anterior do botão B
+    publicar_estado(); // Estado inicial visível para o núcleo 0
+    scheduler_init(&scheduler_core1, tarefas_core1, NUM_TAREFAS_CORE1);
+    // Rolagem e zoom pelo joystick só quando a grade não cabe na matriz
+    scheduler_set_enabled(&scheduler_core1, &tarefas_core1[TAREFA_VISOR], visor_rolavel());
+}
 
-                    // Verifica se o botão do joystick foi pressionado (para sair do modo de cadastro)
-                    if (read_button(JOYSTICK_BUTTON_PIN)) {
-                        desligarLedAzul(); // Restaura a cor original do LED sob o cursor
-                        npWrite();         // Atualiza a matriz física de LEDs
-                        break;             // Sai do loop de cadastro
-                    }
+/**
+ * @brief Copia o modelo dos setores para o snapshot lido pelo núcleo 0.
+ */
+void publicar_estado() {
+    estado_publicado.modelo = modelo_setores;
+    estado_publicado.buzzer_ativo = buzzer_ativo;
+    estado_publicado.modo_cadastro = modo_cadastro;
+    estado_publicado.transicao_pendente = alarmes_transicao_pendente();
+    estado_publicado.temperatura_ambiente = temperatura_ambiente;
+    estado_publicado.visor = visor;
+    setores_publicar(&estado_publicado);
+    estado_alterado = false;
+}
 
-                    // Se o cursor se moveu
-                    if (new_x != current_x || new_y != current_y) {
-                        // 1. Restaura a cor da posição antiga do cursor
-                        int old_idx = getIndex(current_x, current_y);
-                        if (setor_cadastrado[old_idx]) { // Se o setor antigo estava cadastrado
-                            if (temperaturas_setores[old_idx] > 100.0f) npSetLED(old_idx, red_r, red_g, red_b); // Vermelho se alerta
-                            else npSetLED(old_idx, green_r, green_g, green_b); // Verde se OK
-                        } else {
-                            npSetLED(old_idx, 0, 0, 0); // Apagado se não cadastrado
-                        }
-                        current_x = new_x; // Atualiza a posição X do cursor
-                        current_y = new_y; // Atualiza a posição Y do cursor
-                        // 2. Desenha o cursor azul na nova posição
-                        npSetLED(getIndex(current_x, current_y), blue_r, blue_g, blue_b);
-                        npWrite(); // Atualiza a matriz física de LEDs
-                    }
-                    // Se o cursor não moveu, mas o botão A ou B foi pressionado (para atualizar cor imediatamente)
-                    else if (button_a_pressed_now || button_b_pressed_now) {
-                        // Redesenha o setor sob o cursor com a nova cor (verde ou apagado)
-                        int current_idx = getIndex(current_x, current_y);
-                        if (setor_cadastrado[current_idx]) { // Se cadastrado (ou acabou de ser)
-                             if (temperaturas_setores[current_idx] > 100.0f) npSetLED(current_idx, red_r, red_g, red_b); // Alerta
-                             else npSetLED(current_idx, green_r, green_g, green_b); // Verde
-                        } else { // Se descadastrado (ou acabou de ser)
-                            npSetLED(current_idx, 0, 0, 0); // Apagado
-                        }
-                        // Redesenha o cursor azul por cima
-                        npSetLED(getIndex(current_x, current_y), blue_r, blue_g, blue_b);
-                        npWrite(); // Atualiza a matriz física de LEDs
-                    }
-                    sleep_ms(70); // Pequena pausa para debounce e estabilidade da leitura do joystick
+/**
+ * @brief Tarefa de comandos: aplica os pedidos do núcleo 0 e publica o estado.
+ * @details Após uma alteração de temperatura o alarme é reavaliado na mesma
+ *          execução, sem esperar pela próxima ativação de task_alarme.
+ */
+void task_comandos(void *ctx) {
+    setor_cmd_t cmd;
+    bool recebeu = false;
+    while (setores_receber_comando(&cmd)) {
+        recebeu = true;
+        bool por_setor = cmd.tipo == SETOR_CMD_DEFINIR_TEMPERATURA || cmd.tipo == SETOR_CMD_DEFINIR_REGRA;
+        diario_registrar(DIARIO_COMANDO, por_setor ? cmd.setor : SETOR_INVALIDO, cmd.tipo,
+                         cmd.tipo == SETOR_CMD_DEFINIR_TEMPERATURA ? cmd.valor : 0.0f);
+        switch (cmd.tipo) {
+            case SETOR_CMD_DEFINIR_TEMPERATURA:
+                if (cmd.setor < MAX_SETORES && setores_cadastrado(&modelo_setores, cmd.setor)) {
+                    setores_modelo_temperatura(&modelo_setores, cmd.setor, cmd.valor);
                 }
-                update_led_colors(); // Garante que o estado dos LEDs reflita o cadastro ao sair
                 break;
-            case 2: // Limpar Sistema
-                clearSystem(); // Chama a função para resetar o sistema
-                sleep_ms(1500); // Pausa para o usuário ver a mensagem
+            case SETOR_CMD_LIMPAR:
+                clearSystem();
                 break;
-            case 3: // Menu Setores
-                show_setores_menu(); // Chama a função que exibe o submenu de setores
-                update_led_colors(); // Atualiza cores dos LEDs ao retornar do submenu
+            case SETOR_CMD_RESETAR_ALERTAS:
+                resetar_setores_em_alerta();
                 break;
-            case 4: // Sair
-                printf("Saindo do AgroGraf...\n");
-                npClear(); npWrite(); // Apaga todos os LEDs
-                // Desinicializa o Wi-Fi se estiver inicializado
-                if (cyw43_is_initialized(&cyw43_state)) {
-                    cyw43_arch_deinit();
-                }
-                return 0; // Termina o programa
-            case 5: // Opção inválida (digitada ou por erro de scanf)
-                printf("Opcao invalida. Por favor, digite um numero valido.\n");
-                sleep_ms(1500);
-                clear_screen();
+            case SETOR_CMD_DEFINIR_REGRA:
+                alarmes_definir_regra(&modelo_setores, cmd.setor, &cmd.regra, (uint32_t)(hal_tempo_us() / 1000u));
                 break;
-            default: // Caso inesperado
-                printf("Erro inesperado! Voltando ao menu.\n");
-                sleep_ms(1500);
-                clear_screen();
+            case SETOR_CMD_MODO_CADASTRO:
+                modo_cadastro = true;
+                // O cadastro é feito setor a setor: zoom 1, com o cursor na janela
+                visor.zoom = 1;
+                visor_seguir(&visor, current_x, current_y);
+                // 1. Desenha todos os setores com seu estado atual (verde/vermelho/apagado)
+                //    (update_led_colors() preserva a posição do cursor no modo de cadastro)
+                update_led_colors();
+                // 2. Desenha o cursor azul por cima, na posição atual
+                desenhar_cursor();
+                npWrite(); // Atualiza a matriz física de LEDs
+                scheduler_set_enabled(&scheduler_core1, &tarefas_core1[TAREFA_VISOR], false);
+                scheduler_set_enabled(&scheduler_core1, &tarefas_core1[TAREFA_CADASTRO], true);
+                break;
+            case SETOR_CMD_ENCERRAR:
+                npClear(); npWrite(); // Apaga todos os LEDs
+                stop_tone(BUZZER_PIN);
+                buzzer_ativo = false;
+                modo_cadastro = false;
+                publicar_estado();
+                scheduler_stop(&scheduler_core1);
+                return;
+            default:
                 break;
         }
+        estado_alterado = true;
+    }
+    if (recebeu) avaliar_alarme(); // Reage imediatamente a mudanças de temperatura
+    if (estado_alterado) publicar_estado();
+}
 
-        // Lógica de controle do buzzer
-        bool algum_setor_quente = false;
-        // Verifica se algum setor cadastrado está com temperatura alta
-        for (int i = 0; i < MAX_SETORES; i++) {
-            if (setor_cadastrado[i] && temperaturas_setores[i] > 100.0f) {
-                algum_setor_quente = true;
-                break; // Encontrou um, não precisa checar os outros
-            }
-        }
-        // Se há setor quente e o buzzer está desligado, liga o buzzer
-        if (algum_setor_quente && !buzzer_ativo) {
-            beep(BUZZER_PIN, 0); // O '0' em duration_ms significa tom contínuo aqui
-            buzzer_ativo = true;
-        }
-        // Se não há setor quente e o buzzer está ligado, desliga o buzzer
-        else if (!algum_setor_quente && buzzer_ativo) {
-            stop_tone(BUZZER_PIN);
-            buzzer_ativo = false;
-        }
-        // Atualiza as cores dos LEDs, exceto se estiver no modo de cadastro (case 1)
-        // pois o case 1 já gerencia seus próprios LEDs e o cursor.
-        if (main_menu_choice != 1) {
-            update_led_colors();
+/**
+ * @brief Tarefa de ingestão: aplica aos setores as leituras publicadas pelas fontes.
+ * @details Como em SETOR_CMD_DEFINIR_TEMPERATURA, só setores cadastrados são
+ *          atualizados. Uma leitura mais antiga que a última aplicada ao setor
+ *          (fontes com atrasos diferentes) é ignorada. Cada execução aplica no
+ *          máximo INGESTAO_LOTE leituras, limitando seu tempo; o alarme é
+ *          reavaliado logo em seguida.
+ */
+void task_ingestao(void *ctx) {
+    static uint64_t ultimo_instante_us[MAX_SETORES];
+    ingestao_leitura_t leitura;
+    bool aplicou = false;
+    uint64_t agora = hal_tempo_us();
+    for (int n = 0; n < INGESTAO_LOTE && ingestao_receber(&leitura); n++) {
+        bool aplicar = setores_cadastrado(&modelo_setores, leitura.setor) &&
+                       leitura.instante_us >= ultimo_instante_us[leitura.setor];
+        if (aplicar) {
+            setores_modelo_temperatura(&modelo_setores, leitura.setor, leitura.celsius);
+            ultimo_instante_us[leitura.setor] = leitura.instante_us;
+            aplicou = true;
         }
+        ingestao_resultado(&leitura, aplicar, agora);
     }
+    if (aplicou) {
+        estado_alterado = true;
+        avaliar_alarme();
+    }
+}
 
-    // Desinicializa o Wi-Fi antes de sair (embora o loop seja infinito, é boa prática)
-    if (cyw43_is_initialized(&cyw43_state)) {
-         cyw43_arch_deinit();
+/**
+ * @brief Tarefa do ADC: filtra as amostras que o DMA gravou no anel desde a última execução.
+ */
+void task_adc(void *ctx) {
+    sensores_adc_processar();
+}
+
+/**
+ * @brief Tarefa de amostragem: atualiza a temperatura ambiente a partir do sensor onboard.
+ */
+void task_sensor(void *ctx) {
+    temperatura_ambiente = read_onboard_temperature(TEMPERATURE_UNITS);
+    estado_alterado = true;
+}
+
+/**
+ * @brief Tarefa de alarme: aceita os níveis que completaram a duração mínima e aciona/desliga o buzzer.
+ * @details Executa a cada PERIODO_ALARME_MS no núcleo 1, independentemente do
+ *          menu serial e da rede, de modo que a latência entre uma temperatura
+ *          crítica e o buzzer fica limitada ao período da tarefa mais o pior
+ *          tempo das demais tarefas do núcleo 1 (mais a duração da regra).
+ *          Só os setores com mudança pendente são revistos.
+ *
+ *          Flash: cada apagamento de bloco do log (persistencia.c) para este
+ *          núcleo por flash_safe_execute, 45 ms típicos e até 400 ms no pior
+ *          caso da W25Q16JV (uma programação de página: até 3 ms). Enquanto
+ *          uma mudança de nível aguarda a duração mínima, o núcleo 0 adia os
+ *          apagamentos por até PERSISTENCIA_ADIAMENTO_MAX_S; a maior pausa
+ *          medida aparece nas estatísticas do log.
+ */
+void task_alarme(void *ctx) {
+    if (alarmes_processar(&modelo_setores, (uint32_t)(hal_tempo_us() / 1000u))) {
+        estado_alterado = true; // LEDs, painel e eventos refletem o novo nível
     }
-    return 0; // Teoricamente, nunca alcançado devido ao while(true)
+    if (alarmes_transicao_pendente() != estado_publicado.transicao_pendente) {
+        estado_alterado = true; // A persistência volta a apagar blocos (ou passa a adiá-los)
+    }
+    avaliar_alarme();
 }
 
 /**
- * @brief Inicializa o PIO para controlar a matriz de LEDs WS2812B.
- * @param pin O pino GPIO ao qual a matriz de LEDs está conectada.
- * @details Tenta usar pio0. Se não houver State Machine (SM) disponível, tenta pio1.
- *          Carrega o programa PIO ws2818b e configura a SM.
+ * @brief Tarefa do modo de cadastro: lê joystick e botões e move o cursor azul.
+ * @details Habilitada apenas enquanto `modo_cadastro` estiver ativo. O período
+ *          da tarefa substitui o antigo `sleep_ms(70)` de debounce. As mensagens
+ *          de cadastro são impressas pelo núcleo 0 a partir do snapshot.
+ *          O cursor percorre a grade inteira: ao sair da matriz, o visor rola.
  */
-void npInit(uint pin) {
-    // Tenta adicionar o programa PIO ao pio0
-    uint offset = pio_add_program(np_pio, &ws2818b_program);
-    // Tenta requisitar uma SM não utilizada no pio0
-    sm = pio_claim_unused_sm(np_pio, true);
-    // Se não conseguiu SM no pio0 (sm == -1 ou 0xffffffff)
-    if (sm == (uint)-1) {
-        np_pio = pio1; // Tenta usar o pio1
-        offset = pio_add_program(np_pio, &ws2818b_program);
-        sm = pio_claim_unused_sm(np_pio, true);
-        // Se também não conseguiu SM no pio1
-        if (sm == (uint)-1) {
-            printf("ERRO: Nao foi possivel requisitar SM para WS2812B em pio0 ou pio1\n");
-            return;
+void task_cadastro(void *ctx) {
+    // Lê os valores ADC dos eixos X e Y do joystick
+    uint adc_x_raw = sensores_adc_ler(1); // ADC1 é joystick X (definido em ADC_X_PIN)
+    uint adc_y_raw = sensores_adc_ler(0); // ADC0 é joystick Y (definido em ADC_Y_PIN)
+    int new_x = current_x, new_y = current_y; // Posições temporárias para o novo cursor
+    int threshold = 1000; // Limiar para movimento do joystick (centro ~2048)
+
+    // Lógica de movimento do cursor com base no joystick
+    // Joystick X: < (2048-th) -> esquerda, > (2048+th) -> direita
+    if (adc_x_raw < (2048 - threshold) && current_x > 0) new_x--; // Move para a esquerda
+    if (adc_x_raw > (2048 + threshold) && current_x < SETORES_COLUNAS - 1) new_x++; // Move para a direita
+    // Joystick Y: > (2048+th) -> cima, < (2048-th) -> baixo (invertido devido à montagem/leitura)
+    if (adc_y_raw > (2048 + threshold) && current_y > 0) new_y--; // Move para cima
+    if (adc_y_raw < (2048 - threshold) && current_y < SETORES_LINHAS - 1) new_y++; // Move para baixo
+
+    // Verifica se o Botão A foi pressionado (para cadastrar setor)
+    bool button_a_pressed_now = read_button(BUTTON_A);
+    if (button_a_pressed_now && !button_a_last_state) { // Detecção de borda de subida
+        setores_modelo_cadastro(&modelo_setores, setor_indice(current_x, current_y), true); // Marca setor como cadastrado
+        estado_alterado = true;
+    }
+    button_a_last_state = button_a_pressed_now; // Atualiza estado anterior do botão A
+
+    // Verifica se o Botão B foi pressionado (para descadastrar setor)
+    bool button_b_pressed_now = read_button(BUTTON_B);
+    if (button_b_pressed_now && !button_b_last_state) { // Detecção de borda de subida
+        setores_modelo_cadastro(&modelo_setores, setor_indice(current_x, current_y), false); // Marca setor como não cadastrado
+        estado_alterado = true;
+    }
+    button_b_last_state = button_b_pressed_now; // Atualiza estado anterior do botão B
+
+    // Verifica se o botão do joystick foi pressionado (para sair do modo de cadastro)
+    if (read_button(JOYSTICK_BUTTON_PIN)) {
+        desligarLedAzul();      // Restaura a cor original do LED sob o cursor
+        modo_cadastro = false;  // O núcleo 0 percebe pelo snapshot e volta ao menu
+        estado_alterado = true;
+        scheduler_set_enabled(&scheduler_core1, &tarefas_core1[TAREFA_CADASTRO], false);
+        // Volta a rolagem pelo joystick; o botão ainda pressionado não conta como zoom
+        botao_visor_anterior = true;
+        scheduler_set_enabled(&scheduler_core1, &tarefas_core1[TAREFA_VISOR], visor_rolavel());
+        update_led_colors();    // Garante que o estado dos LEDs reflita o cadastro ao sair
+        return;
+    }
+
+    // Se o cursor se moveu
+    if (new_x != current_x || new_y != current_y) {
+        // 1. Restaura a cor da posição antiga do cursor
+        desligarLedAzul();
+        current_x = new_x; // Atualiza a posição X do cursor
+        current_y = new_y; // Atualiza a posição Y do cursor
+        // O cursor saiu da janela: a matriz inteira passa a mostrar outra parte da grade
+        if (visor_seguir(&visor, current_x, current_y)) {
+            update_led_colors();
+            estado_alterado = true; // O painel do OLED espelha a janela
         }
+        // 2. Desenha o cursor azul na nova posição
+        desenhar_cursor();
+        npWrite(); // Atualiza a matriz física de LEDs
+    }
+    // Se o cursor não moveu, mas o botão A ou B foi pressionado (para atualizar cor imediatamente)
+    else if (button_a_pressed_now || button_b_pressed_now) {
+        // Redesenha o setor sob o cursor com a nova cor (verde ou apagado)
+        desligarLedAzul();
+        // Redesenha o cursor azul por cima (se nada mudou no quadro, npWrite não transmite)
+        desenhar_cursor();
+        npWrite(); // Atualiza a matriz física de LEDs
     }
-    // Inicializa a SM do PIO com as configurações para WS2812B
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f); // 800kHz para WS2812B
-    npClear(); // Apaga todos os LEDs
-    npWrite(); // Envia o estado para a matriz
 }
 
 /**
- * @brief Define a cor de um LED específico na matriz.
- * @param index O índice do LED (0 a LED_COUNT-1).
- * @param r Componente Vermelho da cor (0-255).
- * @param g Componente Verde da cor (0-255).
- * @param b Componente Azul da cor (0-255).
- * @details Armazena os valores R, G, B no array `leds`. A ordem G,R,B é importante para o WS2812B.
+ * @brief Tarefa do visor: rola a janela da grade pelo joystick e troca o zoom pelo seu botão.
+ * @details Habilitada fora do modo de cadastro, e só quando a grade é maior
+ *          que a matriz. Cada período desloca a janela em um LED (zoom setores).
  */
-void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) {
-    if (index < LED_COUNT) { // Verifica se o índice é válido
-        // WS2812B espera os dados na ordem G, R, B
-        leds[index].R = r;
-        leds[index].G = g;
-        leds[index].B = b;
+void task_visor(void *ctx) {
+    uint adc_x_raw = sensores_adc_ler(1);
+    uint adc_y_raw = sensores_adc_ler(0);
+    int threshold = 1000; // Mesmo limiar do modo de cadastro (centro ~2048)
+    int dx = 0, dy = 0;
+    if (adc_x_raw < (2048 - threshold)) dx = -1;
+    if (adc_x_raw > (2048 + threshold)) dx = 1;
+    if (adc_y_raw > (2048 + threshold)) dy = -1; // Eixo Y invertido, como no cadastro
+    if (adc_y_raw < (2048 - threshold)) dy = 1;
+    bool mudou = (dx || dy) && visor_mover(&visor, dx, dy);
+
+    bool botao = read_button(JOYSTICK_BUTTON_PIN);
+    if (botao && !botao_visor_anterior) mudou |= visor_proximo_zoom(&visor);
+    botao_visor_anterior = botao;
+
+    if (mudou) {
+        update_led_colors();
+        estado_alterado = true;
     }
 }
 
 /**
- * @brief Apaga todos os LEDs da matriz (define a cor deles para preto).
+ * @brief Tarefa de LEDs: reflete na matriz o estado atual dos setores.
+ * @details Mantém a matriz coerente mesmo quando temperaturas mudam via HTTP.
+ *          No modo de cadastro, o LED sob o cursor azul é preservado.
  */
-void npClear() {
-    for (uint i = 0; i < LED_COUNT; ++i)
-        npSetLED(i, 0, 0, 0); // Define R, G, B como 0
+void task_leds(void *ctx) {
+    update_led_colors();
 }
 
 /**
- * @brief Envia os dados de cor do array `leds` para a matriz de LEDs física via PIO.
+ * @brief Tarefa de histórico: grava uma amostra de todos os setores nos anéis.
+ * @details Os agregados de 1 e 15 minutos são fechados aqui mesmo, a cada
+ *          12 e 180 amostras. Lidos pelo núcleo 0 em /api/history.
  */
-void npWrite() {
-    for (uint i = 0; i < LED_COUNT; ++i) {
-        // Monta a cor no formato GRB (32 bits, mas apenas 24 são usados)
-        // O WS2812B recebe os bits na ordem G7..G0, R7..R0, B7..B0
-        uint32_t color_grb = ((uint32_t)leds[i].G << 16) |
-                               ((uint32_t)leds[i].R << 8)  |
-                                (uint32_t)leds[i].B;
-        // Envia a cor para a state machine do PIO.
-        // '<< 8u' é necessário porque o programa PIO pode estar esperando dados de 32 bits,
-        // e os 24 bits de cor são alinhados à esquerda.
-        pio_sm_put_blocking(np_pio, sm, color_grb << 8u);
+void task_historico(void *ctx) {
+    historico_amostrar(&modelo_setores, hal_tempo_us());
+}
+
+// ===== NÚCLEO 0: WI-FI/HTTP E INTERFACE COM O USUÁRIO =====
+
+/**
+ * @brief Tarefa de rede: realiza o polling da pilha Wi-Fi e lwIP.
+ */
+void task_rede(void *ctx) {
+    hal_rede_poll();
+}
+
+/**
+ * @brief Tarefa de eventos: envia aos clientes de /events as mudanças publicadas pelo núcleo 1.
+ */
+void task_eventos(void *ctx) {
+    http_server_despachar_eventos();
+}
+
+/**
+ * @brief Tarefa de fontes: coleta as fontes periódicas de leituras (sondas I2C, replay).
+ * @details As leituras UDP chegam pelos callbacks do lwIP, dentro de task_rede.
+ */
+void task_fontes(void *ctx) {
+    ingestao_coletar();
+}
+
+/**
+ * @brief Tarefa de persistência: grava na flash o que mudou no estado e no histórico.
+ * @details Cadastro alterado é gravado na hora; temperaturas, no máximo a cada
+ *          PERSISTENCIA_CHECKPOINT_S. A página só é programada quando enche ou
+ *          após PERSISTENCIA_ATRASO_MS.
+ */
+void task_persistencia(void *ctx) {
+    const setores_snapshot_t *estado = ler_estado();
+    persistencia_processar(estado, hal_tempo_us());
+}
+
+/**
+ * @brief Tarefa do diário: numera e guarda os eventos registrados pelos dois núcleos.
+ * @details Só copia registros binários; o texto é gerado por /api/events.
+ */
+void task_diario(void *ctx) {
+    diario_drenar();
+}
+
+/**
+ * @brief Tarefa do log: formata e escreve no console as mensagens LOG_* dos dois núcleos.
+ * @details Última da tabela: o printf que antes rodava em quem registrava a
+ *          mensagem (resposta HTTP, cadastro, núcleo 1) roda aqui, em lotes de
+ *          LOG_LOTE, quando as tarefas mais urgentes já foram atendidas.
+ */
+void task_log(void *ctx) {
+    log_drenar();
+}
+
+/**
+ * @brief Monta o modelo do painel a partir do snapshot dos setores e do estado da rede.
+ */
+void painel_montar_modelo(const setores_snapshot_t *estado, painel_oled_modelo_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->setor_quente = SETOR_INVALIDO;
+    m->em_alarme = setores_bits_contar(&estado->modelo.alarmes);
+    m->em_aviso = setores_bits_contar(&estado->modelo.avisos);
+    float quente = 0.0f;
+    SETORES_BITS_PARA_CADA(&estado->modelo.cadastrados, i) {
+        float t = estado->modelo.temperaturas[i];
+        if (m->setor_quente == SETOR_INVALIDO || t > quente) {
+            m->setor_quente = i;
+            quente = t;
+        }
+    }
+    // A grade espelha a janela exibida na matriz de LEDs
+    for (int y = 0; y < MATRIZ_LEDS_ALTURA; y++) {
+        for (int x = 0; x < MATRIZ_LEDS_LARGURA; x++) {
+            m->grade[x][y] = visor_celula(&estado->visor, x, y, &estado->modelo);
+        }
+    }
+    m->quente_dc = (int16_t)(quente * 10.0f + (quente < 0.0f ? -0.5f : 0.5f));
+    float amb = estado->temperatura_ambiente;
+    m->ambiente_dc = (int16_t)(amb * 10.0f + (amb < 0.0f ? -0.5f : 0.5f));
+
+    if (hal_rede_link() != HAL_REDE_LINK_UP) {
+        snprintf(m->rede, sizeof(m->rede), "Wi-Fi sem link");
+    } else if (!hal_rede_ip(m->rede, sizeof(m->rede))) {
+        snprintf(m->rede, sizeof(m->rede), "Wi-Fi sem IP");
     }
 }
 
 /**
- * @brief Converte coordenadas (x, y) da matriz 5x5 para um índice linear (0-24).
- * @param x Coordenada X (0-4).
- * @param y Coordenada Y (0-4).
- * @return int O índice linear correspondente, considerando um layout serpentina.
- * @details O layout é serpentina:
- *          Linhas pares (0, 2, 4): da direita para a esquerda (4, 3, 2, 1, 0)
- *          Linhas ímpares (1, 3): da esquerda para a direita (0, 1, 2, 3, 4)
- *          Exemplo para uma matriz 5x5:
- *          Y=0: 4  3  2  1  0
- *          Y=1: 5  6  7  8  9
- *          Y=2: 14 13 12 11 10
- *          Y=3: 15 16 17 18 19
- *          Y=4: 24 23 22 21 20
+ * @brief Tarefa do painel: após a mensagem de boas-vindas, mantém o painel de
+ *        status no framebuffer do OLED, redesenhando apenas o que mudou.
+ * @details O envio ao display fica com a task_oled, logo a seguir na tabela.
  */
-int getIndex(int x, int y) {
-    // Se a linha (y) for par
-    if (y % 2 == 0) {
-        return y * 5 + (4 - x); // Contagem da direita para a esquerda
+void task_painel(void *ctx) {
+    static bool iniciado = false;
+    static uint64_t proxima_amostra_us = 0;
+    uint64_t agora = hal_tempo_us();
+    if (!iniciado) {
+        if (agora < painel_inicio_us) return;
+        painel_oled_iniciar(&oled);
+        iniciado = true;
     }
-    // Se a linha (y) for ímpar
-    else {
-        return y * 5 + x;       // Contagem da esquerda para a direita
+
+    const setores_snapshot_t *estado = ler_estado();
+    if (agora >= proxima_amostra_us) {
+        painel_oled_amostrar(estado->temperatura_ambiente);
+        proxima_amostra_us = agora + (uint64_t)PAINEL_AMOSTRA_MS * 1000u;
     }
+    painel_oled_modelo_t modelo;
+    painel_montar_modelo(estado, &modelo);
+    painel_oled_atualizar(&modelo);
+}
+
+/**
+ * @brief Tarefa do OLED: envia ao display apenas as janelas alteradas do framebuffer.
+ * @details O envio segue por DMA enquanto as demais tarefas (sensores, rede)
+ *          rodam. Se o anterior ainda não terminou, as alterações ficam
+ *          pendentes para a próxima execução.
+ */
+void task_oled(void *ctx) {
+    ssd1306_flush_async(&oled, NULL, NULL); // Sem alterações, nada é enviado
 }
 
 /**
- * @brief Reseta o estado da matriz auxiliar `led_states` para `false`.
- * @note Esta função manipula `led_states`, que parece ser uma forma alternativa
- *       de rastrear o cadastro, mas `setor_cadastrado` é a principal.
+ * @brief Tarefa do menu serial: lê caracteres sem bloquear e monta linhas.
+ * @details Cada linha completa (terminada em '\r', '\n' ou "\r\n") é entregue a
+ *          ui_processar_linha(). Também encerra as pausas de mensagem quando
+ *          o prazo é atingido.
  */
-void clear_led_states() {
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            led_states[i][j] = false;
+void task_serial(void *ctx) {
+    // Fim de uma pausa de mensagem: segue para o próximo estado
+    if (ui_estado == UI_PAUSA && hal_tempo_us() >= ui_pausa_ate_us) {
+        ui_entrar(ui_proximo);
+    }
+    // No modo de cadastro, acompanha pelo snapshot o que o núcleo 1 alterou
+    if (ui_estado == UI_CADASTRO) {
+        ui_acompanhar_cadastro();
+    }
+
+    int c;
+    int lidos = 0;
+    // Limita a quantidade de caracteres por execução para manter o WCET baixo
+    while (lidos++ < UI_LINHA_MAX && (c = hal_console_ler()) >= 0) {
+        if (c == '\r' || c == '\n') {
+            // Ignora o '\n' de um par "\r\n" (a linha já foi entregue no '\r')
+            if (c == '\n' && ui_ultimo_cr) {
+                ui_ultimo_cr = false;
+                continue;
+            }
+            ui_ultimo_cr = (c == '\r');
+            ui_linha[ui_linha_len] = '\0';
+            ui_linha_len = 0;
+            ui_processar_linha(ui_linha);
+        } else {
+            ui_ultimo_cr = false;
+            if (ui_linha_len < UI_LINHA_MAX - 1) {
+                ui_linha[ui_linha_len++] = (char)c;
+            }
         }
     }
 }
 
+/**
+ * @brief Inicializa a matriz de LEDs WS2812B e a apaga.
+ * @param pin O pino GPIO ao qual a matriz de LEDs está conectada.
+ * @details No Pico, a HAL carrega o programa PIO ws2818b em pio0 (ou pio1)
+ *          e reserva o canal DMA que alimenta a state machine.
+ */
+void npInit(uint pin) {
+    matriz_leds_init(pin); // Em caso de falha, a HAL já informou o erro
+}
+
+/**
+ * @brief Define a cor de um LED específico na matriz.
+ * @param index A posição do LED na fita (0 a LED_COUNT-1; ver matriz_leds_indice).
+ * @param r Componente Vermelho da cor (0-255).
+ * @param g Componente Verde da cor (0-255).
+ * @param b Componente Azul da cor (0-255).
+ * @details Altera apenas o quadro em memória; a matriz física muda em npWrite().
+ */
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) {
+    matriz_leds_definir(index, r, g, b); // Índices inválidos são ignorados
+}
+
+/**
+ * @brief Apaga todos os LEDs da matriz (define a cor deles para preto).
+ */
+void npClear() {
+    matriz_leds_limpar();
+}
+
+/**
+ * @brief Envia o quadro atual para a matriz de LEDs física sem bloquear.
+ * @details O quadro segue por DMA; se o anterior ainda está no fio, este
+ *          fica pendente e é enviado pela IRQ de conclusão.
+ */
+void npWrite() {
+    matriz_leds_apresentar();
+}
+
 /**
  * @brief Inicializa um pino GPIO como entrada com pull-up interno.
  * @param pin O número do pino GPIO a ser inicializado.
  */
 void init_button(uint pin) {
-    gpio_init(pin);             // Inicializa o GPIO
-    gpio_set_dir(pin, GPIO_IN); // Define a direção como entrada
-    gpio_pull_up(pin);          // Habilita o resistor de pull-up interno
+    hal_gpio_entrada_pullup(pin); // Entrada com o resistor de pull-up interno
 }
 
 /**
@@ -716,7 +1022,7 @@ void init_button(uint pin) {
  * @details Assume que o botão conecta o pino ao GND quando pressionado (pull-up habilitado).
  */
 bool read_button(uint pin) {
-    return !gpio_get(pin); // Retorna true se o pino estiver em nível baixo (botão pressionado)
+    return !hal_gpio_ler(pin); // Retorna true se o pino estiver em nível baixo (botão pressionado)
 }
 
 /**
@@ -730,58 +1036,274 @@ void show_menu() {
     printf("2: Limpar Sistema (LEDs e Temperaturas)\n");
     printf("3: Menu Setores\n");
     printf("4: Sair\n");
+    printf("5: Estatisticas das tarefas\n");
     // Exibe informações de status do Wi-Fi e IP
-    if (netif_default && netif_is_up(netif_default) && !ip4_addr_isany(netif_ip4_addr(netif_default))) {
+    char ip[24];
+    int link = hal_rede_link();
+    if (hal_rede_ip(ip, sizeof(ip))) {
         // Se a interface de rede padrão está ativa e tem um IP válido
-        printf("IP: %s (Acesse via navegador)\n", ip4addr_ntoa(netif_ip4_addr(netif_default)));
-    } else if (cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA) < 0 && cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_DOWN) {
+        printf("IP: %s (Acesse via navegador)\n", ip);
+    } else if (link < 0 && link != HAL_REDE_LINK_DOWN) {
         // Se houve um erro no link Wi-Fi (diferente de simplesmente não conectado)
-        printf("WiFi: Falha no link ou nao conectado (%d).\n", cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA));
+        printf("WiFi: Falha no link ou nao conectado (%d).\n", link);
     } else {
         // Outros casos (conectando, sem IP ainda, ou link down)
         printf("WiFi: Conectando ou sem IP...\n");
     }
-    printf("Escolha uma opcao (1-4): ");
+    printf("Escolha uma opcao (1-5): ");
 }
 
 /**
  * @brief Exibe o submenu de gerenciamento de setores do AgroGraf.
  * @details Permite listar setores, mudar temperatura, acionar equipamentos e voltar ao menu principal.
+ *          A escolha é tratada por ui_processar_linha() no estado UI_MENU_SETORES.
  */
 void show_setores_menu() {
-    int choice_setor_local; // Variável local para a escolha no submenu de setores
-    while (true) { // Loop do submenu de setores
-        cyw43_arch_poll(); // Polling do Wi-Fi
-        clear_screen();    // Limpa a tela do terminal
-        printf("\n--- Menu Setores AgroGraf ---\n");
-        printf("1: Listar setores cadastrados\n");
-        printf("2: Mudar temperatura do setor cadastrado\n");
-        printf("3: Acionar equipamentos contra incendio\n");
-        printf("4: Voltar ao Menu Principal\n");
-        printf("Escolha uma opcao (1-4): ");
-
-        // Lê a escolha do usuário no submenu
-        if (scanf("%d", &choice_setor_local) != 1) {
-            choice_setor_local = 5; // Opção inválida padrão
-            // Limpa o buffer de entrada
-            while (getchar() != '\n' && getchar() != EOF);
+    clear_screen();    // Limpa a tela do terminal
+    printf("\n--- Menu Setores AgroGraf ---\n");
+    printf("1: Listar setores cadastrados\n");
+    printf("2: Mudar temperatura do setor cadastrado\n");
+    printf("3: Acionar equipamentos contra incendio\n");
+    printf("4: Voltar ao Menu Principal\n");
+    printf("Escolha uma opcao (1-4): ");
+}
+
+/**
+ * @brief Entra em um estado do menu serial, exibindo a tela correspondente.
+ * @param estado Novo estado da interface.
+ * @details Ao entrar em UI_CADASTRO, pede ao núcleo 1 que ative o modo de cadastro
+ *          (joystick, botões e cursor azul são tratados por ele).
+ */
+void ui_entrar(ui_estado_t estado) {
+    ui_estado = estado;
+
+    switch (estado) {
+        case UI_MENU_PRINCIPAL:
+            show_menu();
+            break;
+        case UI_CADASTRO: {
+            clear_screen();
+            printf("\nCadastramento de Setores (Joystick). Pressione botao do joystick para sair.\n");
+
+            // Guarda o cadastro atual para imprimir apenas o que mudar durante a sessão
+            ui_cadastro_anterior = ler_estado()->modelo.cadastrados;
+            ui_cadastro_confirmado = false;
+            if (!setores_enviar_comando(SETOR_CMD_MODO_CADASTRO, 0, 0.0f)) {
+                printf("Fila de comandos cheia. Tente novamente.\n");
+                ui_pausar(1500, UI_MENU_PRINCIPAL);
+            }
+            break;
         }
+        case UI_MENU_SETORES:
+            show_setores_menu();
+            break;
+        default:
+            // Os demais estados são alcançados por ui_pausar(), ui_aguardar_enter()
+            // ou diretamente em ui_processar_linha(), que exibem suas próprias mensagens.
+            break;
+    }
+}
 
-        // Processa a escolha do submenu
-        switch (choice_setor_local) {
-            case 1: listar_setores(); break;
-            case 2: mudar_temperatura_setor(); break;
-            case 3: acionar_equipamentos_contra_incendio(); break;
-            case 4: return; // Volta para o menu principal
-            case 5: // Opção inválida (digitada ou por erro de scanf)
-                printf("Opcao invalida. Por favor, digite um numero entre 1 e 4.\n");
-                sleep_ms(1500);
-                break;
-            default: // Caso inesperado
-                printf("Erro inesperado! Voltando ao menu Setores.\n");
-                sleep_ms(1500);
-                break;
+/**
+ * @brief Acompanha o modo de cadastro executado pelo núcleo 1.
+ * @details Imprime os setores cadastrados/descadastrados pelos botões A e B e
+ *          volta ao menu principal quando o núcleo 1 sai do modo de cadastro
+ *          (botão do joystick).
+ */
+void ui_acompanhar_cadastro() {
+    const setores_snapshot_t *estado = ler_estado();
+    if (!ui_cadastro_confirmado) {
+        if (!estado->modo_cadastro) return; // O núcleo 1 ainda não aplicou o comando
+        ui_cadastro_confirmado = true;
+    }
+    // Setores cujo bit de cadastro mudou desde a última impressão
+    setores_bits_t mudaram;
+    for (int p = 0; p < SETORES_PALAVRAS; p++) {
+        mudaram.palavras[p] = estado->modelo.cadastrados.palavras[p] ^ ui_cadastro_anterior.palavras[p];
+    }
+    SETORES_BITS_PARA_CADA(&mudaram, i) {
+        printf("Setor (%d,%d) %s.\n", setor_coluna(i) + 1, setor_linha(i) + 1,
+               setores_cadastrado(&estado->modelo, i) ? "cadastrado" : "descadastrado");
+    }
+    ui_cadastro_anterior = estado->modelo.cadastrados;
+    if (!estado->modo_cadastro) {
+        ui_entrar(UI_MENU_PRINCIPAL); // Botão do joystick pressionado: sai do modo de cadastro
+    }
+}
+
+/**
+ * @brief Mantém a mensagem atual na tela por um tempo, sem bloquear.
+ * @param ms Duração da pausa em milissegundos (substitui `sleep_ms`).
+ * @param proximo Estado a ser exibido ao fim da pausa.
+ */
+void ui_pausar(uint32_t ms, ui_estado_t proximo) {
+    ui_estado = UI_PAUSA;
+    ui_proximo = proximo;
+    ui_pausa_ate_us = hal_tempo_us() + (uint64_t)ms * 1000u;
+}
+
+/**
+ * @brief Aguarda o usuário pressionar Enter antes de seguir para `proximo`.
+ */
+void ui_aguardar_enter(ui_estado_t proximo) {
+    ui_estado = UI_AGUARDA_ENTER;
+    ui_proximo = proximo;
+}
+
+/**
+ * @brief Converte uma linha digitada em inteiro (equivalente ao antigo `scanf("%d")`).
+ * @param linha Texto digitado.
+ * @param valor Recebe o valor convertido.
+ * @return bool `true` se algum número foi reconhecido.
+ */
+static bool ui_ler_inteiro(const char *linha, int *valor) {
+    char *fim;
+    long v = strtol(linha, &fim, 10);
+    if (fim == linha) return false;
+    *valor = (int)v;
+    return true;
+}
+
+/**
+ * @brief Trata uma linha completa digitada no terminal conforme o estado do menu.
+ * @param linha Linha digitada (sem o terminador).
+ */
+void ui_processar_linha(char *linha) {
+    int opcao;
+    switch (ui_estado) {
+        case UI_MENU_PRINCIPAL:
+            if (!ui_ler_inteiro(linha, &opcao)) opcao = 0; // Opção inválida padrão
+            switch (opcao) {
+                case 1: // Cadastrar/Descadastrar Setores
+                    ui_entrar(UI_CADASTRO);
+                    break;
+                case 2: // Limpar Sistema
+                    solicitar_limpeza(); // Pede ao núcleo 1 para resetar o sistema
+                    ui_pausar(1500, UI_MENU_PRINCIPAL); // Pausa para o usuário ver a mensagem
+                    break;
+                case 3: // Menu Setores
+                    ui_entrar(UI_MENU_SETORES);
+                    break;
+                case 4: // Sair
+                    printf("Saindo do AgroGraf...\n");
+                    // O núcleo 1 apaga os LEDs, desliga o buzzer e encerra seu escalonador
+                    setores_enviar_comando(SETOR_CMD_ENCERRAR, 0, 0.0f);
+                    ui_estado = UI_ENCERRADO;
+                    scheduler_stop(&scheduler); // main() desinicializa o Wi-Fi e termina
+                    break;
+                case 5: // Estatísticas do escalonador
+                    clear_screen();
+                    printf("\n--- Estatisticas das Tarefas (AgroGraf) ---\n");
+                    printf("\nNucleo 0 (Wi-Fi/HTTP, menu e OLED):\n");
+                    scheduler_print_stats(&scheduler);
+                    printf("\nNucleo 1 (sensores, alarme e atuadores):\n");
+                    scheduler_print_stats(&scheduler_core1);
+                    printf("\nRotas /api (bytes por resposta e formatacao):\n");
+                    http_server_print_stats();
+                    printf("\nMatriz de LEDs:\n");
+                    matriz_leds_print_stats();
+                    printf("\nPainel OLED:\n");
+                    painel_oled_print_stats();
+                    printf("\nADC (rodizio por DMA):\n");
+                    sensores_adc_print_stats();
+                    printf("\nLeituras dos setores (fontes):\n");
+                    ingestao_print_stats();
+                    printf("\nPersistencia (flash):\n");
+                    persistencia_print_stats();
+                    printf("\nPressione Enter para continuar...\n");
+                    ui_aguardar_enter(UI_MENU_PRINCIPAL);
+                    break;
+                default: // Opção inválida (digitada ou não numérica)
+                    printf("Opcao invalida. Por favor, digite um numero valido.\n");
+                    ui_pausar(1500, UI_MENU_PRINCIPAL);
+                    break;
+            }
+            break;
+
+        case UI_MENU_SETORES:
+            if (!ui_ler_inteiro(linha, &opcao)) opcao = 0; // Opção inválida padrão
+            switch (opcao) {
+                case 1:
+                    listar_setores();
+                    ui_aguardar_enter(UI_MENU_SETORES);
+                    break;
+                case 2:
+                    if (mudar_temperatura_setor()) {
+                        ui_estado = UI_MUDAR_INDICE;
+                    } else {
+                        ui_pausar(1500, UI_MENU_SETORES);
+                    }
+                    break;
+                case 3:
+                    if (acionar_equipamentos_contra_incendio()) {
+                        ui_estado = UI_ACIONAR_CONFIRMA;
+                    } else {
+                        ui_pausar(1500, UI_MENU_SETORES);
+                    }
+                    break;
+                case 4: // Volta para o menu principal
+                    ui_entrar(UI_MENU_PRINCIPAL); // Os LEDs são atualizados pelo núcleo 1
+                    break;
+                default: // Opção inválida (digitada ou não numérica)
+                    printf("Opcao invalida. Por favor, digite um numero entre 1 e 4.\n");
+                    ui_pausar(1500, UI_MENU_SETORES);
+                    break;
+            }
+            break;
+
+        case UI_MUDAR_INDICE: {
+            const setores_snapshot_t *estado = ler_estado();
+            if (!ui_ler_inteiro(linha, &ui_setor_escolhido)) { // Validação da entrada
+                printf("Entrada invalida.\n"); ui_pausar(1500, UI_MENU_SETORES); break;
+            }
+            ui_setor_escolhido--; // Ajusta para índice baseado em 0 (0 a MAX_SETORES-1)
+            // Verifica se o índice é válido e se o setor está cadastrado
+            if (ui_setor_escolhido < 0 || ui_setor_escolhido >= MAX_SETORES || !setores_cadastrado(&estado->modelo, (setor_id_t)ui_setor_escolhido)) {
+                printf("Indice de setor invalido ou setor nao cadastrado.\n"); ui_pausar(1500, UI_MENU_SETORES); break;
+            }
+            // Solicita a nova temperatura
+            printf("Digite a nova temperatura para %s: ", nomes_setores[ui_setor_escolhido]);
+            ui_estado = UI_MUDAR_VALOR;
+            break;
+        }
+
+        case UI_MUDAR_VALOR: {
+            char *fim;
+            float nova_temperatura = strtof(linha, &fim);
+            if (fim == linha) { // Validação da entrada
+                printf("Entrada invalida.\n"); ui_pausar(1500, UI_MENU_SETORES); break;
+            }
+            // Pede ao núcleo 1 que atualize a temperatura (o alarme é reavaliado em seguida)
+            if (!setores_enviar_comando(SETOR_CMD_DEFINIR_TEMPERATURA, (setor_id_t)ui_setor_escolhido, nova_temperatura)) {
+                printf("Fila de comandos cheia. Temperatura nao alterada.\n"); ui_pausar(1500, UI_MENU_SETORES); break;
+            }
+            printf("Temperatura de %s alterada para %.2f C\n", nomes_setores[ui_setor_escolhido], nova_temperatura);
+            ui_pausar(1000, UI_MENU_SETORES); // Pausa para o usuário ver a mensagem
+            break;
         }
+
+        case UI_ACIONAR_CONFIRMA: {
+            // Primeiro caractere não branco (equivalente ao antigo `scanf(" %c")`)
+            while (*linha == ' ' || *linha == '\t') linha++;
+            if (*linha == 's' || *linha == 'S') { // Se o usuário confirmar
+                solicitar_reset_alertas();
+            } else {
+                printf("Nenhuma acao realizada.\n");
+            }
+            printf("\nPressione Enter para retornar...\n");
+            ui_aguardar_enter(UI_MENU_SETORES);
+            break;
+        }
+
+        case UI_AGUARDA_ENTER:
+            ui_entrar(ui_proximo);
+            break;
+
+        case UI_CADASTRO: // O modo de cadastro é controlado pelo joystick
+        case UI_PAUSA:    // Entradas durante a exibição de mensagens são descartadas
+        case UI_ENCERRADO:
+        default:
+            break;
     }
 }
 
@@ -789,15 +1311,16 @@ void show_setores_menu() {
  * @brief Lê a temperatura do sensor interno do RP2040.
  * @param unit Unidade desejada para a temperatura ('C' para Celsius, 'F' para Fahrenheit).
  * @return float A temperatura lida na unidade especificada.
- * @details O sensor de temperatura interno é conectado ao ADC canal 4.
+ * @details O sensor de temperatura interno é conectado ao ADC canal 4, lido
+ *          já filtrado (sobreamostragem e média móvel) pelo módulo sensores_adc.
  *          A fórmula de conversão é baseada na documentação do RP2040.
  */
 float read_onboard_temperature(const char unit) {
     // Fator de conversão de leitura ADC crua para tensão
     const float conversionFactor = 3.3f / (1 << 12); // (3.3V / 4096 níveis ADC de 12 bits)
-    adc_select_input(ADC_TEMP_PIN); // Seleciona o canal ADC do sensor de temperatura (4)
-    uint16_t raw = adc_read();     // Lê o valor cru do ADC
-    float adc_voltage = (float)raw * conversionFactor; // Converte para tensão
+    // Último valor filtrado do canal do sensor (4), com 4 bits fracionários
+    float raw = (float)sensores_adc_ler_q4(ADC_TEMP_PIN) / 16.0f;
+    float adc_voltage = raw * conversionFactor; // Converte para tensão
     // Fórmula para converter tensão em temperatura Celsius (do datasheet do RP2040)
     // Temp (°C) = 27 - (ADC_voltage - 0.706) / 0.001721
     float tempC = 27.0f - (adc_voltage - 0.706f) / 0.001721f;
@@ -809,110 +1332,108 @@ float read_onboard_temperature(const char unit) {
 
 /**
  * @brief Lista todos os setores cadastrados com seus nomes, índices e temperaturas.
- * @details Exibe um alerta "[ALERTA]" se a temperatura do setor for > 100°C.
- *          Aguarda o usuário pressionar Enter para continuar.
+ * @details Exibe "[ALERTA]" para setores no nível crítico da sua regra de alarme e "[AVISO]" no nível de aviso.
+ *          O menu aguarda o usuário pressionar Enter para continuar.
  */
 void listar_setores() {
     clear_screen(); // Limpa a tela do terminal
     printf("\n--- Listando Setores Cadastrados (AgroGraf) ---\n");
-    int count = 0; // Contador de setores cadastrados
-    // Itera pela matriz de LEDs (representando setores)
-    for (int y_loop = 0; y_loop < 5; y_loop++) {
-        for (int x_loop = 0; x_loop < 5; x_loop++) {
-            int index = getIndex(x_loop, y_loop); // Obtém o índice linear do setor
-            if (setor_cadastrado[index]) { // Se o setor estiver cadastrado
-                printf("%s (Indice %d): Temp: %.2f C %s\n",
-                    nomes_setores[index],         // Nome do setor
-                    index + 1,                    // Índice (1-25 para o usuário)
-                    temperaturas_setores[index],  // Temperatura atual
-                    (temperaturas_setores[index] > 100.0f ? "[ALERTA]" : "")); // Alerta se > 100°C
-                count++;
-            }
-        }
+    const setores_snapshot_t *estado = ler_estado();
+    // Itera pelos setores cadastrados em ordem de índice (linha a linha da grade)
+    SETORES_BITS_PARA_CADA(&estado->modelo.cadastrados, index) {
+        printf("%s (Indice %d): Temp: %.2f C %s\n",
+            nomes_setores[index],                // Nome do setor
+            index + 1,                           // Índice (1 a MAX_SETORES para o usuário)
+            estado->modelo.temperaturas[index],   // Temperatura atual
+            setores_em_alarme(&estado->modelo, index) ? "[ALERTA]" :   // Nível crítico da regra do setor
+            setores_em_aviso(&estado->modelo, index) ? "[AVISO]" : ""); // Nível de aviso
     }
-    if (count == 0) printf("\nNao existem setores cadastrados.\n");
+    if (!setores_bits_algum(&estado->modelo.cadastrados)) printf("\nNao existem setores cadastrados.\n");
     printf("\nPressione Enter para continuar...\n");
-    int c_in;
-    // Consome o newline pendente do scanf anterior, se houver
-    while ((c_in = getchar()) != '\n' && c_in != EOF);
-    // Aguarda um novo Enter do usuário
-    if (c_in != EOF && c_in != '\r') getchar(); // Consome o Enter pressionado
 }
 
 
 /**
- * @brief Permite ao usuário alterar a temperatura de um setor cadastrado.
- * @details Lista os setores cadastrados, solicita o índice do setor e a nova temperatura.
+ * @brief Inicia a alteração da temperatura de um setor cadastrado.
+ * @return bool `true` se há setores cadastrados e o índice foi solicitado.
+ * @details Lista os setores cadastrados e solicita o índice do setor. O índice e a
+ *          nova temperatura são tratados por ui_processar_linha() (UI_MUDAR_INDICE
+ *          e UI_MUDAR_VALOR).
  */
-void mudar_temperatura_setor() {
+bool mudar_temperatura_setor() {
     clear_screen(); // Limpa a tela do terminal
-    int setor_idx_escolhido; // Índice do setor escolhido pelo usuário
-    float nova_temperatura;  // Nova temperatura a ser definida
 
     printf("\n--- Mudar Temperatura do Setor (AgroGraf) ---\nSetores Cadastrados:\n");
-    int count = 0; // Contador de setores cadastrados
+    const setores_snapshot_t *estado = ler_estado();
+    if (!setores_bits_algum(&estado->modelo.cadastrados)) { printf("Nenhum setor cadastrado.\n"); return false; }
     // Lista os setores cadastrados para o usuário escolher
-    for (int y_loop = 0; y_loop < 5; y_loop++) {
-        for (int x_loop = 0; x_loop < 5; x_loop++) {
-            int index = getIndex(x_loop, y_loop);
-            if (setor_cadastrado[index]) {
-                printf("%s (Indice %d): Temp: %.2f C\n", nomes_setores[index], index + 1, temperaturas_setores[index]);
-                count++;
-            }
-        }
+    SETORES_BITS_PARA_CADA(&estado->modelo.cadastrados, index) {
+        printf("%s (Indice %d): Temp: %.2f C\n", nomes_setores[index], index + 1, estado->modelo.temperaturas[index]);
     }
-    if (count == 0) { printf("Nenhum setor cadastrado.\n"); sleep_ms(1500); return; }
 
     // Solicita o índice do setor ao usuário
     printf("\nDigite o INDICE do setor (1-%d): ", MAX_SETORES);
-    if (scanf("%d", &setor_idx_escolhido) != 1) { // Validação da entrada
-        printf("Entrada invalida.\n"); while (getchar() != '\n' && getchar() != EOF); sleep_ms(1500); return;
-    }
-    setor_idx_escolhido--; // Ajusta para índice baseado em 0 (0 a MAX_SETORES-1)
-
-    // Verifica se o índice é válido e se o setor está cadastrado
-    if (setor_idx_escolhido < 0 || setor_idx_escolhido >= MAX_SETORES || !setor_cadastrado[setor_idx_escolhido]) {
-        printf("Indice de setor invalido ou setor nao cadastrado.\n"); sleep_ms(1500); return;
-    }
-
-    // Solicita a nova temperatura
-    printf("Digite a nova temperatura para %s: ", nomes_setores[setor_idx_escolhido]);
-    if (scanf("%f", &nova_temperatura) != 1) { // Validação da entrada
-        printf("Entrada invalida.\n"); while (getchar() != '\n' && getchar() != EOF); sleep_ms(1500); return;
-    }
-    temperaturas_setores[setor_idx_escolhido] = nova_temperatura; // Atualiza a temperatura
-    printf("Temperatura de %s alterada para %.2f C\n", nomes_setores[setor_idx_escolhido], nova_temperatura);
-    sleep_ms(1000); // Pausa para o usuário ver a mensagem
+    return true;
 }
 
 /**
  * @brief Atualiza as cores dos LEDs na matriz com base no estado atual dos setores.
- * @details LEDs de setores cadastrados ficam verdes (ou vermelhos se >100°C).
- *          LEDs de setores não cadastrados ficam apagados.
- *          Não altera o LED sob o cursor se estiver no modo de cadastro (menu_choice == 1).
+ * @details Cada LED mostra o bloco de setores da janela do visor: vermelho se
+ *          algum está em alerta (nível crítico), amarelo se algum está em aviso,
+ *          verde se algum está cadastrado, apagado caso contrário.
+ *          Não altera o LED sob o cursor se estiver no modo de cadastro (`modo_cadastro`).
  */
 void update_led_colors() {
-    for (int y_loop = 0; y_loop < 5; y_loop++) {
-        for (int x_loop = 0; x_loop < 5; x_loop++) {
-            // Se estiver no modo de cadastro (main_menu_choice == 1) E este LED
-            // for o que está sob o cursor, não faz nada aqui, pois o cursor azul
-            // tem prioridade e é tratado no loop de cadastro.
-            if (main_menu_choice == 1 && x_loop == current_x && y_loop == current_y) {
+    int cursor_x = -1, cursor_y = -1;
+    if (modo_cadastro) visor_led_do_setor(&visor, current_x, current_y, &cursor_x, &cursor_y);
+    for (int y_loop = 0; y_loop < MATRIZ_LEDS_ALTURA; y_loop++) {
+        for (int x_loop = 0; x_loop < MATRIZ_LEDS_LARGURA; x_loop++) {
+            // Se estiver no modo de cadastro E este LED for o que está sob o
+            // cursor, não faz nada aqui, pois o cursor azul tem prioridade e é
+            // tratado pela task_cadastro.
+            if (x_loop == cursor_x && y_loop == cursor_y) {
                 continue;
             }
-            int index = getIndex(x_loop, y_loop); // Obtém o índice linear do LED/setor
-            if (setor_cadastrado[index]) { // Se o setor está cadastrado
-                if (temperaturas_setores[index] > 100.0f) { // Temperatura alta (alerta)
-                    npSetLED(index, red_r, red_g, red_b); // Define cor vermelha
-                } else { // Temperatura normal
-                    npSetLED(index, green_r, green_g, green_b); // Define cor verde
-                }
-            } else { // Se o setor não está cadastrado
-                npSetLED(index, 0, 0, 0); // Apaga o LED
-            }
+            desenhar_led(x_loop, y_loop);
         }
     }
-    npWrite(); // Envia as atualizações para a matriz de LEDs física
+    npWrite(); // Só transmite se alguma cor mudou desde o último quadro enviado
+}
+
+/**
+ * @brief Define no quadro da matriz a cor de um LED conforme os setores que ele exibe.
+ * @param lx Coluna do LED na matriz.
+ * @param ly Linha do LED na matriz.
+ * @details Vermelho se em alerta, amarelo se em aviso, verde se cadastrado,
+ *          apagado caso contrário (ver visor_celula). Repetir a cor atual não suja o quadro.
+ */
+void desenhar_led(int lx, int ly) {
+    uint index = matriz_leds_indice((uint)lx, (uint)ly);
+    switch (visor_celula(&visor, lx, ly, &modelo_setores)) {
+        case VISOR_CELULA_ALARME: // Temperatura alta (alerta)
+            npSetLED(index, red_r, red_g, red_b); // Define cor vermelha
+            break;
+        case VISOR_CELULA_AVISO: // Acima do limite de aviso ou subindo rápido
+            npSetLED(index, yellow_r, yellow_g, yellow_b); // Define cor amarela
+            break;
+        case VISOR_CELULA_CADASTRADA: // Temperatura normal
+            npSetLED(index, green_r, green_g, green_b); // Define cor verde
+            break;
+        default: // Nenhum setor cadastrado
+            npSetLED(index, 0, 0, 0); // Apaga o LED
+            break;
+    }
+}
+
+/**
+ * @brief Desenha o cursor azul no LED que exibe o setor sob o cursor.
+ * @details No modo de cadastro o visor segue o cursor, então ele está sempre na janela.
+ */
+void desenhar_cursor() {
+    int lx, ly;
+    if (visor_led_do_setor(&visor, current_x, current_y, &lx, &ly)) {
+        npSetLED(matriz_leds_indice((uint)lx, (uint)ly), blue_r, blue_g, blue_b);
+    }
 }
 
 /**
@@ -921,68 +1442,68 @@ void update_led_colors() {
  *          depende se o setor está cadastrado e qual sua temperatura.
  */
 void desligarLedAzul() {
-    int index_cursor = getIndex(current_x, current_y); // Índice do LED sob o cursor
-    if (setor_cadastrado[index_cursor]) { // Se o setor sob o cursor está cadastrado
-        if (temperaturas_setores[index_cursor] > 100.0f) { // Temperatura alta
-            npSetLED(index_cursor, red_r, red_g, red_b); // Vermelho
-        } else { // Temperatura normal
-            npSetLED(index_cursor, green_r, green_g, green_b); // Verde
-        }
-    } else { // Se o setor não está cadastrado
-        npSetLED(index_cursor, 0, 0, 0); // Apagado
+    int lx, ly;
+    if (visor_led_do_setor(&visor, current_x, current_y, &lx, &ly)) {
+        desenhar_led(lx, ly); // LED sob o cursor
     }
     // npWrite() é chamado pela função update_led_colors() ou explicitamente
-    // após esta função ser chamada ao sair do modo de cadastro (case 1 do menu principal).
+    // após esta função ser chamada ao sair do modo de cadastro.
 }
 
 /**
- * @brief Simula o acionamento de equipamentos contra incêndio.
- * @details Lista os setores com temperatura > 100°C. Se o usuário confirmar,
- *          reseta a temperatura desses setores para a temperatura ambiente.
+ * @brief Inicia o acionamento simulado de equipamentos contra incêndio.
+ * @return bool `true` se há setores em alerta e a confirmação (s/n) foi solicitada.
+ * @details Lista os setores no nível crítico da regra de alarme. A resposta do usuário é
+ *          tratada por ui_processar_linha() no estado UI_ACIONAR_CONFIRMA.
  */
-void acionar_equipamentos_contra_incendio() {
+bool acionar_equipamentos_contra_incendio() {
     clear_screen(); // Limpa a tela do terminal
     printf("\n--- Acionar Equipamentos Contra Incendio (AgroGraf) ---\n");
-    printf("\nSetores com temperaturas acima de 100 graus Celsius:\n");
-    int count = 0; // Contador de setores em alerta
+    printf("\nSetores com temperatura critica:\n");
+    const setores_snapshot_t *estado = ler_estado();
+    if (!setores_bits_algum(&estado->modelo.alarmes)) { printf("Nenhum setor com temperatura critica.\n"); return false; }
     // Lista os setores com temperatura crítica
-    for (int y_loop = 0; y_loop < 5; y_loop++) {
-        for (int x_loop = 0; x_loop < 5; x_loop++) {
-            int index = getIndex(x_loop, y_loop);
-            if (setor_cadastrado[index] && temperaturas_setores[index] > 100.0f) {
-                printf("%s (Indice %d): Temp: %.2f C\n", nomes_setores[index], index + 1, temperaturas_setores[index]);
-                count++;
-            }
-        }
+    SETORES_BITS_PARA_CADA(&estado->modelo.alarmes, index) {
+        printf("%s (Indice %d): Temp: %.2f C\n", nomes_setores[index], index + 1, estado->modelo.temperaturas[index]);
     }
-    if (count == 0) { printf("Nenhum setor com temperatura acima de 100 graus Celsius.\n"); sleep_ms(1500); return; }
 
-    char resposta; // Resposta do usuário (s/n)
     printf("\nDeseja voltar todos os setores listados para a temperatura ambiente? (s/n): ");
-    scanf(" %c", &resposta); // Lê um caractere (com espaço antes para consumir newlines pendentes)
-    int c_in;
-    // Limpa o restante do buffer de entrada até o newline
-    while((c_in = getchar()) != '\n' && c_in != EOF);
-
-    if (resposta == 's' || resposta == 'S') { // Se o usuário confirmar
-        float temperatura_ambiente = read_onboard_temperature(TEMPERATURE_UNITS); // Lê temp. ambiente
-        // Itera por todos os setores
-        for (int y_loop = 0; y_loop < 5; y_loop++) {
-            for (int x_loop = 0; x_loop < 5; x_loop++) {
-                int index = getIndex(x_loop, y_loop);
-                // Se o setor estiver cadastrado e com temperatura alta
-                if (setor_cadastrado[index] && temperaturas_setores[index] > 100.0f) {
-                    temperaturas_setores[index] = temperatura_ambiente; // Reseta para temp. ambiente
-                    printf("Equipamentos acionados no %s - temp. controlada (%.2f C).\n", nomes_setores[index], temperatura_ambiente);
-                }
-            }
-        }
-    } else {
-        printf("Nenhuma acao realizada.\n");
+    return true;
+}
+
+/**
+ * @brief Volta todos os setores em alerta (nível crítico) para a temperatura ambiente.
+ * @details Executada no núcleo 1 ao receber SETOR_CMD_RESETAR_ALERTAS.
+ */
+void resetar_setores_em_alerta() {
+    // Itera só pelos setores em alarme (cada escrita limpa o bit do setor)
+    SETORES_BITS_PARA_CADA(&modelo_setores.alarmes, index) {
+        setores_modelo_temperatura(&modelo_setores, index, temperatura_ambiente); // Reseta para temp. ambiente
+    }
+}
+
+/**
+ * @brief Liga o buzzer se algum setor cadastrado estiver no nível crítico e o desliga caso contrário.
+ * @details O conjunto de alarmes é mantido a cada escrita de temperatura ou
+ *          de cadastro: basta testar se alguma palavra é não nula.
+ */
+void avaliar_alarme() {
+    // Verifica se algum setor cadastrado está com temperatura alta
+    bool algum_setor_quente = setores_bits_algum(&modelo_setores.alarmes);
+    // Se há setor quente e o buzzer está desligado, liga o buzzer
+    if (algum_setor_quente && !buzzer_ativo) {
+        beep(BUZZER_PIN, 0); // O '0' em duration_ms significa tom contínuo aqui
+        buzzer_ativo = true;
+        estado_alterado = true;
+        diario_registrar(DIARIO_BUZZER, SETOR_INVALIDO, 1, 0.0f);
+    }
+    // Se não há setor quente e o buzzer está ligado, desliga o buzzer
+    else if (!algum_setor_quente && buzzer_ativo) {
+        stop_tone(BUZZER_PIN);
+        buzzer_ativo = false;
+        estado_alterado = true;
+        diario_registrar(DIARIO_BUZZER, SETOR_INVALIDO, 0, 0.0f);
     }
-    printf("\nPressione Enter para retornar...\n");
-    // Aguarda Enter para continuar. O 'if' é para o caso de 'c_in' já ser EOF ou \r de um CR/LF.
-    if (c_in != EOF && c_in != '\r') getchar();
 }
 
 /**
@@ -992,20 +1513,8 @@ void acionar_equipamentos_contra_incendio() {
  *          para controlar a frequência do buzzer, e inicia o PWM com duty cycle 0 (desligado).
  */
 void pwm_init_buzzer(uint pin) {
-    gpio_set_function(pin, GPIO_FUNC_PWM); // Configura o pino para PWM
-    uint slice_num = pwm_gpio_to_slice_num(pin); // Obtém o slice PWM do pino
-
-    // Configuração padrão do PWM
-    pwm_config config = pwm_get_default_config();
-    // Define o divisor de clock do PWM. Ex: clock_sys (125MHz) / (244+0/16) / 256 ~= 2kHz
-    // Frequência = ClockSys / (clkdiv_int + clkdiv_frac/16) / wrap
-    // Para um tom audível, algo em torno de 1kHz-4kHz é comum.
-    // Divisor 244 e Wrap 255 resulta em aprox. 2000 Hz (125,000,000 / 244 / 256)
-    pwm_config_set_clkdiv_int_frac(&config, 244, 0); // Divisor de clock inteiro
-    pwm_config_set_wrap(&config, 255);               // Valor de contagem máxima (TOP) do PWM
-
-    pwm_init(slice_num, &config, true); // Inicializa o slice PWM com a configuração e habilita
-    pwm_set_gpio_level(pin, 0);         // Define o duty cycle para 0 (buzzer desligado)
+    // Divisor 244 e wrap 255: 125 MHz / 244 / 256 ~= 2 kHz, com duty cycle 0 (desligado)
+    hal_buzzer_init(pin);
 }
 
 /**
@@ -1017,7 +1526,7 @@ void pwm_init_buzzer(uint pin) {
  */
 void beep(uint pin, uint duration_ms) {
     // Define o nível do PWM (duty cycle). 128 é 50% de 255 (wrap).
-    pwm_set_gpio_level(pin, 128);
+    hal_buzzer_nivel(pin, 128);
     // Nota: duration_ms não é usado para parar o tom automaticamente nesta implementação.
     // O tom continuará até que stop_tone() seja chamado.
 }
@@ -1028,5 +1537,5 @@ void beep(uint pin, uint duration_ms) {
  * @details Define o duty cycle do PWM para 0%, silenciando o buzzer.
  */
 void stop_tone(uint pin) {
-    pwm_set_gpio_level(pin, 0); // Define o duty cycle para 0 (buzzer desligado)
+    hal_buzzer_nivel(pin, 0); // Define o duty cycle para 0 (buzzer desligado)
 }
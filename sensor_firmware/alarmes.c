@@ -0,0 +1,200 @@
+/**
+ * @file alarmes.c
+ * @brief Avaliação incremental das regras de alarme de cada setor (núcleo 1).
+ */
+
+#include <string.h>
+#include "hal.h"
+#include "setores.h"
+#include "alarmes.h"
+#include "diario.h"
+
+// Padrão: os mesmos 100 °C de antes como crítico, com aviso a 90 °C e 1 °C de histerese
+const alarme_regra_t alarme_regra_padrao = {
+    .aviso_c = 90.0f,
+    .critico_c = SETORES_ALARME_C,
+    .histerese_c = 1.0f,
+    .subida_c_min = 0.0f,
+    .duracao_ms = 0,
+};
+
+/**
+ * @struct alarme_estado_t
+ * @brief Estado da avaliação de um setor.
+ */
+typedef struct {
+    uint8_t nivel;       // Nível aceito (alarme_nivel_t)
+    uint8_t candidato;   // Nível calculado, aguardando a duração mínima
+    bool subindo;        // A última taxa medida passou de subida_c_min
+    bool referencia;     // ref_c e ref_ms valem
+    uint32_t desde_ms;   // Instante em que `candidato` passou a valer
+    uint32_t ref_ms;     // Início da janela da taxa de subida
+    float ref_c;         // Temperatura no início da janela
+} alarme_estado_t;
+
+static alarme_regra_t regras[MAX_SETORES];  // Escritas pelo núcleo 1, lidas pelo núcleo 0 (seqlock)
+static volatile uint32_t regras_seq;        // Seqlock das regras: ímpar durante a escrita
+static alarme_estado_t estados[MAX_SETORES];
+static setores_bits_t pendentes;            // Candidato diferente do nível, ou subida a confirmar
+
+/**
+ * @brief Aplica a regra padrão a todos os setores e zera o estado.
+ */
+void alarmes_init(void) {
+    for (int i = 0; i < MAX_SETORES; i++) regras[i] = alarme_regra_padrao;
+    memset(estados, 0, sizeof(estados));
+    memset(&pendentes, 0, sizeof(pendentes));
+    regras_seq = 0;
+}
+
+/**
+ * @brief Verifica os limites de uma regra (recebida por HTTP).
+ * @details Rejeita também valores não numéricos (NaN falha em todas as comparações).
+ *          Os limites cabem nos centésimos int16 usados pelas rotas /api.
+ */
+bool alarmes_regra_valida(const alarme_regra_t *r) {
+    return r->aviso_c >= -100.0f && r->critico_c <= 300.0f && r->aviso_c <= r->critico_c &&
+           r->histerese_c >= 0.0f && r->histerese_c <= 100.0f &&
+           r->subida_c_min >= 0.0f && r->subida_c_min <= 300.0f &&
+           r->duracao_ms <= ALARMES_DURACAO_MAX_MS;
+}
+
+// Nível indicado pela temperatura, com a histerese relativa ao nível já aceito
+static uint8_t alarmes_nivel(const alarme_regra_t *r, const alarme_estado_t *e, float t) {
+    if (t > r->critico_c || (e->nivel == ALARME_CRITICO && t > r->critico_c - r->histerese_c)) {
+        return ALARME_CRITICO;
+    }
+    if (t > r->aviso_c || e->subindo || (e->nivel != ALARME_NORMAL && t > r->aviso_c - r->histerese_c)) {
+        return ALARME_AVISO;
+    }
+    return ALARME_NORMAL;
+}
+
+// Mede a taxa de subida quando a janela da referência já passou
+static void alarmes_medir_subida(const alarme_regra_t *r, alarme_estado_t *e, float t, uint32_t agora_ms) {
+    if (r->subida_c_min <= 0.0f) {
+        e->subindo = false;
+        e->referencia = false;
+        return;
+    }
+    if (!e->referencia) {
+        e->referencia = true;
+    } else {
+        uint32_t janela = agora_ms - e->ref_ms;
+        if (janela < ALARMES_JANELA_SUBIDA_MS) return;
+        e->subindo = (t - e->ref_c) * 60000.0f > r->subida_c_min * (float)janela;
+    }
+    e->ref_c = t;
+    e->ref_ms = agora_ms;
+}
+
+/**
+ * @brief Recalcula o nível de um setor cadastrado e aceita a mudança vencida.
+ * @param leitura Chamada por uma nova temperatura (mede a subida); `false` nas revisões periódicas.
+ * @return bool `true` se o nível aceito mudou.
+ */
+static bool alarmes_atualizar(setores_modelo_t *m, setor_id_t i, uint32_t agora_ms, bool leitura) {
+    const alarme_regra_t *r = &regras[i];
+    alarme_estado_t *e = &estados[i];
+    float t = m->temperaturas[i];
+    if (leitura) {
+        alarmes_medir_subida(r, e, t, agora_ms);
+    } else if (e->subindo && agora_ms - e->ref_ms >= 2 * ALARMES_JANELA_SUBIDA_MS) {
+        e->subindo = false; // Sem leituras novas, a subida não se confirma
+    }
+
+    uint8_t nivel = alarmes_nivel(r, e, t);
+    bool mudou = false;
+    if (nivel == e->nivel) {
+        e->candidato = nivel;
+    } else {
+        if (nivel != e->candidato) {
+            e->candidato = nivel;
+            e->desde_ms = agora_ms;
+        }
+        if (agora_ms - e->desde_ms >= r->duracao_ms) {
+            e->nivel = nivel;
+            setores_bits_definir(&m->avisos, i, nivel == ALARME_AVISO);
+            setores_bits_definir(&m->alarmes, i, nivel == ALARME_CRITICO);
+            diario_registrar(DIARIO_NIVEL, i, nivel, t);
+            mudou = true;
+        }
+    }
+    setores_bits_definir(&pendentes, i, e->candidato != e->nivel || e->subindo);
+    return mudou;
+}
+
+/**
+ * @brief Volta um setor ao nível normal, sem histórico de subida (cadastro alterado ou limpeza).
+ */
+void alarmes_reiniciar(setores_modelo_t *m, setor_id_t setor) {
+    memset(&estados[setor], 0, sizeof(estados[setor]));
+    setores_bits_definir(&m->avisos, setor, false);
+    setores_bits_definir(&m->alarmes, setor, false);
+    setores_bits_definir(&pendentes, setor, false);
+}
+
+/**
+ * @brief Avalia a regra de um setor cadastrado após uma nova temperatura.
+ */
+void alarmes_avaliar(setores_modelo_t *m, setor_id_t setor, uint32_t agora_ms) {
+    alarmes_atualizar(m, setor, agora_ms, true);
+}
+
+/**
+ * @brief Revê os setores pendentes: aceita mudanças que completaram a duração mínima.
+ * @return bool `true` se algum nível mudou (o estado deve ser publicado).
+ */
+bool alarmes_processar(setores_modelo_t *m, uint32_t agora_ms) {
+    bool mudou = false;
+    SETORES_BITS_PARA_CADA(&pendentes, i) {
+        mudou |= alarmes_atualizar(m, i, agora_ms, false);
+    }
+    return mudou;
+}
+
+/**
+ * @brief Informa se alguma mudança de nível aguarda a duração mínima.
+ * @details Só percorre os pendentes; uma subida em medição sem mudança de nível não conta.
+ */
+bool alarmes_transicao_pendente(void) {
+    SETORES_BITS_PARA_CADA(&pendentes, i) {
+        if (estados[i].candidato != estados[i].nivel) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Troca a regra de um setor (ou de todos, com SETOR_INVALIDO) e a reavalia.
+ * @details A regra já deve ter passado por alarmes_regra_valida().
+ */
+void alarmes_definir_regra(setores_modelo_t *m, setor_id_t setor, const alarme_regra_t *regra, uint32_t agora_ms) {
+    setor_id_t inicio = setor < MAX_SETORES ? setor : 0;
+    setor_id_t fim = setor < MAX_SETORES ? (setor_id_t)(setor + 1) : MAX_SETORES;
+    regras_seq++; // Ímpar: escrita em andamento
+    hal_barreira();
+    for (setor_id_t i = inicio; i < fim; i++) regras[i] = *regra;
+    hal_barreira();
+    regras_seq++;
+    for (setor_id_t i = inicio; i < fim; i++) {
+        estados[i].referencia = false; // A taxa recomeça com a nova regra
+        estados[i].subindo = false;
+        if (setores_cadastrado(m, i)) alarmes_atualizar(m, i, agora_ms, false);
+    }
+}
+
+/**
+ * @brief Copia a regra atual de um setor (núcleo 0).
+ */
+void alarmes_ler_regra(setor_id_t setor, alarme_regra_t *regra) {
+    uint32_t inicio, fim;
+    do {
+        do {
+            inicio = regras_seq;
+        } while (inicio & 1u);
+        hal_barreira();
+        *regra = regras[setor];
+        hal_barreira();
+        fim = regras_seq;
+    } while (inicio != fim);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file alarmes.h
+ * @brief Regras de alarme por setor: aviso e crítico, taxa de subida, histerese e duração mínima.
+ * @details Cada setor tem uma regra (alarme_regra_t) e um nível atual:
+ *          - ALARME_CRITICO acima de `critico_c` (buzzer, LED vermelho);
+ *          - ALARME_AVISO acima de `aviso_c` ou subindo mais rápido que
+ *            `subida_c_min` (LED amarelo);
+ *          - um nível só cai quando a temperatura fica `histerese_c` abaixo do
+ *            limite que o ativou, de modo que uma leitura oscilando em torno do
+ *            limite não liga e desliga o alarme;
+ *          - uma mudança de nível só é aceita depois de se manter por
+ *            `duracao_ms` (0 = imediata).
+ *
+ *          A avaliação é incremental: cada escrita de temperatura avalia só a
+ *          regra do próprio setor (setores_modelo_temperatura). Mudanças que
+ *          aguardam `duracao_ms` ficam em um conjunto de pendentes, visitado
+ *          por alarmes_processar() (task_alarme) sem varrer os demais setores.
+ *          O resultado fica nos conjuntos `avisos` e `alarmes` do modelo.
+ *
+ *          O núcleo 1 é dono das regras e do estado. O núcleo 0 lê as regras
+ *          com alarmes_ler_regra() e as altera com setores_enviar_regra().
+ */
+
+#ifndef ALARMES_H
+#define ALARMES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ALARMES_JANELA_SUBIDA_MS 10000 // Intervalo mínimo entre duas medições da taxa de subida
+#define ALARMES_DURACAO_MAX_MS 600000  // Maior duração mínima aceita em uma regra (10 min)
+
+struct setores_modelo; // setores.h (que inclui este arquivo)
+
+/**
+ * @enum alarme_nivel_t
+ * @brief Nível de um setor, do menos ao mais grave.
+ */
+typedef enum {
+    ALARME_NORMAL,
+    ALARME_AVISO,
+    ALARME_CRITICO
+} alarme_nivel_t;
+
+/**
+ * @struct alarme_regra_t
+ * @brief Limites de um setor (°C, °C/min e ms).
+ */
+typedef struct {
+    float aviso_c;       // Aviso acima desta temperatura
+    float critico_c;     // Crítico acima desta temperatura (>= aviso_c)
+    float histerese_c;   // Margem abaixo do limite para o nível cair
+    float subida_c_min;  // Aviso se a temperatura sobe mais rápido que isto (0 = desativado)
+    uint32_t duracao_ms; // Tempo que um novo nível deve se manter antes de ser aceito
+} alarme_regra_t;
+
+extern const alarme_regra_t alarme_regra_padrao; // Aplicada a todos os setores no boot
+
+void alarmes_init(void); // Antes de lançar o núcleo 1
+bool alarmes_regra_valida(const alarme_regra_t *regra);
+
+// Núcleo 1 (chamadas pelo modelo em setores.c e por task_alarme/task_comandos)
+void alarmes_reiniciar(struct setores_modelo *m, uint16_t setor);
+void alarmes_avaliar(struct setores_modelo *m, uint16_t setor, uint32_t agora_ms);
+bool alarmes_processar(struct setores_modelo *m, uint32_t agora_ms);
+bool alarmes_transicao_pendente(void); // Algum setor aguarda a duração mínima de uma mudança de nível
+void alarmes_definir_regra(struct setores_modelo *m, uint16_t setor, const alarme_regra_t *regra, uint32_t agora_ms);
+
+// Núcleo 0
+void alarmes_ler_regra(uint16_t setor, alarme_regra_t *regra);
+
+#endif
@@ -0,0 +1,353 @@
+/**
+ * @file agrograf_bench.c
+ * @brief Benchmark dos caminhos críticos do firmware AgroGraf (alvo agrograf_bench).
+ * @details Liga-se ao mesmo código do firmware (agrograf.c compilado com
+ *          AGROGRAF_SEM_MAIN) e mede, com hal_ciclos(), cada caminho repetidas
+ *          vezes: SysTick (ciclos do clk_sys) no Pico, clock_gettime no host.
+ *          Tudo roda em um único núcleo, sem Wi-Fi conectado nem servidor.
+ *
+ *          A saída é JSON Lines, para acompanhar regressões entre versões:
+ *          {"bench":"agrograf","formato":1,"plataforma":"pico","ciclos_por_us":125}
+ *          {"caso":"npWrite","amostras":1000,"min_ns":..,"mediana_ns":..,"p99_ns":..,"max_ns":..}
+ *          O caso "vazio" mede a chamada indireta e a leitura do contador (a sobrecarga).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal.h"
+#include "inc/ssd1306.h"
+#include "scheduler.h"
+#include "setores.h"
+#include "http_server.h"
+#include "painel_oled.h"
+#include "sensores_adc.h"
+#include "ingestao.h"
+#include "historico.h"
+#include "persistencia.h"
+#include "diario.h"
+#include "log.h"
+
+#define BENCH_FORMATO 1         // Versão do formato da saída
+#define BENCH_AMOSTRAS_MAX 1000 // Amostras por caso
+#define BENCH_AQUECIMENTO 5     // Execuções descartadas antes de medir
+#define BENCH_RESPOSTA_MAX 8192 // Buffer para as respostas HTTP geradas (/api/history: ~5 KB)
+
+// ===== SÍMBOLOS DO FIRMWARE (agrograf.c) =====
+extern ssd1306_t oled;
+extern struct render_area frame_area;
+extern bool estado_alterado;
+extern setores_modelo_t modelo_setores;
+extern scheduler_t scheduler;
+extern scheduler_t scheduler_core1;
+
+void npWrite();
+float read_onboard_temperature(const char unit);
+void core0_inicializar();
+void core1_inicializar();
+void inicializar_nomes_setores();
+void publicar_estado();
+void painel_montar_modelo(const setores_snapshot_t *estado, painel_oled_modelo_t *m);
+void task_ingestao(void *ctx);
+void avaliar_alarme();
+// =============================================
+
+typedef void (*bench_funcao_t)(void);
+typedef void (*bench_preparo_t)(void); // Executado antes de cada amostra, fora da medição
+
+static uint32_t amostras[BENCH_AMOSTRAS_MAX];
+static char resposta[BENCH_RESPOSTA_MAX];
+static volatile float bench_descarte; // Impede que o compilador elimine a leitura medida
+
+static int bench_comparar(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static unsigned long bench_ns(uint32_t ciclos) {
+    return (unsigned long)(((uint64_t)ciclos * 1000u) / hal_ciclos_por_us());
+}
+
+/**
+ * @brief Executa `funcao` `n` vezes e imprime min/mediana/p99/max em uma linha JSON.
+ * @details `preparo` (opcional) roda antes de cada execução, sem ser medido.
+ */
+static void bench_medir_preparado(const char *caso, bench_preparo_t preparo, bench_funcao_t funcao, uint32_t n) {
+    if (n > BENCH_AMOSTRAS_MAX) n = BENCH_AMOSTRAS_MAX;
+    for (int i = 0; i < BENCH_AQUECIMENTO; i++) {
+        if (preparo) preparo();
+        funcao();
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (preparo) preparo();
+        uint32_t inicio = hal_ciclos();
+        funcao();
+        amostras[i] = hal_ciclos_delta(inicio, hal_ciclos());
+    }
+    qsort(amostras, n, sizeof(amostras[0]), bench_comparar);
+    uint32_t p99 = (n * 99 + 99) / 100 - 1; // Posição do percentil 99 (arredondada para cima)
+    printf("{\"caso\":\"%s\",\"amostras\":%lu,\"min_ns\":%lu,\"mediana_ns\":%lu,\"p99_ns\":%lu,\"max_ns\":%lu}\n",
+           caso, (unsigned long)n,
+           bench_ns(amostras[0]), bench_ns(amostras[(n - 1) / 2]),
+           bench_ns(amostras[p99]), bench_ns(amostras[n - 1]));
+}
+
+static void bench_medir(const char *caso, bench_funcao_t funcao, uint32_t n) {
+    bench_medir_preparado(caso, NULL, funcao, n);
+}
+
+// ===== CASOS =====
+
+static void caso_vazio(void) {}
+
+static void caso_np_write(void) {
+    npWrite();
+}
+
+static void caso_oled_flush(void) {
+    ssd1306_flush(&oled, &frame_area); // Tela inteira pelo driver (antes: render_on_display)
+}
+
+static void caso_oled_parcial(void) {
+    // Uma leitura de temperatura (5 caracteres) que muda a cada atualização
+    static bool alterna;
+    alterna = !alterna;
+    ssd1306_draw_string(ssd1306_framebuffer(&oled), 40, 48, alterna ? "23.5°C" : "24.0°C");
+    ssd1306_flush_dirty(&oled);
+}
+
+// Espera o envio anterior terminar e altera a tela inteira
+static void preparo_oled_async(void) {
+    while (ssd1306_flush_busy(&oled)) {}
+    ssd1306_invalidate(&oled, &frame_area);
+}
+
+static void caso_oled_async(void) {
+    ssd1306_flush_async(&oled, NULL, NULL); // Só o custo de CPU: o quadro segue por DMA
+}
+
+// Pior quadro do painel: todas as células, o setor mais quente, o alarme, a
+// temperatura ambiente e o gráfico mudam entre dois estados alternados
+static painel_oled_modelo_t painel_modelos[2];
+static int painel_modelo_atual;
+
+static void preparo_painel(void) {
+    painel_modelo_atual ^= 1;
+    painel_oled_amostrar(painel_modelo_atual ? 35.0f : 20.0f);
+}
+
+static void caso_painel(void) {
+    painel_oled_atualizar(&painel_modelos[painel_modelo_atual]);
+}
+
+// Um período da tarefa do ADC: ~30 amostras novas no anel
+static void preparo_adc(void) {
+    hal_dormir_ms(10);
+}
+
+static void caso_adc(void) {
+    sensores_adc_processar();
+}
+
+// Um lote cheio de leituras na fila, uma para cada setor (carimbos crescentes)
+static void preparo_ingestao(void) {
+    static uint64_t instante;
+    for (int i = 0; i < INGESTAO_LOTE; i++) {
+        ingestao_publicar(0, (setor_id_t)(i % MAX_SETORES), 20.0f + (float)(i % 7), ++instante);
+    }
+}
+
+static void caso_ingestao(void) {
+    task_ingestao(NULL);
+}
+
+// Escrita de uma temperatura (mantém o conjunto de alarmes) e reavaliação do buzzer
+static void caso_alarme(void) {
+    static bool alterna;
+    alterna = !alterna;
+    setores_modelo_temperatura(&modelo_setores, MAX_SETORES - 1, alterna ? 120.0f : 25.0f);
+    avaliar_alarme();
+}
+
+// Dreno fora da medição, antes que o anel do núcleo encha (o descarte seria mais barato)
+static void preparo_diario(void) {
+    static uint32_t n;
+    if (++n % (DIARIO_FILA / 2) == 0) diario_drenar();
+}
+
+// Custo que os caminhos quentes pagam por evento
+static void caso_diario(void) {
+    diario_registrar(DIARIO_TEMPERATURA, MAX_SETORES - 1, 0, 31.5f);
+}
+
+// Formatação fora da medição (em buffer: o stdout do bench é só JSON)
+static void preparo_log(void) {
+    static uint32_t n;
+    char linha[LOG_LINHA_MAX];
+    if (++n % (LOG_FILA / 2) == 0) {
+        while (log_formatar(linha, sizeof(linha))) {}
+    }
+}
+
+// Custo no chamador de uma mensagem com inteiro, float e string
+static void caso_log(void) {
+    LOG_ERRO("Setor %d em %.2f C (%s)", MAX_SETORES - 1, 31.5f, "bench");
+}
+
+// Uma mensagem pendente por medição (nada sobra para o task_log de loop_nucleo0)
+static void preparo_log_formatar(void) {
+    char linha[LOG_LINHA_MAX];
+    while (log_formatar(linha, sizeof(linha))) {}
+    LOG_ERRO("Setor %d em %.2f C (%s)", MAX_SETORES - 1, 31.5f, "bench");
+}
+
+// Custo adiado para task_log, por mensagem
+static void caso_log_formatar(void) {
+    char linha[LOG_LINHA_MAX];
+    log_formatar(linha, sizeof(linha));
+}
+
+static void caso_persistencia_replay(void) {
+    persistencia_iniciar(); // Leitura do log inteiro, como no boot
+}
+
+static void caso_temperatura(void) {
+    bench_descarte = read_onboard_temperature('C');
+}
+
+static void bench_http(const char *requisicao) {
+    if (http_server_gerar_resposta(requisicao, resposta, sizeof(resposta)) == 0) {
+        printf("{\"erro\":\"requisicao incompleta\"}\n");
+    }
+}
+
+static void caso_http_pagina(void) {
+    bench_http("GET / HTTP/1.1\r\nHost: agrograf\r\n\r\n");
+}
+
+static void caso_http_json(void) {
+    bench_http("GET /api/sectors HTTP/1.1\r\nHost: agrograf\r\n\r\n");
+}
+
+static void caso_http_bin(void) {
+    bench_http("GET /api/sectors.bin HTTP/1.1\r\nHost: agrograf\r\n\r\n");
+}
+
+static void caso_http_historico(void) {
+    bench_http("GET /api/history?sector=7 HTTP/1.1\r\nHost: agrograf\r\n\r\n");
+}
+
+static void caso_http_eventos(void) {
+    bench_http("GET /api/events HTTP/1.1\r\nHost: agrograf\r\n\r\n"); // Diário cheio
+}
+
+// Libera todas as tarefas habilitadas de um escalonador para o próximo tick
+static void bench_vencer_tarefas(scheduler_t *s) {
+    for (size_t i = 0; i < s->num_tarefas; i++) s->tarefas[i].proxima_execucao_us = 0;
+}
+
+static void caso_loop_nucleo0(void) {
+    // Pior caso: todas as tarefas vencidas e o framebuffer do OLED inteiro alterado
+    bench_vencer_tarefas(&scheduler);
+    ssd1306_invalidate(&oled, &frame_area);
+    scheduler_tick(&scheduler);
+}
+
+static void caso_loop_nucleo1(void) {
+    // Pior caso: todas as tarefas vencidas e um novo estado a publicar
+    bench_vencer_tarefas(&scheduler_core1);
+    estado_alterado = true;
+    scheduler_tick(&scheduler_core1);
+}
+
+// =============================================
+
+/**
+ * @brief Prepara o firmware em um único núcleo com todos os setores cadastrados.
+ */
+static void bench_preparar(void) {
+    hal_rede_iniciar(); // Sem conectar: apenas para que o polling da pilha seja válido
+    ingestao_init();
+    inicializar_nomes_setores();
+    historico_init();
+    core0_inicializar();
+    setores_init();
+    core1_inicializar();
+
+    // Pior caso da página e das rotas /api: todos os setores cadastrados, alguns em alarme
+    for (int i = 0; i < MAX_SETORES; i++) {
+        setores_modelo_cadastro(&modelo_setores, (setor_id_t)i, true);
+        setores_modelo_temperatura(&modelo_setores, (setor_id_t)i, (i % 5 == 0) ? 120.5f : 20.0f + (float)i * 0.75f);
+    }
+    estado_alterado = true;
+    publicar_estado();
+    static setores_snapshot_t estado; // Estático: cresce com MAX_SETORES
+
+    // Histórico com as três camadas cheias (24 h de amostras)
+    uint32_t amostras_24h = HISTORICO_15MIN_AMOSTRAS * 15 * 60 / HISTORICO_PERIODO_BRUTO_S;
+    for (uint32_t k = 0; k < amostras_24h; k++) {
+        historico_amostrar(&modelo_setores, 1 + (uint64_t)k * HISTORICO_PERIODO_BRUTO_S * 1000000u);
+    }
+
+    // Diário cheio, com eventos de todos os formatos
+    for (uint32_t k = 0; k < DIARIO_ENTRADAS; k++) {
+        diario_registrar((diario_tipo_t)(k % DIARIO_PERDIDOS), (setor_id_t)(k % MAX_SETORES), (uint8_t)(k % 3),
+                         -12.5f + (float)k);
+        if (k % DIARIO_FILA == DIARIO_FILA - 1) diario_drenar();
+    }
+    diario_drenar();
+
+    // Log na flash com o estado e os agregados do histórico, para medir o replay do boot
+    persistencia_iniciar();
+    setores_ler_snapshot(&estado);
+    persistencia_processar(&estado, hal_tempo_us());
+
+    setores_ler_snapshot(&estado);
+    painel_montar_modelo(&estado, &painel_modelos[0]);
+    // Segundo quadro escrito direto na cópia (as regras de alarme são do modelo do núcleo 1)
+    for (int i = 0; i < MAX_SETORES; i++) {
+        setor_id_t s = (setor_id_t)i;
+        bool cadastrado = !setores_cadastrado(&estado.modelo, s) || i % 2 == 0;
+        estado.modelo.temperaturas[i] = (i % 5 == 1) ? 130.0f - (float)i : 25.0f;
+        setores_bits_definir(&estado.modelo.cadastrados, s, cadastrado);
+        setores_bits_definir(&estado.modelo.alarmes, s, cadastrado && i % 5 == 1);
+        setores_bits_definir(&estado.modelo.avisos, s, cadastrado && i % 5 == 3);
+    }
+    estado.temperatura_ambiente += 3.0f;
+    painel_montar_modelo(&estado, &painel_modelos[1]);
+    painel_oled_iniciar(&oled);
+}
+
+int main() {
+    hal_console_init();
+    hal_dormir_ms(2000); // Tempo para o terminal serial se conectar
+    hal_ciclos_init();
+    bench_preparar();
+
+    printf("{\"bench\":\"agrograf\",\"formato\":%d,\"plataforma\":\"%s\",\"ciclos_por_us\":%lu}\n",
+           BENCH_FORMATO, HAL_PLATAFORMA, (unsigned long)hal_ciclos_por_us());
+    bench_medir("vazio", caso_vazio, 1000);
+    bench_medir("npWrite", caso_np_write, 1000);
+    bench_medir("oled_flush", caso_oled_flush, 100);
+    bench_medir("oled_flush_parcial", caso_oled_parcial, 500);
+    bench_medir_preparado("oled_flush_async", preparo_oled_async, caso_oled_async, 100);
+    bench_medir_preparado("painel_oled", preparo_painel, caso_painel, 500);
+    bench_medir_preparado("adc_processar", preparo_adc, caso_adc, 100);
+    bench_medir("read_onboard_temperature", caso_temperatura, 1000);
+    bench_medir_preparado("ingestao_lote", preparo_ingestao, caso_ingestao, 500);
+    bench_medir("alarme", caso_alarme, 1000);
+    bench_medir_preparado("diario_registrar", preparo_diario, caso_diario, 1000);
+    bench_medir_preparado("log_registrar", preparo_log, caso_log, 1000);
+    bench_medir_preparado("log_formatar", preparo_log_formatar, caso_log_formatar, 500);
+    bench_medir("http_pagina", caso_http_pagina, 500);
+    bench_medir("http_api_json", caso_http_json, 500);
+    bench_medir("http_api_bin", caso_http_bin, 500);
+    bench_medir("http_api_historico", caso_http_historico, 200);
+    bench_medir("http_api_eventos", caso_http_eventos, 200);
+    bench_medir("persistencia_replay", caso_persistencia_replay, 50);
+    bench_medir("loop_nucleo0", caso_loop_nucleo0, 200);
+    bench_medir("loop_nucleo1", caso_loop_nucleo1, 200);
+
+    hal_dormir_ms(100); // Deixa a saída USB esvaziar
+    return 0;
+}
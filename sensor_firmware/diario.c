@@ -0,0 +1,149 @@
+/**
+ * @file diario.c
+ * @brief Anéis de registro por núcleo e diário numerado de eventos.
+ */
+
+#include <string.h>
+#include "hal.h"
+#include "setores.h"
+#include "diario.h"
+
+/**
+ * @struct diario_fila_t
+ * @brief Anel SPSC de um núcleo: o núcleo (e suas IRQs) escreve, task_diario lê.
+ */
+typedef struct {
+    volatile uint32_t escrita;  // Eventos gravados (só o produtor escreve)
+    volatile uint32_t leitura;  // Eventos drenados (só task_diario escreve)
+    volatile uint32_t perdidos; // Descartados por anel cheio (só o produtor escreve)
+    diario_evento_t itens[DIARIO_FILA];
+} diario_fila_t;
+
+static diario_fila_t filas[DIARIO_NUCLEOS];
+static uint32_t perdidos_vistos[DIARIO_NUCLEOS]; // Última contagem já anunciada no diário
+
+static diario_evento_t entradas[DIARIO_ENTRADAS]; // Núcleo 0: entrada seq em seq % DIARIO_ENTRADAS
+static uint32_t ultimo_seq;
+static uint32_t descartados;
+
+static const char *const nomes[DIARIO_TIPOS] = {
+    [DIARIO_CADASTRO] = "cadastro",
+    [DIARIO_TEMPERATURA] = "temperatura",
+    [DIARIO_NIVEL] = "nivel",
+    [DIARIO_BUZZER] = "buzzer",
+    [DIARIO_COMANDO] = "comando",
+    [DIARIO_PERDIDOS] = "perdidos",
+};
+
+void diario_init(void) {
+    memset(filas, 0, sizeof(filas));
+    memset(perdidos_vistos, 0, sizeof(perdidos_vistos));
+    memset(entradas, 0, sizeof(entradas));
+    ultimo_seq = 0;
+    descartados = 0;
+}
+
+/**
+ * @brief Grava um evento no anel do núcleo atual, sem esperar pelo outro núcleo.
+ * @details O índice de escrita só avança depois da barreira, então task_diario
+ *          nunca lê um evento pela metade. Anel cheio: o evento é descartado.
+ */
+void diario_registrar(diario_tipo_t tipo, uint16_t setor, uint8_t dado, float celsius) {
+    diario_fila_t *f = &filas[hal_nucleo()];
+    uint32_t irq = hal_irq_bloquear(); // Exclusão contra as IRQs deste núcleo
+    uint32_t escrita = f->escrita;
+    if (escrita - f->leitura >= DIARIO_FILA) {
+        f->perdidos++;
+    } else {
+        diario_evento_t *e = &f->itens[escrita % DIARIO_FILA];
+        e->instante = (uint32_t)hal_tempo_us();
+        e->valor.celsius = celsius;
+        e->setor = setor;
+        e->tipo = (uint8_t)tipo;
+        e->dado = dado;
+        hal_barreira();
+        f->escrita = escrita + 1;
+    }
+    hal_irq_restaurar(irq);
+}
+
+// Acrescenta um evento ao diário, numerando-o
+static void diario_acrescentar(diario_evento_t *e) {
+    e->seq = ++ultimo_seq;
+    entradas[e->seq % DIARIO_ENTRADAS] = *e;
+}
+
+/**
+ * @brief Move para o diário os eventos gravados nos anéis, em ordem de tempo.
+ * @details Os anéis são lidos até o índice de escrita fixado no início, de modo
+ *          que a execução é limitada a DIARIO_NUCLEOS * DIARIO_FILA eventos.
+ *          Os instantes de 32 bits viram ms desde o boot em relação a `agora`,
+ *          lido depois dos índices (nenhum evento drenado é posterior a ele).
+ */
+void diario_drenar(void) {
+    uint32_t fim[DIARIO_NUCLEOS];
+    for (int n = 0; n < DIARIO_NUCLEOS; n++) fim[n] = filas[n].escrita;
+    hal_barreira();
+    uint64_t agora = hal_tempo_us();
+
+    for (int n = 0; n < DIARIO_NUCLEOS; n++) {
+        uint32_t perdidos = filas[n].perdidos;
+        if (perdidos != perdidos_vistos[n]) {
+            diario_evento_t e = {
+                .instante = (uint32_t)(agora / 1000u),
+                .valor.quantidade = perdidos - perdidos_vistos[n],
+                .setor = SETOR_INVALIDO,
+                .tipo = DIARIO_PERDIDOS,
+                .dado = (uint8_t)n,
+            };
+            descartados += e.valor.quantidade;
+            perdidos_vistos[n] = perdidos;
+            diario_acrescentar(&e);
+        }
+    }
+
+    for (;;) {
+        // Próximo evento: o mais antigo entre as cabeças dos anéis
+        diario_fila_t *escolhida = NULL;
+        for (int n = 0; n < DIARIO_NUCLEOS; n++) {
+            diario_fila_t *f = &filas[n];
+            if (f->leitura == fim[n]) continue;
+            if (!escolhida || (int32_t)(f->itens[f->leitura % DIARIO_FILA].instante -
+                                        escolhida->itens[escolhida->leitura % DIARIO_FILA].instante) < 0) {
+                escolhida = f;
+            }
+        }
+        if (!escolhida) break;
+        diario_evento_t e = escolhida->itens[escolhida->leitura % DIARIO_FILA];
+        hal_barreira(); // Cópia concluída antes de liberar a posição ao produtor
+        escolhida->leitura++;
+        uint64_t instante_us = agora - (uint32_t)((uint32_t)agora - e.instante);
+        e.instante = (uint32_t)(instante_us / 1000u);
+        diario_acrescentar(&e);
+    }
+}
+
+uint32_t diario_ultimo(void) {
+    return ultimo_seq;
+}
+
+uint32_t diario_primeiro(void) {
+    return ultimo_seq >= DIARIO_ENTRADAS ? ultimo_seq - DIARIO_ENTRADAS + 1 : 1;
+}
+
+/**
+ * @brief Copia o evento `seq`, se ele ainda está no diário.
+ */
+bool diario_ler(uint32_t seq, diario_evento_t *evento) {
+    if (seq == 0 || seq > ultimo_seq || seq < diario_primeiro()) return false;
+    *evento = entradas[seq % DIARIO_ENTRADAS];
+    return true;
+}
+
+uint32_t diario_descartados(void) {
+    return descartados;
+}
+
+const char *diario_nome(uint8_t tipo) {
+    return tipo < DIARIO_TIPOS ? nomes[tipo] : "?";
+}
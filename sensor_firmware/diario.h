@@ -0,0 +1,83 @@
+/**
+ * @file diario.h
+ * @brief Diário de eventos: registro sem trava em qualquer núcleo e leitura por número de sequência.
+ * @details Cadastros, temperaturas, mudanças de nível de alarme, buzzer e
+ *          comandos viram eventos estruturados (diario_evento_t), registrados
+ *          com diario_registrar() por qualquer núcleo ou handler de IRQ. O
+ *          registro só grava alguns campos: nada é formatado nem impresso.
+ *
+ *          Filas: o Cortex-M0+ não tem instruções atômicas (LDREX/STREX), então
+ *          a fila de vários produtores é um anel SPSC por núcleo. O produtor
+ *          nunca espera pelo outro núcleo; contra as IRQs do próprio núcleo, as
+ *          interrupções ficam bloqueadas durante a gravação (alguns ciclos).
+ *          Anel cheio: o evento é descartado e contado.
+ *
+ *          task_diario (núcleo 0) drena os anéis em ordem de tempo, numera os
+ *          eventos (seq crescente a partir de 1) e os guarda no diário, um anel
+ *          de DIARIO_ENTRADAS eventos; os mais antigos são sobrescritos. A
+ *          formatação é preguiçosa: o JSON só é gerado quando um cliente pede
+ *          GET /api/events?since=SEQ (http_server.h), no mesmo núcleo.
+ */
+
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DIARIO_NUCLEOS 2 // Um anel de registro por núcleo
+
+// Capacidades (potências de 2)
+#ifndef DIARIO_FILA
+#define DIARIO_FILA 64       // Eventos por núcleo aguardando task_diario
+#endif
+#ifndef DIARIO_ENTRADAS
+#define DIARIO_ENTRADAS 256  // Eventos guardados no diário (4 KB)
+#endif
+_Static_assert((DIARIO_FILA & (DIARIO_FILA - 1)) == 0, "DIARIO_FILA deve ser potência de 2");
+_Static_assert((DIARIO_ENTRADAS & (DIARIO_ENTRADAS - 1)) == 0, "DIARIO_ENTRADAS deve ser potência de 2");
+
+/**
+ * @enum diario_tipo_t
+ * @brief Tipos de evento e o significado de `dado` e `valor`.
+ */
+typedef enum {
+    DIARIO_CADASTRO,    // dado: 1 cadastrado, 0 descadastrado
+    DIARIO_TEMPERATURA, // valor.celsius: temperatura publicada (variação acima da histerese)
+    DIARIO_NIVEL,       // dado: novo nível (alarme_nivel_t); valor.celsius: temperatura
+    DIARIO_BUZZER,      // dado: 1 ligado, 0 desligado (sem setor)
+    DIARIO_COMANDO,     // dado: setor_cmd_tipo_t aplicado pelo núcleo 1; valor.celsius: valor do comando
+    DIARIO_PERDIDOS,    // valor.quantidade: eventos descartados por anel cheio (dado: núcleo)
+    DIARIO_TIPOS
+} diario_tipo_t;
+
+/**
+ * @struct diario_evento_t
+ * @brief Um evento (16 bytes), no anel de um núcleo ou no diário.
+ */
+typedef struct {
+    uint32_t seq;        // Posição no diário (0 enquanto está no anel do núcleo)
+    uint32_t instante;   // No anel: hal_tempo_us() em 32 bits; no diário: ms desde o boot
+    union {
+        float celsius;
+        uint32_t quantidade;
+    } valor;
+    uint16_t setor;      // SETOR_INVALIDO em eventos do sistema
+    uint8_t tipo;        // diario_tipo_t
+    uint8_t dado;        // Detalhe do tipo
+} diario_evento_t;
+
+void diario_init(void); // Antes de lançar o núcleo 1
+
+// Qualquer núcleo ou IRQ
+void diario_registrar(diario_tipo_t tipo, uint16_t setor, uint8_t dado, float celsius);
+
+// Núcleo 0
+void diario_drenar(void);                               // task_diario
+uint32_t diario_ultimo(void);                           // seq do evento mais recente (0 = nenhum)
+uint32_t diario_primeiro(void);                         // seq do mais antigo ainda guardado
+bool diario_ler(uint32_t seq, diario_evento_t *evento); // `false` se fora do diário
+uint32_t diario_descartados(void);                      // Eventos perdidos por anel cheio desde o boot
+const char *diario_nome(uint8_t tipo);                  // "cadastro", "temperatura", ...
+
+#endif
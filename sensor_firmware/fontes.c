@@ -0,0 +1,156 @@
+/**
+ * @file fontes.c
+ * @brief Sondas I2C, datagramas UDP e replay de arquivo como fontes de leituras.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal.h"
+#include "lwip/udp.h"
+#include "setores.h"
+#include "fontes.h"
+
+// ===== SONDAS I2C =====
+
+#define FONTE_I2C_REG_TEMPERATURA 0x00 // Registrador de temperatura do LM75/TMP102
+
+static bool fonte_i2c_ler(const fonte_i2c_t *f, uint8_t i, float *celsius) {
+    uint8_t bruto[2];
+    if (hal_i2c_ler(f->porta, f->sondas[i].endereco, FONTE_I2C_REG_TEMPERATURA, bruto, sizeof(bruto)) != 2) {
+        return false;
+    }
+    *celsius = (float)(int16_t)((bruto[0] << 8) | bruto[1]) / 256.0f;
+    return true;
+}
+
+/**
+ * @brief Verifica quais sondas respondem; sem nenhuma, a fonte não é registrada.
+ */
+bool fonte_i2c_iniciar(void *ctx, uint8_t fonte) {
+    fonte_i2c_t *f = ctx;
+    f->fonte = fonte;
+    f->presentes = 0;
+    f->proxima = 0;
+    f->proximo_ciclo_us = hal_tempo_us();
+    if (f->quantidade > FONTE_I2C_SONDAS_MAX) f->quantidade = FONTE_I2C_SONDAS_MAX;
+    for (uint8_t i = 0; i < f->quantidade; i++) {
+        float celsius;
+        if (fonte_i2c_ler(f, i, &celsius)) f->presentes |= (uint8_t)(1u << i);
+    }
+    return f->presentes != 0;
+}
+
+void fonte_i2c_coletar(void *ctx, uint64_t agora_us) {
+    fonte_i2c_t *f = ctx;
+    if (f->proxima == 0 && agora_us < f->proximo_ciclo_us) return;
+    for (; f->proxima < f->quantidade; f->proxima++) {
+        if (!(f->presentes & (1u << f->proxima))) continue;
+        if (hal_i2c_ocupado(f->porta)) return; // Quadro do OLED em envio: continua na próxima coleta
+        float celsius;
+        if (fonte_i2c_ler(f, f->proxima, &celsius)) {
+            ingestao_publicar(f->fonte, f->sondas[f->proxima].setor, celsius, hal_tempo_us());
+        }
+    }
+    f->proxima = 0;
+    f->proximo_ciclo_us += (uint64_t)f->periodo_ms * 1000u;
+    if (f->proximo_ciclo_us < agora_us) f->proximo_ciclo_us = agora_us; // Sem rajadas após um atraso
+}
+
+// ===== UDP =====
+
+// Converte "<setor 1-N> <°C>"; devolve o setor 0-based ou SETOR_INVALIDO (conta como inválida)
+static setor_id_t fonte_linha_leitura(char *linha, float *celsius) {
+    char *fim;
+    long setor = strtol(linha, &fim, 10);
+    if (fim == linha) return SETOR_INVALIDO;
+    linha = fim;
+    *celsius = strtof(linha, &fim);
+    if (fim == linha || setor < 1 || setor > MAX_SETORES) return SETOR_INVALIDO;
+    return (setor_id_t)(setor - 1);
+}
+
+/**
+ * @brief Callback do lwIP (núcleo 0): publica cada linha do datagrama.
+ */
+static void fonte_udp_receber(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    (void)pcb; (void)addr; (void)port;
+    fonte_udp_t *f = arg;
+    uint64_t agora = hal_tempo_us();
+    char texto[FONTE_UDP_DATAGRAMA_MAX + 1];
+    u16_t n = pbuf_copy_partial(p, texto, FONTE_UDP_DATAGRAMA_MAX, 0);
+    pbuf_free(p);
+    texto[n] = '\0';
+
+    for (char *linha = texto; *linha;) {
+        char *fim = strchr(linha, '\n');
+        if (fim) *fim = '\0';
+        if (strspn(linha, " \t\r") != strlen(linha)) { // Linhas em branco são ignoradas
+            float celsius = 0.0f;
+            setor_id_t setor = fonte_linha_leitura(linha, &celsius);
+            ingestao_publicar(f->fonte, setor, celsius, agora);
+        }
+        if (!fim) break;
+        linha = fim + 1;
+    }
+}
+
+bool fonte_udp_iniciar(void *ctx, uint8_t fonte) {
+    fonte_udp_t *f = ctx;
+    f->fonte = fonte;
+    hal_rede_bloquear();
+    f->pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    bool ok = f->pcb && udp_bind(f->pcb, IP_ANY_TYPE, f->porta) == ERR_OK;
+    if (ok) {
+        udp_recv(f->pcb, fonte_udp_receber, f);
+    } else if (f->pcb) {
+        udp_remove(f->pcb);
+        f->pcb = NULL;
+    }
+    hal_rede_liberar();
+    if (ok) printf("Leituras UDP na porta %u\n", (unsigned)f->porta);
+    return ok;
+}
+
+// ===== REPLAY =====
+
+// Lê a próxima linha válida; `false` no fim do arquivo
+static bool fonte_replay_proxima(fonte_replay_t *f) {
+    char linha[96];
+    while (fgets(linha, sizeof(linha), f->arquivo)) {
+        char *comentario = strchr(linha, '#');
+        if (comentario) *comentario = '\0';
+        char *fim;
+        unsigned long ms = strtoul(linha, &fim, 10);
+        if (fim == linha) continue; // Linha vazia ou só comentário
+        f->setor = fonte_linha_leitura(fim, &f->celsius);
+        f->ms = (uint32_t)ms;
+        return true;
+    }
+    return false;
+}
+
+bool fonte_replay_iniciar(void *ctx, uint8_t fonte) {
+    fonte_replay_t *f = ctx;
+    f->fonte = fonte;
+    f->arquivo = f->caminho ? fopen(f->caminho, "r") : NULL;
+    if (!f->arquivo) return false;
+    f->inicio_us = hal_tempo_us();
+    f->pendente = fonte_replay_proxima(f);
+    printf("Replay de leituras: %s\n", f->caminho);
+    return true;
+}
+
+void fonte_replay_coletar(void *ctx, uint64_t agora_us) {
+    fonte_replay_t *f = ctx;
+    for (int n = 0; f->pendente && n < FONTE_REPLAY_LOTE; n++) {
+        uint64_t instante = f->inicio_us + (uint64_t)f->ms * 1000u;
+        if (instante > agora_us) return;
+        ingestao_publicar(f->fonte, f->setor, f->celsius, instante);
+        f->pendente = fonte_replay_proxima(f);
+    }
+    if (!f->pendente && f->arquivo) {
+        fclose(f->arquivo); // Fim do arquivo: a fonte fica inativa
+        f->arquivo = NULL;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file fontes.h
+ * @brief Fontes de leituras dos setores para o módulo de ingestão.
+ * @details Cada fonte é um contexto (preenchido com a configuração) mais as
+ *          funções de ingestao_fonte_t; FONTE_*(ctx) monta o descritor:
+ *          - sondas I2C: sensores LM75/TMP102 (temperatura em 2 bytes,
+ *            complemento de 2, 1/256 °C por LSB) no barramento do OLED, um por
+ *            setor, lidos a cada `periodo_ms`. Só as sondas que respondem no
+ *            início são lidas; se o barramento está ocupado com um quadro do
+ *            OLED, a leitura fica para a próxima coleta;
+ *          - UDP: nós remotos enviam datagramas com uma leitura por linha,
+ *            "<setor 1-N> <°C>\n" (N = MAX_SETORES) (ex.: `echo "7 31.5" | nc -u -w0 <ip> 5005`);
+ *            a leitura é carimbada na chegada;
+ *          - replay: arquivo de texto com linhas "<ms> <setor 1-N> <°C>"
+ *            (ms crescentes, a partir do início; '#' inicia um comentário),
+ *            reproduzido no ritmo gravado. Depende de um sistema de arquivos,
+ *            então só tem efeito no build de host.
+ */
+
+#ifndef FONTES_H
+#define FONTES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "hal.h"
+#include "ingestao.h"
+
+// ===== SONDAS I2C =====
+#define FONTE_I2C_SONDAS_MAX 8 // Endereços 0x48-0x4F do LM75/TMP102
+
+typedef struct {
+    uint8_t endereco;   // Endereço I2C de 7 bits
+    setor_id_t setor;   // Índice do setor (0 a MAX_SETORES - 1)
+} fonte_i2c_sonda_t;
+
+typedef struct {
+    uint porta;
+    const fonte_i2c_sonda_t *sondas;
+    uint8_t quantidade;
+    uint32_t periodo_ms;
+    // Estado (preenchido pela fonte)
+    uint8_t fonte;
+    uint8_t presentes;          // Bit i: sondas[i] respondeu no início
+    uint8_t proxima;            // Próxima sonda do ciclo em andamento
+    uint64_t proximo_ciclo_us;
+} fonte_i2c_t;
+
+bool fonte_i2c_iniciar(void *ctx, uint8_t fonte);
+void fonte_i2c_coletar(void *ctx, uint64_t agora_us);
+#define FONTE_I2C(ctx) ((ingestao_fonte_t){ "i2c", fonte_i2c_iniciar, fonte_i2c_coletar, (ctx) })
+
+// ===== UDP =====
+#define FONTE_UDP_DATAGRAMA_MAX 512 // Bytes considerados de cada datagrama
+
+struct udp_pcb;
+
+typedef struct {
+    uint16_t porta;
+    // Estado (preenchido pela fonte)
+    uint8_t fonte;
+    struct udp_pcb *pcb;
+} fonte_udp_t;
+
+bool fonte_udp_iniciar(void *ctx, uint8_t fonte);
+#define FONTE_UDP(ctx) ((ingestao_fonte_t){ "udp", fonte_udp_iniciar, NULL, (ctx) })
+
+// ===== REPLAY =====
+#define FONTE_REPLAY_LOTE 32 // Linhas vencidas publicadas por coleta (não inunda a fila)
+
+typedef struct {
+    const char *caminho;
+    // Estado (preenchido pela fonte)
+    uint8_t fonte;
+    FILE *arquivo;
+    uint64_t inicio_us;
+    bool pendente;              // Há uma linha lida aguardando seu instante
+    uint32_t ms;
+    setor_id_t setor;
+    float celsius;
+} fonte_replay_t;
+
+bool fonte_replay_iniciar(void *ctx, uint8_t fonte);
+void fonte_replay_coletar(void *ctx, uint64_t agora_us);
+#define FONTE_REPLAY(ctx) ((ingestao_fonte_t){ "replay", fonte_replay_iniciar, fonte_replay_coletar, (ctx) })
+
+#endif
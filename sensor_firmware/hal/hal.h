@@ -0,0 +1,148 @@
+/**
+ * @file hal.h
+ * @brief Camada de abstração de hardware (HAL) do AgroGraf.
+ * @details A lógica do firmware (modelo de setores, alarme, servidor HTTP,
+ *          menu serial e escalonador) usa apenas as funções abaixo. Há duas
+ *          implementações, escolhidas pelo CMakeLists.txt:
+ *          - hal/pico/hal_pico.c: RP2040/Pico W (pico-sdk, PIO, PWM, CYW43);
+ *          - hal/host/hal_host.c: Linux, com periféricos simulados (hal_sim.h)
+ *            e o núcleo 1 executado em uma thread.
+ *          A rede TCP segue a API raw do lwIP ("lwip/tcp.h"): no Pico é o
+ *          próprio lwIP; no host, hal/host/lwip é um shim sobre sockets POSIX.
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hal_plataforma.h" // Tipos da plataforma (uint, _u, count_of, hal_fila_t)
+
+// ===== TEMPO =====
+uint64_t hal_tempo_us(void);                  // Microssegundos desde o boot
+void hal_dormir_ms(uint32_t ms);              // Espera bloqueante (somente na inicialização)
+void hal_aguardar_ate_us(uint64_t instante);  // Dorme até o instante (pode acordar antes)
+
+// ===== CONTADOR DE CICLOS (BENCHMARK) =====
+void hal_ciclos_init(void);                   // Prepara o contador (SysTick no Pico)
+uint32_t hal_ciclos(void);                    // Contador crescente, com HAL_CICLOS_MASCARA bits válidos
+uint32_t hal_ciclos_por_us(void);             // Resolução: ciclos do clk_sys no Pico, ns no host
+
+// Intervalo entre duas leituras de hal_ciclos(), tratando o estouro do contador
+static inline uint32_t hal_ciclos_delta(uint32_t inicio, uint32_t fim) {
+    return (fim - inicio) & HAL_CICLOS_MASCARA;
+}
+
+// ===== CONSOLE (MENU SERIAL) =====
+void hal_console_init(void);
+int hal_console_ler(void);                    // Próximo caractere ou -1, sem bloquear
+
+// ===== NÚCLEOS E COMUNICAÇÃO ENTRE ELES =====
+void hal_nucleo1_iniciar(void (*entrada)(void));
+uint hal_nucleo(void);                        // Núcleo que executa a chamada (0 ou 1)
+void hal_barreira(void);                      // Barreira de memória entre os núcleos
+void hal_fila_init(hal_fila_t *fila, size_t tamanho_item, unsigned capacidade);
+bool hal_fila_adicionar(hal_fila_t *fila, const void *item); // `false` se cheia
+bool hal_fila_remover(hal_fila_t *fila, void *item);         // `false` se vazia
+
+// ===== INTERRUPÇÕES =====
+// Seção crítica contra os callbacks de IRQ da HAL no núcleo atual (aninhável)
+uint32_t hal_irq_bloquear(void);
+void hal_irq_restaurar(uint32_t estado);
+
+// ===== GPIO =====
+void hal_gpio_entrada_pullup(uint pino);
+bool hal_gpio_ler(uint pino);
+
+// ===== ADC =====
+void hal_adc_init(void);
+void hal_adc_pino(uint pino);                 // Prepara um pino como entrada analógica
+void hal_adc_sensor_temperatura(bool habilitar);
+uint16_t hal_adc_ler(uint canal);             // Leitura de 12 bits do canal (4 = sensor interno)
+
+// Aquisição contínua: o ADC percorre em rodízio os canais da máscara (em ordem
+// crescente) e o DMA grava as amostras do FIFO em um anel, sem a CPU. A amostra
+// k fica em anel[k % HAL_ADC_ANEL_AMOSTRAS]. Com ela ativa, hal_adc_ler não deve
+// ser usada. O anel é lido apenas pelo núcleo que iniciou a aquisição.
+#define HAL_ADC_ANEL_AMOSTRAS 256 // Potência de 2 (o DMA usa o modo anel do endereço de escrita)
+bool hal_adc_continuo_iniciar(uint32_t mascara_canais, uint32_t amostras_por_segundo);
+const volatile uint16_t *hal_adc_continuo_anel(void);
+uint32_t hal_adc_continuo_total(void);        // Amostras gravadas desde o início (módulo 2^32)
+
+// ===== MATRIZ DE LEDS WS2812B (PIO + DMA) =====
+// Palavra de um LED no formato consumido pelo PIO: G, R, B alinhados à esquerda
+#define HAL_LEDS_GRB(r, g, b) (((uint32_t)(g) << 24) | ((uint32_t)(r) << 16) | ((uint32_t)(b) << 8))
+
+// Chamado em contexto de IRQ quando a transferência e o reset do WS2812B
+// terminaram; pode iniciar a próxima transferência
+typedef void (*hal_leds_concluido_t)(void *ctx);
+
+bool hal_leds_init(uint pino, hal_leds_concluido_t concluido, void *ctx);
+// Inicia o envio por DMA sem bloquear; `palavras` deve permanecer intacto até
+// o callback de conclusão. `false` se outra transferência está em andamento.
+bool hal_leds_enviar(const uint32_t *palavras, size_t quantidade);
+bool hal_leds_ocupado(void);
+
+// ===== I2C (DISPLAY OLED) =====
+#define HAL_I2C_LOTE_MAX 1152 // Bytes de um lote assíncrono (tela inteira + comandos das janelas)
+
+// Trecho de um lote: `fim` encerra a transação (STOP); o trecho seguinte abre outra
+typedef struct {
+    const uint8_t *dados;
+    size_t tamanho;
+    bool fim;
+} hal_i2c_trecho_t;
+
+// Chamado em contexto de IRQ ao fim do lote (ou por hal_i2c_ocupado, com as IRQs
+// bloqueadas, se o lote passou do prazo); `sucesso` é false se faltou ACK ou expirou
+typedef void (*hal_i2c_concluido_t)(void *ctx, bool sucesso);
+
+void hal_i2c_init(uint porta, uint32_t frequencia_hz, uint sda, uint scl);
+// Escrita bloqueante; aguarda o fim de um lote em andamento. As esperas têm prazo
+// pelo número de bytes e pelo clock da porta: estourado, a porta é reiniciada e
+// a chamada retorna negativo
+int hal_i2c_escrever(uint porta, uint8_t endereco, const uint8_t *dados, size_t tamanho);
+// Inicia o envio por DMA de uma sequência de transações e retorna sem esperar.
+// Os trechos são copiados para o buffer do DMA antes do retorno, então podem ser
+// alterados em seguida. `false` se há um lote em andamento ou se excede HAL_I2C_LOTE_MAX.
+bool hal_i2c_escrever_lote(uint porta, uint8_t endereco, const hal_i2c_trecho_t *trechos, size_t quantidade,
+                           hal_i2c_concluido_t concluido, void *ctx);
+bool hal_i2c_ocupado(uint porta);
+// Leitura bloqueante de `tamanho` bytes a partir de `registrador` (escrita do
+// ponteiro com repeated START). Aguarda o fim de um lote em andamento.
+// Bytes lidos ou negativo se o dispositivo não respondeu.
+int hal_i2c_ler(uint porta, uint8_t endereco, uint8_t registrador, uint8_t *dados, size_t tamanho);
+
+// ===== BUZZER (PWM, ~2 kHz) =====
+void hal_buzzer_init(uint pino);
+void hal_buzzer_nivel(uint pino, uint8_t nivel); // 0 = desligado, 128 = 50%
+
+// ===== FLASH (PERSISTÊNCIA) =====
+// Região reservada no fim da flash, fora do programa. Offsets relativos ao seu início.
+// A leitura é direta pelo ponteiro devolvido; apagar/programar param o outro
+// núcleo e as interrupções durante a operação (até dezenas de ms ao apagar).
+#define HAL_FLASH_SETOR 4096  // Menor unidade apagável (bytes voltam a 0xFF)
+#define HAL_FLASH_PAGINA 256  // Unidade de programação (bits só passam de 1 para 0)
+
+const uint8_t *hal_flash_regiao(uint32_t tamanho); // NULL se a região invadir o programa
+bool hal_flash_apagar(uint32_t offset);            // Um setor, alinhado a HAL_FLASH_SETOR
+bool hal_flash_programar(uint32_t offset, const uint8_t *pagina); // Uma página alinhada
+void hal_flash_nucleo_init(void);                  // Chamada pelo outro núcleo para poder ser pausado
+
+// ===== REDE =====
+// Estados do link (mesmos valores de CYW43_LINK_*)
+#define HAL_REDE_LINK_DOWN 0
+#define HAL_REDE_LINK_UP 3
+
+int hal_rede_iniciar(void);                   // 0 se o rádio foi inicializado
+int hal_rede_conectar(const char *ssid, const char *senha, uint32_t timeout_ms); // 0 se conectou
+bool hal_rede_ip(char *texto, size_t tamanho); // `true` se há endereço IP válido
+int hal_rede_link(void);                      // HAL_REDE_LINK_*; negativo em falha
+void hal_rede_led(bool aceso);                // LED de status (LED do CYW43 no Pico W)
+void hal_rede_poll(void);                     // Processa a pilha de rede
+void hal_rede_bloquear(void);                 // Acesso à pilha fora dos callbacks
+void hal_rede_liberar(void);
+void hal_rede_encerrar(void);
+
+#endif
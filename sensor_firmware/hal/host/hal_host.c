@@ -0,0 +1,752 @@
+/**
+ * @file hal_host.c
+ * @brief Implementação da HAL para o build de host (Linux), com periféricos simulados.
+ * @details O núcleo 1 roda em uma thread; botões, joystick e sensor interno
+ *          retornam valores ajustáveis por hal_sim.h; as IRQs de fim de DMA são
+ *          alarmes executados por uma thread própria; a matriz de LEDs guarda o
+ *          último quadro; o OLED é um modelo do SSD1306 que interpreta o fluxo
+ *          I2C (bytes de controle, comandos e janela de endereçamento) e mantém
+ *          uma cópia da GDDRAM. A rede usa o shim lwIP sobre sockets (lwip_shim.c).
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "lwip/tcp.h"
+#include "hal.h"
+#include "hal_sim.h"
+
+// ===== TEMPO =====
+
+static struct timespec hal_inicio;
+static pthread_once_t hal_inicio_once = PTHREAD_ONCE_INIT;
+
+static void hal_marcar_inicio(void) {
+    clock_gettime(CLOCK_MONOTONIC, &hal_inicio);
+}
+
+uint64_t hal_tempo_us(void) {
+    pthread_once(&hal_inicio_once, hal_marcar_inicio);
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (uint64_t)(agora.tv_sec - hal_inicio.tv_sec) * 1000000u +
+           (uint64_t)((agora.tv_nsec - hal_inicio.tv_nsec) / 1000);
+}
+
+void hal_dormir_ms(uint32_t ms) {
+    struct timespec t = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&t, &t) != 0 && errno == EINTR) {}
+}
+
+void hal_aguardar_ate_us(uint64_t instante) {
+    uint64_t agora = hal_tempo_us();
+    if (instante <= agora) return;
+    uint64_t espera = instante - agora;
+    struct timespec t = { .tv_sec = (time_t)(espera / 1000000u), .tv_nsec = (long)(espera % 1000000u) * 1000L };
+    nanosleep(&t, NULL); // Um sinal apenas acorda antes, como o WFE no Pico
+}
+
+// ===== CONTADOR DE CICLOS =====
+
+void hal_ciclos_init(void) {
+    pthread_once(&hal_inicio_once, hal_marcar_inicio);
+}
+
+uint32_t hal_ciclos(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (uint32_t)((uint64_t)agora.tv_sec * 1000000000u + (uint64_t)agora.tv_nsec);
+}
+
+uint32_t hal_ciclos_por_us(void) {
+    return 1000; // Um "ciclo" do host é um nanossegundo
+}
+
+// ===== CONSOLE =====
+
+void hal_console_init(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    hal_tempo_us(); // Fixa o instante do "boot"
+}
+
+int hal_console_ler(void) {
+    struct pollfd p = { .fd = STDIN_FILENO, .events = POLLIN };
+    if (poll(&p, 1, 0) <= 0 || !(p.revents & (POLLIN | POLLHUP))) return -1;
+    unsigned char c;
+    return read(STDIN_FILENO, &c, 1) == 1 ? c : -1; // EOF: o menu apenas deixa de receber linhas
+}
+
+// ===== NÚCLEOS =====
+
+static _Thread_local uint hal_nucleo_atual; // 1 na thread do núcleo 1; IRQs simuladas contam como núcleo 0
+
+static void *hal_nucleo1_thread(void *arg) {
+    void (*entrada)(void) = (void (*)(void))arg;
+    hal_nucleo_atual = 1;
+    entrada();
+    return NULL;
+}
+
+void hal_nucleo1_iniciar(void (*entrada)(void)) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, hal_nucleo1_thread, (void *)entrada) != 0) {
+        perror("hal_nucleo1_iniciar");
+        exit(1);
+    }
+    pthread_detach(thread);
+}
+
+uint hal_nucleo(void) {
+    return hal_nucleo_atual;
+}
+
+void hal_barreira(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void hal_fila_init(hal_fila_t *fila, size_t tamanho_item, unsigned capacidade) {
+    pthread_mutex_init(&fila->trava, NULL);
+    fila->itens = calloc(capacidade, tamanho_item);
+    fila->tamanho_item = tamanho_item;
+    fila->capacidade = capacidade;
+    fila->inicio = 0;
+    fila->quantidade = 0;
+}
+
+bool hal_fila_adicionar(hal_fila_t *fila, const void *item) {
+    pthread_mutex_lock(&fila->trava);
+    bool ok = fila->quantidade < fila->capacidade;
+    if (ok) {
+        unsigned pos = (fila->inicio + fila->quantidade) % fila->capacidade;
+        memcpy(fila->itens + (size_t)pos * fila->tamanho_item, item, fila->tamanho_item);
+        fila->quantidade++;
+    }
+    pthread_mutex_unlock(&fila->trava);
+    return ok;
+}
+
+bool hal_fila_remover(hal_fila_t *fila, void *item) {
+    pthread_mutex_lock(&fila->trava);
+    bool ok = fila->quantidade > 0;
+    if (ok) {
+        memcpy(item, fila->itens + (size_t)fila->inicio * fila->tamanho_item, fila->tamanho_item);
+        fila->inicio = (fila->inicio + 1) % fila->capacidade;
+        fila->quantidade--;
+    }
+    pthread_mutex_unlock(&fila->trava);
+    return ok;
+}
+
+// ===== INTERRUPÇÕES SIMULADAS =====
+// Uma thread executa os alarmes simulados (fim de DMA e afins) segurando
+// sim_irq_trava. hal_irq_bloquear() toma a mesma trava, o que reproduz a
+// exclusão entre as tarefas e os handlers de IRQ do RP2040.
+
+#define SIM_ALARMES_MAX 4 // Como os 4 alarmes do timer do RP2040
+
+typedef struct {
+    void (*funcao)(void);  // "Handler" executado no instante
+    uint64_t instante_us;  // Em hal_tempo_us()
+    bool armado;
+} sim_alarme_t;
+
+static pthread_mutex_t sim_irq_trava;
+static pthread_mutex_t sim_alarmes_trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_alarmes_cond;
+static sim_alarme_t *sim_alarmes[SIM_ALARMES_MAX];
+static unsigned sim_alarmes_qtd;
+static pthread_once_t sim_irq_once = PTHREAD_ONCE_INIT;
+
+static void *sim_irq_thread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&sim_alarmes_trava);
+    for (;;) {
+        sim_alarme_t *proximo = NULL;
+        for (unsigned i = 0; i < sim_alarmes_qtd; i++) {
+            sim_alarme_t *a = sim_alarmes[i];
+            if (a->armado && (!proximo || a->instante_us < proximo->instante_us)) proximo = a;
+        }
+        if (!proximo) {
+            pthread_cond_wait(&sim_alarmes_cond, &sim_alarmes_trava);
+            continue;
+        }
+        if (proximo->instante_us > hal_tempo_us()) {
+            uint64_t ns = (uint64_t)hal_inicio.tv_nsec + proximo->instante_us * 1000u;
+            struct timespec prazo = { .tv_sec = hal_inicio.tv_sec + (time_t)(ns / 1000000000u),
+                                      .tv_nsec = (long)(ns % 1000000000u) };
+            pthread_cond_timedwait(&sim_alarmes_cond, &sim_alarmes_trava, &prazo);
+            continue; // Reavalia: o alarme pode ter sido reagendado
+        }
+        proximo->armado = false;
+        pthread_mutex_unlock(&sim_alarmes_trava);
+        pthread_mutex_lock(&sim_irq_trava);
+        proximo->funcao();
+        pthread_mutex_unlock(&sim_irq_trava);
+        pthread_mutex_lock(&sim_alarmes_trava);
+    }
+    return NULL;
+}
+
+static void sim_irq_iniciar(void) {
+    pthread_mutexattr_t ma;
+    pthread_mutexattr_init(&ma);
+    pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE); // Bloqueios aninhados, como no Pico
+    pthread_mutex_init(&sim_irq_trava, &ma);
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&sim_alarmes_cond, &ca);
+    hal_tempo_us(); // Fixa hal_inicio antes de a thread calcular prazos
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, sim_irq_thread, NULL) != 0) {
+        perror("sim_irq_iniciar");
+        exit(1);
+    }
+    pthread_detach(thread);
+}
+
+static void sim_alarme_registrar(sim_alarme_t *alarme, void (*funcao)(void)) {
+    pthread_once(&sim_irq_once, sim_irq_iniciar);
+    pthread_mutex_lock(&sim_alarmes_trava);
+    alarme->funcao = funcao;
+    alarme->armado = false;
+    assert(sim_alarmes_qtd < SIM_ALARMES_MAX);
+    sim_alarmes[sim_alarmes_qtd++] = alarme;
+    pthread_mutex_unlock(&sim_alarmes_trava);
+}
+
+static void sim_alarme_agendar(sim_alarme_t *alarme, uint64_t instante_us) {
+    pthread_mutex_lock(&sim_alarmes_trava);
+    alarme->instante_us = instante_us;
+    alarme->armado = true;
+    pthread_cond_signal(&sim_alarmes_cond);
+    pthread_mutex_unlock(&sim_alarmes_trava);
+}
+
+uint32_t hal_irq_bloquear(void) {
+    pthread_once(&sim_irq_once, sim_irq_iniciar);
+    pthread_mutex_lock(&sim_irq_trava);
+    return 0;
+}
+
+void hal_irq_restaurar(uint32_t estado) {
+    (void)estado;
+    pthread_mutex_unlock(&sim_irq_trava);
+}
+
+// ===== GPIO E ADC SIMULADOS =====
+
+#define HAL_SIM_PINOS 30
+#define HAL_SIM_CANAIS_ADC 5
+
+static volatile bool sim_gpio[HAL_SIM_PINOS];
+static volatile bool sim_pullup[HAL_SIM_PINOS];
+static volatile bool sim_gpio_forcado[HAL_SIM_PINOS];
+static volatile uint16_t sim_adc[HAL_SIM_CANAIS_ADC] = { 2048, 2048, 0, 0, 881 }; // Joystick centrado, ~25 °C
+
+void hal_gpio_entrada_pullup(uint pino) {
+    if (pino < HAL_SIM_PINOS) sim_pullup[pino] = true;
+}
+
+bool hal_gpio_ler(uint pino) {
+    if (pino >= HAL_SIM_PINOS) return false;
+    return sim_gpio_forcado[pino] ? sim_gpio[pino] : sim_pullup[pino]; // Botão solto: nível alto
+}
+
+void hal_sim_gpio(uint pino, bool nivel) {
+    if (pino >= HAL_SIM_PINOS) return;
+    sim_gpio[pino] = nivel;
+    sim_gpio_forcado[pino] = true;
+}
+
+void hal_adc_init(void) {}
+void hal_adc_pino(uint pino) { (void)pino; }
+void hal_adc_sensor_temperatura(bool habilitar) { (void)habilitar; }
+
+uint16_t hal_adc_ler(uint canal) {
+    return canal < HAL_SIM_CANAIS_ADC ? sim_adc[canal] : 0;
+}
+
+// Aquisição contínua: o anel é preenchido sob demanda, quando o consumidor lê o
+// total, com as amostras que o ADC teria convertido desde a última leitura
+// (valor simulado do canal + ruído de ±2 LSB, para que a média tenha efeito)
+static pthread_mutex_t sim_adc_trava = PTHREAD_MUTEX_INITIALIZER;
+static uint16_t sim_adc_anel[HAL_ADC_ANEL_AMOSTRAS];
+static uint8_t sim_adc_ordem[HAL_SIM_CANAIS_ADC]; // Canais do rodízio em ordem crescente
+static uint sim_adc_qtd_canais;
+static uint sim_adc_proximo;    // Posição em sim_adc_ordem da próxima conversão
+static uint32_t sim_adc_total;
+static uint64_t sim_adc_inicio_us;
+static uint64_t sim_adc_convertidas; // Conversões desde o início (inclui as puladas)
+static uint32_t sim_adc_taxa;
+static uint32_t sim_adc_ruido = 1;
+
+bool hal_adc_continuo_iniciar(uint32_t mascara_canais, uint32_t amostras_por_segundo) {
+    if (mascara_canais == 0 || amostras_por_segundo == 0 || sim_adc_taxa != 0) return false;
+    for (uint c = 0; c < HAL_SIM_CANAIS_ADC; c++) {
+        if (mascara_canais & (1u << c)) sim_adc_ordem[sim_adc_qtd_canais++] = (uint8_t)c;
+    }
+    sim_adc_inicio_us = hal_tempo_us();
+    sim_adc_taxa = amostras_por_segundo;
+    return sim_adc_qtd_canais > 0;
+}
+
+const volatile uint16_t *hal_adc_continuo_anel(void) {
+    return sim_adc_anel;
+}
+
+uint32_t hal_adc_continuo_total(void) {
+    if (sim_adc_taxa == 0) return 0;
+    pthread_mutex_lock(&sim_adc_trava);
+    uint64_t devidas = (hal_tempo_us() - sim_adc_inicio_us) * sim_adc_taxa / 1000000u;
+    uint64_t pendentes = devidas - sim_adc_convertidas;
+    if (pendentes > HAL_ADC_ANEL_AMOSTRAS) {
+        // As mais antigas seriam sobrescritas no anel: só avança a posição
+        uint64_t puladas = pendentes - HAL_ADC_ANEL_AMOSTRAS;
+        sim_adc_total += (uint32_t)puladas;
+        sim_adc_proximo = (uint)((sim_adc_proximo + puladas) % sim_adc_qtd_canais);
+        pendentes = HAL_ADC_ANEL_AMOSTRAS;
+    }
+    for (uint64_t i = 0; i < pendentes; i++) {
+        sim_adc_ruido = sim_adc_ruido * 1103515245u + 12345u;
+        int valor = sim_adc[sim_adc_ordem[sim_adc_proximo]] + (int)((sim_adc_ruido >> 16) % 5u) - 2;
+        sim_adc_anel[sim_adc_total % HAL_ADC_ANEL_AMOSTRAS] = (uint16_t)(valor < 0 ? 0 : valor > 4095 ? 4095 : valor);
+        sim_adc_total++;
+        if (++sim_adc_proximo == sim_adc_qtd_canais) sim_adc_proximo = 0;
+    }
+    sim_adc_convertidas = devidas;
+    uint32_t total = sim_adc_total;
+    pthread_mutex_unlock(&sim_adc_trava);
+    return total;
+}
+
+void hal_sim_adc(uint canal, uint16_t valor) {
+    if (canal < HAL_SIM_CANAIS_ADC) sim_adc[canal] = valor & 0x0FFFu;
+}
+
+void hal_sim_temperatura(float celsius) {
+    // Inverso da fórmula do datasheet: V = 0,706 - (T - 27) * 0,001721
+    float v = 0.706f - (celsius - 27.0f) * 0.001721f;
+    float bruto = v * 4096.0f / 3.3f + 0.5f;
+    hal_sim_adc(4, bruto < 0.0f ? 0 : bruto > 4095.0f ? 4095 : (uint16_t)bruto);
+}
+
+// ===== MATRIZ DE LEDS SIMULADA =====
+
+static pthread_mutex_t sim_leds_trava = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t sim_leds[HAL_SIM_LEDS_MAX];
+static size_t sim_leds_qtd;
+static hal_sim_contadores_t sim_contadores;
+static sim_alarme_t sim_leds_alarme;       // Fim do quadro no fio + reset
+static volatile bool sim_leds_ocupado;
+static hal_leds_concluido_t sim_leds_concluido;
+static void *sim_leds_concluido_ctx;
+
+static void sim_leds_fim(void) {
+    sim_leds_ocupado = false;
+    if (sim_leds_concluido) sim_leds_concluido(sim_leds_concluido_ctx);
+}
+
+bool hal_leds_init(uint pino, hal_leds_concluido_t concluido, void *ctx) {
+    (void)pino;
+    sim_leds_concluido = concluido;
+    sim_leds_concluido_ctx = ctx;
+    sim_alarme_registrar(&sim_leds_alarme, sim_leds_fim);
+    return true;
+}
+
+/**
+ * @brief Captura o quadro e agenda a "IRQ" de conclusão para quando o quadro
+ *        real terminaria: 30 us por LED mais 300 us de reset.
+ */
+bool hal_leds_enviar(const uint32_t *palavras, size_t quantidade) {
+    if (sim_leds_ocupado) return false;
+    sim_leds_ocupado = true;
+    if (quantidade > HAL_SIM_LEDS_MAX) quantidade = HAL_SIM_LEDS_MAX;
+    pthread_mutex_lock(&sim_leds_trava);
+    for (size_t i = 0; i < quantidade; i++) sim_leds[i] = palavras[i] >> 8; // 0x00GGRRBB
+    sim_leds_qtd = quantidade;
+    sim_contadores.quadros_leds++;
+    pthread_mutex_unlock(&sim_leds_trava);
+    sim_alarme_agendar(&sim_leds_alarme, hal_tempo_us() + quantidade * 30u + 300u);
+    return true;
+}
+
+bool hal_leds_ocupado(void) {
+    return sim_leds_ocupado;
+}
+
+size_t hal_sim_leds(uint32_t *grb, size_t maximo) {
+    pthread_mutex_lock(&sim_leds_trava);
+    size_t n = sim_leds_qtd < maximo ? sim_leds_qtd : maximo;
+    memcpy(grb, sim_leds, n * sizeof grb[0]);
+    pthread_mutex_unlock(&sim_leds_trava);
+    return n;
+}
+
+// ===== SSD1306 SIMULADO (I2C) =====
+
+#define SSD1306_ENDERECO 0x3C
+
+/**
+ * @struct sim_oled_t
+ * @brief Estado do controlador SSD1306 relevante para a GDDRAM.
+ */
+typedef struct {
+    uint8_t gddram[HAL_SIM_OLED_PAGINAS][HAL_SIM_OLED_LARGURA];
+    uint8_t modo;                 // 0 = horizontal, 1 = vertical, 2 = página
+    uint8_t col_ini, col_fim, col;
+    uint8_t pag_ini, pag_fim, pag;
+    uint8_t cmd;                  // Comando aguardando parâmetros
+    uint8_t params[6];
+    uint8_t params_faltando;
+    uint8_t params_lidos;
+} sim_oled_t;
+
+static sim_oled_t sim_oled = { .col_fim = HAL_SIM_OLED_LARGURA - 1, .pag_fim = HAL_SIM_OLED_PAGINAS - 1 };
+
+// Quantidade de bytes de parâmetro de cada comando de múltiplos bytes
+static uint8_t sim_oled_num_params(uint8_t cmd) {
+    switch (cmd) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+        case 0x21: case 0x22: case 0xA3: return 2;
+        case 0x29: case 0x2A: return 5;
+        case 0x26: case 0x27: return 6;
+        default: return 0;
+    }
+}
+
+static void sim_oled_executar(sim_oled_t *o) {
+    switch (o->cmd) {
+        case 0x20: o->modo = o->params[0] & 0x03; break;
+        case 0x21:
+            o->col_ini = o->params[0] & 0x7F; o->col_fim = o->params[1] & 0x7F;
+            o->col = o->col_ini;
+            break;
+        case 0x22:
+            o->pag_ini = o->params[0] & 0x07; o->pag_fim = o->params[1] & 0x07;
+            o->pag = o->pag_ini;
+            break;
+        default: break;
+    }
+}
+
+static void sim_oled_comando(sim_oled_t *o, uint8_t b) {
+    if (o->params_faltando) {
+        o->params[o->params_lidos++] = b;
+        if (--o->params_faltando == 0) sim_oled_executar(o);
+        return;
+    }
+    o->cmd = b;
+    o->params_lidos = 0;
+    o->params_faltando = sim_oled_num_params(b);
+    if (o->modo == 2) {
+        // Endereçamento por página: B0..B7 seleciona a página, 00..1F a coluna
+        if (b >= 0xB0 && b <= 0xB7) o->pag = b & 0x07;
+        else if (b <= 0x0F) o->col = (uint8_t)((o->col & 0xF0) | b);
+        else if (b <= 0x1F) o->col = (uint8_t)((o->col & 0x0F) | ((b & 0x0F) << 4));
+    }
+}
+
+static void sim_oled_dado(sim_oled_t *o, uint8_t b) {
+    o->gddram[o->pag & 0x07][o->col & 0x7F] = b;
+    sim_contadores.bytes_gddram++;
+    if (o->modo == 2) {
+        if (o->col < HAL_SIM_OLED_LARGURA - 1) o->col++;
+    } else if (o->modo == 1) {
+        if (o->pag++ >= o->pag_fim) {
+            o->pag = o->pag_ini;
+            o->col = o->col >= o->col_fim ? o->col_ini : o->col + 1;
+        }
+    } else if (o->col++ >= o->col_fim) {
+        o->col = o->col_ini;
+        o->pag = o->pag >= o->pag_fim ? o->pag_ini : o->pag + 1;
+    }
+}
+
+// Uma transação completa (START, endereço, bytes, STOP) chegando ao barramento
+static int sim_i2c_transacao(uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    sim_contadores.transacoes_i2c++;
+    sim_contadores.bytes_i2c += (uint32_t)tamanho;
+    if (endereco != SSD1306_ENDERECO) return -1; // Sem ACK: nenhum outro dispositivo no barramento
+
+    // Cada byte de controle tem Co (bit 7) e D/C (bit 6). Com Co = 1 apenas o
+    // próximo byte segue esse controle; com Co = 0 todo o resto da transação.
+    size_t i = 0;
+    while (i < tamanho) {
+        uint8_t controle = dados[i++];
+        bool dado = controle & 0x40;
+        size_t fim = (controle & 0x80) ? (i + 1 < tamanho ? i + 1 : tamanho) : tamanho;
+        for (; i < fim; i++) {
+            if (dado) sim_oled_dado(&sim_oled, dados[i]);
+            else sim_oled_comando(&sim_oled, dados[i]);
+        }
+    }
+    return (int)tamanho;
+}
+
+// Lote assíncrono: copiado no início e aplicado à GDDRAM quando a "IRQ" de
+// conclusão dispara, no instante em que o último STOP sairia no fio real
+static uint8_t sim_i2c_lote[HAL_I2C_LOTE_MAX];
+static size_t sim_i2c_fins[HAL_I2C_LOTE_MAX]; // Posição após o último byte de cada transação
+static size_t sim_i2c_transacoes;
+static uint8_t sim_i2c_endereco;
+static uint32_t sim_i2c_hz = 400000;
+static sim_alarme_t sim_i2c_alarme;
+static volatile bool sim_i2c_ocupado;
+static hal_i2c_concluido_t sim_i2c_concluido;
+static void *sim_i2c_concluido_ctx;
+
+static void sim_i2c_fim(void) {
+    bool sucesso = true;
+    for (size_t t = 0, inicio = 0; t < sim_i2c_transacoes; inicio = sim_i2c_fins[t++]) {
+        if (sim_i2c_transacao(sim_i2c_endereco, sim_i2c_lote + inicio, sim_i2c_fins[t] - inicio) < 0) {
+            sucesso = false; // Sem ACK: o RP2040 descarta o resto do FIFO
+            break;
+        }
+    }
+    sim_i2c_ocupado = false;
+    if (sim_i2c_concluido) sim_i2c_concluido(sim_i2c_concluido_ctx, sucesso);
+}
+
+void hal_i2c_init(uint porta, uint32_t frequencia_hz, uint sda, uint scl) {
+    (void)porta; (void)sda; (void)scl;
+    static bool registrado;
+    if (!registrado) sim_alarme_registrar(&sim_i2c_alarme, sim_i2c_fim);
+    registrado = true;
+    sim_i2c_hz = frequencia_hz;
+}
+
+int hal_i2c_escrever(uint porta, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    while (hal_i2c_ocupado(porta)) hal_dormir_ms(0); // Não intercala com um lote
+    return sim_i2c_transacao(endereco, dados, tamanho);
+}
+
+/**
+ * @brief Copia o lote e agenda a conclusão pelo tempo que ele levaria no fio:
+ *        9 bits por byte (8 + ACK), mais o endereço de cada transação.
+ */
+bool hal_i2c_escrever_lote(uint porta, uint8_t endereco, const hal_i2c_trecho_t *trechos, size_t quantidade,
+                           hal_i2c_concluido_t concluido, void *ctx) {
+    (void)porta;
+    if (sim_i2c_ocupado) return false;
+    size_t n = 0, transacoes = 0;
+    for (size_t t = 0; t < quantidade; t++) {
+        if (trechos[t].tamanho > HAL_I2C_LOTE_MAX - n) return false;
+        memcpy(sim_i2c_lote + n, trechos[t].dados, trechos[t].tamanho);
+        n += trechos[t].tamanho;
+        if (trechos[t].fim && n > 0 && (transacoes == 0 || sim_i2c_fins[transacoes - 1] < n)) {
+            sim_i2c_fins[transacoes++] = n;
+        }
+    }
+    if (n == 0) return false;
+    if (transacoes == 0 || sim_i2c_fins[transacoes - 1] < n) sim_i2c_fins[transacoes++] = n;
+
+    sim_i2c_ocupado = true;
+    sim_i2c_transacoes = transacoes;
+    sim_i2c_endereco = endereco;
+    sim_i2c_concluido = concluido;
+    sim_i2c_concluido_ctx = ctx;
+    uint64_t bits = (uint64_t)(n + transacoes) * 9u;
+    sim_alarme_agendar(&sim_i2c_alarme, hal_tempo_us() + bits * 1000000u / sim_i2c_hz);
+    return true;
+}
+
+bool hal_i2c_ocupado(uint porta) {
+    (void)porta;
+    return sim_i2c_ocupado;
+}
+
+// Sondas LM75/TMP102 (0x48-0x4F): o registrador 0 devolve a temperatura em
+// complemento de 2, 1/256 °C por LSB, MSB primeiro
+#define SIM_SONDA_ENDERECO 0x48
+#define SIM_SONDAS 8
+
+static volatile bool sim_sonda_presente[SIM_SONDAS];
+static volatile int16_t sim_sonda_valor[SIM_SONDAS];
+
+void hal_sim_sonda_i2c(uint8_t endereco, bool presente, float celsius) {
+    if (endereco < SIM_SONDA_ENDERECO || endereco >= SIM_SONDA_ENDERECO + SIM_SONDAS) return;
+    float bruto = celsius * 256.0f;
+    sim_sonda_valor[endereco - SIM_SONDA_ENDERECO] =
+        (int16_t)(bruto < -32768.0f ? -32768.0f : bruto > 32767.0f ? 32767.0f : bruto);
+    sim_sonda_presente[endereco - SIM_SONDA_ENDERECO] = presente;
+}
+
+int hal_i2c_ler(uint porta, uint8_t endereco, uint8_t registrador, uint8_t *dados, size_t tamanho) {
+    while (hal_i2c_ocupado(porta)) hal_dormir_ms(0);
+    uint8_t i = (uint8_t)(endereco - SIM_SONDA_ENDERECO);
+    if (endereco < SIM_SONDA_ENDERECO || i >= SIM_SONDAS || !sim_sonda_presente[i]) return -1; // Sem ACK
+    uint16_t valor = (uint16_t)sim_sonda_valor[i];
+    for (size_t b = 0; b < tamanho; b++) {
+        // Registrador 0: dois bytes que se repetem; os demais leem como zero
+        dados[b] = registrador == 0 ? (uint8_t)(b % 2 == 0 ? valor >> 8 : valor) : 0;
+    }
+    return (int)tamanho;
+}
+
+const uint8_t *hal_sim_oled_gddram(void) {
+    return &sim_oled.gddram[0][0];
+}
+
+void hal_sim_oled_imprimir(FILE *saida) {
+    // Duas linhas de pixels por caractere para manter a proporção no terminal
+    for (int y = 0; y < HAL_SIM_OLED_PAGINAS * 8; y += 2) {
+        char linha[HAL_SIM_OLED_LARGURA + 2];
+        for (int x = 0; x < HAL_SIM_OLED_LARGURA; x++) {
+            bool cima = sim_oled.gddram[y / 8][x] & (1u << (y % 8));
+            bool baixo = sim_oled.gddram[(y + 1) / 8][x] & (1u << ((y + 1) % 8));
+            linha[x] = cima && baixo ? '#' : cima ? '"' : baixo ? '.' : ' ';
+        }
+        linha[HAL_SIM_OLED_LARGURA] = '|';
+        linha[HAL_SIM_OLED_LARGURA + 1] = '\0';
+        fprintf(saida, "%s\n", linha);
+    }
+}
+
+void hal_sim_contadores(hal_sim_contadores_t *c, bool zerar) {
+    pthread_mutex_lock(&sim_leds_trava);
+    *c = sim_contadores;
+    if (zerar) memset(&sim_contadores, 0, sizeof sim_contadores);
+    pthread_mutex_unlock(&sim_leds_trava);
+}
+
+// ===== BUZZER SIMULADO =====
+
+static volatile uint8_t sim_buzzer;
+
+void hal_buzzer_init(uint pino) {
+    (void)pino;
+    sim_buzzer = 0;
+}
+
+void hal_buzzer_nivel(uint pino, uint8_t nivel) {
+    (void)pino;
+    sim_buzzer = nivel;
+}
+
+uint8_t hal_sim_buzzer(void) {
+    return sim_buzzer;
+}
+
+// ===== FLASH SIMULADA (RAM, OPCIONALMENTE EM ARQUIVO) =====
+// Com AGROGRAF_FLASH=<arquivo>, a região é carregada do arquivo e cada
+// operação é gravada nele: o estado sobrevive entre execuções do host.
+
+static uint8_t *sim_flash;
+static uint32_t sim_flash_tamanho;
+static FILE *sim_flash_arquivo;
+static bool sim_flash_interromper;
+
+// Grava no arquivo o trecho alterado da região
+static void sim_flash_salvar(uint32_t offset, uint32_t tamanho) {
+    if (!sim_flash_arquivo) return;
+    if (fseek(sim_flash_arquivo, (long)offset, SEEK_SET) == 0) {
+        fwrite(sim_flash + offset, 1, tamanho, sim_flash_arquivo);
+        fflush(sim_flash_arquivo);
+    }
+}
+
+const uint8_t *hal_flash_regiao(uint32_t tamanho) {
+    if (tamanho == 0 || tamanho % HAL_FLASH_SETOR) return NULL;
+    if (sim_flash) return tamanho == sim_flash_tamanho ? sim_flash : NULL;
+    sim_flash = malloc(tamanho);
+    if (!sim_flash) return NULL;
+    memset(sim_flash, 0xFF, tamanho); // Flash apagada
+    sim_flash_tamanho = tamanho;
+
+    const char *caminho = getenv("AGROGRAF_FLASH");
+    if (caminho) {
+        sim_flash_arquivo = fopen(caminho, "r+b");
+        if (sim_flash_arquivo) {
+            size_t lidos = fread(sim_flash, 1, tamanho, sim_flash_arquivo);
+            if (lidos < tamanho) sim_flash_salvar((uint32_t)lidos, tamanho - (uint32_t)lidos);
+        } else {
+            sim_flash_arquivo = fopen(caminho, "w+b");
+            if (!sim_flash_arquivo) perror("AGROGRAF_FLASH");
+            sim_flash_salvar(0, tamanho);
+        }
+    }
+    return sim_flash;
+}
+
+bool hal_flash_apagar(uint32_t offset) {
+    if (!sim_flash || offset % HAL_FLASH_SETOR || offset >= sim_flash_tamanho) return false;
+    memset(sim_flash + offset, 0xFF, HAL_FLASH_SETOR);
+    sim_flash_salvar(offset, HAL_FLASH_SETOR);
+    return true;
+}
+
+bool hal_flash_programar(uint32_t offset, const uint8_t *pagina) {
+    if (!sim_flash || offset % HAL_FLASH_PAGINA || offset >= sim_flash_tamanho) return false;
+    uint32_t limite = HAL_FLASH_PAGINA;
+    if (sim_flash_interromper) {
+        // Para antes do primeiro byte da segunda metade dos que mudariam
+        sim_flash_interromper = false;
+        uint32_t mudam = 0, vistos = 0;
+        for (uint32_t i = 0; i < HAL_FLASH_PAGINA; i++) {
+            mudam += (sim_flash[offset + i] & pagina[i]) != sim_flash[offset + i];
+        }
+        for (limite = 0; limite < HAL_FLASH_PAGINA; limite++) {
+            if ((sim_flash[offset + limite] & pagina[limite]) == sim_flash[offset + limite]) continue;
+            if (vistos++ == mudam / 2) break;
+        }
+    }
+    for (uint32_t i = 0; i < limite; i++) {
+        sim_flash[offset + i] &= pagina[i]; // Como na NOR: programar só zera bits
+    }
+    sim_flash_salvar(offset, HAL_FLASH_PAGINA);
+    return true;
+}
+
+void hal_flash_nucleo_init(void) {
+}
+
+void hal_sim_flash_interromper(void) {
+    sim_flash_interromper = true;
+}
+
+uint8_t *hal_sim_flash(void) {
+    return sim_flash;
+}
+
+// ===== REDE (SOCKETS DO SISTEMA) =====
+
+int hal_rede_iniciar(void) {
+    return 0;
+}
+
+int hal_rede_conectar(const char *ssid, const char *senha, uint32_t timeout_ms) {
+    (void)ssid; (void)senha; (void)timeout_ms;
+    return 0; // A rede do host já está disponível
+}
+
+bool hal_rede_ip(char *texto, size_t tamanho) {
+    snprintf(texto, tamanho, "127.0.0.1:%u", (unsigned)tcp_shim_porta(80));
+    return true;
+}
+
+int hal_rede_link(void) {
+    return HAL_REDE_LINK_UP;
+}
+
+void hal_rede_led(bool aceso) {
+    (void)aceso;
+}
+
+void hal_rede_poll(void) {
+    tcp_shim_poll(0);
+}
+
+void hal_rede_bloquear(void) {}
+void hal_rede_liberar(void) {}
+
+void hal_rede_encerrar(void) {}
@@ -0,0 +1,37 @@
+/**
+ * @file hal_plataforma.h
+ * @brief Tipos da HAL para o build de host (Linux).
+ * @details Reproduz os tipos e macros do pico-sdk usados pela lógica do firmware.
+ */
+
+#ifndef HAL_PLATAFORMA_H
+#define HAL_PLATAFORMA_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x ## u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define HAL_PLATAFORMA "host" // Identifica a plataforma (ex.: na saída do benchmark)
+
+#define HAL_CICLOS_MASCARA 0xFFFFFFFFu // Nanossegundos em 32 bits (~4,3 s)
+
+/**
+ * @struct hal_fila_t
+ * @brief Fila circular protegida por mutex (equivalente ao queue_t do pico-sdk).
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    uint8_t *itens;
+    size_t tamanho_item;
+    unsigned capacidade;
+    unsigned inicio;
+    unsigned quantidade;
+} hal_fila_t;
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file hal_sim.h
+ * @brief Controle e inspeção dos periféricos simulados do build de host.
+ * @details Permite a testes, benchmarks e ao menu de simulação injetar entradas
+ *          (botões, joystick, temperatura) e observar as saídas (quadro da
+ *          matriz de LEDs, GDDRAM do SSD1306, nível do buzzer).
+ */
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "hal.h"
+
+#define HAL_SIM_LEDS_MAX 256
+#define HAL_SIM_OLED_LARGURA 128
+#define HAL_SIM_OLED_PAGINAS 8
+
+/**
+ * @struct hal_sim_contadores_t
+ * @brief Tráfego observado nos barramentos simulados.
+ */
+typedef struct {
+    uint32_t quadros_leds;       // Transferências iniciadas por hal_leds_enviar
+    uint32_t transacoes_i2c;     // Chamadas a hal_i2c_escrever
+    uint32_t bytes_i2c;          // Bytes transmitidos (incluindo bytes de controle)
+    uint32_t bytes_gddram;       // Bytes de dados gravados na GDDRAM do OLED
+} hal_sim_contadores_t;
+
+// ===== ENTRADAS =====
+void hal_sim_gpio(uint pino, bool nivel);                // Nível lido por hal_gpio_ler
+void hal_sim_adc(uint canal, uint16_t valor);            // Valor lido por hal_adc_ler
+void hal_sim_temperatura(float celsius);                 // Ajusta o canal 4 para a temperatura
+void hal_sim_sonda_i2c(uint8_t endereco, bool presente, float celsius); // Sonda LM75 em 0x48-0x4F
+
+// ===== FALHAS =====
+// Queda de energia durante a próxima hal_flash_programar: só a primeira metade
+// dos bytes que a página mudaria é gravada
+void hal_sim_flash_interromper(void);
+uint8_t *hal_sim_flash(void);                            // Região da flash (NULL antes de hal_flash_regiao)
+
+// ===== SAÍDAS =====
+size_t hal_sim_leds(uint32_t *grb, size_t maximo);       // Último quadro enviado à matriz (0x00GGRRBB)
+const uint8_t *hal_sim_oled_gddram(void);                // 8 páginas x 128 colunas
+void hal_sim_oled_imprimir(FILE *saida);                 // Desenho ASCII da GDDRAM
+uint8_t hal_sim_buzzer(void);                            // Nível PWM atual
+void hal_sim_contadores(hal_sim_contadores_t *c, bool zerar);
+
+#endif
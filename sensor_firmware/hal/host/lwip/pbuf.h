@@ -0,0 +1,33 @@
+/**
+ * @file pbuf.h
+ * @brief Shim de host: subconjunto de pbufs do lwIP usado pelo firmware.
+ * @details Mesma semântica do lwIP (cadeia via `next`, `tot_len`, contagem de
+ *          referências), com cada pbuf alocado no heap do sistema.
+ */
+
+#ifndef AGROGRAF_SHIM_LWIP_PBUF_H
+#define AGROGRAF_SHIM_LWIP_PBUF_H
+
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;   // Soma de `len` deste pbuf e dos seguintes
+    u16_t len;       // Bytes em `payload`
+    u8_t ref;
+};
+
+struct pbuf *pbuf_shim_alloc(u16_t len); // Usado apenas pelo shim TCP
+u8_t pbuf_free(struct pbuf *p);
+void pbuf_ref(struct pbuf *p);
+void pbuf_cat(struct pbuf *head, struct pbuf *tail);
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#endif
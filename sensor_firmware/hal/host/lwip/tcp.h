@@ -0,0 +1,85 @@
+/**
+ * @file tcp.h
+ * @brief Shim de host: API raw TCP do lwIP sobre sockets POSIX não bloqueantes.
+ * @details Permite compilar e executar http_server.c sem alterações no Linux.
+ *          Preserva os contratos usados pelo servidor:
+ *          - tcp_write copia os dados e respeita TCP_SND_BUF/TCP_SND_QUEUELEN
+ *            (ERR_MEM quando cheio); tcp_output envia ao kernel;
+ *          - o callback `sent` é chamado depois, fora de tcp_write/tcp_output;
+ *          - a recepção para quando TCP_WND bytes aguardam tcp_recved;
+ *          - FIN é entregue ao callback `recv` com p == NULL;
+ *          - `poll` é chamado a cada intervalo * 500 ms;
+ *          - tcp_abort envia RST, chama `err` com ERR_ABRT e nunca libera o
+ *            pcb dentro do callback em execução.
+ *          Toda a pilha roda no thread de tcp_shim_poll() (núcleo 0).
+ */
+
+#ifndef AGROGRAF_SHIM_LWIP_TCP_H
+#define AGROGRAF_SHIM_LWIP_TCP_H
+
+#include <stdint.h>
+#include "lwipopts.h"
+#include "lwip/pbuf.h"
+
+// ===== ERROS (valores do lwIP) =====
+#define ERR_OK          0
+#define ERR_MEM        -1
+#define ERR_BUF        -2
+#define ERR_TIMEOUT    -3
+#define ERR_RTE        -4
+#define ERR_INPROGRESS -5
+#define ERR_VAL        -6
+#define ERR_WOULDBLOCK -7
+#define ERR_USE        -8
+#define ERR_ALREADY    -9
+#define ERR_ISCONN    -10
+#define ERR_CONN      -11
+#define ERR_IF        -12
+#define ERR_ABRT      -13
+#define ERR_RST       -14
+#define ERR_CLSD      -15
+#define ERR_ARG       -16
+
+// ===== ENDEREÇOS =====
+typedef struct {
+    u32_t addr;
+} ip_addr_t;
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ANY_TYPE (&ip_addr_any)
+#define IPADDR_TYPE_ANY 46U
+
+// ===== PCB E CALLBACKS =====
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb *tcp_new_ip_type(u8_t type);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb);
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb);
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb);
+
+// ===== EXCLUSIVO DO SHIM =====
+void tcp_shim_poll(int timeout_ms);   // Atende sockets e callbacks (equivale a cyw43_arch_poll)
+u16_t tcp_shim_porta(u16_t porta);    // Porta real usada no host para a porta pedida
+
+#endif
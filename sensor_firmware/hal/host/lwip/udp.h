@@ -0,0 +1,25 @@
+/**
+ * @file udp.h
+ * @brief Shim de host: API raw UDP do lwIP sobre sockets POSIX não bloqueantes.
+ * @details Cada datagrama recebido vira um pbuf único entregue ao callback
+ *          `recv`, que passa a ser o dono do pbuf. Os callbacks são chamados
+ *          dentro de tcp_shim_poll(), junto com os do TCP (núcleo 0).
+ */
+
+#ifndef AGROGRAF_SHIM_LWIP_UDP_H
+#define AGROGRAF_SHIM_LWIP_UDP_H
+
+#include "lwip/tcp.h" // Erros, ip_addr_t e pbufs compartilhados com o shim TCP
+
+#define MEMP_NUM_UDP_PCB 4 // Padrão do lwIP (o DHCP do Pico usa um)
+
+struct udp_pcb;
+
+typedef void (*udp_recv_fn)(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+
+struct udp_pcb *udp_new_ip_type(u8_t type);
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg);
+void udp_remove(struct udp_pcb *pcb);
+
+#endif
@@ -0,0 +1,499 @@
+/**
+ * @file lwip_shim.c
+ * @brief API raw TCP e UDP do lwIP implementada sobre sockets POSIX (build de host).
+ * @details Cada pcb guarda um buffer de envio de TCP_SND_BUF bytes. Os
+ *          callbacks da aplicação são chamados apenas dentro de tcp_shim_poll(),
+ *          como o lwIP faz dentro de cyw43_arch_poll(); pcbs fechados ou
+ *          abortados só são liberados no fim do ciclo de polling, então um
+ *          callback que aborta o próprio pcb nunca deixa ponteiros inválidos.
+ *          O número de pcbs vivos respeita MEMP_NUM_TCP_PCB, como no Pico:
+ *          conexões excedentes aguardam no backlog do kernel.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#undef TCP_MSS              // O do lwipopts.h prevalece
+#include "hal.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+
+#define SHIM_PRAZO_FECHAMENTO_US 5000000u // Limite para o par confirmar o FIN após tcp_close
+#define SHIM_LEITURA_MAX 2048             // Bytes lidos do socket por pbuf
+
+const ip_addr_t ip_addr_any = { 0 };
+
+/**
+ * @struct tcp_pcb
+ * @brief Conexão (ou socket de escuta) com o estado que o lwIP manteria.
+ */
+struct tcp_pcb {
+    int fd;
+    bool escuta;
+    bool morto;            // Liberado no fim do ciclo de polling
+    bool fechando;         // tcp_close: envia o restante, depois FIN
+    bool fin_enviado;
+    bool fin_recebido;
+    err_t erro_pendente;   // Erro do socket a entregar ao callback `err`
+    uint64_t prazo_fechamento_us;
+
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_poll_fn poll;
+    tcp_err_fn err;
+    u8_t poll_intervalo;   // Em unidades de 500 ms (0 = sem poll)
+    uint64_t proximo_poll_us;
+
+    uint8_t envio[TCP_SND_BUF];
+    size_t envio_len;
+    size_t fim_escritas[TCP_SND_QUEUELEN]; // Fim de cada tcp_write ainda no buffer
+    unsigned num_escritas;
+    uint32_t enviados;     // Bytes aceitos pelo kernel ainda não informados via `sent`
+    uint32_t recebidos;    // Bytes entregues à aplicação ainda sem tcp_recved
+
+    struct tcp_pcb *proximo;
+};
+
+static struct tcp_pcb *pcbs;
+
+// ===== PBUFS =====
+
+struct pbuf *pbuf_shim_alloc(u16_t len) {
+    struct pbuf *p = malloc(sizeof *p + len);
+    if (!p) return NULL;
+    p->next = NULL;
+    p->payload = p + 1;
+    p->len = p->tot_len = len;
+    p->ref = 1;
+    return p;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    u8_t liberados = 0;
+    while (p && --p->ref == 0) {
+        struct pbuf *seguinte = p->next;
+        free(p);
+        liberados++;
+        p = seguinte;
+    }
+    return liberados;
+}
+
+void pbuf_ref(struct pbuf *p) {
+    if (p) p->ref++;
+}
+
+void pbuf_cat(struct pbuf *head, struct pbuf *tail) {
+    struct pbuf *p = head;
+    for (; p->next; p = p->next) p->tot_len += tail->tot_len;
+    p->tot_len += tail->tot_len;
+    p->next = tail;
+}
+
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size) {
+    while (q && size) {
+        if (size >= q->len) {
+            // Remove o pbuf inteiro; a referência da cadeia passa ao seguinte
+            struct pbuf *seguinte = q->next;
+            size -= q->len;
+            q->next = NULL;
+            pbuf_free(q);
+            q = seguinte;
+        } else {
+            q->payload = (uint8_t *)q->payload + size;
+            q->len -= size;
+            q->tot_len -= size;
+            size = 0;
+        }
+    }
+    return q;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+    u16_t copiados = 0;
+    for (; p && copiados < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        u16_t n = (u16_t)(p->len - offset);
+        if (n > len - copiados) n = (u16_t)(len - copiados);
+        memcpy((uint8_t *)dataptr + copiados, (const uint8_t *)p->payload + offset, n);
+        copiados += n;
+        offset = 0;
+    }
+    return copiados;
+}
+
+// ===== PCBS =====
+
+static unsigned shim_pcbs_vivos(void) {
+    unsigned n = 0;
+    for (struct tcp_pcb *p = pcbs; p; p = p->proximo) n += !p->morto;
+    return n;
+}
+
+static struct tcp_pcb *shim_novo(int fd) {
+    struct tcp_pcb *pcb = calloc(1, sizeof *pcb);
+    if (!pcb) return NULL;
+    pcb->fd = fd;
+    pcb->proximo = pcbs;
+    pcbs = pcb;
+    return pcb;
+}
+
+static void shim_destruir(struct tcp_pcb *pcb, bool rst) {
+    if (pcb->fd >= 0) {
+        if (rst) {
+            struct linger l = { .l_onoff = 1, .l_linger = 0 };
+            setsockopt(pcb->fd, SOL_SOCKET, SO_LINGER, &l, sizeof l);
+        }
+        close(pcb->fd);
+        pcb->fd = -1;
+    }
+    pcb->morto = true;
+}
+
+u16_t tcp_shim_porta(u16_t porta) {
+    const char *env = getenv("AGROGRAF_PORTA");
+    if (env && *env) return (u16_t)atoi(env);
+    return porta < 1024 ? (u16_t)(porta + 8000) : porta; // Sem privilégios: 80 -> 8080
+}
+
+struct tcp_pcb *tcp_new_ip_type(u8_t type) {
+    (void)type;
+    return shim_novo(-1);
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void)ipaddr;
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return ERR_MEM;
+    int um = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof um);
+    struct sockaddr_in endereco = {
+        .sin_family = AF_INET,
+        .sin_port = htons(tcp_shim_porta(port)),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof endereco) != 0) {
+        perror("tcp_bind");
+        close(fd);
+        return ERR_USE;
+    }
+    pcb->fd = fd;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    if (pcb->fd < 0 || listen(pcb->fd, 16) != 0) return NULL;
+    pcb->escuta = true;
+    return pcb;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) { pcb->arg = arg; }
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) { pcb->accept = accept; }
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) { pcb->recv = recv; }
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) { pcb->sent = sent; }
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) { pcb->err = err; }
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+    pcb->poll = poll;
+    pcb->poll_intervalo = interval;
+    pcb->proximo_poll_us = hal_tempo_us() + (uint64_t)interval * 500000u;
+}
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+    return (u16_t)(TCP_SND_BUF - pcb->envio_len);
+}
+
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb) {
+    return (u16_t)pcb->num_escritas;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+    (void)apiflags; // Sempre copia: válido também para quem pediu NOCOPY
+    if (pcb->morto || pcb->fechando || pcb->fd < 0) return ERR_CONN;
+    if (len == 0) return ERR_OK;
+    if (len > TCP_SND_BUF - pcb->envio_len || pcb->num_escritas >= TCP_SND_QUEUELEN) return ERR_MEM;
+    memcpy(pcb->envio + pcb->envio_len, dataptr, len);
+    pcb->envio_len += len;
+    pcb->fim_escritas[pcb->num_escritas++] = pcb->envio_len;
+    return ERR_OK;
+}
+
+static void shim_consumir_envio(struct tcp_pcb *pcb, size_t n) {
+    memmove(pcb->envio, pcb->envio + n, pcb->envio_len - n);
+    pcb->envio_len -= n;
+    unsigned restantes = 0;
+    for (unsigned i = 0; i < pcb->num_escritas; i++) {
+        if (pcb->fim_escritas[i] > n) pcb->fim_escritas[restantes++] = pcb->fim_escritas[i] - n;
+    }
+    pcb->num_escritas = restantes;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+    while (!pcb->morto && pcb->fd >= 0 && pcb->envio_len > 0) {
+        ssize_t n = send(pcb->fd, pcb->envio, pcb->envio_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            shim_consumir_envio(pcb, (size_t)n);
+            pcb->enviados += (uint32_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                pcb->erro_pendente = ERR_RST; // Entregue no próximo tcp_shim_poll
+            }
+            break;
+        }
+    }
+    return ERR_OK;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+    pcb->recebidos = len > pcb->recebidos ? 0 : pcb->recebidos - len;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    if (pcb->morto) return ERR_OK;
+    if (pcb->escuta || pcb->fd < 0) {
+        shim_destruir(pcb, false);
+        return ERR_OK;
+    }
+    pcb->fechando = true;
+    pcb->prazo_fechamento_us = hal_tempo_us() + SHIM_PRAZO_FECHAMENTO_US;
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    if (pcb->morto) return;
+    tcp_err_fn err = pcb->err;
+    void *arg = pcb->arg;
+    shim_destruir(pcb, true);
+    if (err) err(arg, ERR_ABRT);
+}
+
+// ===== UDP =====
+
+struct udp_pcb {
+    int fd;
+    udp_recv_fn recv;
+    void *arg;
+};
+
+static struct udp_pcb udp_pcbs[MEMP_NUM_UDP_PCB];
+static bool udp_em_uso[MEMP_NUM_UDP_PCB];
+
+struct udp_pcb *udp_new_ip_type(u8_t type) {
+    (void)type;
+    for (int i = 0; i < MEMP_NUM_UDP_PCB; i++) {
+        if (!udp_em_uso[i]) {
+            udp_em_uso[i] = true;
+            udp_pcbs[i] = (struct udp_pcb){ .fd = -1 };
+            return &udp_pcbs[i];
+        }
+    }
+    return NULL;
+}
+
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void)ipaddr;
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return ERR_MEM;
+    struct sockaddr_in endereco = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof endereco) != 0) {
+        perror("udp_bind");
+        close(fd);
+        return ERR_USE;
+    }
+    pcb->fd = fd;
+    return ERR_OK;
+}
+
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg) {
+    pcb->recv = recv;
+    pcb->arg = recv_arg;
+}
+
+void udp_remove(struct udp_pcb *pcb) {
+    if (pcb->fd >= 0) close(pcb->fd);
+    pcb->fd = -1;
+    udp_em_uso[pcb - udp_pcbs] = false;
+}
+
+static void shim_udp_receber(struct udp_pcb *pcb) {
+    uint8_t buffer[SHIM_LEITURA_MAX];
+    for (;;) {
+        struct sockaddr_in origem;
+        socklen_t tamanho = sizeof origem;
+        ssize_t n = recvfrom(pcb->fd, buffer, sizeof buffer, MSG_DONTWAIT, (struct sockaddr *)&origem, &tamanho);
+        if (n < 0) return; // EAGAIN: nada mais a ler
+        struct pbuf *p = pbuf_shim_alloc((u16_t)n);
+        if (!p) return;
+        memcpy(p->payload, buffer, (size_t)n);
+        ip_addr_t endereco = { .addr = origem.sin_addr.s_addr };
+        if (pcb->recv) pcb->recv(pcb->arg, pcb, p, &endereco, ntohs(origem.sin_port));
+        else pbuf_free(p);
+        if (pcb->fd < 0) return; // Removido pelo callback
+    }
+}
+
+// ===== CICLO DE POLLING =====
+
+static void shim_aceitar(struct tcp_pcb *escuta) {
+    while (shim_pcbs_vivos() < MEMP_NUM_TCP_PCB) {
+        int fd = accept4(escuta->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        int um = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof um);
+        struct tcp_pcb *pcb = shim_novo(fd);
+        if (!pcb) {
+            close(fd);
+            return;
+        }
+        pcb->arg = escuta->arg;
+        err_t r = escuta->accept ? escuta->accept(escuta->arg, pcb, ERR_OK) : ERR_VAL;
+        if (r != ERR_OK && r != ERR_ABRT) tcp_abort(pcb);
+    }
+}
+
+static void shim_receber(struct tcp_pcb *pcb) {
+    uint8_t buffer[SHIM_LEITURA_MAX];
+    if (pcb->fechando) {
+        // Após tcp_close a aplicação não recebe mais dados: apenas aguarda o FIN do par
+        ssize_t n = recv(pcb->fd, buffer, sizeof buffer, MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            pcb->fin_recebido = true;
+        }
+        return;
+    }
+    if (pcb->fin_recebido || pcb->recebidos >= TCP_WND) return;
+
+    size_t espaco = TCP_WND - pcb->recebidos;
+    ssize_t n = recv(pcb->fd, buffer, espaco < sizeof buffer ? espaco : sizeof buffer, MSG_DONTWAIT);
+    if (n > 0) {
+        struct pbuf *p = pbuf_shim_alloc((u16_t)n);
+        if (!p) return;
+        memcpy(p->payload, buffer, (size_t)n);
+        pcb->recebidos += (uint32_t)n;
+        if (pcb->recv) {
+            pcb->recv(pcb->arg, pcb, p, ERR_OK);
+        } else {
+            tcp_recved(pcb, (u16_t)n);
+            pbuf_free(p);
+        }
+    } else if (n == 0) {
+        pcb->fin_recebido = true;
+        if (pcb->recv) pcb->recv(pcb->arg, pcb, NULL, ERR_OK);
+        else tcp_close(pcb);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        pcb->erro_pendente = ERR_RST;
+    }
+}
+
+static void shim_falhar(struct tcp_pcb *pcb) {
+    tcp_err_fn err = pcb->fechando ? NULL : pcb->err;
+    void *arg = pcb->arg;
+    err_t erro = pcb->erro_pendente;
+    shim_destruir(pcb, true);
+    if (err) err(arg, erro);
+}
+
+static void shim_callbacks(struct tcp_pcb *pcb, uint64_t agora) {
+    if (pcb->erro_pendente != ERR_OK) {
+        shim_falhar(pcb);
+        return;
+    }
+    if (pcb->fechando) {
+        if (pcb->envio_len == 0 && !pcb->fin_enviado) {
+            shutdown(pcb->fd, SHUT_WR);
+            pcb->fin_enviado = true;
+        }
+        if ((pcb->fin_enviado && pcb->fin_recebido) || agora >= pcb->prazo_fechamento_us) {
+            shim_destruir(pcb, false);
+        }
+        return;
+    }
+    if (pcb->enviados > 0) {
+        u16_t n = pcb->enviados > 0xFFFFu ? 0xFFFFu : (u16_t)pcb->enviados;
+        pcb->enviados -= n;
+        if (pcb->sent) pcb->sent(pcb->arg, pcb, n);
+        if (pcb->morto || pcb->fechando) return;
+    }
+    if (pcb->poll && pcb->poll_intervalo && agora >= pcb->proximo_poll_us) {
+        pcb->proximo_poll_us = agora + (uint64_t)pcb->poll_intervalo * 500000u;
+        pcb->poll(pcb->arg, pcb);
+    }
+}
+
+void tcp_shim_poll(int timeout_ms) {
+    struct pollfd fds[MEMP_NUM_TCP_PCB + 4 + MEMP_NUM_UDP_PCB];
+    struct tcp_pcb *alvos[MEMP_NUM_TCP_PCB + 4];
+    struct udp_pcb *alvos_udp[MEMP_NUM_UDP_PCB];
+    nfds_t n = 0, n_udp = 0;
+
+    for (struct tcp_pcb *p = pcbs; p && n < count_of(alvos); p = p->proximo) {
+        if (p->morto || p->fd < 0) continue;
+        short eventos = 0;
+        if (p->escuta) eventos = POLLIN;
+        else {
+            if (!p->fin_recebido && (p->fechando || p->recebidos < TCP_WND)) eventos |= POLLIN;
+            if (p->envio_len > 0) eventos |= POLLOUT;
+        }
+        fds[n] = (struct pollfd){ .fd = p->fd, .events = eventos };
+        alvos[n++] = p;
+    }
+    for (int i = 0; i < MEMP_NUM_UDP_PCB; i++) {
+        if (!udp_em_uso[i] || udp_pcbs[i].fd < 0) continue;
+        fds[n + n_udp] = (struct pollfd){ .fd = udp_pcbs[i].fd, .events = POLLIN };
+        alvos_udp[n_udp++] = &udp_pcbs[i];
+    }
+    if (n + n_udp > 0 && poll(fds, n + n_udp, timeout_ms) < 0 && errno != EINTR) return;
+
+    for (nfds_t i = 0; i < n_udp; i++) {
+        if ((fds[n + i].revents & POLLIN) && alvos_udp[i]->fd >= 0) shim_udp_receber(alvos_udp[i]);
+    }
+
+    for (nfds_t i = 0; i < n; i++) {
+        struct tcp_pcb *p = alvos[i];
+        short re = fds[i].revents;
+        if (p->morto || !re) continue;
+        if (p->escuta) {
+            shim_aceitar(p);
+            continue;
+        }
+        if (re & POLLOUT) tcp_output(p);
+        if (!p->morto && (re & (POLLIN | POLLHUP | POLLERR))) shim_receber(p);
+    }
+
+    uint64_t agora = hal_tempo_us();
+    for (struct tcp_pcb *p = pcbs; p; p = p->proximo) {
+        if (!p->morto && !p->escuta && p->fd >= 0) shim_callbacks(p, agora);
+    }
+
+    // Libera os pcbs mortos: nenhum callback está em execução neste ponto
+    for (struct tcp_pcb **pp = &pcbs; *pp;) {
+        if ((*pp)->morto) {
+            struct tcp_pcb *morto = *pp;
+            *pp = morto->proximo;
+            free(morto);
+        } else {
+            pp = &(*pp)->proximo;
+        }
+    }
+}
@@ -0,0 +1,593 @@
+/**
+ * @file hal_pico.c
+ * @brief Implementação da HAL para o Raspberry Pi Pico W (RP2040 + CYW43).
+ * @details Concentra todo o acesso ao pico-sdk: PIO e DMA da matriz WS2812B, ADC,
+ *          GPIO, I2C do OLED, PWM do buzzer, núcleo 1 e rádio Wi-Fi.
+ */
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"    // Núcleo 1
+#include "pico/cyw43_arch.h"   // Rádio Wi-Fi e lwIP
+#include "pico/flash.h"        // flash_safe_execute (pausa o outro núcleo)
+#include "lwip/ip4_addr.h"     // Endereço IPv4 da interface
+#include "hardware/adc.h"
+#include "hardware/clocks.h"   // Usado pelo programa PIO
+#include "hardware/dma.h"      // Matriz de LEDs, lotes I2C e aquisição contínua do ADC
+#include "hardware/flash.h"    // Apagar/programar a região de persistência
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/structs/systick.h" // Contador de ciclos do Cortex-M0+
+#include "hardware/sync.h"     // __dmb(), save_and_disable_interrupts()
+#include "hardware/timer.h"    // Alarme de hardware do reset do WS2812B
+#include "ws2818b.pio.h"       // Header gerado pelo pioasm para o WS2812B
+#include "hal.h"
+
+// ===== TEMPO =====
+
+uint64_t hal_tempo_us(void) {
+    return time_us_64();
+}
+
+void hal_dormir_ms(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+void hal_aguardar_ate_us(uint64_t instante) {
+    // Acorda antes do prazo em qualquer evento (ex.: IRQ do CYW43)
+    best_effort_wfe_or_timeout(from_us_since_boot(instante));
+}
+
+// ===== CONTADOR DE CICLOS =====
+
+void hal_ciclos_init(void) {
+    systick_hw->csr = 0;                   // Desliga durante a configuração
+    systick_hw->rvr = HAL_CICLOS_MASCARA;  // Recarga máxima (24 bits)
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;                 // ENABLE + CLKSOURCE = clock do processador, sem IRQ
+}
+
+uint32_t hal_ciclos(void) {
+    return HAL_CICLOS_MASCARA - systick_hw->cvr; // O SysTick conta para baixo
+}
+
+uint32_t hal_ciclos_por_us(void) {
+    return clock_get_hz(clk_sys) / 1000000u;
+}
+
+// ===== CONSOLE =====
+
+void hal_console_init(void) {
+    stdio_init_all(); // USB e/ou UART
+}
+
+int hal_console_ler(void) {
+    int c = getchar_timeout_us(0);
+    return c >= 0 ? c : -1;
+}
+
+// ===== NÚCLEOS =====
+
+void hal_nucleo1_iniciar(void (*entrada)(void)) {
+    multicore_launch_core1(entrada);
+}
+
+uint hal_nucleo(void) {
+    return get_core_num(); // Registrador CPUID do SIO
+}
+
+void hal_barreira(void) {
+    __dmb();
+}
+
+void hal_fila_init(hal_fila_t *fila, size_t tamanho_item, unsigned capacidade) {
+    queue_init(fila, tamanho_item, capacidade);
+}
+
+bool hal_fila_adicionar(hal_fila_t *fila, const void *item) {
+    return queue_try_add(fila, item);
+}
+
+bool hal_fila_remover(hal_fila_t *fila, void *item) {
+    return queue_try_remove(fila, item);
+}
+
+// ===== INTERRUPÇÕES =====
+
+uint32_t hal_irq_bloquear(void) {
+    return save_and_disable_interrupts();
+}
+
+void hal_irq_restaurar(uint32_t estado) {
+    restore_interrupts(estado);
+}
+
+// ===== GPIO =====
+
+void hal_gpio_entrada_pullup(uint pino) {
+    gpio_init(pino);             // Inicializa o GPIO
+    gpio_set_dir(pino, GPIO_IN); // Define a direção como entrada
+    gpio_pull_up(pino);          // Habilita o resistor de pull-up interno
+}
+
+bool hal_gpio_ler(uint pino) {
+    return gpio_get(pino);
+}
+
+// ===== ADC =====
+
+void hal_adc_init(void) {
+    adc_init();
+}
+
+void hal_adc_pino(uint pino) {
+    adc_gpio_init(pino);
+}
+
+void hal_adc_sensor_temperatura(bool habilitar) {
+    adc_set_temp_sensor_enabled(habilitar);
+}
+
+uint16_t hal_adc_ler(uint canal) {
+    adc_select_input(canal);
+    return adc_read();
+}
+
+// O canal DMA é rearmado a cada ADC_DMA_RODADA transferências (múltiplo do anel,
+// para que a posição k % HAL_ADC_ANEL_AMOSTRAS continue valendo); a 3 kS/s isso
+// acontece a cada ~16 dias. O FIFO do ADC (4 amostras) cobre a latência da IRQ.
+#define ADC_DMA_RODADA 0xFFFFFF00u
+#define ADC_DMA_IRQ DMA_IRQ_1 // Compartilhada com a matriz de LEDs
+
+static uint16_t adc_anel[HAL_ADC_ANEL_AMOSTRAS] __attribute__((aligned(HAL_ADC_ANEL_AMOSTRAS * sizeof(uint16_t))));
+static int adc_dma = -1;
+static volatile uint32_t adc_base; // Amostras das rodadas já concluídas
+
+static void hal_adc_dma_irq(void) {
+    if (adc_dma < 0 || !dma_channel_get_irq1_status((uint)adc_dma)) return; // IRQ compartilhada
+    dma_channel_acknowledge_irq1((uint)adc_dma);
+    adc_base += ADC_DMA_RODADA;
+    dma_channel_set_trans_count((uint)adc_dma, ADC_DMA_RODADA, true); // O endereço já voltou ao início do anel
+}
+
+/**
+ * @brief Inicia o rodízio entre os canais da máscara, com o FIFO alimentando um
+ *        canal DMA em modo anel.
+ * @details A IRQ de rearme fica no núcleo que chama esta função.
+ */
+bool hal_adc_continuo_iniciar(uint32_t mascara_canais, uint32_t amostras_por_segundo) {
+    if (mascara_canais == 0 || adc_dma >= 0) return false;
+    adc_dma = dma_claim_unused_channel(false);
+    if (adc_dma < 0) {
+        printf("ERRO: Nenhum canal DMA livre para o ADC\n");
+        return false;
+    }
+
+    adc_select_input((uint)__builtin_ctz(mascara_canais)); // O rodízio parte do canal selecionado
+    adc_set_round_robin(mascara_canais);
+    adc_fifo_setup(true, true, 1, false, false); // DREQ a cada amostra, 12 bits em 16
+    float divisor = 48000000.0f / (float)amostras_por_segundo - 1.0f; // clk_adc de 48 MHz
+    adc_set_clkdiv(divisor < 96.0f ? 0.0f : divisor); // 96 ciclos por conversão no mínimo
+    adc_fifo_drain();
+
+    dma_channel_config c = dma_channel_get_default_config((uint)adc_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, (uint)__builtin_ctz(sizeof(adc_anel))); // Escrita volta ao início do anel
+    channel_config_set_dreq(&c, DREQ_ADC);
+    adc_base = 0;
+    dma_channel_configure((uint)adc_dma, &c, adc_anel, &adc_hw->fifo, ADC_DMA_RODADA, true);
+
+    dma_channel_set_irq1_enabled((uint)adc_dma, true);
+    irq_add_shared_handler(ADC_DMA_IRQ, hal_adc_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(ADC_DMA_IRQ, true);
+    adc_run(true);
+    return true;
+}
+
+const volatile uint16_t *hal_adc_continuo_anel(void) {
+    return adc_anel;
+}
+
+uint32_t hal_adc_continuo_total(void) {
+    if (adc_dma < 0) return 0;
+    uint32_t irq = save_and_disable_interrupts(); // Base e contador da mesma rodada
+    uint32_t total = adc_base + (ADC_DMA_RODADA - dma_channel_hw_addr((uint)adc_dma)->transfer_count);
+    restore_interrupts(irq);
+    return total;
+}
+
+// ===== MATRIZ DE LEDS WS2812B =====
+
+// Após o fim do DMA, ainda saem no fio as palavras do FIFO (8, com o TX unido)
+// e a do OSR, a 30 us cada (24 bits a 800 kHz); depois, o reset exige >= 280 us
+// em nível baixo para que o próximo quadro não seja tomado como continuação.
+#define NP_DRENO_FIFO_US (9u * 30u)
+#define NP_RESET_US 300u
+#define NP_DMA_IRQ DMA_IRQ_1 // DMA_IRQ_0 fica livre para o driver do CYW43
+
+static PIO np_pio = pio0; // Instância do PIO (pio0 ou pio1)
+static uint np_sm;        // State Machine usada pelo programa ws2818b
+static int np_dma = -1;   // Canal DMA que alimenta o FIFO TX da SM
+static uint np_alarme;    // Alarme de hardware que marca o fim do reset
+static volatile bool np_ocupado;
+static hal_leds_concluido_t np_concluido;
+static void *np_concluido_ctx;
+
+// Fim do reset: a matriz aceita um novo quadro
+static void hal_leds_alarme(uint alarme) {
+    (void)alarme;
+    np_ocupado = false;
+    if (np_concluido) np_concluido(np_concluido_ctx);
+}
+
+// Fim do DMA: agenda o fim do quadro no fio mais o reset
+static void hal_leds_dma_irq(void) {
+    if (np_dma < 0 || !dma_channel_get_irq1_status((uint)np_dma)) return; // IRQ compartilhada
+    dma_channel_acknowledge_irq1((uint)np_dma);
+    if (hardware_alarm_set_target(np_alarme, make_timeout_time_us(NP_DRENO_FIFO_US + NP_RESET_US))) {
+        hal_leds_alarme(np_alarme); // Prazo já passou: o alarme não dispararia
+    }
+}
+
+/**
+ * @brief Carrega o programa ws2818b em pio0 (ou pio1, se não houver SM livre)
+ *        e prepara um canal DMA pautado pelo DREQ do FIFO TX da SM.
+ * @details As IRQs de DMA e do alarme ficam no núcleo que chama esta função,
+ *          assim como o callback `concluido`.
+ */
+bool hal_leds_init(uint pino, hal_leds_concluido_t concluido, void *ctx) {
+    uint offset = pio_add_program(np_pio, &ws2818b_program);
+    int sm = pio_claim_unused_sm(np_pio, false);
+    if (sm < 0) {
+        np_pio = pio1; // Tenta usar o pio1
+        offset = pio_add_program(np_pio, &ws2818b_program);
+        sm = pio_claim_unused_sm(np_pio, false);
+        if (sm < 0) {
+            printf("ERRO: Nao foi possivel requisitar SM para WS2812B em pio0 ou pio1\n");
+            return false;
+        }
+    }
+    np_sm = (uint)sm;
+    ws2818b_program_init(np_pio, np_sm, offset, pino, 800000.f); // 800kHz para WS2812B
+
+    np_dma = dma_claim_unused_channel(false);
+    if (np_dma < 0) {
+        printf("ERRO: Nenhum canal DMA livre para o WS2812B\n");
+        return false;
+    }
+    dma_channel_config c = dma_channel_get_default_config((uint)np_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, np_sm, true));
+    dma_channel_configure((uint)np_dma, &c, &np_pio->txf[np_sm], NULL, 0, false);
+
+    np_concluido = concluido;
+    np_concluido_ctx = ctx;
+    np_alarme = (uint)hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(np_alarme, hal_leds_alarme);
+    dma_channel_set_irq1_enabled((uint)np_dma, true);
+    irq_add_shared_handler(NP_DMA_IRQ, hal_leds_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(NP_DMA_IRQ, true);
+    return true;
+}
+
+bool hal_leds_enviar(const uint32_t *palavras, size_t quantidade) {
+    if (np_ocupado || np_dma < 0) return false;
+    np_ocupado = true;
+    dma_channel_transfer_from_buffer_now((uint)np_dma, palavras, (uint32_t)quantidade);
+    return true;
+}
+
+bool hal_leds_ocupado(void) {
+    return np_ocupado;
+}
+
+// ===== I2C =====
+
+// O DMA escreve no IC_DATA_CMD palavras de 16 bits: o byte e, no bit 9, o STOP
+// do último byte de cada transação. Com o FIFO TX ainda cheio após um STOP, o
+// controlador abre a próxima transação (START + endereço) sozinho, então um lote
+// inteiro segue sem a CPU. Escritas de 8 bits não servem: o DMA replica o byte
+// nas demais faixas do barramento e acionaria os bits CMD/STOP/RESTART.
+static uint16_t i2c_lote[HAL_I2C_LOTE_MAX];
+static i2c_inst_t *i2c_lote_instancia; // Porta do último hal_i2c_init
+static int i2c_dma = -1;
+static volatile bool i2c_ocupado;
+static uint64_t i2c_lote_prazo_us;     // Fim do lote em andamento, no pior caso
+static hal_i2c_concluido_t i2c_concluido;
+static void *i2c_concluido_ctx;
+static uint32_t i2c_hz[2] = { 100000, 100000 }; // Clock real de cada porta (i2c_init)
+
+static i2c_inst_t *hal_i2c_instancia(uint porta) {
+    return porta ? i2c1 : i2c0;
+}
+
+/**
+ * @brief Tempo máximo de `bytes` na porta: 9 clocks por byte (com o ACK) mais
+ *        START e endereço, com folga de 2x para clock stretching, e 1 ms fixo.
+ */
+static uint32_t hal_i2c_prazo_us(uint porta, size_t bytes) {
+    uint64_t bits = ((uint64_t)bytes + 2u) * 9u * 2u;
+    return (uint32_t)(bits * 1000000u / i2c_hz[porta ? 1 : 0]) + 1000u;
+}
+
+/**
+ * @brief Devolve a porta a um estado conhecido após um prazo estourado: aborta
+ *        o DMA do lote, desabilita o bloco (descarta os FIFOs e a transação em
+ *        curso) e o habilita de novo.
+ */
+static void hal_i2c_reiniciar(i2c_inst_t *i2c) {
+    if (i2c == i2c_lote_instancia && i2c_dma >= 0) dma_channel_abort((uint)i2c_dma);
+    i2c->hw->intr_mask = 0;
+    i2c->hw->enable = 0;
+    // O bloco conclui o byte em curso antes de desligar (alguns períodos de SCL)
+    uint64_t limite = time_us_64() + 1000u;
+    while ((i2c->hw->enable_status & I2C_IC_ENABLE_STATUS_IC_EN_BITS) && time_us_64() < limite) {
+        tight_loop_contents();
+    }
+    (void)i2c->hw->clr_intr;
+    i2c->hw->enable = 1;
+}
+
+static void hal_i2c_lote_fim(bool sucesso) {
+    i2c_lote_instancia->hw->intr_mask = 0; // Escritas bloqueantes não geram IRQ
+    i2c_ocupado = false;
+    if (i2c_concluido) i2c_concluido(i2c_concluido_ctx, sucesso);
+}
+
+// STOP de cada transação do lote ou abort (sem ACK). O lote termina no STOP em
+// que o DMA já entregou tudo e o controlador está parado com o FIFO vazio.
+static void hal_i2c_irq(void) {
+    i2c_hw_t *hw = i2c_lote_instancia->hw;
+    uint32_t status = hw->intr_stat;
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        dma_channel_abort((uint)i2c_dma);
+        (void)hw->clr_tx_abrt; // Libera o FIFO TX, descartado pelo abort
+        (void)hw->clr_stop_det;
+        hal_i2c_lote_fim(false);
+        return;
+    }
+    if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (!dma_channel_is_busy((uint)i2c_dma) && hw->txflr == 0 &&
+            !(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) {
+            hal_i2c_lote_fim(true);
+        }
+    }
+}
+
+/**
+ * @brief Encerra com falha o lote que passou do prazo.
+ * @details Se o último STOP_DET chegar com MST_ACTIVITY ainda ativo, a IRQ não
+ *          conclui o lote e, sem prazo, a porta ficaria ocupada para sempre
+ *          (travando o OLED, as sondas e o escalonador do núcleo 0).
+ * @return bool `true` se o lote expirou agora.
+ */
+static bool hal_i2c_lote_expirado(void) {
+    if (!i2c_ocupado || time_us_64() < i2c_lote_prazo_us) return false;
+    uint32_t irq = save_and_disable_interrupts(); // Contra a IRQ concluindo ao mesmo tempo
+    bool expirou = i2c_ocupado;
+    if (expirou) {
+        hal_i2c_reiniciar(i2c_lote_instancia);
+        hal_i2c_lote_fim(false);
+    }
+    restore_interrupts(irq);
+    return expirou;
+}
+
+/**
+ * @brief Inicializa a porta e prepara o canal DMA dos lotes assíncronos,
+ *        pautado pelo DREQ do FIFO TX da porta.
+ * @details A IRQ da porta fica no núcleo que chama esta função, assim como o
+ *          callback de hal_i2c_escrever_lote.
+ */
+void hal_i2c_init(uint porta, uint32_t frequencia_hz, uint sda, uint scl) {
+    i2c_inst_t *i2c = hal_i2c_instancia(porta);
+    i2c_hz[porta ? 1 : 0] = i2c_init(i2c, frequencia_hz);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+
+    if (i2c_dma < 0) i2c_dma = dma_claim_unused_channel(false);
+    if (i2c_dma < 0) {
+        printf("ERRO: Nenhum canal DMA livre para o I2C; apenas escritas bloqueantes\n");
+        return;
+    }
+    i2c_lote_instancia = i2c;
+    i2c->hw->intr_mask = 0;
+    dma_channel_config c = dma_channel_get_default_config((uint)i2c_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure((uint)i2c_dma, &c, &i2c->hw->data_cmd, NULL, 0, false);
+
+    uint irq = I2C0_IRQ + i2c_hw_index(i2c);
+    irq_set_exclusive_handler(irq, hal_i2c_irq);
+    irq_set_enabled(irq, true);
+}
+
+/**
+ * @brief Espera o fim de um lote em andamento (não intercala transações).
+ * @return bool `false` se o lote expirou: a porta foi reiniciada e a chamada falha.
+ */
+static bool hal_i2c_aguardar_lote(uint porta) {
+    (void)porta; // Um único lote por vez, na porta do último hal_i2c_init
+    while (i2c_ocupado) {
+        if (hal_i2c_lote_expirado()) return false;
+        tight_loop_contents();
+    }
+    return true;
+}
+
+int hal_i2c_escrever(uint porta, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    if (!hal_i2c_aguardar_lote(porta)) return PICO_ERROR_TIMEOUT;
+    i2c_inst_t *i2c = hal_i2c_instancia(porta);
+    int r = i2c_write_timeout_us(i2c, endereco, dados, tamanho, false, hal_i2c_prazo_us(porta, tamanho));
+    if (r == PICO_ERROR_TIMEOUT) hal_i2c_reiniciar(i2c);
+    return r;
+}
+
+int hal_i2c_ler(uint porta, uint8_t endereco, uint8_t registrador, uint8_t *dados, size_t tamanho) {
+    if (!hal_i2c_aguardar_lote(porta)) return PICO_ERROR_TIMEOUT;
+    i2c_inst_t *i2c = hal_i2c_instancia(porta);
+    // Sem STOP: segue com repeated START
+    int r = i2c_write_timeout_us(i2c, endereco, &registrador, 1, true, hal_i2c_prazo_us(porta, 1));
+    if (r >= 0) r = i2c_read_timeout_us(i2c, endereco, dados, tamanho, false, hal_i2c_prazo_us(porta, tamanho));
+    if (r == PICO_ERROR_TIMEOUT) hal_i2c_reiniciar(i2c);
+    return r;
+}
+
+bool hal_i2c_escrever_lote(uint porta, uint8_t endereco, const hal_i2c_trecho_t *trechos, size_t quantidade,
+                           hal_i2c_concluido_t concluido, void *ctx) {
+    i2c_inst_t *i2c = hal_i2c_instancia(porta);
+    if (i2c_ocupado || i2c_dma < 0 || i2c != i2c_lote_instancia) return false;
+
+    size_t n = 0;
+    for (size_t t = 0; t < quantidade; t++) {
+        if (trechos[t].tamanho > HAL_I2C_LOTE_MAX - n) return false;
+        for (size_t i = 0; i < trechos[t].tamanho; i++) i2c_lote[n++] = trechos[t].dados[i];
+        if (trechos[t].fim && n > 0) i2c_lote[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    if (n == 0) return false;
+    i2c_lote[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS; // O lote sempre termina com STOP
+
+    i2c_ocupado = true;
+    i2c_lote_prazo_us = time_us_64() + hal_i2c_prazo_us(porta, n + quantidade); // Endereço de cada transação
+    i2c_concluido = concluido;
+    i2c_concluido_ctx = ctx;
+    i2c->hw->enable = 0; // O endereço só pode ser trocado com a porta desabilitada
+    i2c->hw->tar = endereco;
+    i2c->hw->enable = 1;
+    (void)i2c->hw->clr_intr;
+    i2c->hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    dma_channel_transfer_from_buffer_now((uint)i2c_dma, i2c_lote, (uint32_t)n);
+    return true;
+}
+
+bool hal_i2c_ocupado(uint porta) {
+    (void)porta; // Um único lote por vez, na porta do último hal_i2c_init
+    hal_i2c_lote_expirado();
+    return i2c_ocupado;
+}
+
+// ===== BUZZER =====
+
+void hal_buzzer_init(uint pino) {
+    gpio_set_function(pino, GPIO_FUNC_PWM);
+    uint slice_num = pwm_gpio_to_slice_num(pino);
+
+    pwm_config config = pwm_get_default_config();
+    // 125 MHz / 244 / 256 ~= 2 kHz (tom audível)
+    pwm_config_set_clkdiv_int_frac(&config, 244, 0);
+    pwm_config_set_wrap(&config, 255);
+
+    pwm_init(slice_num, &config, true);
+    pwm_set_gpio_level(pino, 0); // Buzzer desligado
+}
+
+void hal_buzzer_nivel(uint pino, uint8_t nivel) {
+    pwm_set_gpio_level(pino, nivel);
+}
+
+// ===== FLASH =====
+
+#define FLASH_TIMEOUT_MS 100 // Espera máxima para pausar o outro núcleo
+
+extern char __flash_binary_end; // Fim do programa na flash (linker script do pico-sdk)
+
+static uint32_t flash_regiao_inicio; // Offset da região desde o início da flash
+static uint32_t flash_regiao_tamanho;
+
+typedef struct {
+    uint32_t offset;                 // Offset absoluto na flash
+    const uint8_t *pagina;           // NULL = apagar o setor
+} flash_operacao_t;
+
+// Executada por flash_safe_execute com o XIP desligado: outro núcleo parado e IRQs desabilitadas
+static void flash_executar(void *param) {
+    const flash_operacao_t *op = (const flash_operacao_t *)param;
+    if (op->pagina) {
+        flash_range_program(op->offset, op->pagina, FLASH_PAGE_SIZE);
+    } else {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    }
+}
+
+const uint8_t *hal_flash_regiao(uint32_t tamanho) {
+    uint32_t inicio = PICO_FLASH_SIZE_BYTES - tamanho;
+    uint32_t fim_programa = (uint32_t)((uintptr_t)&__flash_binary_end - XIP_BASE);
+    if (tamanho > PICO_FLASH_SIZE_BYTES || tamanho % FLASH_SECTOR_SIZE || inicio < fim_programa) return NULL;
+    flash_regiao_inicio = inicio;
+    flash_regiao_tamanho = tamanho;
+    return (const uint8_t *)(uintptr_t)(XIP_BASE + inicio);
+}
+
+bool hal_flash_apagar(uint32_t offset) {
+    if (offset % FLASH_SECTOR_SIZE || offset >= flash_regiao_tamanho) return false;
+    flash_operacao_t op = { flash_regiao_inicio + offset, NULL };
+    return flash_safe_execute(flash_executar, &op, FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+bool hal_flash_programar(uint32_t offset, const uint8_t *pagina) {
+    if (offset % FLASH_PAGE_SIZE || offset >= flash_regiao_tamanho) return false;
+    flash_operacao_t op = { flash_regiao_inicio + offset, pagina };
+    return flash_safe_execute(flash_executar, &op, FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+void hal_flash_nucleo_init(void) {
+    flash_safe_execute_core_init();
+}
+
+// ===== REDE =====
+
+int hal_rede_iniciar(void) {
+    if (cyw43_arch_init()) return -1;
+    cyw43_arch_enable_sta_mode(); // Modo Station (cliente Wi-Fi)
+    return 0;
+}
+
+int hal_rede_conectar(const char *ssid, const char *senha, uint32_t timeout_ms) {
+    return cyw43_arch_wifi_connect_timeout_ms(ssid, senha, CYW43_AUTH_WPA2_AES_PSK, timeout_ms);
+}
+
+bool hal_rede_ip(char *texto, size_t tamanho) {
+    if (!netif_default || !netif_is_up(netif_default) || ip4_addr_isany(netif_ip4_addr(netif_default))) {
+        return false;
+    }
+    snprintf(texto, tamanho, "%s", ip4addr_ntoa(netif_ip4_addr(netif_default)));
+    return true;
+}
+
+int hal_rede_link(void) {
+    return cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA);
+}
+
+void hal_rede_led(bool aceso) {
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, aceso);
+}
+
+void hal_rede_poll(void) {
+    cyw43_arch_poll();
+}
+
+void hal_rede_bloquear(void) {
+    cyw43_arch_lwip_begin();
+}
+
+void hal_rede_liberar(void) {
+    cyw43_arch_lwip_end();
+}
+
+void hal_rede_encerrar(void) {
+    if (cyw43_is_initialized(&cyw43_state)) {
+        cyw43_arch_deinit();
+    }
+}
@@ -0,0 +1,18 @@
+/**
+ * @file hal_plataforma.h
+ * @brief Tipos da HAL para o RP2040 (pico-sdk).
+ */
+
+#ifndef HAL_PLATAFORMA_H
+#define HAL_PLATAFORMA_H
+
+#include "pico/stdlib.h"       // uint, _u(), count_of()
+#include "pico/util/queue.h"   // Fila segura entre núcleos e IRQs
+
+typedef queue_t hal_fila_t;
+
+#define HAL_PLATAFORMA "pico" // Identifica a plataforma (ex.: na saída do benchmark)
+
+#define HAL_CICLOS_MASCARA 0x00FFFFFFu // SysTick tem 24 bits (~134 ms a 125 MHz)
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * @file historico.c
+ * @brief Anéis por setor e consolidação das camadas de 1 e 15 minutos.
+ */
+
+#include "hal.h"
+#include "historico.h"
+
+#define HISTORICO_POR_1MIN (60 / HISTORICO_PERIODO_BRUTO_S)        // Amostras brutas por agregado de 1 min
+#define HISTORICO_POR_15MIN (15 * 60 / HISTORICO_PERIODO_BRUTO_S)  // Amostras brutas por agregado de 15 min
+
+_Static_assert(HISTORICO_BYTES <= HISTORICO_ORCAMENTO_BYTES, "historico excede HISTORICO_ORCAMENTO_BYTES");
+_Static_assert(60 % HISTORICO_PERIODO_BRUTO_S == 0, "o periodo bruto deve dividir 1 minuto");
+
+/**
+ * @struct historico_acumulador_t
+ * @brief Agregado em formação de um setor.
+ */
+typedef struct {
+    int32_t soma;
+    uint16_t n;         // Amostras válidas somadas
+    int16_t min;
+    int16_t max;
+} historico_acumulador_t;
+
+static int16_t anel_bruto[MAX_SETORES][HISTORICO_BRUTO_AMOSTRAS];
+static historico_ponto_t anel_1min[MAX_SETORES][HISTORICO_1MIN_AMOSTRAS];
+static historico_ponto_t anel_15min[MAX_SETORES][HISTORICO_15MIN_AMOSTRAS];
+static historico_acumulador_t acumulador[2][MAX_SETORES]; // 1 min e 15 min
+
+static volatile uint32_t total[HISTORICO_CAMADAS]; // Entradas já escritas em cada camada (módulo 2^32)
+static uint32_t base[HISTORICO_CAMADAS]; // Entradas restauradas da flash (anteriores ao boot)
+static uint32_t brutas_no_1min;   // Amostras brutas no agregado de 1 min em formação
+static uint32_t brutas_no_15min;
+static volatile uint64_t inicio_us; // Instante da primeira amostra bruta (0 = nenhuma)
+
+static const uint32_t capacidade[HISTORICO_CAMADAS] = {
+    HISTORICO_BRUTO_AMOSTRAS, HISTORICO_1MIN_AMOSTRAS, HISTORICO_15MIN_AMOSTRAS
+};
+static const uint32_t brutas_por_entrada[HISTORICO_CAMADAS] = { 1, HISTORICO_POR_1MIN, HISTORICO_POR_15MIN };
+static const char *const nomes[HISTORICO_CAMADAS] = { "bruto", "1min", "15min" };
+
+static void historico_zerar_acumulador(historico_acumulador_t *a) {
+    a->soma = 0;
+    a->n = 0;
+    a->min = INT16_MAX;
+    a->max = INT16_MIN;
+}
+
+void historico_init(void) {
+    for (int c = 0; c < HISTORICO_CAMADAS; c++) total[c] = base[c] = 0;
+    brutas_no_1min = brutas_no_15min = 0;
+    inicio_us = 0;
+    for (int a = 0; a < 2; a++) {
+        for (int i = 0; i < MAX_SETORES; i++) historico_zerar_acumulador(&acumulador[a][i]);
+    }
+}
+
+// Converte para ponto fixo, saturando na faixa do int16 (sem tocar em HISTORICO_SEM_DADO)
+static int16_t historico_codificar(float celsius) {
+    float v = celsius * (float)HISTORICO_Q;
+    v += v >= 0.0f ? 0.5f : -0.5f;
+    if (v > (float)INT16_MAX) return INT16_MAX;
+    if (v <= (float)INT16_MIN) return INT16_MIN + 1;
+    return (int16_t)v;
+}
+
+// Grava o agregado do setor em `destino` e recomeça a acumulação
+static void historico_fechar(historico_acumulador_t *a, historico_ponto_t *destino) {
+    if (a->n == 0) {
+        *destino = (historico_ponto_t){ HISTORICO_SEM_DADO, HISTORICO_SEM_DADO, HISTORICO_SEM_DADO };
+    } else {
+        int32_t media = (a->soma >= 0 ? a->soma + a->n / 2 : a->soma - a->n / 2) / a->n;
+        *destino = (historico_ponto_t){ a->min, a->max, (int16_t)media };
+    }
+    historico_zerar_acumulador(a);
+}
+
+static void historico_acumular(historico_acumulador_t *a, int16_t v) {
+    if (v == HISTORICO_SEM_DADO) return;
+    a->soma += v;
+    a->n++;
+    if (v < a->min) a->min = v;
+    if (v > a->max) a->max = v;
+}
+
+// Publica a entrada já escrita no anel: os leitores só a consideram depois disto
+static void historico_publicar(uint8_t camada) {
+    hal_barreira();
+    total[camada] = total[camada] + 1;
+}
+
+/**
+ * @brief Grava uma amostra bruta de todos os setores e fecha os agregados vencidos.
+ * @details Chamada pelo núcleo 1 a cada HISTORICO_PERIODO_BRUTO_S.
+ */
+void historico_amostrar(const setores_modelo_t *modelo, uint64_t agora_us) {
+    if (inicio_us == 0) inicio_us = agora_us ? agora_us : 1;
+
+    uint32_t slot = total[HISTORICO_BRUTO] % HISTORICO_BRUTO_AMOSTRAS;
+    for (int i = 0; i < MAX_SETORES; i++) {
+        int16_t v = setores_cadastrado(modelo, (setor_id_t)i) ? historico_codificar(modelo->temperaturas[i])
+                                                             : HISTORICO_SEM_DADO;
+        anel_bruto[i][slot] = v;
+        historico_acumular(&acumulador[0][i], v);
+        historico_acumular(&acumulador[1][i], v);
+    }
+    historico_publicar(HISTORICO_BRUTO);
+
+    if (++brutas_no_1min == HISTORICO_POR_1MIN) {
+        brutas_no_1min = 0;
+        slot = total[HISTORICO_1MIN] % HISTORICO_1MIN_AMOSTRAS;
+        for (int i = 0; i < MAX_SETORES; i++) historico_fechar(&acumulador[0][i], &anel_1min[i][slot]);
+        historico_publicar(HISTORICO_1MIN);
+    }
+    if (++brutas_no_15min == HISTORICO_POR_15MIN) {
+        brutas_no_15min = 0;
+        slot = total[HISTORICO_15MIN] % HISTORICO_15MIN_AMOSTRAS;
+        for (int i = 0; i < MAX_SETORES; i++) historico_fechar(&acumulador[1][i], &anel_15min[i][slot]);
+        historico_publicar(HISTORICO_15MIN);
+    }
+}
+
+const char *historico_nome(uint8_t camada) {
+    return camada < HISTORICO_CAMADAS ? nomes[camada] : "";
+}
+
+uint32_t historico_periodo_s(uint8_t camada) {
+    return camada < HISTORICO_CAMADAS ? brutas_por_entrada[camada] * HISTORICO_PERIODO_BRUTO_S : 0;
+}
+
+/**
+ * @brief Entradas disponíveis de uma camada: [inicio, fim), as mais antigas primeiro.
+ * @details Com o anel cheio, o slot da entrada mais antiga é o próximo a ser
+ *          escrito; por isso ela fica de fora e o leitor vê no máximo cap - 1 entradas.
+ */
+void historico_intervalo(uint8_t camada, uint32_t *inicio, uint32_t *fim) {
+    uint32_t t = camada < HISTORICO_CAMADAS ? total[camada] : 0;
+    uint32_t cap = camada < HISTORICO_CAMADAS ? capacidade[camada] : 0;
+    *fim = t;
+    *inicio = t >= cap ? t - cap + 1 : 0;
+}
+
+/**
+ * @brief Instante nominal do fim do período coberto pela entrada k.
+ * @details Negativo para as entradas restauradas, anteriores ao boot.
+ */
+int64_t historico_instante_us(uint8_t camada, uint32_t k) {
+    if (camada >= HISTORICO_CAMADAS) return 0;
+    int64_t brutas = ((int64_t)k - base[camada] + 1) * brutas_por_entrada[camada] - 1;
+    return (int64_t)inicio_us + brutas * HISTORICO_PERIODO_BRUTO_S * 1000000;
+}
+
+/**
+ * @brief Lê a entrada k do setor diretamente no anel.
+ * @return bool `false` se a entrada não existe mais (foi sobrescrita) ou ainda
+ *         não existe; nesse caso `ponto` vem como HISTORICO_SEM_DADO.
+ */
+bool historico_ler(uint8_t camada, setor_id_t setor, uint32_t k, historico_ponto_t *ponto) {
+    *ponto = (historico_ponto_t){ HISTORICO_SEM_DADO, HISTORICO_SEM_DADO, HISTORICO_SEM_DADO };
+    if (camada >= HISTORICO_CAMADAS || setor >= MAX_SETORES) return false;
+    uint32_t cap = capacidade[camada];
+    if (total[camada] - k - 1 >= cap - 1) return false; // Fora do anel (k >= total ou prestes a ser sobrescrita)
+    hal_barreira();
+
+    uint32_t slot = k % cap;
+    historico_ponto_t lido;
+    if (camada == HISTORICO_BRUTO) {
+        lido.min = lido.max = lido.media = ((volatile int16_t *)anel_bruto[setor])[slot];
+    } else {
+        const volatile historico_ponto_t *anel =
+            camada == HISTORICO_1MIN ? anel_1min[setor] : anel_15min[setor];
+        lido.min = anel[slot].min;
+        lido.max = anel[slot].max;
+        lido.media = anel[slot].media;
+    }
+
+    // O escritor só altera este slot ao gravar a entrada k + cap, quando total == k + cap
+    hal_barreira();
+    if (total[camada] - k >= cap) return false;
+    *ponto = lido;
+    return true;
+}
+
+/**
+ * @brief Define que a camada já tem `n` entradas, restauradas da flash.
+ * @details Somente no boot, antes de lançar o núcleo 1. As próximas entradas
+ *          continuam a numeração (índices usados também pela persistência).
+ *          Os slots das entradas ainda no anel devem ser preenchidos com
+ *          historico_restaurar_entrada (HISTORICO_SEM_DADO quando faltarem).
+ */
+void historico_restaurar(uint8_t camada, uint32_t n) {
+    if (camada >= HISTORICO_CAMADAS) return;
+    total[camada] = base[camada] = n;
+}
+
+/**
+ * @brief Grava a entrada k dos setores [primeiro, primeiro + n) no seu slot do anel (somente no boot).
+ */
+void historico_restaurar_entrada(uint8_t camada, uint32_t k, setor_id_t primeiro, setor_id_t n,
+                                 const historico_ponto_t *pontos) {
+    if (camada >= HISTORICO_CAMADAS || primeiro >= MAX_SETORES || n > MAX_SETORES - primeiro) return;
+    uint32_t slot = k % capacidade[camada];
+    for (setor_id_t j = 0; j < n; j++) {
+        setor_id_t i = (setor_id_t)(primeiro + j);
+        if (camada == HISTORICO_BRUTO) anel_bruto[i][slot] = pontos[j].media;
+        else if (camada == HISTORICO_1MIN) anel_1min[i][slot] = pontos[j];
+        else anel_15min[i][slot] = pontos[j];
+    }
+}
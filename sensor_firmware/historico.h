@@ -0,0 +1,130 @@
+/**
+ * @file historico.h
+ * @brief Histórico de temperatura por setor em anéis de tamanho fixo, com três camadas.
+ * @details O núcleo 1 amostra todos os setores a cada HISTORICO_PERIODO_BRUTO_S
+ *          (camada "bruto") e consolida as amostras em agregados de 1 e de 15
+ *          minutos (mínimo, máximo e média). Cada camada é um anel por setor;
+ *          quando enche, a entrada mais antiga é sobrescrita.
+ *
+ *          Codificação: os valores são int16 em ponto fixo (HISTORICO_Q avos de
+ *          °C, faixa de ±512 °C), e o tempo não é armazenado por entrada: as
+ *          amostras são periódicas, então o instante da entrada k de uma camada
+ *          é derivado do instante da primeira amostra (instantes nominais).
+ *          Setor não cadastrado no momento da amostra grava HISTORICO_SEM_DADO.
+ *          Toda a memória é estática: HISTORICO_BYTES, verificado em tempo de
+ *          compilação contra HISTORICO_ORCAMENTO_BYTES.
+ *
+ *          Os agregados podem ser restaurados da flash no boot (persistencia.h).
+ *          Sem relógio de tempo real, as entradas restauradas ficam contíguas,
+ *          terminando no boot: seus instantes são negativos.
+ *
+ *          Leitura sem cópia (núcleo 0): o leitor percorre as entradas
+ *          diretamente no anel, enquanto o núcleo 1 continua escrevendo. Cada
+ *          leitura confere, depois de copiar a entrada, se ela não foi
+ *          sobrescrita nesse meio-tempo; se foi, é informada como sem dado.
+ */
+
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "setores.h"
+
+#define HISTORICO_PERIODO_BRUTO_S 5     // Intervalo entre amostras da camada bruta
+#define HISTORICO_Q 64                  // Valores em 1/64 °C
+#define HISTORICO_SEM_DADO INT16_MIN    // Setor não cadastrado (ou entrada sobrescrita)
+
+// Profundidade mínima útil de cada camada: 1 minuto de amostras brutas, 1 hora
+// de agregados de 1 minuto e 2 horas de agregados de 15 minutos. Um build que
+// não a comporta (grade ou orçamento) falha na compilação.
+#define HISTORICO_BRUTO_MINIMO 12
+#define HISTORICO_1MIN_MINIMO 60
+#define HISTORICO_15MIN_MINIMO 8
+
+// Orçamento de RAM dos anéis (CMake: AGROGRAF_HISTORICO_ORCAMENTO). O padrão
+// cresce com a grade até as profundidades completas, limitado a
+// HISTORICO_ORCAMENTO_TETO: o restante da RAM do Pico fica para a rede.
+#define HISTORICO_SETOR_COMPLETO_BYTES (120 * 2 + (60 + 96) * 6) // Um setor com as profundidades completas
+#define HISTORICO_ORCAMENTO_TETO (80 * 1024)
+#ifndef HISTORICO_ORCAMENTO_BYTES
+#define HISTORICO_ORCAMENTO_BYTES                                                      \
+    (MAX_SETORES * HISTORICO_SETOR_COMPLETO_BYTES < HISTORICO_ORCAMENTO_TETO           \
+         ? MAX_SETORES * HISTORICO_SETOR_COMPLETO_BYTES : HISTORICO_ORCAMENTO_TETO)
+#endif
+
+// Profundidade das camadas: a completa (10 min, 1 h e 24 h) enquanto a grade
+// couber no orçamento (68 setores no teto). Acima disso, a camada de 1 minuto
+// continua completa e as camadas bruta e de 15 minutos dividem o que sobra,
+// na mesma proporção. Também podem ser definidas no build (-D...).
+#define HISTORICO_SETOR_BYTES (HISTORICO_ORCAMENTO_BYTES / MAX_SETORES)
+#define HISTORICO_1MIN_PADRAO (HISTORICO_SETOR_BYTES >= 60 * 6 ? 60 : HISTORICO_SETOR_BYTES / 6)
+#define HISTORICO_PROPORCAO(completa) \
+    ((completa) * (HISTORICO_SETOR_BYTES - HISTORICO_1MIN_PADRAO * 6) / (120 * 2 + 96 * 6))
+#define HISTORICO_PROFUNDIDADE(completa)                               \
+    (HISTORICO_PROPORCAO(completa) >= (completa) ? (completa)          \
+     : HISTORICO_PROPORCAO(completa) < 2          ? 2                  \
+                                                  : HISTORICO_PROPORCAO(completa))
+#ifndef HISTORICO_BRUTO_AMOSTRAS
+#define HISTORICO_BRUTO_AMOSTRAS HISTORICO_PROFUNDIDADE(120) // Completa: 10 minutos de amostras brutas
+#endif
+#ifndef HISTORICO_1MIN_AMOSTRAS
+#define HISTORICO_1MIN_AMOSTRAS HISTORICO_1MIN_PADRAO        // Completa: 1 hora de agregados de 1 minuto
+#endif
+#ifndef HISTORICO_15MIN_AMOSTRAS
+#define HISTORICO_15MIN_AMOSTRAS HISTORICO_PROFUNDIDADE(96)  // Completa: 24 horas de agregados de 15 minutos
+#endif
+
+_Static_assert(HISTORICO_BRUTO_AMOSTRAS >= HISTORICO_BRUTO_MINIMO && HISTORICO_1MIN_AMOSTRAS >= HISTORICO_1MIN_MINIMO &&
+                   HISTORICO_15MIN_AMOSTRAS >= HISTORICO_15MIN_MINIMO,
+               "historico abaixo da profundidade minima: reduza a grade ou aumente HISTORICO_ORCAMENTO_BYTES");
+
+/**
+ * @brief Camadas do histórico.
+ */
+enum {
+    HISTORICO_BRUTO,
+    HISTORICO_1MIN,
+    HISTORICO_15MIN,
+    HISTORICO_CAMADAS
+};
+
+/**
+ * @struct historico_ponto_t
+ * @brief Entrada de uma camada (na camada bruta, min = max = media).
+ */
+typedef struct {
+    int16_t min;
+    int16_t max;
+    int16_t media;
+} historico_ponto_t;
+
+#define HISTORICO_BYTES (MAX_SETORES * (HISTORICO_BRUTO_AMOSTRAS * sizeof(int16_t) + \
+                         (HISTORICO_1MIN_AMOSTRAS + HISTORICO_15MIN_AMOSTRAS) * sizeof(historico_ponto_t)))
+
+void historico_init(void);
+
+// Núcleo 1: uma amostra de todos os setores a cada HISTORICO_PERIODO_BRUTO_S
+void historico_amostrar(const setores_modelo_t *modelo, uint64_t agora_us);
+
+// Leitores (núcleo 0)
+const char *historico_nome(uint8_t camada);
+uint32_t historico_periodo_s(uint8_t camada);
+void historico_intervalo(uint8_t camada, uint32_t *inicio, uint32_t *fim); // Entradas [inicio, fim) no anel
+int64_t historico_instante_us(uint8_t camada, uint32_t k);                 // Fim do período da entrada k
+bool historico_ler(uint8_t camada, setor_id_t setor, uint32_t k, historico_ponto_t *ponto);
+
+// Restauração no boot, antes de lançar o núcleo 1: as entradas são gravadas
+// nos seus slots (`n` setores a partir de `primeiro` por chamada) e a camada
+// passa a ter `total` entradas
+void historico_restaurar(uint8_t camada, uint32_t total);
+void historico_restaurar_entrada(uint8_t camada, uint32_t k, setor_id_t primeiro, setor_id_t n,
+                                 const historico_ponto_t *pontos);
+
+// Converte um valor do histórico em centésimos de °C (arredondado)
+static inline int32_t historico_centesimos(int16_t v) {
+    int32_t c = (int32_t)v * 100;
+    return (c >= 0 ? c + HISTORICO_Q / 2 : c - HISTORICO_Q / 2) / HISTORICO_Q;
+}
+
+#endif
@@ -0,0 +1,1801 @@
+/**
+ * @file http_server.c
+ * @brief Servidor HTTP/1.1 do AgroGraf: parser incremental, keep-alive e resposta em partes.
+ * @details Recepção: os pbufs recebidos ficam encadeados na conexão e são
+ *          consumidos byte a byte por um parser incremental (linha de
+ *          requisição -> cabeçalhos -> corpo descartado), de modo que uma
+ *          requisição dividida em vários segmentos ou em uma cadeia de pbufs é
+ *          tratada normalmente. A janela de recepção só é devolvida
+ *          (`tcp_recved`) à medida que os bytes são consumidos; enquanto uma
+ *          resposta está em andamento, requisições em pipeline aguardam no pbuf.
+ *
+ *          Envio: cada conexão percorre uma pequena máquina de estados:
+ *          prefixo HTML (constante em flash, sem cópia) -> uma linha por setor
+ *          cadastrado (formatada sob demanda) -> estado do buzzer -> sufixo HTML.
+ *          Em HTTP/1.1 a página segue em `Transfer-Encoding: chunked` para que a
+ *          conexão possa ser reutilizada (keep-alive); as rotas /api levam
+ *          Content-Length, exceto /api/history, gerada em blocos (chunked)
+ *          diretamente dos anéis do histórico. /api/sectors e /api/sectors.bin
+ *          também saem em pedaços de HTTP_CORPO_MAX bytes, formatados à medida
+ *          que a janela abre, de um único snapshot compartilhado pelas respostas
+ *          em andamento: nenhum buffer cresce com a grade. Cada conexão limita os dados sem confirmação a uma
+ *          fração do heap e dos segmentos do lwIP (HTTP_BYTES_POR_CONEXAO e
+ *          HTTP_SEGMENTOS_POR_CONEXAO); o restante é retomado em `tcp_sent`.
+ *
+ *          Conexões: a tabela é estática (HTTP_MAX_CONEXOES). Quando está cheia,
+ *          a conexão keep-alive ociosa há mais tempo é fechada para dar lugar à
+ *          nova. `tcp_poll` fecha conexões ociosas, aborta respostas paradas e
+ *          retoma envios interrompidos por falta de memória no lwIP.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "hal.h"
+#include "lwip/tcp.h"
+#include "setores.h"
+#include "historico.h"
+#include "diario.h"
+#include "log.h"
+#include "http_server.h"
+
+#define HTTP_LINHA_MAX 112     // Buffer de uma linha de setor (nome de até 29 caracteres + HTML)
+#define HTTP_REQ_LINHA_MAX 128 // Linha da requisição/cabeçalho acumulada pelo parser (cabe /api/alarms/set completo)
+#define HTTP_CABECALHO_MAX 128 // Cabeçalho HTTP das rotas /api (com Content-Length)
+#define HTTP_MOLDURA_MAX 8     // Tamanho de um chunk em hexadecimal + CRLF
+#define HTTP_CORPO_MAX 512     // Pedaço de corpo formatado por vez (/api, /api/history, /api/events)
+#define HTTP_SETOR_JSON_MAX 40 // Pior caso de um setor no JSON: ,{"i":65535,"c":1,"t":-327.68,"a":1}
+#define HTTP_EVENTO_MAX 80     // Um evento SSE de setor ("event: ...\ndata: {...}\n\n")
+// Espaço reservado ao fim de cada bloco de /api/history: o maior item escrito de uma
+// vez é o início de uma camada ({"nome":"15min","periodo_s":900,"fim_ms":4294967295,"valores":[)
+// seguido do fechamento da anterior e do objeto ("]},", "]}]}")
+#define HTTP_HISTORICO_MARGEM 96
+// Idem para /api/events: o maior item é um evento de comando
+// ({"seq":4294967295,"ms":4294967295,"tipo":"comando","comando":"definir_temperatura","setor":65535,"t":-327.68},)
+// ou o fechamento "]}"
+#define HTTP_DIARIO_MARGEM 128
+
+#define HTTP_POLL_INTERVALO 2     // tcp_poll a cada 2 x 500 ms (contadores em segundos)
+#define HTTP_TIMEOUT_OCIOSO_S 15  // Conexão keep-alive sem requisição é fechada
+#define HTTP_TIMEOUT_ENVIO_S 20   // Resposta sem confirmação do cliente é abortada
+#define HTTP_SSE_HEARTBEAT_S 15   // Comentário enviado a streams /events parados (detecta clientes mortos)
+#define HTTP_MAX_EVENTOS 4        // Streams /events simultâneos (o restante da tabela fica para a página e /api)
+
+// Fração dos recursos do lwIP que uma conexão pode ocupar com dados não confirmados
+#define HTTP_BYTES_POR_CONEXAO (MEM_SIZE / (2 * HTTP_MAX_CONEXOES))
+#define HTTP_SEGMENTOS_POR_CONEXAO (MEMP_NUM_TCP_SEG / HTTP_MAX_CONEXOES)
+
+// ===== PARTES FIXAS DAS RESPOSTAS (EM FLASH, ENVIADAS SEM CÓPIA) =====
+static const char http_cabecalho_chunked[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nTransfer-Encoding: chunked\r\n\r\n";
+static const char http_cabecalho_close[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nConnection: close\r\n\r\n";
+static const char http_pagina_inicio[] =
+    "<!DOCTYPE html><html><head><title>AgroGraf Control</title>"
+    "<noscript><meta http-equiv='refresh' content='5'></noscript>" // Sem JavaScript: auto-refresh a cada 5s
+    "</head><body>"
+    "<h1>AgroGraf - Controle Remoto</h1>"
+    "<h2>Status dos Setores:</h2><ul>";
+static const char http_pagina_buzzer_ativo[] = "</ul><p>Buzzer: <span id='bz'>ATIVO</span></p>";
+static const char http_pagina_buzzer_desativado[] = "</ul><p>Buzzer: <span id='bz'>DESATIVADO</span></p>";
+static const char http_pagina_fim[] =
+    "<h2>Acoes:</h2>"
+    "<p><a href=\"/reset_alarms\">Acionar Equipamentos (Resetar Alarmes)</a></p>" // Link para resetar alarmes
+    "<p><a href=\"/clear_system\">Limpar Sistema</a></p>"                     // Link para limpar o sistema
+    // Atualização ao vivo: aplica os eventos de /events às linhas <li id='sN'>;
+    // um setor recém-cadastrado (sem linha) ou uma reconexão recarregam a página
+    "<script>"
+    "var es=new EventSource('/events'),caiu=0;"
+    "function bz(b){document.getElementById('bz').textContent=b?'ATIVO':'DESATIVADO'}"
+    "function s(d){var l=document.getElementById('s'+d.i);"
+    "if(!l){if(d.c)location.reload();return}"
+    "if(!d.c){l.remove();return}"
+    "l.children[0].textContent=d.t.toFixed(2);l.children[1].textContent=d.a?'(ALERTA!)':''}"
+    "['cadastro','temperatura','alarme'].forEach(function(n){es.addEventListener(n,function(e){s(JSON.parse(e.data))})});"
+    "es.addEventListener('buzzer',function(e){bz(JSON.parse(e.data).b)});"
+    "es.addEventListener('estado',function(e){var d=JSON.parse(e.data);d.setores.forEach(s);bz(d.b)});"
+    "es.onerror=function(){caiu=1};es.onopen=function(){if(caiu)location.reload()};"
+    "</script>"
+    "</body></html>\r\n";
+static const char http_chunk_fim[] = "\r\n";         // Encerra os dados de um chunk
+static const char http_chunk_ultimo[] = "0\r\n\r\n"; // Chunk vazio: fim da página
+static const char http_resposta_400[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char http_resposta_400_parametro[] = // Requisição bem formada: a conexão continua
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+static const char http_resposta_404[] =
+    "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+static const char http_resposta_405[] =
+    "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\n\r\n";
+static const char http_resposta_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 10\r\nContent-Length: 0\r\n\r\n";
+static const char http_cabecalho_json_chunked[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n\r\n";
+static const char http_cabecalho_json_close[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n";
+static const char http_cabecalho_eventos[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n\r\n";
+static const char http_evento_estado[] = "event: estado\ndata: "; // Seguido do JSON de /api/sectors
+static const char http_evento_fim[] = "\n\n";
+static const char http_evento_heartbeat[] = ":\n\n";          // Comentário SSE (ignorado pelo cliente)
+// =================================================================
+
+/**
+ * @enum http_rota_t
+ * @brief Resposta a gerar para a requisição.
+ */
+typedef enum {
+    HTTP_ROTA_PAGINA,             // Página de status em HTML
+    HTTP_ROTA_RESETAR_ALARMES,    // Aciona os equipamentos e mostra a página
+    HTTP_ROTA_LIMPAR_SISTEMA,     // Limpa o sistema e mostra a página
+    HTTP_ROTA_API_JSON,           // GET /api/sectors
+    HTTP_ROTA_API_BIN,            // GET /api/sectors.bin
+    HTTP_ROTA_EVENTOS,            // GET /events (Server-Sent Events)
+    HTTP_ROTA_API_HISTORICO,      // GET /api/history?sector=N
+    HTTP_ROTA_API_ALARMES,        // GET /api/alarms?sector=N
+    HTTP_ROTA_API_ALARMES_DEFINIR, // GET /api/alarms/set?[sector=N&]aviso=...
+    HTTP_ROTA_API_DIARIO,         // GET /api/events?since=SEQ
+    HTTP_ROTA_INDISPONIVEL,       // 503 (limite de streams /events atingido ou fila de comandos cheia)
+    HTTP_ROTA_NAO_ENCONTRADA,     // 404
+    HTTP_ROTA_METODO_INVALIDO,    // 405 (somente GET é aceito)
+    HTTP_ROTA_PARAMETRO_INVALIDO, // 400 (parâmetro da query string ausente ou fora da faixa)
+    HTTP_ROTA_REQUISICAO_INVALIDA // 400 (linha de requisição malformada ou longa demais)
+} http_rota_t;
+
+// Caminhos atendidos (a query string só é lida por /api/history, /api/alarms e /api/events)
+static const struct {
+    const char *caminho;
+    http_rota_t rota;
+} http_rotas[] = {
+    { "/",                 HTTP_ROTA_PAGINA },
+    { "/reset_alarms",     HTTP_ROTA_RESETAR_ALARMES },
+    { "/clear_system",     HTTP_ROTA_LIMPAR_SISTEMA },
+    { "/api/sectors",      HTTP_ROTA_API_JSON },
+    { "/api/sectors.bin",  HTTP_ROTA_API_BIN },
+    { "/events",           HTTP_ROTA_EVENTOS },
+    { "/api/history",      HTTP_ROTA_API_HISTORICO },
+    { "/api/alarms",       HTTP_ROTA_API_ALARMES },
+    { "/api/alarms/set",   HTTP_ROTA_API_ALARMES_DEFINIR },
+    { "/api/events",       HTTP_ROTA_API_DIARIO },
+};
+
+/**
+ * @enum http_parser_t
+ * @brief Estado do parser incremental da requisição.
+ */
+typedef enum {
+    HTTP_PARSER_REQUISICAO, // Aguardando a linha "METODO caminho HTTP/1.x"
+    HTTP_PARSER_CABECALHOS, // Lendo cabeçalhos até a linha vazia
+    HTTP_PARSER_CORPO       // Descartando `corpo_restante` bytes (Content-Length)
+} http_parser_t;
+
+/**
+ * @enum http_etapa_t
+ * @brief Etapas da geração da resposta.
+ */
+typedef enum {
+    HTTP_ETAPA_OCIOSA,      // Nenhuma resposta em andamento (aguardando requisição)
+    HTTP_ETAPA_CABECALHO,   // Cabeçalho HTTP da página
+    HTTP_ETAPA_INICIO,      // Início do HTML
+    HTTP_ETAPA_SETORES,     // Uma linha por setor cadastrado
+    HTTP_ETAPA_BUZZER,      // Fim da lista e estado do buzzer
+    HTTP_ETAPA_FIM,         // Ações e fim do HTML
+    HTTP_ETAPA_ULTIMO_CHUNK, // Chunk vazio que encerra a página (keep-alive)
+    HTTP_ETAPA_API_CABECALHO, // Cabeçalho HTTP de uma rota /api
+    HTTP_ETAPA_API_CORPO,   // Corpo de /api/alarms já formatado
+    HTTP_ETAPA_API_SETORES, // Um pedaço de /api/sectors(.bin), formatado do snapshot compartilhado
+    HTTP_ETAPA_HISTORICO_CABECALHO, // Cabeçalho de /api/history
+    HTTP_ETAPA_HISTORICO,   // Um bloco do histórico, lido diretamente dos anéis
+    HTTP_ETAPA_DIARIO_CABECALHO, // Cabeçalho de /api/events
+    HTTP_ETAPA_DIARIO,      // Um bloco de eventos, formatados a partir do diário
+    HTTP_ETAPA_SSE_CABECALHO, // Cabeçalho do stream /events
+    HTTP_ETAPA_SSE,         // Stream /events aberto: eventos são escritos pelo despacho
+    HTTP_ETAPA_SSE_ESTADO_CORPO, // Ressincronização: um pedaço do JSON completo do estado
+    HTTP_ETAPA_SSE_ESTADO_FIM,   // Ressincronização: fim do evento
+    HTTP_ETAPA_ERRO,        // Resposta de erro sem corpo
+    HTTP_ETAPA_CONCLUIDA    // Tudo enfileirado no lwIP
+} http_etapa_t;
+
+/**
+ * @enum http_parte_tipo_t
+ * @brief Classificação das partes geradas por http_proxima_parte().
+ */
+typedef enum {
+    HTTP_PARTE_NENHUMA,     // Resposta completa
+    HTTP_PARTE_CRUA,        // Enviada como está (cabeçalhos, fim do chunked)
+    HTTP_PARTE_CORPO        // Corpo da página: vira um chunk em modo chunked
+} http_parte_tipo_t;
+
+/**
+ * @struct http_conexao_t
+ * @brief Estado de uma conexão HTTP (tabela estática, sem heap).
+ */
+typedef struct {
+    struct tcp_pcb *pcb;          // PCB da conexão (NULL = entrada livre)
+    struct pbuf *rx;              // Dados recebidos ainda não consumidos pelo parser
+    bool remoto_fechou;           // Cliente enviou FIN: fechar após a resposta atual
+    uint8_t ociosidade_s;         // Segundos sem atividade (contados em tcp_poll)
+
+    // Parser da requisição
+    http_parser_t parser;         // Estado do parser
+    uint8_t req_linha_len;        // Bytes acumulados em `req_linha`
+    bool req_linha_truncada;      // A linha atual excedeu HTTP_REQ_LINHA_MAX
+    char req_linha[HTTP_REQ_LINHA_MAX]; // Linha em montagem
+    uint32_t corpo_restante;      // Bytes de corpo da requisição a descartar
+    http_rota_t rota;             // Rota da requisição atual
+    bool http11;                  // Cliente HTTP/1.1 (entende chunked)
+    bool manter;                  // Manter a conexão após a resposta (keep-alive)
+    bool sse_ressinc;             // Stream /events perdeu eventos: enviar o estado completo
+
+    // Resposta
+    http_etapa_t etapa;           // Etapa atual da resposta
+    bool chunked;                 // Página em Transfer-Encoding: chunked
+    setor_id_t proximo_setor;     // Próximo setor da página ou de /api/sectors(.bin)
+    const setores_snapshot_t *estado; // Snapshot compartilhado lido pela resposta (NULL: nenhum)
+    const char *parte;            // Parte atual sendo enviada
+    uint16_t parte_len;           // Tamanho da parte atual
+    uint16_t parte_enviado;       // Bytes da parte atual já enfileirados
+    uint8_t parte_flags;          // TCP_WRITE_FLAG_COPY para partes em RAM
+    const char *pendente;         // Dados de um chunk aguardando o envio do seu tamanho
+    uint16_t pendente_len;        // Tamanho de `pendente`
+    uint8_t pendente_flags;       // Flags de `pendente`
+    bool sufixo_pendente;         // Falta o CRLF que fecha o chunk
+    char moldura[HTTP_MOLDURA_MAX]; // Tamanho do chunk atual ("%X\r\n")
+    union {
+        char linha[HTTP_LINHA_MAX];         // Linha do setor sendo enviada (página)
+        uint8_t corpo[HTTP_CORPO_MAX];      // Pedaço do corpo de uma rota /api
+    };
+    uint16_t corpo_len;           // Bytes válidos em `corpo`
+    char cabecalho[HTTP_CABECALHO_MAX]; // Cabeçalho HTTP de uma rota /api
+    uint8_t cabecalho_len;        // Bytes válidos em `cabecalho`
+    uint32_t api_bytes;           // Cabeçalho + corpo de /api/sectors(.bin), para as estatísticas
+    uint32_t api_formatacao_us;   // Tempo de formatação somado dos pedaços
+
+    // Cursor de /api/history nos anéis do histórico
+    setor_id_t historico_setor;   // Setor pedido (0 a MAX_SETORES-1)
+    int8_t historico_camada;      // Camada em envio (-1 = objeto JSON ainda não aberto)
+    uint32_t historico_inicio;    // Primeira entrada da camada no início do envio
+    uint32_t historico_proximo;   // Próxima entrada a escrever
+    uint32_t historico_fim;       // Fim da camada (entradas gravadas depois ficam de fora)
+
+    // /api/alarms e /api/alarms/set
+    setor_id_t regra_setor;       // Setor pedido (SETOR_INVALIDO = todos, só em /set)
+    alarme_regra_t regra;         // Regra lida ou a aplicar
+
+    // Cursor de /api/events no diário
+    uint32_t diario_desde;        // Último seq que o cliente já tem (parâmetro `since`)
+    uint32_t diario_proximo;      // Próximo seq a escrever (0 = objeto JSON ainda não aberto)
+    uint32_t diario_fim;          // Último seq no início do envio (eventos novos ficam para o próximo pedido)
+} http_conexao_t;
+
+/**
+ * @struct http_conexoes_stats_t
+ * @brief Contadores do uso da tabela de conexões.
+ */
+typedef struct {
+    uint32_t aceitas;             // Conexões aceitas
+    uint32_t requisicoes;         // Requisições atendidas
+    uint32_t reutilizacoes;       // Requisições atendidas em uma conexão já usada (keep-alive)
+    uint32_t despejadas;          // Conexões ociosas fechadas para dar lugar a uma nova
+    uint32_t recusadas;           // Conexões abortadas por falta de entrada livre
+    uint32_t expiradas;           // Conexões fechadas/abortadas por timeout
+    uint32_t eventos;             // Eventos SSE escritos (somando todos os clientes)
+    uint32_t ressincronizacoes;   // Estados completos enviados a streams que perderam eventos
+} http_conexoes_stats_t;
+
+static http_conexao_t conexoes[HTTP_MAX_CONEXOES];
+static http_conexoes_stats_t stats_conexoes;
+static http_api_stats_t stats_json; // Estatísticas de GET /api/sectors
+static http_api_stats_t stats_bin;  // Estatísticas de GET /api/sectors.bin
+static http_api_stats_t stats_historico; // Estatísticas de GET /api/history (somando os blocos)
+
+// Estado dos setores lido pelas respostas em andamento (página, /api e
+// ressincronização de /events), em vez de uma cópia por conexão. Um snapshot
+// só é renovado sem leitores; com o atual ocupado, a resposta nova renova e
+// passa a usar o outro, se estiver livre (senão recebe o atual: o campo "v"
+// informa a versão). Um cliente lento não prende as respostas seguintes no estado antigo.
+static setores_snapshot_t http_estados[2];
+static uint8_t http_estados_leitores[2];
+static uint8_t http_estado_atual;
+
+/**
+ * @brief Associa à conexão o snapshot compartilhado mais recente possível.
+ */
+static void http_estado_adquirir(http_conexao_t *c) {
+    if (c->estado) return;
+    uint8_t k = http_estado_atual;
+    if (http_estados_leitores[k] && !http_estados_leitores[k ^ 1]) k ^= 1;
+    if (!http_estados_leitores[k]) setores_ler_snapshot(&http_estados[k]);
+    http_estado_atual = k;
+    http_estados_leitores[k]++;
+    c->estado = &http_estados[k];
+}
+
+static void http_estado_liberar(http_conexao_t *c) {
+    if (!c->estado) return;
+    http_estados_leitores[c->estado - http_estados]--;
+    c->estado = NULL;
+}
+
+// ===== FORMATAÇÃO DAS ROTAS /api (SEM printf DE PONTO FLUTUANTE) =====
+
+/**
+ * @brief Converte uma temperatura em centésimos de grau, arredondando e saturando em int16.
+ */
+static int16_t http_centesimos(float temperatura) {
+    float c = temperatura * 100.0f;
+    c += (c >= 0.0f) ? 0.5f : -0.5f;
+    if (c > 32767.0f) return 32767;
+    if (c < -32768.0f) return -32768;
+    return (int16_t)c;
+}
+
+/**
+ * @brief Escreve um inteiro sem sinal em decimal.
+ * @return char* Posição após o último dígito.
+ */
+static char *json_uint(char *p, uint32_t v) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+/**
+ * @brief Escreve um inteiro com sinal em decimal.
+ */
+static char *json_int(char *p, int32_t v) {
+    if (v < 0) {
+        *p++ = '-';
+        return json_uint(p, (uint32_t)0 - (uint32_t)v);
+    }
+    return json_uint(p, (uint32_t)v);
+}
+
+/**
+ * @brief Escreve um valor em centésimos como decimal com duas casas ("-12.05").
+ */
+static char *json_centesimos(char *p, int32_t v) {
+    if (v < 0) {
+        *p++ = '-';
+        v = -v;
+    }
+    p = json_uint(p, (uint32_t)v / 100);
+    *p++ = '.';
+    *p++ = (char)('0' + (v / 10) % 10);
+    *p++ = (char)('0' + v % 10);
+    return p;
+}
+
+/**
+ * @brief Copia uma string literal (sem o '\0').
+ */
+static char *json_texto(char *p, const char *s) {
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+/**
+ * @brief Escreve o objeto JSON de um setor: {"i":1,"c":1,"t":25.31,"a":0}.
+ * @param i Índice do setor (0 a MAX_SETORES-1; publicado a partir de 1).
+ */
+static char *json_setor(char *p, int i, bool cadastrado, float temperatura, bool alarme) {
+    p = json_texto(p, "{\"i\":");
+    p = json_uint(p, (uint32_t)(i + 1));
+    p = json_texto(p, cadastrado ? ",\"c\":1,\"t\":" : ",\"c\":0,\"t\":");
+    p = json_centesimos(p, http_centesimos(temperatura));
+    return json_texto(p, alarme ? ",\"a\":1}" : ",\"a\":0}");
+}
+
+/**
+ * @brief Escreve o início de GET /api/sectors: {"v":<versao>,"b":0,"setores":[
+ */
+static char *json_setores_inicio(char *p, const setores_snapshot_t *e) {
+    p = json_texto(p, "{\"v\":");
+    p = json_uint(p, e->versao);
+    return json_texto(p, e->buzzer_ativo ? ",\"b\":1,\"setores\":[" : ",\"b\":0,\"setores\":[");
+}
+
+// Setor i do snapshot compartilhado, precedido da vírgula a partir do segundo
+static char *json_setores_item(char *p, const setores_snapshot_t *e, setor_id_t i) {
+    const setores_modelo_t *m = &e->modelo;
+    if (i) *p++ = ',';
+    return json_setor(p, i, setores_cadastrado(m, i), m->temperaturas[i], setores_em_alarme(m, i));
+}
+
+/**
+ * @brief Tamanho do corpo de GET /api/sectors para o snapshot `e`, para o Content-Length.
+ * @details Formata cada setor em um buffer de rascunho e soma: o corpo é
+ *          enviado depois, em pedaços, do mesmo snapshot.
+ */
+static uint32_t http_tamanho_json(const setores_snapshot_t *e) {
+    char rascunho[HTTP_SETOR_JSON_MAX];
+    uint32_t n = (uint32_t)(json_setores_inicio(rascunho, e) - rascunho) + 2; // + "]}"
+    for (setor_id_t i = 0; i < MAX_SETORES; i++) {
+        n += (uint32_t)(json_setores_item(rascunho, e, i) - rascunho);
+    }
+    return n;
+}
+
+/**
+ * @brief Formata o próximo pedaço de GET /api/sectors em `corpo`.
+ * @details Formato: {"v":<versao>,"b":0,"setores":[{"i":1,"c":1,"t":25.31,"a":0},...]}
+ *          com "b" = buzzer ativo, "i" = índice (1-N), "c" = cadastrado,
+ *          "t" = temperatura em °C com duas casas e "a" = alarme (cadastrado e
+ *          no nível crítico da regra de alarme). Também é o dado do evento SSE "estado".
+ *          Continua de `proximo_setor`; a resposta acabou quando ele chega a MAX_SETORES.
+ * @return uint16_t Tamanho do pedaço (até HTTP_CORPO_MAX bytes).
+ */
+static uint16_t http_formatar_json(http_conexao_t *c) {
+    char *inicio = (char *)c->corpo;
+    char *limite = inicio + sizeof(c->corpo) - 2 - HTTP_SETOR_JSON_MAX; // Sempre cabe o "]}"
+    char *p = inicio;
+    if (c->proximo_setor == 0) p = json_setores_inicio(p, c->estado);
+    while (c->proximo_setor < MAX_SETORES && p <= limite) {
+        p = json_setores_item(p, c->estado, c->proximo_setor++);
+    }
+    if (c->proximo_setor == MAX_SETORES) p = json_texto(p, "]}");
+    return (uint16_t)(p - inicio);
+}
+
+/**
+ * @brief Formata o próximo pedaço de GET /api/sectors.bin (layout descrito em http_server.h).
+ * @return uint16_t Tamanho do pedaço; os pedaços somam HTTP_API_BIN_TAMANHO.
+ */
+static uint16_t http_formatar_bin(http_conexao_t *c) {
+    uint8_t *p = c->corpo;
+    uint8_t *limite = c->corpo + sizeof(c->corpo) - 4;
+    if (c->proximo_setor == 0) {
+        uint32_t versao = c->estado->versao;
+        *p++ = HTTP_API_BIN_MAGIC0;
+        *p++ = HTTP_API_BIN_MAGIC1;
+        *p++ = HTTP_API_BIN_VERSAO;
+        *p++ = 0;
+        *p++ = (uint8_t)versao;
+        *p++ = (uint8_t)(versao >> 8);
+        *p++ = (uint8_t)(versao >> 16);
+        *p++ = (uint8_t)(versao >> 24);
+        *p++ = (uint8_t)MAX_SETORES;
+        *p++ = (uint8_t)(MAX_SETORES >> 8);
+        *p++ = (uint8_t)SETORES_COLUNAS;
+        *p++ = (uint8_t)(SETORES_COLUNAS >> 8);
+    }
+    const setores_modelo_t *m = &c->estado->modelo;
+    while (c->proximo_setor < MAX_SETORES && p <= limite) {
+        setor_id_t i = c->proximo_setor++;
+        uint16_t t = (uint16_t)http_centesimos(m->temperaturas[i]);
+        uint8_t flags = 0;
+        if (setores_cadastrado(m, i)) flags |= HTTP_API_BIN_CADASTRADO;
+        if (setores_em_alarme(m, i)) flags |= HTTP_API_BIN_ALARME;
+        if (setores_em_aviso(m, i)) flags |= HTTP_API_BIN_AVISO;
+        *p++ = (uint8_t)t;          // Temperatura (int16 little-endian)
+        *p++ = (uint8_t)(t >> 8);
+        *p++ = flags;
+        *p++ = 0;
+    }
+    return (uint16_t)(p - c->corpo);
+}
+
+/**
+ * @brief Formata o corpo de GET /api/alarms e /api/alarms/set.
+ * @details Formato: {"setor":N,"nivel":1,"aviso":90.00,"critico":100.00,
+ *          "histerese":1.00,"subida":0.00,"duracao_ms":0}, com "nivel" =
+ *          0 (normal), 1 (aviso) ou 2 (crítico) no snapshot da conexão.
+ *          Uma regra aplicada a todos os setores sai com "setor" e "nivel" null.
+ * @return uint16_t Tamanho do corpo.
+ */
+static uint16_t http_formatar_regra(http_conexao_t *c) {
+    const alarme_regra_t *r = &c->regra;
+    char *inicio = (char *)c->corpo;
+    char *p = json_texto(inicio, "{\"setor\":");
+    if (c->regra_setor == SETOR_INVALIDO) {
+        p = json_texto(p, "null,\"nivel\":null");
+    } else {
+        const setores_modelo_t *m = &c->estado->modelo;
+        p = json_uint(p, (uint32_t)c->regra_setor + 1);
+        p = json_texto(p, ",\"nivel\":");
+        *p++ = setores_em_alarme(m, c->regra_setor) ? '2' : setores_em_aviso(m, c->regra_setor) ? '1' : '0';
+    }
+    p = json_texto(p, ",\"aviso\":");
+    p = json_centesimos(p, http_centesimos(r->aviso_c));
+    p = json_texto(p, ",\"critico\":");
+    p = json_centesimos(p, http_centesimos(r->critico_c));
+    p = json_texto(p, ",\"histerese\":");
+    p = json_centesimos(p, http_centesimos(r->histerese_c));
+    p = json_texto(p, ",\"subida\":");
+    p = json_centesimos(p, http_centesimos(r->subida_c_min));
+    p = json_texto(p, ",\"duracao_ms\":");
+    p = json_uint(p, r->duracao_ms);
+    *p++ = '}';
+    return (uint16_t)(p - inicio);
+}
+
+/**
+ * @brief Formata o cabeçalho de uma rota /api (e o corpo, se cabe em um pedaço).
+ * @details /api/alarms é formatado aqui, de uma vez. /api/sectors(.bin) só tem
+ *          o tamanho calculado (o JSON, formatando cada setor em um rascunho): os
+ *          pedaços saem na etapa HTTP_ETAPA_API_SETORES. X-Format-Us é o tempo
+ *          deste cálculo; o da formatação dos pedaços entra nas estatísticas
+ *          quando o último é gerado (http_contar_api).
+ */
+static void http_preparar_api(http_conexao_t *c, http_rota_t rota) {
+    uint32_t inicio = (uint32_t)hal_tempo_us();
+    uint32_t tamanho;
+    if (rota == HTTP_ROTA_API_BIN) tamanho = HTTP_API_BIN_TAMANHO;
+    else if (rota == HTTP_ROTA_API_JSON) tamanho = http_tamanho_json(c->estado);
+    else tamanho = c->corpo_len = http_formatar_regra(c);
+    uint32_t duracao = (uint32_t)hal_tempo_us() - inicio;
+
+    int n = snprintf(c->cabecalho, sizeof(c->cabecalho),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %lu\r\n"
+                     "X-Format-Us: %lu\r\nConnection: %s\r\n\r\n",
+                     (rota == HTTP_ROTA_API_BIN) ? "application/octet-stream" : "application/json",
+                     (unsigned long)tamanho, (unsigned long)duracao,
+                     c->manter ? "keep-alive" : "close");
+    if (n >= (int)sizeof(c->cabecalho)) n = sizeof(c->cabecalho) - 1;
+    c->cabecalho_len = (uint8_t)n;
+    c->api_bytes = (uint32_t)c->cabecalho_len + tamanho;
+    c->api_formatacao_us = duracao;
+}
+
+/**
+ * @brief Formata o próximo pedaço de /api/sectors(.bin) e, no último, atualiza as estatísticas.
+ */
+static void http_contar_api(http_conexao_t *c) {
+    uint32_t inicio = (uint32_t)hal_tempo_us();
+    c->corpo_len = (c->rota == HTTP_ROTA_API_BIN) ? http_formatar_bin(c) : http_formatar_json(c);
+    c->api_formatacao_us += (uint32_t)hal_tempo_us() - inicio;
+    if (c->proximo_setor < MAX_SETORES) return;
+
+    http_api_stats_t *s = (c->rota == HTTP_ROTA_API_BIN) ? &stats_bin : &stats_json;
+    s->respostas++;
+    s->ultimo_bytes = c->api_bytes;
+    s->ultimo_formatacao_us = c->api_formatacao_us;
+    if (c->api_formatacao_us > s->pior_formatacao_us) s->pior_formatacao_us = c->api_formatacao_us;
+}
+
+/**
+ * @brief Escreve um valor do histórico em °C, ou null se não há dado.
+ */
+static char *json_historico(char *p, int16_t v) {
+    if (v == HISTORICO_SEM_DADO) return json_texto(p, "null");
+    return json_centesimos(p, historico_centesimos(v));
+}
+
+/**
+ * @brief Formata o próximo bloco de GET /api/history em `corpo`.
+ * @details Formato:
+ *          {"setor":N,"agora_ms":T,"camadas":[
+ *            {"nome":"bruto","periodo_s":5,"fim_ms":T,"valores":[25.31,null,...]},
+ *            {"nome":"1min","periodo_s":60,"fim_ms":T,"valores":[[min,max,media],...]},
+ *            {"nome":"15min",...}]}
+ *          Os valores vão do mais antigo ao mais recente; o valor j de uma camada
+ *          com n valores cobre o período que termina em fim_ms - (n - 1 - j) * periodo_s.
+ *          Valores restaurados da flash são anteriores ao boot (fim_ms negativo).
+ *          As entradas são lidas uma a uma no anel, sem cópia do histórico: o
+ *          fim de cada camada é fixado quando ela começa a ser enviada, e uma
+ *          entrada sobrescrita pelo núcleo 1 durante o envio sai como null.
+ * @return uint16_t Tamanho do bloco (até HTTP_CORPO_MAX bytes).
+ */
+static uint16_t http_formatar_historico(http_conexao_t *c) {
+    uint32_t t0 = (uint32_t)hal_tempo_us();
+    char *inicio = (char *)c->corpo;
+    char *limite = inicio + sizeof(c->corpo) - HTTP_HISTORICO_MARGEM;
+    char *p = inicio;
+
+    if (c->historico_camada < 0) {
+        p = json_texto(p, "{\"setor\":");
+        p = json_uint(p, (uint32_t)c->historico_setor + 1);
+        p = json_texto(p, ",\"agora_ms\":");
+        p = json_uint(p, (uint32_t)(hal_tempo_us() / 1000));
+        p = json_texto(p, ",\"camadas\":[");
+    }
+    while (p < limite) {
+        if (c->historico_proximo == c->historico_fim) {
+            // Camada concluída (ou nenhuma aberta ainda): passa à próxima
+            if (c->historico_camada >= 0) p = json_texto(p, "]}");
+            if (++c->historico_camada == HISTORICO_CAMADAS) {
+                p = json_texto(p, "]}");
+                c->etapa = c->chunked ? HTTP_ETAPA_ULTIMO_CHUNK : HTTP_ETAPA_CONCLUIDA;
+                break;
+            }
+            uint8_t camada = (uint8_t)c->historico_camada;
+            historico_intervalo(camada, &c->historico_inicio, &c->historico_fim);
+            c->historico_proximo = c->historico_inicio;
+            if (camada) *p++ = ',';
+            p = json_texto(p, "{\"nome\":\"");
+            p = json_texto(p, historico_nome(camada));
+            p = json_texto(p, "\",\"periodo_s\":");
+            p = json_uint(p, historico_periodo_s(camada));
+            p = json_texto(p, ",\"fim_ms\":");
+            if (c->historico_fim == c->historico_inicio) {
+                p = json_texto(p, "null");
+            } else {
+                p = json_int(p, (int32_t)(historico_instante_us(camada, c->historico_fim - 1) / 1000));
+            }
+            p = json_texto(p, ",\"valores\":[");
+            continue;
+        }
+
+        historico_ponto_t v;
+        historico_ler((uint8_t)c->historico_camada, c->historico_setor, c->historico_proximo, &v);
+        if (c->historico_proximo != c->historico_inicio) *p++ = ',';
+        c->historico_proximo++;
+        if (c->historico_camada == HISTORICO_BRUTO) {
+            p = json_historico(p, v.media);
+        } else if (v.media == HISTORICO_SEM_DADO) {
+            p = json_texto(p, "null");
+        } else {
+            *p++ = '[';
+            p = json_historico(p, v.min);
+            *p++ = ',';
+            p = json_historico(p, v.max);
+            *p++ = ',';
+            p = json_historico(p, v.media);
+            *p++ = ']';
+        }
+    }
+
+    uint16_t len = (uint16_t)(p - inicio);
+    uint32_t duracao = (uint32_t)hal_tempo_us() - t0;
+    stats_historico.ultimo_bytes += len;
+    stats_historico.ultimo_formatacao_us += duracao;
+    if (c->etapa != HTTP_ETAPA_HISTORICO &&
+        stats_historico.ultimo_formatacao_us > stats_historico.pior_formatacao_us) {
+        stats_historico.pior_formatacao_us = stats_historico.ultimo_formatacao_us;
+    }
+    return len;
+}
+
+// Nomes dos comandos no diário (setor_cmd_tipo_t)
+static const char *const http_comandos[] = {
+    [SETOR_CMD_DEFINIR_TEMPERATURA] = "definir_temperatura",
+    [SETOR_CMD_LIMPAR] = "limpar",
+    [SETOR_CMD_RESETAR_ALERTAS] = "resetar_alertas",
+    [SETOR_CMD_MODO_CADASTRO] = "modo_cadastro",
+    [SETOR_CMD_DEFINIR_REGRA] = "definir_regra",
+    [SETOR_CMD_ENCERRAR] = "encerrar",
+};
+
+/**
+ * @brief Escreve o objeto JSON de um evento do diário.
+ * @details Campos comuns: "seq", "ms" (desde o boot) e "tipo"; os demais
+ *          dependem do tipo (diario_tipo_t):
+ *          cadastro {"setor","cadastrado","t"}, temperatura {"setor","t"},
+ *          nivel {"setor","nivel","t"}, buzzer {"ativo"},
+ *          comando {"comando"[,"setor"][,"t"]}, perdidos {"nucleo","quantidade"}.
+ */
+static char *json_evento_diario(char *p, const diario_evento_t *e) {
+    p = json_texto(p, "{\"seq\":");
+    p = json_uint(p, e->seq);
+    p = json_texto(p, ",\"ms\":");
+    p = json_uint(p, e->instante);
+    p = json_texto(p, ",\"tipo\":\"");
+    p = json_texto(p, diario_nome(e->tipo));
+    *p++ = '"';
+    switch (e->tipo) {
+        case DIARIO_BUZZER:
+            p = json_texto(p, e->dado ? ",\"ativo\":1" : ",\"ativo\":0");
+            break;
+        case DIARIO_PERDIDOS:
+            p = json_texto(p, ",\"nucleo\":");
+            p = json_uint(p, e->dado);
+            p = json_texto(p, ",\"quantidade\":");
+            p = json_uint(p, e->valor.quantidade);
+            break;
+        case DIARIO_COMANDO:
+            p = json_texto(p, ",\"comando\":\"");
+            p = json_texto(p, e->dado < sizeof(http_comandos) / sizeof(http_comandos[0]) ? http_comandos[e->dado] : "?");
+            *p++ = '"';
+            // fall through
+        default:
+            if (e->setor < MAX_SETORES) {
+                p = json_texto(p, ",\"setor\":");
+                p = json_uint(p, (uint32_t)e->setor + 1);
+            }
+            if (e->tipo == DIARIO_CADASTRO) p = json_texto(p, e->dado ? ",\"cadastrado\":1" : ",\"cadastrado\":0");
+            if (e->tipo == DIARIO_NIVEL) {
+                p = json_texto(p, ",\"nivel\":");
+                p = json_uint(p, e->dado);
+            }
+            if (e->tipo != DIARIO_COMANDO || e->dado == SETOR_CMD_DEFINIR_TEMPERATURA) {
+                p = json_texto(p, ",\"t\":");
+                p = json_centesimos(p, http_centesimos(e->valor.celsius));
+            }
+            break;
+    }
+    *p++ = '}';
+    return p;
+}
+
+/**
+ * @brief Formata o próximo bloco de GET /api/events em `corpo`.
+ * @details Formato: {"seq":S,"primeiro":P,"descartados":D,"eventos":[...]},
+ *          com os eventos de seq maior que `since` até S (o mais recente no
+ *          início do envio); o cliente repete o pedido com since=S. "primeiro"
+ *          é o evento mais antigo guardado: se for maior que since+1, eventos
+ *          foram sobrescritos antes de serem lidos. "descartados" conta os
+ *          perdidos por anel cheio desde o boot. O JSON é gerado aqui, a partir
+ *          dos registros binários; um evento sobrescrito durante o envio é pulado.
+ * @return uint16_t Tamanho do bloco (até HTTP_CORPO_MAX bytes).
+ */
+static uint16_t http_formatar_diario(http_conexao_t *c) {
+    char *inicio = (char *)c->corpo;
+    char *limite = inicio + sizeof(c->corpo) - HTTP_DIARIO_MARGEM;
+    char *p = inicio;
+
+    if (c->diario_proximo == 0) {
+        uint32_t primeiro = diario_primeiro();
+        c->diario_fim = diario_ultimo();
+        c->diario_proximo = c->diario_desde >= primeiro ? c->diario_desde + 1 : primeiro;
+        p = json_texto(p, "{\"seq\":");
+        p = json_uint(p, c->diario_fim);
+        p = json_texto(p, ",\"primeiro\":");
+        p = json_uint(p, primeiro);
+        p = json_texto(p, ",\"descartados\":");
+        p = json_uint(p, diario_descartados());
+        p = json_texto(p, ",\"eventos\":[");
+    }
+    while (p < limite) {
+        if (c->diario_proximo > c->diario_fim) {
+            p = json_texto(p, "]}");
+            c->etapa = c->chunked ? HTTP_ETAPA_ULTIMO_CHUNK : HTTP_ETAPA_CONCLUIDA;
+            break;
+        }
+        diario_evento_t e;
+        if (!diario_ler(c->diario_proximo++, &e)) {
+            // Sobrescrito pelo dreno entre dois blocos: segue do mais antigo restante
+            uint32_t primeiro = diario_primeiro();
+            if (c->diario_proximo < primeiro) c->diario_proximo = primeiro;
+            continue;
+        }
+        if (p == inicio || p[-1] != '[') *p++ = ','; // Todo bloco seguinte ao primeiro continua a lista
+        p = json_evento_diario(p, &e);
+    }
+    return (uint16_t)(p - inicio);
+}
+// =====================================================================
+
+// ===== PARSER INCREMENTAL DA REQUISIÇÃO =====
+
+/**
+ * @brief Volta a conexão ao estado "aguardando requisição" (início ou keep-alive).
+ */
+static void http_reiniciar(http_conexao_t *c) {
+    http_estado_liberar(c);
+    c->parser = HTTP_PARSER_REQUISICAO;
+    c->req_linha_len = 0;
+    c->req_linha_truncada = false;
+    c->corpo_restante = 0;
+    c->rota = HTTP_ROTA_PAGINA;
+    c->http11 = false;
+    c->manter = false;
+    c->sse_ressinc = false;
+    c->etapa = HTTP_ETAPA_OCIOSA;
+    c->chunked = false;
+    c->parte_len = c->parte_enviado = 0;
+    c->pendente = NULL;
+    c->sufixo_pendente = false;
+    c->ociosidade_s = 0;
+}
+
+/**
+ * @brief Procura "nome=valor" na query string.
+ * @return const char* Início do valor, ou NULL se o parâmetro está ausente.
+ */
+static const char *http_consulta_buscar(const char *consulta, const char *nome) {
+    size_t n = strlen(nome);
+    const char *p = consulta;
+    while (p && *p) {
+        if (strncmp(p, nome, n) == 0 && p[n] == '=') return p + n + 1;
+        p = strchr(p, '&');
+        if (p) p++;
+    }
+    return NULL;
+}
+
+// O número terminou no fim do valor (e não é vazio)
+static bool http_consulta_fim(const char *valor, const char *fim) {
+    return fim != valor && (*fim == '\0' || *fim == '&');
+}
+
+/**
+ * @brief Procura "nome=valor" na query string e converte o valor em inteiro decimal.
+ * @return bool `false` se o parâmetro está ausente ou o valor não é um número.
+ */
+static bool http_consulta_inteiro(const char *consulta, const char *nome, long *valor) {
+    const char *v = http_consulta_buscar(consulta, nome);
+    if (!v) return false;
+    char *fim;
+    *valor = strtol(v, &fim, 10);
+    return http_consulta_fim(v, fim);
+}
+
+/**
+ * @brief Substitui `*valor` pelo parâmetro "nome", se presente na query string.
+ * @return bool `false` se o parâmetro está presente mas não é um número.
+ */
+static bool http_consulta_real(const char *consulta, const char *nome, float *valor) {
+    const char *v = http_consulta_buscar(consulta, nome);
+    if (!v) return true;
+    char *fim;
+    *valor = strtof(v, &fim);
+    return http_consulta_fim(v, fim);
+}
+
+/**
+ * @brief Lê o setor e, em /api/alarms/set, a nova regra da query string.
+ * @details Em /set os limites omitidos mantêm o valor atual do setor; sem
+ *          "sector", a regra vale para todos e parte de alarme_regra_padrao.
+ * @return bool `false` se um parâmetro está ausente, malformado ou a regra é inválida.
+ */
+static bool http_parser_regra(http_conexao_t *c, const char *consulta) {
+    bool definir = c->rota == HTTP_ROTA_API_ALARMES_DEFINIR;
+    long setor;
+    if (http_consulta_inteiro(consulta, "sector", &setor)) {
+        if (setor < 1 || setor > MAX_SETORES) return false;
+        c->regra_setor = (setor_id_t)(setor - 1);
+        alarmes_ler_regra(c->regra_setor, &c->regra);
+    } else if (definir && !http_consulta_buscar(consulta, "sector")) {
+        c->regra_setor = SETOR_INVALIDO;
+        c->regra = alarme_regra_padrao;
+    } else {
+        return false;
+    }
+    if (!definir) return true;
+
+    long duracao = (long)c->regra.duracao_ms;
+    if (http_consulta_buscar(consulta, "duracao_ms") && !http_consulta_inteiro(consulta, "duracao_ms", &duracao)) {
+        return false;
+    }
+    if (duracao < 0 || duracao > ALARMES_DURACAO_MAX_MS) return false;
+    c->regra.duracao_ms = (uint32_t)duracao;
+    return http_consulta_real(consulta, "aviso", &c->regra.aviso_c) &&
+           http_consulta_real(consulta, "critico", &c->regra.critico_c) &&
+           http_consulta_real(consulta, "histerese", &c->regra.histerese_c) &&
+           http_consulta_real(consulta, "subida", &c->regra.subida_c_min) &&
+           alarmes_regra_valida(&c->regra);
+}
+
+/**
+ * @brief Interpreta a linha "METODO caminho HTTP/1.x" acumulada em `req_linha`.
+ * @param truncada A linha excedeu o buffer (caminho longo demais).
+ */
+static void http_parser_requisicao(http_conexao_t *c, bool truncada) {
+    char *metodo = c->req_linha;
+    char *caminho = strchr(metodo, ' ');
+    char *versao = caminho ? strchr(caminho + 1, ' ') : NULL;
+    if (truncada || !versao) {
+        c->rota = HTTP_ROTA_REQUISICAO_INVALIDA;
+        return;
+    }
+    *caminho++ = '\0';
+    *versao++ = '\0';
+    if (strncmp(versao, "HTTP/1.", 7) != 0) {
+        c->rota = HTTP_ROTA_REQUISICAO_INVALIDA;
+        return;
+    }
+    c->http11 = strcmp(versao, "HTTP/1.0") != 0;
+    c->manter = c->http11; // HTTP/1.1 mantém a conexão por padrão; HTTP/1.0 fecha
+
+    if (strcmp(metodo, "GET") != 0) {
+        c->rota = HTTP_ROTA_METODO_INVALIDO;
+        return;
+    }
+    char *consulta = strchr(caminho, '?');
+    if (consulta) *consulta++ = '\0';
+    c->rota = HTTP_ROTA_NAO_ENCONTRADA;
+    for (size_t i = 0; i < sizeof(http_rotas) / sizeof(http_rotas[0]); i++) {
+        if (strcmp(caminho, http_rotas[i].caminho) == 0) {
+            c->rota = http_rotas[i].rota;
+            break;
+        }
+    }
+
+    if (c->rota == HTTP_ROTA_API_HISTORICO) {
+        long setor;
+        if (!consulta || !http_consulta_inteiro(consulta, "sector", &setor) ||
+            setor < 1 || setor > MAX_SETORES) {
+            c->rota = HTTP_ROTA_PARAMETRO_INVALIDO;
+            return;
+        }
+        c->historico_setor = (setor_id_t)(setor - 1);
+    } else if (c->rota == HTTP_ROTA_API_ALARMES || c->rota == HTTP_ROTA_API_ALARMES_DEFINIR) {
+        if (!http_parser_regra(c, consulta)) c->rota = HTTP_ROTA_PARAMETRO_INVALIDO;
+    } else if (c->rota == HTTP_ROTA_API_DIARIO) {
+        long desde = 0; // Sem `since`: todos os eventos guardados
+        if (http_consulta_buscar(consulta, "since") &&
+            (!http_consulta_inteiro(consulta, "since", &desde) || desde < 0)) {
+            c->rota = HTTP_ROTA_PARAMETRO_INVALIDO;
+            return;
+        }
+        c->diario_desde = (uint32_t)desde;
+    }
+}
+
+/**
+ * @brief Interpreta um cabeçalho; somente Connection e Content-Length importam.
+ */
+static void http_parser_cabecalho(http_conexao_t *c) {
+    char *linha = c->req_linha;
+    for (char *p = linha; *p; p++) *p = (char)tolower((unsigned char)*p); // Nomes e valores usados são case-insensitive
+    if (strncmp(linha, "connection:", 11) == 0) {
+        if (strstr(linha + 11, "close")) c->manter = false;
+        else if (strstr(linha + 11, "keep-alive")) c->manter = true;
+    } else if (strncmp(linha, "content-length:", 15) == 0) {
+        c->corpo_restante = strtoul(linha + 15, NULL, 10);
+    }
+}
+
+/**
+ * @brief Alimenta o parser com um byte da linha de requisição ou dos cabeçalhos.
+ * @return bool `true` quando os cabeçalhos terminaram.
+ */
+static bool http_parser_byte(http_conexao_t *c, char ch) {
+    if (ch != '\n') {
+        if (c->req_linha_len < HTTP_REQ_LINHA_MAX - 1) {
+            c->req_linha[c->req_linha_len++] = ch;
+        } else {
+            c->req_linha_truncada = true; // O excedente é descartado
+        }
+        return false;
+    }
+
+    // Fim de linha: remove o '\r' e processa
+    uint8_t len = c->req_linha_len;
+    if (len && c->req_linha[len - 1] == '\r') len--;
+    c->req_linha[len] = '\0';
+    bool truncada = c->req_linha_truncada;
+    c->req_linha_len = 0;
+    c->req_linha_truncada = false;
+
+    if (c->parser == HTTP_PARSER_REQUISICAO) {
+        if (len == 0) return false; // Linhas vazias antes da requisição são ignoradas
+        http_parser_requisicao(c, truncada);
+        c->parser = HTTP_PARSER_CABECALHOS;
+        return false;
+    }
+    if (len == 0) return true; // Linha vazia: fim dos cabeçalhos
+    if (!truncada) http_parser_cabecalho(c);
+    return false;
+}
+
+/**
+ * @brief Consome os pbufs recebidos até completar uma requisição.
+ * @return bool `true` se uma requisição completa foi lida (o restante fica em `rx`).
+ * @details Os bytes consumidos são liberados e devolvidos à janela de recepção.
+ */
+static bool http_consumir(http_conexao_t *c) {
+    while (c->rx) {
+        struct pbuf *q = c->rx;
+        if (q->len == 0) { // pbuf vazio no meio da cadeia
+            c->rx = q->next;
+            if (c->rx) pbuf_ref(c->rx);
+            pbuf_free(q);
+            continue;
+        }
+        const char *dados = (const char *)q->payload;
+        uint16_t usados = 0;
+        bool completa = false;
+        while (usados < q->len && !completa) {
+            if (c->parser == HTTP_PARSER_CORPO) {
+                // Corpo da requisição: descartado em bloco
+                uint16_t n = q->len - usados;
+                if (n > c->corpo_restante) n = (uint16_t)c->corpo_restante;
+                usados += n;
+                c->corpo_restante -= n;
+                completa = (c->corpo_restante == 0);
+            } else if (http_parser_byte(c, dados[usados++])) {
+                if (c->corpo_restante && c->rota != HTTP_ROTA_REQUISICAO_INVALIDA) {
+                    c->parser = HTTP_PARSER_CORPO;
+                } else {
+                    completa = true;
+                }
+            }
+        }
+        c->rx = pbuf_free_header(q, usados);
+        tcp_recved(c->pcb, usados);
+        if (completa) return true;
+    }
+    return false;
+}
+// ============================================
+
+/**
+ * @brief Libera a entrada da conexão e fecha o PCB.
+ * @return err_t ERR_ABRT se o PCB teve de ser abortado (deve ser devolvido ao lwIP
+ *         quando a chamada ocorre em um callback desta conexão), senão ERR_OK.
+ * @details Se o fechamento gracioso falhar (falta de memória), aborta o PCB.
+ */
+static err_t http_fechar(http_conexao_t *c) {
+    struct tcp_pcb *pcb = c->pcb;
+    if (c->rx) {
+        pbuf_free(c->rx);
+        c->rx = NULL;
+    }
+    c->pcb = NULL;
+    c->etapa = HTTP_ETAPA_OCIOSA;
+    http_estado_liberar(c);
+    if (!pcb) return ERR_OK;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+/**
+ * @brief Aborta a conexão (RST) e libera a entrada.
+ * @return err_t Sempre ERR_ABRT.
+ */
+static err_t http_abortar(http_conexao_t *c) {
+    struct tcp_pcb *pcb = c->pcb;
+    if (c->rx) {
+        pbuf_free(c->rx);
+        c->rx = NULL;
+    }
+    c->pcb = NULL;
+    c->etapa = HTTP_ETAPA_OCIOSA;
+    http_estado_liberar(c);
+    if (pcb) {
+        tcp_arg(pcb, NULL);
+        tcp_err(pcb, NULL);
+        tcp_abort(pcb);
+    }
+    return ERR_ABRT;
+}
+
+/**
+ * @brief Conta as conexões com stream /events aberto.
+ */
+static int http_num_eventos(void) {
+    int n = 0;
+    for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+        if (conexoes[i].pcb && conexoes[i].etapa >= HTTP_ETAPA_SSE_CABECALHO &&
+            conexoes[i].etapa <= HTTP_ETAPA_SSE_ESTADO_FIM) {
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Prepara a resposta para a requisição que o parser acabou de ler.
+ */
+static void http_iniciar_resposta(http_conexao_t *c) {
+    stats_conexoes.requisicoes++;
+    LOG_DEPURACAO("HTTP: rota %d, keep-alive %d", c->rota, c->manter);
+    switch (c->rota) {
+        case HTTP_ROTA_RESETAR_ALARMES:
+            solicitar_reset_alertas(); // Reseta os alarmes (o clique no link é a confirmação)
+            break;
+        case HTTP_ROTA_LIMPAR_SISTEMA:
+            solicitar_limpeza(); // Pede ao núcleo 1 para limpar o sistema
+            break;
+        default:
+            break;
+    }
+
+    c->proximo_setor = 0;
+    c->parte_len = c->parte_enviado = 0;
+    switch (c->rota) {
+        case HTTP_ROTA_PAGINA:
+        case HTTP_ROTA_RESETAR_ALARMES:
+        case HTTP_ROTA_LIMPAR_SISTEMA:
+            // Gera a página a partir de um snapshot tirado agora. Um comando
+            // recém-enviado pode ainda não aparecer, pois o núcleo 1 o aplica no próximo tick.
+            http_estado_adquirir(c);
+            if (!c->http11) c->manter = false; // Sem chunked, o fim da página é o fechamento
+            c->chunked = c->manter;
+            c->etapa = HTTP_ETAPA_CABECALHO;
+            break;
+        case HTTP_ROTA_API_JSON:
+        case HTTP_ROTA_API_BIN:
+            http_estado_adquirir(c);
+            http_preparar_api(c, c->rota);
+            c->etapa = HTTP_ETAPA_API_CABECALHO;
+            break;
+        case HTTP_ROTA_API_ALARMES_DEFINIR:
+            // Aplicada pelo núcleo 1 no próximo tick; a resposta ecoa a regra enviada
+            if (!setores_enviar_regra(c->regra_setor, &c->regra)) {
+                c->rota = HTTP_ROTA_INDISPONIVEL; // Fila de comandos cheia: o cliente repete
+                c->etapa = HTTP_ETAPA_ERRO;
+                break;
+            }
+            // fall through
+        case HTTP_ROTA_API_ALARMES:
+            http_estado_adquirir(c);
+            http_preparar_api(c, c->rota); // Corpo formatado de uma vez: o estado já não é lido
+            http_estado_liberar(c);
+            c->etapa = HTTP_ETAPA_API_CABECALHO;
+            break;
+        case HTTP_ROTA_EVENTOS:
+            // Streams ocupam a entrada indefinidamente: limitados para não esgotar a tabela
+            if (http_num_eventos() >= HTTP_MAX_EVENTOS) {
+                c->rota = HTTP_ROTA_INDISPONIVEL;
+                c->etapa = HTTP_ETAPA_ERRO;
+                break;
+            }
+            c->etapa = HTTP_ETAPA_SSE_CABECALHO; // O cliente já tem o estado (página ou /api/sectors)
+            break;
+        case HTTP_ROTA_API_HISTORICO:
+            // Tamanho desconhecido de antemão: chunked, ou fechamento em HTTP/1.0
+            if (!c->http11) c->manter = false;
+            c->chunked = c->manter;
+            c->historico_camada = -1;
+            c->historico_proximo = c->historico_fim = 0;
+            stats_historico.respostas++;
+            stats_historico.ultimo_bytes = 0;
+            stats_historico.ultimo_formatacao_us = 0;
+            c->etapa = HTTP_ETAPA_HISTORICO_CABECALHO;
+            break;
+        case HTTP_ROTA_API_DIARIO:
+            // Como /api/history: blocos em chunked, ou fechamento em HTTP/1.0
+            if (!c->http11) c->manter = false;
+            c->chunked = c->manter;
+            c->diario_proximo = 0;
+            c->etapa = HTTP_ETAPA_DIARIO_CABECALHO;
+            break;
+        case HTTP_ROTA_REQUISICAO_INVALIDA:
+            c->manter = false; // O restante do fluxo não pode ser interpretado
+            // fall through
+        default:
+            c->etapa = HTTP_ETAPA_ERRO;
+            break;
+    }
+}
+
+/**
+ * @brief Prepara a próxima parte da resposta.
+ * @return http_parte_tipo_t HTTP_PARTE_NENHUMA quando a resposta está completa.
+ */
+static http_parte_tipo_t http_proxima_parte(http_conexao_t *c) {
+    c->parte_enviado = 0;
+    c->parte_flags = 0; // Partes constantes: referenciadas diretamente na flash
+    switch (c->etapa) {
+        case HTTP_ETAPA_CABECALHO:
+            if (c->chunked) {
+                c->parte = http_cabecalho_chunked;
+                c->parte_len = sizeof(http_cabecalho_chunked) - 1;
+            } else {
+                c->parte = http_cabecalho_close;
+                c->parte_len = sizeof(http_cabecalho_close) - 1;
+            }
+            c->etapa = HTTP_ETAPA_INICIO;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_INICIO:
+            c->parte = http_pagina_inicio;
+            c->parte_len = sizeof(http_pagina_inicio) - 1;
+            c->etapa = HTTP_ETAPA_SETORES;
+            c->proximo_setor = 0;
+            return HTTP_PARTE_CORPO;
+
+        case HTTP_ETAPA_SETORES:
+            // Próximo setor cadastrado, direto do conjunto de bits
+            c->proximo_setor = setores_bits_proximo(&c->estado->modelo.cadastrados, c->proximo_setor);
+            if (c->proximo_setor != SETOR_INVALIDO) {
+                int i = c->proximo_setor++;
+                // Formata a linha do setor (nome, índice, temperatura, alerta)
+                // (id, <span> e <b> permitem que o script da página aplique os eventos de /events)
+                int n = snprintf(c->linha, sizeof(c->linha), "<li id='s%d'>%s (Indice %d): <span>%.2f</span> C <b>%s</b></li>",
+                                 i + 1,
+                                 nomes_setores[i],
+                                 i + 1, // Índice para o usuário (1-N)
+                                 c->estado->modelo.temperaturas[i],
+                                 setores_em_alarme(&c->estado->modelo, (setor_id_t)i) ? "(ALERTA!)" : ""); // Alerta no nível crítico
+                if (n >= (int)sizeof(c->linha)) n = sizeof(c->linha) - 1;
+                c->parte = c->linha;
+                c->parte_len = (uint16_t)n;
+                c->parte_flags = TCP_WRITE_FLAG_COPY; // O buffer será reutilizado na próxima linha
+                return HTTP_PARTE_CORPO;
+            }
+            c->etapa = HTTP_ETAPA_BUZZER;
+            // fall through
+        case HTTP_ETAPA_BUZZER:
+            if (c->estado->buzzer_ativo) {
+                c->parte = http_pagina_buzzer_ativo;
+                c->parte_len = sizeof(http_pagina_buzzer_ativo) - 1;
+            } else {
+                c->parte = http_pagina_buzzer_desativado;
+                c->parte_len = sizeof(http_pagina_buzzer_desativado) - 1;
+            }
+            http_estado_liberar(c); // O restante da página é constante
+            c->etapa = HTTP_ETAPA_FIM;
+            return HTTP_PARTE_CORPO;
+
+        case HTTP_ETAPA_FIM:
+            c->parte = http_pagina_fim;
+            c->parte_len = sizeof(http_pagina_fim) - 1;
+            c->etapa = c->chunked ? HTTP_ETAPA_ULTIMO_CHUNK : HTTP_ETAPA_CONCLUIDA;
+            return HTTP_PARTE_CORPO;
+
+        case HTTP_ETAPA_ULTIMO_CHUNK:
+            c->parte = http_chunk_ultimo;
+            c->parte_len = sizeof(http_chunk_ultimo) - 1;
+            c->etapa = HTTP_ETAPA_CONCLUIDA;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_API_CABECALHO:
+            c->parte = c->cabecalho;
+            c->parte_len = c->cabecalho_len;
+            c->parte_flags = TCP_WRITE_FLAG_COPY; // A entrada pode ser reutilizada antes do ACK
+            c->etapa = (c->rota == HTTP_ROTA_API_JSON || c->rota == HTTP_ROTA_API_BIN) ? HTTP_ETAPA_API_SETORES
+                                                                                      : HTTP_ETAPA_API_CORPO;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_API_CORPO:
+            c->parte = (const char *)c->corpo;
+            c->parte_len = c->corpo_len;
+            c->parte_flags = TCP_WRITE_FLAG_COPY;
+            c->etapa = HTTP_ETAPA_CONCLUIDA;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_API_SETORES:
+            http_contar_api(c);
+            c->parte = (const char *)c->corpo;
+            c->parte_len = c->corpo_len;
+            c->parte_flags = TCP_WRITE_FLAG_COPY; // O buffer recebe o próximo pedaço
+            if (c->proximo_setor == MAX_SETORES) {
+                http_estado_liberar(c);
+                c->etapa = HTTP_ETAPA_CONCLUIDA;
+            }
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_HISTORICO_CABECALHO:
+            if (c->chunked) {
+                c->parte = http_cabecalho_json_chunked;
+                c->parte_len = sizeof(http_cabecalho_json_chunked) - 1;
+            } else {
+                c->parte = http_cabecalho_json_close;
+                c->parte_len = sizeof(http_cabecalho_json_close) - 1;
+            }
+            stats_historico.ultimo_bytes += c->parte_len;
+            c->etapa = HTTP_ETAPA_HISTORICO;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_HISTORICO:
+            c->parte = (const char *)c->corpo;
+            c->parte_len = http_formatar_historico(c); // Avança a etapa no último bloco
+            c->parte_flags = TCP_WRITE_FLAG_COPY; // O buffer recebe o próximo bloco
+            return HTTP_PARTE_CORPO;
+
+        case HTTP_ETAPA_DIARIO_CABECALHO:
+            if (c->chunked) {
+                c->parte = http_cabecalho_json_chunked;
+                c->parte_len = sizeof(http_cabecalho_json_chunked) - 1;
+            } else {
+                c->parte = http_cabecalho_json_close;
+                c->parte_len = sizeof(http_cabecalho_json_close) - 1;
+            }
+            c->etapa = HTTP_ETAPA_DIARIO;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_DIARIO:
+            c->parte = (const char *)c->corpo;
+            c->parte_len = http_formatar_diario(c); // Avança a etapa no último bloco
+            c->parte_flags = TCP_WRITE_FLAG_COPY;
+            return HTTP_PARTE_CORPO;
+
+        case HTTP_ETAPA_SSE_CABECALHO:
+            c->parte = http_cabecalho_eventos;
+            c->parte_len = sizeof(http_cabecalho_eventos) - 1;
+            c->etapa = HTTP_ETAPA_SSE;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_SSE:
+            if (!c->sse_ressinc) return HTTP_PARTE_NENHUMA; // Aguarda eventos
+            // Eventos foram perdidos: envia o estado completo como evento "estado"
+            c->sse_ressinc = false;
+            stats_conexoes.ressincronizacoes++;
+            http_estado_adquirir(c);
+            c->proximo_setor = 0;
+            c->parte = http_evento_estado;
+            c->parte_len = sizeof(http_evento_estado) - 1;
+            c->etapa = HTTP_ETAPA_SSE_ESTADO_CORPO;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_SSE_ESTADO_CORPO:
+            c->parte = (const char *)c->corpo;
+            c->parte_len = http_formatar_json(c);
+            c->parte_flags = TCP_WRITE_FLAG_COPY;
+            if (c->proximo_setor == MAX_SETORES) {
+                http_estado_liberar(c);
+                c->etapa = HTTP_ETAPA_SSE_ESTADO_FIM;
+            }
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_SSE_ESTADO_FIM:
+            c->parte = http_evento_fim;
+            c->parte_len = sizeof(http_evento_fim) - 1;
+            c->etapa = HTTP_ETAPA_SSE;
+            return HTTP_PARTE_CRUA;
+
+        case HTTP_ETAPA_ERRO:
+            if (c->rota == HTTP_ROTA_INDISPONIVEL) {
+                c->parte = http_resposta_503;
+                c->parte_len = sizeof(http_resposta_503) - 1;
+            } else if (c->rota == HTTP_ROTA_METODO_INVALIDO) {
+                c->parte = http_resposta_405;
+                c->parte_len = sizeof(http_resposta_405) - 1;
+            } else if (c->rota == HTTP_ROTA_PARAMETRO_INVALIDO) {
+                c->parte = http_resposta_400_parametro;
+                c->parte_len = sizeof(http_resposta_400_parametro) - 1;
+            } else if (c->rota == HTTP_ROTA_NAO_ENCONTRADA) {
+                c->parte = http_resposta_404;
+                c->parte_len = sizeof(http_resposta_404) - 1;
+            } else {
+                c->parte = http_resposta_400;
+                c->parte_len = sizeof(http_resposta_400) - 1;
+            }
+            c->etapa = HTTP_ETAPA_CONCLUIDA;
+            return HTTP_PARTE_CRUA;
+
+        default:
+            return HTTP_PARTE_NENHUMA;
+    }
+}
+
+/**
+ * @brief Seleciona o próximo trecho a enviar, envolvendo o corpo em chunks.
+ * @return bool `false` quando a resposta está completa.
+ * @details Em modo chunked cada parte do corpo é enviada como
+ *          "<tamanho hex>\r\n" + dados + "\r\n".
+ */
+static bool http_proximo_trecho(http_conexao_t *c) {
+    c->parte_enviado = 0;
+    if (c->pendente) {
+        c->parte = c->pendente;
+        c->parte_len = c->pendente_len;
+        c->parte_flags = c->pendente_flags;
+        c->pendente = NULL;
+        c->sufixo_pendente = true;
+        return true;
+    }
+    if (c->sufixo_pendente) {
+        c->parte = http_chunk_fim;
+        c->parte_len = sizeof(http_chunk_fim) - 1;
+        c->parte_flags = 0;
+        c->sufixo_pendente = false;
+        return true;
+    }
+    http_parte_tipo_t tipo = http_proxima_parte(c);
+    if (tipo == HTTP_PARTE_NENHUMA) {
+        c->parte_len = 0; // Nada a reenviar
+        return false;
+    }
+    if (tipo == HTTP_PARTE_CORPO && c->chunked && c->parte_len > 0) {
+        c->pendente = c->parte;
+        c->pendente_len = c->parte_len;
+        c->pendente_flags = c->parte_flags;
+        int n = snprintf(c->moldura, sizeof(c->moldura), "%X\r\n", (unsigned)c->parte_len);
+        c->parte = c->moldura;
+        c->parte_len = (uint16_t)n;
+        c->parte_flags = TCP_WRITE_FLAG_COPY;
+    }
+    return true;
+}
+
+/**
+ * @brief Indica se não há mais nada a enfileirar agora (sem TCP_WRITE_FLAG_MORE).
+ */
+static bool http_ultimo_trecho(const http_conexao_t *c) {
+    return (c->etapa == HTTP_ETAPA_CONCLUIDA || (c->etapa == HTTP_ETAPA_SSE && !c->sse_ressinc)) &&
+           !c->pendente && !c->sufixo_pendente;
+}
+
+/**
+ * @brief Indica se a resposta inteira já foi enfileirada no lwIP.
+ */
+static bool http_resposta_enfileirada(const http_conexao_t *c) {
+    return c->etapa == HTTP_ETAPA_CONCLUIDA && !c->pendente && !c->sufixo_pendente &&
+           c->parte_enviado >= c->parte_len;
+}
+
+/**
+ * @brief Enfileira no lwIP tudo o que couber na cota de envio da conexão.
+ * @return err_t Diferente de ERR_OK se a conexão foi fechada/abortada.
+ * @details Chamada ao iniciar a resposta, a cada `tcp_sent` e em `tcp_poll`.
+ *          Respeita `tcp_sndbuf()` e a cota por conexão em bytes
+ *          (HTTP_BYTES_POR_CONEXAO) e segmentos (HTTP_SEGMENTOS_POR_CONEXAO),
+ *          para que muitos clientes simultâneos não esgotem o heap nem
+ *          MEMP_NUM_TCP_SEG; partes maiores que o espaço livre são enviadas em pedaços.
+ */
+static err_t http_enviar(http_conexao_t *c) {
+    struct tcp_pcb *pcb = c->pcb;
+    bool enfileirou = false;
+
+    while (true) {
+        if (c->parte_enviado >= c->parte_len) {
+            if (!http_proximo_trecho(c)) break;
+            continue;
+        }
+        uint16_t livre = tcp_sndbuf(pcb);
+        uint16_t em_voo = (uint16_t)(TCP_SND_BUF - livre);
+        if (em_voo >= HTTP_BYTES_POR_CONEXAO || tcp_sndqueuelen(pcb) >= HTTP_SEGMENTOS_POR_CONEXAO) {
+            break; // Cota esgotada: aguarda tcp_sent
+        }
+        if (livre > HTTP_BYTES_POR_CONEXAO - em_voo) livre = HTTP_BYTES_POR_CONEXAO - em_voo;
+
+        uint16_t restante = c->parte_len - c->parte_enviado;
+        uint16_t tamanho = restante < livre ? restante : livre;
+        uint8_t flags = c->parte_flags;
+        if (tamanho < restante || !http_ultimo_trecho(c)) {
+            flags |= TCP_WRITE_FLAG_MORE; // Ainda há dados: adia o PSH
+        }
+        err_t err = tcp_write(pcb, c->parte + c->parte_enviado, tamanho, flags);
+        if (err == ERR_MEM) break; // Sem memória no lwIP: tenta de novo no próximo tcp_sent/tcp_poll
+        if (err != ERR_OK) {
+            LOG_ERRO("Erro ao enviar resposta HTTP: %d", err);
+            return http_abortar(c);
+        }
+        c->parte_enviado += tamanho;
+        enfileirou = true;
+    }
+
+    if (enfileirou) tcp_output(pcb);
+    return ERR_OK;
+}
+
+/**
+ * @brief Avança a conexão: lê requisições, envia respostas e aplica o keep-alive.
+ * @return err_t Valor a devolver ao lwIP pelo callback que a chamou.
+ */
+static err_t http_processar(http_conexao_t *c) {
+    while (c->pcb) {
+        if (c->etapa == HTTP_ETAPA_OCIOSA) {
+            if (!http_consumir(c)) {
+                // Requisição ainda incompleta; se o cliente já fechou, não virá o resto
+                return c->remoto_fechou ? http_fechar(c) : ERR_OK;
+            }
+            http_iniciar_resposta(c);
+        }
+        err_t err = http_enviar(c);
+        if (err != ERR_OK) return err;
+        if (!http_resposta_enfileirada(c)) return ERR_OK; // Continua em tcp_sent
+
+        // Resposta enfileirada: o fechamento gracioso envia o que falta e depois o FIN
+        if (!c->manter || c->remoto_fechou) return http_fechar(c);
+        http_reiniciar(c); // Keep-alive: atende requisições já recebidas (pipeline)
+        stats_conexoes.reutilizacoes++;
+    }
+    return ERR_OK;
+}
+
+/**
+ * @brief Callback chamado quando o cliente confirma dados enviados.
+ * @details Libera espaço na cota de envio: continua a geração da resposta.
+ */
+static err_t http_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    http_conexao_t *c = (http_conexao_t *)arg;
+    if (!c) return ERR_OK;
+    c->ociosidade_s = 0;
+    if (c->etapa == HTTP_ETAPA_OCIOSA) return ERR_OK;
+    return http_processar(c);
+}
+
+/**
+ * @brief Callback periódico (HTTP_POLL_INTERVALO): timeouts e retomada de envios.
+ */
+static err_t http_poll_callback(void *arg, struct tcp_pcb *tpcb) {
+    http_conexao_t *c = (http_conexao_t *)arg;
+    if (!c) return ERR_OK;
+    if (c->ociosidade_s < UINT8_MAX) c->ociosidade_s++;
+
+    if (c->etapa == HTTP_ETAPA_OCIOSA) {
+        if (c->ociosidade_s >= HTTP_TIMEOUT_OCIOSO_S) {
+            stats_conexoes.expiradas++;
+            return http_fechar(c); // Keep-alive sem uso
+        }
+        return ERR_OK;
+    }
+    bool em_voo = tcp_sndbuf(tpcb) < TCP_SND_BUF;
+    if (c->etapa == HTTP_ETAPA_SSE && !em_voo && c->parte_enviado >= c->parte_len) {
+        // Stream parado: um comentário periódico revela clientes que sumiram
+        if (c->ociosidade_s >= HTTP_SSE_HEARTBEAT_S &&
+            tcp_write(tpcb, http_evento_heartbeat, sizeof(http_evento_heartbeat) - 1, 0) == ERR_OK) {
+            tcp_output(tpcb);
+            c->ociosidade_s = 0;
+        }
+        return http_processar(c); // Ressincronização pendente, se houver
+    }
+    if (c->ociosidade_s >= HTTP_TIMEOUT_ENVIO_S) {
+        stats_conexoes.expiradas++;
+        return http_abortar(c); // Cliente parou de confirmar dados
+    }
+    return http_processar(c); // Retoma um envio interrompido por ERR_MEM
+}
+
+/**
+ * @brief Callback de erro: o lwIP já liberou o PCB, resta liberar a entrada.
+ */
+static void http_err_callback(void *arg, err_t err) {
+    http_conexao_t *c = (http_conexao_t *)arg;
+    if (c) {
+        if (c->rx) {
+            pbuf_free(c->rx);
+            c->rx = NULL;
+        }
+        c->pcb = NULL;
+        c->etapa = HTTP_ETAPA_OCIOSA;
+        http_estado_liberar(c);
+    }
+}
+
+/**
+ * @brief Callback para lidar com dados HTTP recebidos.
+ * @param arg Entrada da tabela de conexões.
+ * @param tpcb Ponteiro para a estrutura de controle do TCP.
+ * @param p Cadeia de pbufs recebida (NULL quando o cliente fecha a conexão).
+ * @param err Código de erro (se houver).
+ * @return err_t Código de erro lwIP. ERR_OK se bem sucedido.
+ * @details Os dados são anexados aos ainda não consumidos; o parser só avança
+ *          quando não há resposta em andamento. Rotas: "/" (página de status),
+ *          "/reset_alarms", "/clear_system", "/api/sectors", "/api/sectors.bin",
+ *          "/api/history?sector=N" e "/events".
+ */
+static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    http_conexao_t *c = (http_conexao_t *)arg;
+    if (!c) {
+        if (p) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+        }
+        return ERR_OK;
+    }
+    // Se p for NULL, o cliente fechou seu lado: termina a resposta atual e fecha
+    if (p == NULL) {
+        c->remoto_fechou = true;
+        if (c->etapa >= HTTP_ETAPA_SSE_CABECALHO && c->etapa <= HTTP_ETAPA_SSE_ESTADO_FIM) {
+            return http_fechar(c); // Um stream /events não tem fim: o cliente saiu
+        }
+        return (c->etapa == HTTP_ETAPA_OCIOSA) ? http_processar(c) : ERR_OK;
+    }
+    c->ociosidade_s = 0;
+    if (c->rx) {
+        pbuf_cat(c->rx, p);
+    } else {
+        c->rx = p;
+    }
+    // Com uma resposta em andamento, os dados aguardam (a janela não é devolvida)
+    if (c->etapa != HTTP_ETAPA_OCIOSA) return ERR_OK;
+    return http_processar(c);
+}
+
+/**
+ * @brief Escolhe a conexão keep-alive ociosa há mais tempo para ceder sua entrada.
+ * @return http_conexao_t* NULL se todas estiverem atendendo requisições.
+ */
+static http_conexao_t *http_conexao_ociosa(void) {
+    http_conexao_t *vitima = NULL;
+    for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+        http_conexao_t *c = &conexoes[i];
+        if (c->etapa != HTTP_ETAPA_OCIOSA || c->rx) continue;
+        if (!vitima || c->ociosidade_s > vitima->ociosidade_s) vitima = c;
+    }
+    return vitima;
+}
+
+/**
+ * @brief Callback para aceitar novas conexões TCP.
+ * @param arg Argumento passado para o callback (não utilizado aqui).
+ * @param newpcb Ponteiro para a nova estrutura de controle TCP da conexão aceita.
+ * @param err Código de erro (se houver).
+ * @return err_t Código de erro lwIP. ERR_OK se bem sucedido, ERR_MEM se faltar memória.
+ * @details Se a tabela de conexões estiver cheia, fecha a conexão keep-alive
+ *          ociosa há mais tempo; se todas estiverem ocupadas, a nova é abortada.
+ */
+static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    // Se newpcb for NULL, pode ser um erro de falta de memória
+    if (newpcb == NULL) {
+        return ERR_MEM; // Retorna erro de memória
+    }
+    http_conexao_t *c = NULL;
+    for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+        if (conexoes[i].pcb == NULL) { c = &conexoes[i]; break; }
+    }
+    if (!c) {
+        c = http_conexao_ociosa();
+        if (c) {
+            stats_conexoes.despejadas++;
+            http_fechar(c); // Outro PCB: um eventual abort não afeta este callback
+        }
+    }
+    if (!c) {
+        stats_conexoes.recusadas++;
+        tcp_abort(newpcb); // Sem entrada livre: recusa a conexão
+        return ERR_ABRT;
+    }
+    stats_conexoes.aceitas++;
+    c->pcb = newpcb;
+    c->rx = NULL;
+    c->remoto_fechou = false;
+    http_reiniciar(c);
+    tcp_arg(newpcb, c);
+    // Define a função http_callback para ser chamada quando dados forem recebidos nesta conexão
+    tcp_recv(newpcb, http_callback);
+    tcp_sent(newpcb, http_sent_callback);
+    tcp_err(newpcb, http_err_callback);
+    tcp_poll(newpcb, http_poll_callback, HTTP_POLL_INTERVALO);
+    return ERR_OK;
+}
+
+/**
+ * @brief Inicializa e inicia o servidor HTTP na porta 80.
+ * @details Cria um novo PCB TCP, faz o bind para qualquer endereço IP na porta 80,
+ *          coloca o servidor em modo de escuta (listen) e define o callback para aceitar conexões.
+ */
+void start_http_server(void) {
+    // Cria um novo Protocol Control Block (PCB) para TCP, aceitando qualquer tipo de IP (IPv4/IPv6)
+    struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    if (!pcb) {
+        printf("Erro ao criar PCB HTTP\n");
+        return;
+    }
+    // Associa (bind) o PCB a qualquer endereço IP local (IP_ANY_TYPE) na porta 80
+    err_t bind_err = tcp_bind(pcb, IP_ANY_TYPE, HTTP_PORTA);
+    if (bind_err != ERR_OK) {
+        printf("Erro ao ligar o servidor HTTP na porta %d: %d\n", HTTP_PORTA, bind_err);
+        tcp_abort(pcb); // Aborta o PCB se o bind falhar
+        return;
+    }
+    // Coloca o PCB em modo de escuta (listen) para novas conexões
+    pcb = tcp_listen(pcb);
+    if (!pcb) {
+        printf("Erro ao colocar PCB em modo listen\n");
+        return;
+    }
+    // Define connection_callback para ser chamado quando uma nova conexão for estabelecida
+    tcp_accept(pcb, connection_callback);
+    printf("Servidor HTTP AgroGraf rodando na porta %d...\n", HTTP_PORTA);
+}
+
+/**
+ * @brief Escreve um evento já formatado em um stream /events.
+ * @return bool `false` se não coube na cota da conexão (o cliente será ressincronizado).
+ */
+static bool http_sse_escrever(http_conexao_t *c, const char *evento, uint16_t len) {
+    struct tcp_pcb *pcb = c->pcb;
+    uint16_t livre = tcp_sndbuf(pcb);
+    uint16_t em_voo = (uint16_t)(TCP_SND_BUF - livre);
+    if (c->etapa != HTTP_ETAPA_SSE || c->parte_enviado < c->parte_len || c->sse_ressinc) {
+        return false; // Estado completo a caminho
+    }
+    if (len > livre || em_voo + len > HTTP_BYTES_POR_CONEXAO ||
+        tcp_sndqueuelen(pcb) >= HTTP_SEGMENTOS_POR_CONEXAO) {
+        return false;
+    }
+    if (tcp_write(pcb, evento, len, TCP_WRITE_FLAG_COPY) != ERR_OK) return false;
+    stats_conexoes.eventos++;
+    return true;
+}
+
+/**
+ * @brief Formata um evento do núcleo 1 no formato SSE.
+ * @return uint16_t Tamanho do texto em `destino` (HTTP_EVENTO_MAX bytes).
+ */
+static uint16_t http_formatar_evento(char *destino, const setor_evento_t *e) {
+    static const char *const nomes[] = {
+        [SETOR_EVT_CADASTRO] = "event: cadastro\ndata: ",
+        [SETOR_EVT_TEMPERATURA] = "event: temperatura\ndata: ",
+        [SETOR_EVT_ALARME] = "event: alarme\ndata: ",
+        [SETOR_EVT_BUZZER] = "event: buzzer\ndata: ",
+    };
+    char *p = json_texto(destino, nomes[e->tipo]);
+    if (e->tipo == SETOR_EVT_BUZZER) {
+        p = json_texto(p, e->alarme ? "{\"b\":1}" : "{\"b\":0}");
+    } else {
+        p = json_setor(p, e->setor, e->cadastrado, e->temperatura, e->alarme);
+    }
+    p = json_texto(p, "\n\n");
+    return (uint16_t)(p - destino);
+}
+
+/**
+ * @brief Repassa os eventos do núcleo 1 a todos os streams /events abertos.
+ * @details Chamada periodicamente pelo escalonador do núcleo 0. Cada evento é
+ *          formatado uma única vez e copiado para cada cliente; um cliente sem
+ *          espaço na cota não acumula eventos: recebe depois o estado completo
+ *          (evento "estado"). O mesmo ocorre com todos se a fila entre os
+ *          núcleos transbordou. Sem clientes, a fila é apenas esvaziada.
+ */
+void http_server_despachar_eventos(void) {
+    static char evento[HTTP_EVENTO_MAX];
+    setor_evento_t e;
+    bool perdidos = setores_eventos_perdidos();
+    bool ha_eventos = false;
+
+    hal_rede_bloquear();
+    for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+        http_conexao_t *c = &conexoes[i];
+        if (perdidos && c->pcb && c->etapa == HTTP_ETAPA_SSE) c->sse_ressinc = true;
+    }
+    while (setores_receber_evento(&e)) {
+        ha_eventos = true;
+        uint16_t len = http_formatar_evento(evento, &e);
+        for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+            http_conexao_t *c = &conexoes[i];
+            if (!c->pcb || c->etapa < HTTP_ETAPA_SSE || c->etapa > HTTP_ETAPA_SSE_ESTADO_FIM) continue;
+            // Durante o envio do estado, o evento seguinte é outro estado completo
+            if (!http_sse_escrever(c, evento, len)) c->sse_ressinc = true;
+        }
+    }
+    if (ha_eventos || perdidos) {
+        for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+            http_conexao_t *c = &conexoes[i];
+            if (!c->pcb || c->etapa != HTTP_ETAPA_SSE) continue;
+            if (c->sse_ressinc) {
+                http_processar(c); // Inicia o envio do estado completo, se houver espaço
+            } else {
+                tcp_output(c->pcb);
+            }
+        }
+    }
+    hal_rede_liberar();
+}
+
+/**
+ * @brief Gera, sem rede, a resposta completa de uma requisição.
+ * @param requisicao Requisição HTTP crua (linha, cabeçalhos e linha vazia).
+ * @param saida Destino da resposta (truncada em `tamanho` bytes; pode ser NULL com tamanho 0).
+ * @return size_t Tamanho total da resposta, ou 0 se a requisição estiver incompleta.
+ * @details Percorre o mesmo parser e as mesmas etapas das conexões TCP com uma
+ *          conexão auxiliar sem pcb. Usada pelo benchmark (bench/agrograf_bench.c);
+ *          em /events apenas o cabeçalho é gerado, pois o stream não termina.
+ */
+size_t http_server_gerar_resposta(const char *requisicao, char *saida, size_t tamanho) {
+    static http_conexao_t c; // Fora da pilha: inclui o buffer do corpo das rotas /api
+    c.pcb = NULL;
+    c.rx = NULL;
+    http_reiniciar(&c); // Também libera o estado de uma resposta anterior interrompida
+
+    bool completa = false;
+    for (const char *p = requisicao; *p && !completa; p++) {
+        completa = http_parser_byte(&c, *p);
+    }
+    if (!completa) return 0;
+
+    http_iniciar_resposta(&c);
+    size_t total = 0;
+    while (http_proximo_trecho(&c)) {
+        if (total < tamanho) {
+            size_t n = tamanho - total < c.parte_len ? tamanho - total : c.parte_len;
+            memcpy(saida + total, c.parte, n);
+        }
+        total += c.parte_len;
+        c.parte_enviado = c.parte_len;
+    }
+    return total;
+}
+
+/**
+ * @brief Imprime o uso da tabela de conexões e o custo das rotas /api.
+ */
+void http_server_print_stats(void) {
+    printf("\nConexoes: aceitas %lu, requisicoes %lu, keep-alive %lu, despejadas %lu, recusadas %lu, expiradas %lu\n",
+           (unsigned long)stats_conexoes.aceitas, (unsigned long)stats_conexoes.requisicoes,
+           (unsigned long)stats_conexoes.reutilizacoes, (unsigned long)stats_conexoes.despejadas,
+           (unsigned long)stats_conexoes.recusadas, (unsigned long)stats_conexoes.expiradas);
+    printf("Streams /events: abertos %d, eventos enviados %lu, ressincronizacoes %lu\n",
+           http_num_eventos(), (unsigned long)stats_conexoes.eventos,
+           (unsigned long)stats_conexoes.ressincronizacoes);
+
+    const http_api_stats_t *s[] = { &stats_json, &stats_bin, &stats_historico };
+    const char *nomes[] = { "/api/sectors", "/api/sectors.bin", "/api/history" };
+    printf("\nRota               Respostas  Bytes  Formatacao(us)  Pior(us)\n");
+    for (int i = 0; i < 3; i++) {
+        printf("%-18s %9lu %6lu %15lu %9lu\n", nomes[i],
+               (unsigned long)s[i]->respostas, (unsigned long)s[i]->ultimo_bytes,
+               (unsigned long)s[i]->ultimo_formatacao_us, (unsigned long)s[i]->pior_formatacao_us);
+    }
+}
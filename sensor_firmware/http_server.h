@@ -0,0 +1,100 @@
+/**
+ * @file http_server.h
+ * @brief Servidor HTTP do AgroGraf (lwIP raw API, executado no núcleo 0).
+ * @details A página de status é gerada em partes, à medida que a janela de
+ *          envio do TCP permite: o HTML fixo fica em flash e é enviado sem
+ *          cópia, e as linhas dos setores são formatadas uma a uma em um
+ *          pequeno buffer da conexão.
+ *
+ *          As conexões HTTP/1.1 são mantidas abertas (keep-alive) entre as
+ *          requisições: a página segue em chunked e as rotas /api levam
+ *          Content-Length. Conexões ociosas são fechadas após um timeout ou
+ *          quando a tabela enche e um novo cliente precisa de uma entrada.
+ *          Somente GET é aceito; caminhos desconhecidos recebem 404.
+ *
+ *          GET /events mantém um stream Server-Sent Events com apenas as
+ *          mudanças publicadas pelo núcleo 1 (eventos "cadastro", "temperatura",
+ *          "alarme" e "buzzer", com o mesmo objeto de setor do JSON acima). Um
+ *          cliente que não acompanha recebe o estado completo (evento "estado",
+ *          com o JSON de /api/sectors). A página de status usa esse stream no
+ *          lugar do auto-refresh.
+ *
+ *          Para coletores há duas rotas de leitura com o estado de todos os
+ *          MAX_SETORES setores:
+ *          - GET /api/sectors: JSON compacto
+ *            {"v":<versao>,"b":0,"setores":[{"i":1,"c":1,"t":25.31,"a":0},...]}
+ *            ("b" buzzer, "i" índice 1-N, "c" cadastrado, "t" °C com duas
+ *            casas, "a" alarme no nível crítico);
+ *          - GET /api/sectors.bin: layout binário fixo, little-endian:
+ *              offset 0  2 bytes  'A' 'G'
+ *              offset 2  1 byte   versão do formato (HTTP_API_BIN_VERSAO)
+ *              offset 3  1 byte   reservado (0)
+ *              offset 4  4 bytes  versão do snapshot (uint32)
+ *              offset 8  2 bytes  número de setores (N, uint16)
+ *              offset 10 2 bytes  colunas da grade (uint16); linhas = N / colunas
+ *              offset 12+4i       int16 temperatura em centésimos de °C (saturada),
+ *                                 uint8 flags (HTTP_API_BIN_*), uint8 reservado;
+ *                                 o setor i (índice i+1) está na coluna i % colunas
+ *                                 e na linha i / colunas
+ *          Ambas informam Content-Length e o tempo gasto para calculá-lo
+ *          (X-Format-Us). O corpo é formatado em pedaços, à medida que o cliente
+ *          confirma os anteriores, de um snapshot compartilhado com as demais
+ *          respostas: a RAM usada não cresce com a grade nem com os clientes.
+ *
+ *          GET /api/history?sector=N (N de 1 a MAX_SETORES) devolve o histórico
+ *          do setor nas três camadas de historico.h, em JSON (formato descrito em
+ *          http_formatar_historico). A resposta é formatada em blocos, lendo as
+ *          entradas diretamente nos anéis, e segue em chunked (ou com
+ *          Connection: close em HTTP/1.0). Sem `sector` válido: 400.
+ *
+ *          Regras de alarme (alarmes.h):
+ *          - GET /api/alarms?sector=N devolve a regra e o nível atual do setor
+ *            (formato em http_formatar_regra);
+ *          - GET /api/alarms/set?sector=N&aviso=90&critico=100&histerese=1&subida=5&duracao_ms=30000
+ *            troca a regra; parâmetros omitidos mantêm o valor atual. Sem
+ *            `sector`, a regra vale para todos os setores e os omitidos vêm da
+ *            regra padrão. Regra inválida: 400; fila de comandos cheia: 503.
+ *            A resposta ecoa a regra enviada, aplicada pelo núcleo 1 no próximo tick.
+ *
+ *          GET /api/events?since=SEQ devolve os eventos do diário (diario.h) com
+ *          número de sequência maior que SEQ (sem `since`: todos os guardados),
+ *          em JSON gerado na hora a partir dos registros binários (formato em
+ *          http_formatar_diario). Segue em chunked, como /api/history; o campo
+ *          "seq" da resposta é o `since` do próximo pedido.
+ */
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "setores.h"
+
+#define HTTP_PORTA 80          // Porta TCP do servidor
+#define HTTP_MAX_CONEXOES 8    // Conexões simultâneas atendidas (tabela estática; ver MEMP_NUM_TCP_PCB)
+
+#define HTTP_API_BIN_MAGIC0 'A'      // Assinatura do formato binário
+#define HTTP_API_BIN_MAGIC1 'G'
+#define HTTP_API_BIN_VERSAO 2        // Versão do layout de /api/sectors.bin (1: até 255 setores, sem a grade)
+#define HTTP_API_BIN_CADASTRADO 0x01 // Flag: setor cadastrado
+#define HTTP_API_BIN_ALARME 0x02     // Flag: setor em alarme (nível crítico)
+#define HTTP_API_BIN_AVISO 0x04      // Flag: setor em aviso
+#define HTTP_API_BIN_TAMANHO (12 + 4 * MAX_SETORES) // Tamanho do corpo binário
+
+/**
+ * @struct http_api_stats_t
+ * @brief Custo das respostas de uma rota /api.
+ */
+typedef struct {
+    uint32_t respostas;             // Respostas geradas
+    uint32_t ultimo_bytes;          // Bytes da última resposta (cabeçalho + corpo)
+    uint32_t ultimo_formatacao_us;  // Tempo de formatação da última resposta
+    uint32_t pior_formatacao_us;    // Maior tempo de formatação observado
+} http_api_stats_t;
+
+void start_http_server(void);
+void http_server_despachar_eventos(void);
+void http_server_print_stats(void);
+size_t http_server_gerar_resposta(const char *requisicao, char *saida, size_t tamanho); // Sem rede (benchmark)
+
+#endif
@@ -12,6 +12,21 @@ extern void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t charac
 extern void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string);
 extern void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 extern void ssd1306_config(ssd1306_t *ssd);
-extern void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+extern void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint i2c);
 extern void ssd1306_send_data(ssd1306_t *ssd);
-extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
\ No newline at end of file
+extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
+extern void ssd1306_blit(uint8_t *ssd, const uint8_t *bitmap, int bitmap_width,
+                         int src_x, int src_y, int width, int height, int x, int y);
+extern void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t number);
+extern void ssd1306_display_init(ssd1306_t *ssd, uint i2c, uint8_t address);
+extern void ssd1306_flush(ssd1306_t *ssd, const struct render_area *area);
+extern void ssd1306_invalidate(ssd1306_t *ssd, const struct render_area *area);
+extern bool ssd1306_is_dirty(const ssd1306_t *ssd);
+extern size_t ssd1306_flush_dirty(ssd1306_t *ssd);
+extern int ssd1306_flush_async(ssd1306_t *ssd, hal_i2c_concluido_t done, void *ctx);
+extern bool ssd1306_flush_busy(const ssd1306_t *ssd);
+
+// Framebuffer do driver (página a página, ssd1306_buffer_length bytes)
+static inline uint8_t *ssd1306_framebuffer(ssd1306_t *ssd) {
+    return ssd->ram_buffer + 1;
+}
\ No newline at end of file
@@ -1,40 +1,128 @@
-
-static uint8_t font[] = {
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
-    0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00, // A
-    0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00, // B
-    0x7e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x00, // C
-    0x7f, 0x41, 0x41, 0x41, 0x41, 0x41, 0x7e, 0x00, // D
-    0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00, // E
-    0x7f, 0x09, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00, // F
-    0x7f, 0x41, 0x41, 0x41, 0x51, 0x51, 0x73, 0x00, // G
-    0x7f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7f, 0x00, // H
-    0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, // I
-    0x21, 0x41, 0x41, 0x3f, 0x01, 0x01, 0x01, 0x00, // J
-    0x00, 0x7f, 0x08, 0x08, 0x14, 0x22, 0x41, 0x00, // K
-    0x7f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00, // L
-    0x7f, 0x02, 0x04, 0x08, 0x04, 0x02, 0x7f, 0x00, // M
-    0x7f, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7f, 0x00, // N
-    0x3e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00, // O
-    0x7f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00, // P
-    0x3e, 0x41, 0x41, 0x49, 0x51, 0x61, 0x7e, 0x00, // Q
-    0x7f, 0x11, 0x11, 0x11, 0x31, 0x51, 0x0e, 0x00, // R
-    0x46, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, // S
-    0x01, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x01, 0x00, // T
-    0x3f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x3f, 0x00, // U
-    0x0f, 0x10, 0x20, 0x40, 0x20, 0x10, 0x0f, 0x00, // V
-    0x7f, 0x20, 0x10, 0x08, 0x10, 0x20, 0x7f, 0x00, // W
-    0x00, 0x41, 0x22, 0x14, 0x14, 0x22, 0x41, 0x00, // X
-    0x01, 0x02, 0x04, 0x78, 0x04, 0x02, 0x01, 0x00, // Y
-    0x41, 0x61, 0x59, 0x45, 0x43, 0x41, 0x00, 0x00, // Z
-    0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, // 0
-    0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00, // 1
-    0x30, 0x49, 0x49, 0x49, 0x49, 0x46, 0x00, 0x00, // 2
-    0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, // 3
-    0x3f, 0x20, 0x20, 0x78, 0x20, 0x20, 0x00, 0x00, // 4
-    0x4f, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, // 5
-    0x3f, 0x48, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00, // 6
-    0x01, 0x01, 0x01, 0x61, 0x31, 0x0d, 0x03, 0x00, // 7
-    0x36, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, // 8
-    0x06, 0x09, 0x09, 0x09, 0x09, 0x09, 0x7f, 0x00, // 9
-};
\ No newline at end of file
+// Glifos 8x8 (um byte por coluna, bit 0 em cima) indexados diretamente pelo
+// código Latin-1 do caractere: ASCII imprimível (0x20-0x7E), '°' e as letras
+// acentuadas do português (as maiúsculas acentuadas em versalete, para caber o
+// acento). Códigos sem glifo ficam em branco (zerados).
+static const uint8_t font[256][8] = {
+    [' '] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    ['!'] = { 0x00, 0x00, 0x00, 0x5f, 0x00, 0x00, 0x00, 0x00 },
+    ['"'] = { 0x00, 0x00, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00 },
+    ['#'] = { 0x00, 0x14, 0x7f, 0x14, 0x7f, 0x14, 0x00, 0x00 },
+    ['$'] = { 0x00, 0x24, 0x2a, 0x7f, 0x2a, 0x12, 0x00, 0x00 },
+    ['%'] = { 0x00, 0x23, 0x13, 0x08, 0x64, 0x62, 0x00, 0x00 },
+    ['&'] = { 0x00, 0x36, 0x49, 0x55, 0x22, 0x50, 0x00, 0x00 },
+    ['\''] = { 0x00, 0x00, 0x05, 0x03, 0x00, 0x00, 0x00, 0x00 },
+    ['('] = { 0x00, 0x00, 0x1c, 0x22, 0x41, 0x00, 0x00, 0x00 },
+    [')'] = { 0x00, 0x00, 0x41, 0x22, 0x1c, 0x00, 0x00, 0x00 },
+    ['*'] = { 0x00, 0x08, 0x2a, 0x1c, 0x2a, 0x08, 0x00, 0x00 },
+    ['+'] = { 0x00, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x00, 0x00 },
+    [','] = { 0x00, 0x00, 0x50, 0x30, 0x00, 0x00, 0x00, 0x00 },
+    ['-'] = { 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00 },
+    ['.'] = { 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00 },
+    ['/'] = { 0x00, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00 },
+    ['0'] = { 0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00 },
+    ['1'] = { 0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00 },
+    ['2'] = { 0x30, 0x49, 0x49, 0x49, 0x49, 0x46, 0x00, 0x00 },
+    ['3'] = { 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00 },
+    ['4'] = { 0x3f, 0x20, 0x20, 0x78, 0x20, 0x20, 0x00, 0x00 },
+    ['5'] = { 0x4f, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00 },
+    ['6'] = { 0x3f, 0x48, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00 },
+    ['7'] = { 0x01, 0x01, 0x01, 0x61, 0x31, 0x0d, 0x03, 0x00 },
+    ['8'] = { 0x36, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00 },
+    ['9'] = { 0x06, 0x09, 0x09, 0x09, 0x09, 0x09, 0x7f, 0x00 },
+    [':'] = { 0x00, 0x00, 0x36, 0x36, 0x00, 0x00, 0x00, 0x00 },
+    [';'] = { 0x00, 0x00, 0x56, 0x36, 0x00, 0x00, 0x00, 0x00 },
+    ['<'] = { 0x00, 0x08, 0x14, 0x22, 0x41, 0x00, 0x00, 0x00 },
+    ['='] = { 0x00, 0x14, 0x14, 0x14, 0x14, 0x14, 0x00, 0x00 },
+    ['>'] = { 0x00, 0x00, 0x41, 0x22, 0x14, 0x08, 0x00, 0x00 },
+    ['?'] = { 0x00, 0x02, 0x01, 0x51, 0x09, 0x06, 0x00, 0x00 },
+    ['@'] = { 0x00, 0x32, 0x49, 0x79, 0x41, 0x3e, 0x00, 0x00 },
+    ['A'] = { 0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00 },
+    ['B'] = { 0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00 },
+    ['C'] = { 0x7e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x00 },
+    ['D'] = { 0x7f, 0x41, 0x41, 0x41, 0x41, 0x41, 0x7e, 0x00 },
+    ['E'] = { 0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00 },
+    ['F'] = { 0x7f, 0x09, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00 },
+    ['G'] = { 0x7f, 0x41, 0x41, 0x41, 0x51, 0x51, 0x73, 0x00 },
+    ['H'] = { 0x7f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7f, 0x00 },
+    ['I'] = { 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00 },
+    ['J'] = { 0x21, 0x41, 0x41, 0x3f, 0x01, 0x01, 0x01, 0x00 },
+    ['K'] = { 0x00, 0x7f, 0x08, 0x08, 0x14, 0x22, 0x41, 0x00 },
+    ['L'] = { 0x7f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00 },
+    ['M'] = { 0x7f, 0x02, 0x04, 0x08, 0x04, 0x02, 0x7f, 0x00 },
+    ['N'] = { 0x7f, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7f, 0x00 },
+    ['O'] = { 0x3e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00 },
+    ['P'] = { 0x7f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00 },
+    ['Q'] = { 0x3e, 0x41, 0x41, 0x49, 0x51, 0x61, 0x7e, 0x00 },
+    ['R'] = { 0x7f, 0x11, 0x11, 0x11, 0x31, 0x51, 0x0e, 0x00 },
+    ['S'] = { 0x46, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00 },
+    ['T'] = { 0x01, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x01, 0x00 },
+    ['U'] = { 0x3f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x3f, 0x00 },
+    ['V'] = { 0x0f, 0x10, 0x20, 0x40, 0x20, 0x10, 0x0f, 0x00 },
+    ['W'] = { 0x7f, 0x20, 0x10, 0x08, 0x10, 0x20, 0x7f, 0x00 },
+    ['X'] = { 0x00, 0x41, 0x22, 0x14, 0x14, 0x22, 0x41, 0x00 },
+    ['Y'] = { 0x01, 0x02, 0x04, 0x78, 0x04, 0x02, 0x01, 0x00 },
+    ['Z'] = { 0x41, 0x61, 0x59, 0x45, 0x43, 0x41, 0x00, 0x00 },
+    ['['] = { 0x00, 0x00, 0x7f, 0x41, 0x41, 0x00, 0x00, 0x00 },
+    ['\\'] = { 0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x00 },
+    [']'] = { 0x00, 0x00, 0x41, 0x41, 0x7f, 0x00, 0x00, 0x00 },
+    ['^'] = { 0x00, 0x04, 0x02, 0x01, 0x02, 0x04, 0x00, 0x00 },
+    ['_'] = { 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00 },
+    ['`'] = { 0x00, 0x00, 0x01, 0x02, 0x04, 0x00, 0x00, 0x00 },
+    ['a'] = { 0x00, 0x20, 0x54, 0x54, 0x54, 0x78, 0x00, 0x00 },
+    ['b'] = { 0x00, 0x7f, 0x48, 0x44, 0x44, 0x38, 0x00, 0x00 },
+    ['c'] = { 0x00, 0x38, 0x44, 0x44, 0x44, 0x20, 0x00, 0x00 },
+    ['d'] = { 0x00, 0x38, 0x44, 0x44, 0x48, 0x7f, 0x00, 0x00 },
+    ['e'] = { 0x00, 0x38, 0x54, 0x54, 0x54, 0x18, 0x00, 0x00 },
+    ['f'] = { 0x00, 0x08, 0x7e, 0x09, 0x01, 0x02, 0x00, 0x00 },
+    ['g'] = { 0x00, 0x08, 0x54, 0x54, 0x54, 0x3c, 0x00, 0x00 },
+    ['h'] = { 0x00, 0x7f, 0x08, 0x04, 0x04, 0x78, 0x00, 0x00 },
+    ['i'] = { 0x00, 0x00, 0x44, 0x7d, 0x40, 0x00, 0x00, 0x00 },
+    ['j'] = { 0x00, 0x20, 0x40, 0x44, 0x3d, 0x00, 0x00, 0x00 },
+    ['k'] = { 0x00, 0x00, 0x7f, 0x10, 0x28, 0x44, 0x00, 0x00 },
+    ['l'] = { 0x00, 0x00, 0x41, 0x7f, 0x40, 0x00, 0x00, 0x00 },
+    ['m'] = { 0x00, 0x7c, 0x04, 0x18, 0x04, 0x78, 0x00, 0x00 },
+    ['n'] = { 0x00, 0x7c, 0x08, 0x04, 0x04, 0x78, 0x00, 0x00 },
+    ['o'] = { 0x00, 0x38, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00 },
+    ['p'] = { 0x00, 0x7c, 0x14, 0x14, 0x14, 0x08, 0x00, 0x00 },
+    ['q'] = { 0x00, 0x08, 0x14, 0x14, 0x18, 0x7c, 0x00, 0x00 },
+    ['r'] = { 0x00, 0x7c, 0x08, 0x04, 0x04, 0x08, 0x00, 0x00 },
+    ['s'] = { 0x00, 0x48, 0x54, 0x54, 0x54, 0x20, 0x00, 0x00 },
+    ['t'] = { 0x00, 0x04, 0x3f, 0x44, 0x40, 0x20, 0x00, 0x00 },
+    ['u'] = { 0x00, 0x3c, 0x40, 0x40, 0x20, 0x7c, 0x00, 0x00 },
+    ['v'] = { 0x00, 0x1c, 0x20, 0x40, 0x20, 0x1c, 0x00, 0x00 },
+    ['w'] = { 0x00, 0x3c, 0x40, 0x30, 0x40, 0x3c, 0x00, 0x00 },
+    ['x'] = { 0x00, 0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x00 },
+    ['y'] = { 0x00, 0x0c, 0x50, 0x50, 0x50, 0x3c, 0x00, 0x00 },
+    ['z'] = { 0x00, 0x44, 0x64, 0x54, 0x4c, 0x44, 0x00, 0x00 },
+    ['{'] = { 0x00, 0x00, 0x08, 0x36, 0x41, 0x00, 0x00, 0x00 },
+    ['|'] = { 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00 },
+    ['}'] = { 0x00, 0x00, 0x41, 0x36, 0x08, 0x00, 0x00, 0x00 },
+    ['~'] = { 0x00, 0x08, 0x04, 0x08, 0x10, 0x08, 0x00, 0x00 },
+    [0xB0] = { 0x00, 0x00, 0x06, 0x09, 0x09, 0x06, 0x00, 0x00 }, // °
+    [0xC0] = { 0x00, 0x78, 0x15, 0x16, 0x14, 0x78, 0x00, 0x00 }, // À
+    [0xC1] = { 0x00, 0x78, 0x14, 0x16, 0x15, 0x78, 0x00, 0x00 }, // Á
+    [0xC2] = { 0x00, 0x78, 0x16, 0x15, 0x16, 0x78, 0x00, 0x00 }, // Â
+    [0xC3] = { 0x00, 0x7a, 0x15, 0x16, 0x15, 0x78, 0x00, 0x00 }, // Ã
+    [0xC7] = { 0x00, 0x38, 0x44, 0xc4, 0x44, 0x44, 0x00, 0x00 }, // Ç
+    [0xC9] = { 0x00, 0x7c, 0x54, 0x56, 0x55, 0x44, 0x00, 0x00 }, // É
+    [0xCA] = { 0x00, 0x7c, 0x56, 0x55, 0x56, 0x44, 0x00, 0x00 }, // Ê
+    [0xCD] = { 0x00, 0x00, 0x44, 0x7e, 0x45, 0x00, 0x00, 0x00 }, // Í
+    [0xD3] = { 0x00, 0x38, 0x44, 0x46, 0x45, 0x38, 0x00, 0x00 }, // Ó
+    [0xD4] = { 0x00, 0x38, 0x46, 0x45, 0x46, 0x38, 0x00, 0x00 }, // Ô
+    [0xD5] = { 0x00, 0x3a, 0x45, 0x46, 0x45, 0x38, 0x00, 0x00 }, // Õ
+    [0xDA] = { 0x00, 0x3c, 0x40, 0x42, 0x41, 0x3c, 0x00, 0x00 }, // Ú
+    [0xDC] = { 0x00, 0x3c, 0x42, 0x40, 0x42, 0x3c, 0x00, 0x00 }, // Ü
+    [0xE0] = { 0x00, 0x20, 0x55, 0x56, 0x54, 0x78, 0x00, 0x00 }, // à
+    [0xE1] = { 0x00, 0x20, 0x54, 0x56, 0x55, 0x78, 0x00, 0x00 }, // á
+    [0xE2] = { 0x00, 0x20, 0x56, 0x55, 0x56, 0x78, 0x00, 0x00 }, // â
+    [0xE3] = { 0x00, 0x22, 0x55, 0x56, 0x55, 0x78, 0x00, 0x00 }, // ã
+    [0xE7] = { 0x00, 0x38, 0x44, 0xc4, 0x44, 0x20, 0x00, 0x00 }, // ç
+    [0xE9] = { 0x00, 0x38, 0x54, 0x56, 0x55, 0x18, 0x00, 0x00 }, // é
+    [0xEA] = { 0x00, 0x38, 0x56, 0x55, 0x56, 0x18, 0x00, 0x00 }, // ê
+    [0xED] = { 0x00, 0x00, 0x44, 0x7e, 0x41, 0x00, 0x00, 0x00 }, // í
+    [0xF3] = { 0x00, 0x38, 0x44, 0x46, 0x45, 0x38, 0x00, 0x00 }, // ó
+    [0xF4] = { 0x00, 0x38, 0x46, 0x45, 0x46, 0x38, 0x00, 0x00 }, // ô
+    [0xF5] = { 0x00, 0x3a, 0x45, 0x46, 0x45, 0x38, 0x00, 0x00 }, // õ
+    [0xFA] = { 0x00, 0x3c, 0x40, 0x42, 0x21, 0x7c, 0x00, 0x00 }, // ú
+    [0xFC] = { 0x00, 0x3c, 0x42, 0x40, 0x22, 0x7c, 0x00, 0x00 }, // ü
+};
@@ -1,13 +1,28 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
-#include "pico/stdlib.h"
-#include "pico/binary_info.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
 
+// Display cujo framebuffer tem as alterações rastreadas (o último de
+// ssd1306_display_init). As funções de desenho recebem apenas o ponteiro do
+// framebuffer; desenhos em outros buffers não são rastreados.
+static ssd1306_t *ssd1306_tracked = NULL;
+
+// Marca as colunas [first, last] da página como alteradas, se `fb` for o framebuffer rastreado
+static inline void ssd1306_mark_dirty(const uint8_t *fb, int page, int first, int last) {
+    ssd1306_t *d = ssd1306_tracked;
+    if (!d || fb != d->ram_buffer + 1) return;
+    if (first < d->dirty_start[page]) d->dirty_start[page] = (uint8_t)first;
+    if (last > d->dirty_end[page] || d->dirty_start[page] > d->dirty_end[page]) d->dirty_end[page] = (uint8_t)last;
+}
+
+static void ssd1306_clear_dirty(ssd1306_t *ssd) {
+    memset(ssd->dirty_start, 0xFF, sizeof(ssd->dirty_start));
+    memset(ssd->dirty_end, 0, sizeof(ssd->dirty_end));
+}
+
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
@@ -16,26 +31,38 @@ void calculate_render_area_buffer_length(struct render_area *area) {
 // Processo de escrita do i2c espera um byte de controle, seguido por dados
 void ssd1306_send_command(uint8_t command) {
     uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+    hal_i2c_escrever(ssd1306_i2c_porta, ssd1306_i2c_address, buffer, 2);
+}
+
+// Envia comandos em lotes: um byte de controle 0x00 e até ssd1306_command_batch_max
+// comandos por transação, em vez de uma transação por byte
+static void ssd1306_write_commands(uint i2c, uint8_t address, const uint8_t *commands, size_t number) {
+    uint8_t buffer[ssd1306_command_batch_max + 1];
+    buffer[0] = ssd1306_control_commands;
+    while (number > 0) {
+        size_t n = number < ssd1306_command_batch_max ? number : ssd1306_command_batch_max;
+        memcpy(buffer + 1, commands, n);
+        hal_i2c_escrever(i2c, address, buffer, n + 1);
+        commands += n;
+        number -= n;
+    }
 }
 
 // Envia uma lista de comandos ao hardware
 void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
-    }
+    ssd1306_write_commands(ssd1306_i2c_porta, ssd1306_i2c_address, ssd, (size_t)number);
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
+// Envia um buffer arbitrário como dados. Usa um buffer estático (sem heap); o
+// caminho sem cópia é o do driver (ssd1306_flush), cujo framebuffer já vem após o 0x40
 void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
+    static uint8_t temp_buffer[ssd1306_buffer_length + 1];
+    if (buffer_length > ssd1306_buffer_length) buffer_length = ssd1306_buffer_length;
 
-    temp_buffer[0] = 0x40;
+    temp_buffer[0] = ssd1306_control_data;
     memcpy(temp_buffer + 1, ssd, buffer_length);
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
-
-    free(temp_buffer);
+    hal_i2c_escrever(ssd1306_i2c_porta, ssd1306_i2c_address, temp_buffer, buffer_length + 1);
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -101,7 +128,10 @@ void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
         byte &= ~(1 << (y % 8));
     }
 
-    ssd[byte_idx] = byte;
+    if (byte != ssd[byte_idx]) {
+        ssd[byte_idx] = byte;
+        ssd1306_mark_dirty(ssd, y / 8, x, x);
+    }
 }
 
 // Algoritmo de Bresenham básico
@@ -132,44 +162,49 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
     }
 }
 
-// Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
-{
-  if (character >= 'A' && character <= 'Z') {
-    return character - 'A' + 1;
-  }
-  else if (character >= '0' && character <= '9') {
-    return character - '0' + 27;
-  }
-  else
-    return 0;
-}
-
-// Desenha um único caractere no display
+// Desenha um caractere (código Latin-1, ver ssd1306_font.h) em uma página:
+// o glifo é lido direto pelo código e copiado como uma palavra de 8 bytes
 void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
     if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
         return;
     }
 
     y = y / 8;
+    uint8_t *dst = &ssd[y * ssd1306_width + x];
+    uint64_t glyph, old;
+    memcpy(&glyph, font[character], 8);
+    memcpy(&old, dst, 8);
+    memcpy(dst, &glyph, 8);
+    if (glyph != old) { // Redesenhar o mesmo caractere não suja a página
+        ssd1306_mark_dirty(ssd, y, x, x + 7);
+    }
+}
 
-    character = toupper(character);
-    int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
-
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
+// Próximo caractere de uma string UTF-8, convertido para o código da fonte.
+// U+0080-U+00FF (acentos, '°') vêm em 2 bytes iniciados por 0xC2/0xC3; o resto
+// fora do ASCII vira um espaço.
+static inline uint8_t ssd1306_next_char(const char **string) {
+    const uint8_t *s = (const uint8_t *)*string;
+    uint8_t c = *s++;
+    if (c >= 0x80) {
+        uint8_t code = 0;
+        if ((c == 0xC2 || c == 0xC3) && (*s & 0xC0) == 0x80) code = (uint8_t)(((c & 0x03) << 6) | (*s & 0x3F));
+        while ((*s & 0xC0) == 0x80) s++; // Descarta os bytes de continuação
+        c = code;
     }
+    *string = (const char *)s;
+    return c;
 }
 
-// Desenha uma string, chamando a função de desenhar caractere várias vezes
+// Desenha uma string (UTF-8) a partir de (x, y), um caractere a cada 8 colunas
 void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
     if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
         return;
     }
 
-    while (*string) {
-        ssd1306_draw_char(ssd, x, y, *string++);
+    const char *s = string;
+    while (*s) {
+        ssd1306_draw_char(ssd, x, y, ssd1306_next_char(&s));
         x += 8;
     }
 }
@@ -177,69 +212,287 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
 // Comando de configuração com base na estrutura ssd1306_t
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
+  hal_i2c_escrever(ssd->i2c_port, ssd->address, ssd->port_buffer, 2);
+}
+
+// Envia uma lista de comandos ao display do driver (em lotes, ver ssd1306_write_commands)
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t number) {
+    ssd1306_write_commands(ssd->i2c_port, ssd->address, commands, number);
 }
 
 // Função de configuração do display para o caso do bitmap
 void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
+    const uint8_t commands[] = {
+        ssd1306_set_display | 0x00,
+        ssd1306_set_memory_mode, 0x01,
+        ssd1306_set_display_start_line | 0x00,
+        ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_common_output_direction | 0x08,
+        ssd1306_set_display_offset, 0x00,
+        ssd1306_set_common_pin_configuration, 0x12,
+        ssd1306_set_display_clock_divide_ratio, 0x80,
+        ssd1306_set_precharge, 0xF1,
+        ssd1306_set_vcomh_deselect_level, 0x30,
+        ssd1306_set_contrast, 0xFF,
+        ssd1306_set_entire_on,
+        ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, 0x14,
+        ssd1306_set_display | 0x01,
+    };
+    ssd1306_command_list(ssd, commands, count_of(commands));
 }
 
 // Inicializa o display para o caso de exibição de bitmap
-void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint i2c) {
+    assert(width <= ssd1306_width && height <= ssd1306_height); // O buffer é do tamanho máximo
     ssd->width = width;
     ssd->height = height;
     ssd->pages = height / 8U;
     ssd->address = address;
     ssd->i2c_port = i2c;
+    ssd->external_vcc = external_vcc;
     ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
+    memset(ssd->ram_buffer, 0, sizeof(ssd->ram_buffer));
+    ssd->ram_buffer[0] = ssd1306_control_data;
+    ssd->port_buffer[0] = ssd1306_control_command;
+    ssd1306_clear_dirty(ssd);
+}
+
+// Envia `length` bytes do framebuffer a partir de `offset` em uma única transação.
+// O byte anterior recebe o controle 0x40 durante o envio e é restaurado depois
+// (no início do buffer ele já é o 0x40), evitando cópia e alocação.
+static void ssd1306_write_data(ssd1306_t *ssd, size_t offset, size_t length) {
+    uint8_t *start = ssd->ram_buffer + offset; // ram_buffer[offset] precede o 1º byte enviado
+    uint8_t saved = *start;
+    *start = ssd1306_control_data;
+    hal_i2c_escrever(ssd->i2c_port, ssd->address, start, length + 1);
+    *start = saved;
+}
+
+// A janela enviada deixa de estar pendente (páginas parcialmente cobertas
+// continuam sujas, ajustadas para as colunas fora da janela)
+static void ssd1306_clear_window(ssd1306_t *ssd, const struct render_area *area) {
+    for (uint page = area->start_page; page <= area->end_page; page++) {
+        if (ssd->dirty_start[page] > ssd->dirty_end[page]) continue;
+        bool covers_start = ssd->dirty_start[page] >= area->start_column;
+        bool covers_end = ssd->dirty_end[page] <= area->end_column;
+        if (covers_start && covers_end) {
+            ssd->dirty_start[page] = 0xFF;
+            ssd->dirty_end[page] = 0;
+        } else if (covers_start && ssd->dirty_start[page] <= area->end_column) {
+            ssd->dirty_start[page] = area->end_column + 1;
+        } else if (covers_end && ssd->dirty_end[page] >= area->start_column) {
+            ssd->dirty_end[page] = area->start_column - 1;
+        }
+    }
+}
+
+// Envia a janela `area` do framebuffer do driver (coordenadas da tela).
+// Os comandos da janela seguem em uma transação; os dados, em uma transação
+// se a janela ocupa a largura inteira (páginas contíguas) ou uma por página.
+void ssd1306_flush(ssd1306_t *ssd, const struct render_area *area) {
+    ssd1306_clear_window(ssd, area);
+
+    const uint8_t commands[] = {
+        ssd1306_set_column_address, area->start_column, area->end_column,
+        ssd1306_set_page_address, area->start_page, area->end_page
+    };
+    ssd1306_command_list(ssd, commands, count_of(commands));
+
+    size_t columns = (size_t)(area->end_column - area->start_column + 1);
+    if (columns == ssd->width) {
+        size_t pages = (size_t)(area->end_page - area->start_page + 1);
+        ssd1306_write_data(ssd, (size_t)area->start_page * ssd->width, pages * columns);
+        return;
+    }
+    for (uint page = area->start_page; page <= area->end_page; page++) {
+        ssd1306_write_data(ssd, page * ssd->width + area->start_column, columns);
+    }
 }
 
-// Envia os dados ao display
+// Envia os dados ao display (tela inteira: uma transação de comandos e uma de dados)
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-    ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
+    struct render_area area = { 0, ssd->width - 1, 0, ssd->pages - 1, (int)ssd->bufsize - 1 };
+    ssd1306_flush(ssd, &area);
 }
 
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+// Desenha o bitmap (a ser fornecido em display_oled.c) no display.
+// Copia a imagem inteira para o buffer e só então a envia, uma única vez.
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
+}
+
+// Copia o retângulo (src_x, src_y, width, height) de um bitmap no formato da
+// GDDRAM (bitmap_width colunas por página de 8 linhas, bit 0 em cima) para a
+// posição (x, y) do framebuffer, em qualquer alinhamento vertical. O que sai da
+// tela é recortado; os pixels fora do retângulo não são alterados. O retângulo
+// de origem deve estar contido no bitmap.
+void ssd1306_blit(uint8_t *ssd, const uint8_t *bitmap, int bitmap_width,
+                  int src_x, int src_y, int width, int height, int x, int y) {
+    // Recorte contra as bordas da tela
+    if (x < 0) { src_x -= x; width += x; x = 0; }
+    if (y < 0) { src_y -= y; height += y; y = 0; }
+    if (x + width > ssd1306_width) width = ssd1306_width - x;
+    if (y + height > ssd1306_height) height = ssd1306_height - y;
+    if (width <= 0 || height <= 0 || src_x < 0 || src_y < 0) return;
+
+    // Cada coluna da tela cabe em 64 bits: linhas [y, y + height) da coluna
+    uint64_t mask = (height == 64 ? ~0ull : ((1ull << height) - 1)) << y;
+    int first_page = y / 8, last_page = (y + height - 1) / 8;
+    int src_first = src_y / 8, src_last = (src_y + height - 1) / 8;
+
+    for (int col = 0; col < width; col++) {
+        // Reúne as linhas de origem da coluna, deslocadas para começar em src_y
+        uint64_t bits = 0;
+        for (int page = src_first; page <= src_last; page++) {
+            uint64_t byte = bitmap[page * bitmap_width + src_x + col];
+            int shift = page * 8 - src_y;
+            bits |= shift >= 0 ? byte << shift : byte >> -shift;
+        }
+        bits = (bits << y) & mask;
+
+        int fb_x = x + col;
+        for (int page = first_page; page <= last_page; page++) {
+            uint8_t page_mask = (uint8_t)(mask >> (page * 8));
+            uint8_t *dst = &ssd[page * ssd1306_width + fb_x];
+            uint8_t value = (uint8_t)((*dst & ~page_mask) | ((uint8_t)(bits >> (page * 8)) & page_mask));
+            if (value != *dst) {
+                *dst = value;
+                ssd1306_mark_dirty(ssd, page, fb_x, fb_x);
+            }
+        }
+    }
+}
+
+// Marca uma área do framebuffer do driver como alterada (para escritas diretas no buffer)
+void ssd1306_invalidate(ssd1306_t *ssd, const struct render_area *area) {
+    for (uint page = area->start_page; page <= area->end_page; page++) {
+        if (area->start_column < ssd->dirty_start[page]) ssd->dirty_start[page] = area->start_column;
+        if (area->end_column > ssd->dirty_end[page] || ssd->dirty_start[page] > ssd->dirty_end[page]) {
+            ssd->dirty_end[page] = area->end_column;
+        }
+    }
+}
 
-        ssd1306_send_data(ssd);
+bool ssd1306_is_dirty(const ssd1306_t *ssd) {
+    for (uint page = 0; page < ssd->pages; page++) {
+        if (ssd->dirty_start[page] <= ssd->dirty_end[page]) return true;
     }
+    return false;
+}
+
+// Próxima janela a enviar a partir de `*page`; `false` se não há mais alterações.
+// Cada sequência de páginas alteradas vira uma janela com a união das colunas,
+// desde que as colunas extras custem menos que abrir outra janela.
+static bool ssd1306_next_window(const ssd1306_t *ssd, uint *page, struct render_area *window) {
+    while (*page < ssd->pages && ssd->dirty_start[*page] > ssd->dirty_end[*page]) (*page)++;
+    if (*page >= ssd->pages) return false;
+
+    struct render_area area = {
+        .start_column = ssd->dirty_start[*page], .end_column = ssd->dirty_end[*page],
+        .start_page = (uint8_t)*page, .end_page = (uint8_t)*page
+    };
+    size_t useful = (size_t)(area.end_column - area.start_column + 1);
+    while (area.end_page + 1u < ssd->pages) {
+        uint next = area.end_page + 1u;
+        if (ssd->dirty_start[next] > ssd->dirty_end[next]) break;
+        uint8_t start = ssd->dirty_start[next] < area.start_column ? ssd->dirty_start[next] : area.start_column;
+        uint8_t end = ssd->dirty_end[next] > area.end_column ? ssd->dirty_end[next] : area.end_column;
+        size_t merged = (size_t)(end - start + 1) * (next - area.start_page + 1);
+        size_t next_useful = (size_t)(ssd->dirty_end[next] - ssd->dirty_start[next] + 1);
+        if (merged - (useful + next_useful) >= ssd1306_window_overhead) break;
+        area.start_column = start;
+        area.end_column = end;
+        area.end_page = (uint8_t)next;
+        useful += next_useful;
+    }
+    calculate_render_area_buffer_length(&area);
+    *window = area;
+    *page = area.end_page + 1u;
+    return true;
+}
+
+// Envia apenas o que mudou desde o último envio e retorna os bytes de GDDRAM enviados;
+// assim um número atualizado custa dezenas de bytes em vez do quadro inteiro.
+size_t ssd1306_flush_dirty(ssd1306_t *ssd) {
+    size_t sent = 0;
+    uint page = 0;
+    struct render_area area;
+    while (ssd1306_next_window(ssd, &page, &area)) {
+        ssd1306_flush(ssd, &area);
+        sent += (size_t)area.buffer_length;
+    }
+    return sent; // ssd1306_flush já limpou as páginas enviadas
+}
+
+// Como ssd1306_flush_dirty, mas as janelas vão em um único lote por DMA
+// (hal_i2c_escrever_lote) e a função retorna sem esperar o barramento. O lote é
+// copiado para o buffer do DMA antes do retorno, então o framebuffer pode ser
+// redesenhado enquanto o quadro anterior é transmitido (buffer duplo).
+// Retorna os bytes de GDDRAM enviados (0 sem alterações: `done` não é chamado)
+// ou -1 se um envio ainda está em andamento (as alterações ficam pendentes).
+int ssd1306_flush_async(ssd1306_t *ssd, hal_i2c_concluido_t done, void *ctx) {
+    static const uint8_t control_data = ssd1306_control_data;
+    if (hal_i2c_ocupado(ssd->i2c_port)) return -1;
+
+    struct render_area windows[ssd1306_n_pages];
+    uint8_t commands[ssd1306_n_pages][7];
+    hal_i2c_trecho_t parts[ssd1306_n_pages * 3]; // Por janela: comandos + (controle, dados) por página
+    size_t n_windows = 0, n_parts = 0;
+    int sent = 0;
+    uint page = 0;
+    while (ssd1306_next_window(ssd, &page, &windows[n_windows])) {
+        const struct render_area *area = &windows[n_windows];
+        uint8_t *cmd = commands[n_windows++];
+        cmd[0] = ssd1306_control_commands;
+        cmd[1] = ssd1306_set_column_address; cmd[2] = area->start_column; cmd[3] = area->end_column;
+        cmd[4] = ssd1306_set_page_address; cmd[5] = area->start_page; cmd[6] = area->end_page;
+        parts[n_parts++] = (hal_i2c_trecho_t){ cmd, 7, true };
+
+        size_t columns = (size_t)(area->end_column - area->start_column + 1);
+        bool full_width = columns == ssd->width;
+        for (uint p = area->start_page; p <= area->end_page; p++) {
+            size_t length = full_width ? (size_t)area->buffer_length : columns;
+            parts[n_parts++] = (hal_i2c_trecho_t){ &control_data, 1, false };
+            parts[n_parts++] = (hal_i2c_trecho_t){ ssd->ram_buffer + 1 + p * ssd->width + area->start_column, length, true };
+            if (full_width) break; // Páginas contíguas: uma transação só
+        }
+        sent += area->buffer_length;
+    }
+    if (n_windows == 0) return 0;
+    if (!hal_i2c_escrever_lote(ssd->i2c_port, ssd->address, parts, n_parts, done, ctx)) return -1;
+    for (size_t i = 0; i < n_windows; i++) ssd1306_clear_window(ssd, &windows[i]);
+    return sent;
+}
+
+bool ssd1306_flush_busy(const ssd1306_t *ssd) {
+    return hal_i2c_ocupado(ssd->i2c_port);
+}
+
+// Inicializa o driver e o controlador (endereçamento horizontal) e apaga a tela
+void ssd1306_display_init(ssd1306_t *ssd, uint i2c, uint8_t address) {
+    ssd1306_init_bm(ssd, ssd1306_width, ssd1306_height, false, address, i2c);
+    ssd1306_tracked = ssd;
+    const uint8_t commands[] = {
+        ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset, 0x00,
+#if ((ssd1306_width == 128) && (ssd1306_height == 64))
+        ssd1306_set_common_pin_configuration, 0x12,
+#else
+        ssd1306_set_common_pin_configuration, 0x02,
+#endif
+        ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge, 0xF1,
+        ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast, 0xFF,
+        ssd1306_set_entire_on, ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_display | 0x01,
+    };
+    ssd1306_command_list(ssd, commands, count_of(commands));
+
+    struct render_area tela = { 0, ssd1306_width - 1, 0, ssd1306_n_pages - 1, ssd1306_buffer_length };
+    ssd1306_flush(ssd, &tela);
 }
@@ -1,6 +1,5 @@
 #include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 
 #ifndef ssd1306_inc_h
 #define ssd1306_inc_h
@@ -9,6 +8,7 @@
 #define ssd1306_width 128 // Define a largura do display (128 pixels)
 
 #define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
+#define ssd1306_i2c_porta 1 // Porta I2C do display (I2C1 na BitDogLab)
 
 #define ssd1306_i2c_clock 400 // Define o tempo do clock (pode ser aumentado)
 
@@ -44,6 +44,17 @@
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Bytes de controle de uma transação I2C (Co = bit 7, D/C = bit 6)
+#define ssd1306_control_commands _u(0x00) // Todo o resto da transação são comandos
+#define ssd1306_control_command _u(0x80)  // Um único comando a seguir
+#define ssd1306_control_data _u(0x40)     // Todo o resto da transação são dados da GDDRAM
+
+#define ssd1306_command_batch_max 32 // Comandos por transação em ssd1306_command_list
+// Custo aproximado, em bytes no barramento, de abrir mais uma janela (endereço,
+// controle, 6 comandos e START/STOP): ssd1306_flush_dirty une páginas vizinhas
+// quando as colunas extras custam menos que isso
+#define ssd1306_window_overhead 9
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
@@ -56,13 +67,19 @@ struct render_area {
     int buffer_length;
 };
 
+// Driver de um display: o framebuffer vive no próprio objeto, logo após o
+// byte de controle 0x40, e é enviado sem cópia nem alocação (ver ssd1306_flush)
 typedef struct {
   uint8_t width, height, pages, address;
-  i2c_inst_t * i2c_port;
+  uint i2c_port; // Porta I2C (ver hal_i2c_escrever)
   bool external_vcc;
-  uint8_t *ram_buffer;
+  uint8_t ram_buffer[ssd1306_buffer_length + 1]; // [0] = 0x40, seguido da GDDRAM (página a página)
   size_t bufsize;
   uint8_t port_buffer[2];
+  // Colunas alteradas em cada página desde o último envio (início > fim = página limpa).
+  // Atualizadas por ssd1306_set_pixel/draw_char/draw_line e por ssd1306_invalidate.
+  uint8_t dirty_start[ssd1306_n_pages];
+  uint8_t dirty_end[ssd1306_n_pages];
 } ssd1306_t;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file ingestao.c
+ * @brief Registro das fontes e fila única de leituras até o núcleo 1.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "setores.h"
+#include "ingestao.h"
+#include "log.h"
+
+#define INGESTAO_MIN_C -60.0f  // Faixa aceita: fora dela a leitura é tratada como falha da sonda
+#define INGESTAO_MAX_C 500.0f
+
+static hal_fila_t fila_leituras;
+static ingestao_fonte_t fontes[INGESTAO_FONTES_MAX];
+static ingestao_stats_t stats[INGESTAO_FONTES_MAX];
+static uint8_t num_fontes;
+
+void ingestao_init(void) {
+    hal_fila_init(&fila_leituras, sizeof(ingestao_leitura_t), INGESTAO_FILA);
+    memset(stats, 0, sizeof(stats));
+    num_fontes = 0;
+}
+
+/**
+ * @brief Inicia a fonte e, se ela estiver disponível, passa a coletá-la.
+ * @details A estrutura é copiada; o contexto deve permanecer válido.
+ */
+int ingestao_registrar(const ingestao_fonte_t *fonte) {
+    if (num_fontes >= INGESTAO_FONTES_MAX) return -1;
+    uint8_t id = num_fontes;
+    if (fonte->iniciar && !fonte->iniciar(fonte->ctx, id)) {
+        printf("Fonte de leituras '%s' indisponivel\n", fonte->nome);
+        return -1;
+    }
+    fontes[id] = *fonte;
+    num_fontes++;
+    return id;
+}
+
+/**
+ * @brief Dá a vez às fontes periódicas (tarefa do núcleo 0).
+ */
+void ingestao_coletar(void) {
+    uint64_t agora = hal_tempo_us();
+    for (uint8_t i = 0; i < num_fontes; i++) {
+        if (fontes[i].coletar) fontes[i].coletar(fontes[i].ctx, agora);
+    }
+}
+
+/**
+ * @brief Enfileira uma leitura para o núcleo 1 sem bloquear.
+ * @return bool `false` se a leitura foi recusada (inválida ou fila cheia).
+ */
+bool ingestao_publicar(uint8_t fonte, setor_id_t setor, float celsius, uint64_t instante_us) {
+    if (fonte >= INGESTAO_FONTES_MAX) return false;
+    ingestao_stats_t *s = &stats[fonte];
+    // A comparação também recusa NaN
+    if (setor >= MAX_SETORES || !(celsius >= INGESTAO_MIN_C && celsius <= INGESTAO_MAX_C)) {
+        s->invalidas++;
+        LOG_DEPURACAO("Leitura invalida da fonte %d: setor %d, %.2f C", fonte, setor, celsius);
+        return false;
+    }
+    ingestao_leitura_t leitura = { .instante_us = instante_us, .celsius = celsius, .setor = setor, .fonte = fonte };
+    if (!hal_fila_adicionar(&fila_leituras, &leitura)) {
+        s->descartadas++;
+        return false;
+    }
+    s->publicadas++;
+    return true;
+}
+
+bool ingestao_receber(ingestao_leitura_t *leitura) {
+    return hal_fila_remover(&fila_leituras, leitura);
+}
+
+/**
+ * @brief Contabiliza o destino de uma leitura recebida (núcleo 1).
+ */
+void ingestao_resultado(const ingestao_leitura_t *leitura, bool aplicada, uint64_t agora_us) {
+    ingestao_stats_t *s = &stats[leitura->fonte < INGESTAO_FONTES_MAX ? leitura->fonte : 0];
+    if (!aplicada) {
+        s->ignoradas++;
+        return;
+    }
+    s->aplicadas++;
+    uint64_t latencia = agora_us > leitura->instante_us ? agora_us - leitura->instante_us : 0;
+    if (latencia > s->pior_latencia_us) s->pior_latencia_us = latencia > UINT32_MAX ? UINT32_MAX : (uint32_t)latencia;
+}
+
+void ingestao_print_stats(void) {
+    if (num_fontes == 0) {
+        printf("Nenhuma fonte de leituras registrada\n");
+        return;
+    }
+    printf("Fonte      Publicadas Descartadas Invalidas  Aplicadas Ignoradas Latencia max\n");
+    for (uint8_t i = 0; i < num_fontes; i++) {
+        const ingestao_stats_t *s = &stats[i];
+        printf("%-10s %10lu %11lu %9lu %10lu %9lu %10luus\n", fontes[i].nome,
+               (unsigned long)s->publicadas, (unsigned long)s->descartadas, (unsigned long)s->invalidas,
+               (unsigned long)s->aplicadas, (unsigned long)s->ignoradas, (unsigned long)s->pior_latencia_us);
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file ingestao.h
+ * @brief Ingestão das leituras de temperatura dos setores a partir de fontes plugáveis.
+ * @details Cada fonte (sondas I2C, pacotes UDP de nós remotos, arquivo de
+ *          replay no build de host; ver fontes.h) é registrada no núcleo 0 e
+ *          publica leituras com carimbo de tempo (hal_tempo_us) em uma única
+ *          fila até o núcleo 1, dono do modelo de setores. O núcleo 1 drena a
+ *          fila em lotes e aplica cada leitura ao setor.
+ *
+ *          As fontes podem ser dirigidas por eventos (callbacks do lwIP, que
+ *          chamam ingestao_publicar diretamente) ou periódicas (`coletar`,
+ *          chamada por ingestao_coletar a partir de uma tarefa do núcleo 0).
+ *          Nenhuma fonte pode bloquear: quem depende de um barramento ocupado
+ *          tenta novamente na próxima coleta.
+ */
+
+#ifndef INGESTAO_H
+#define INGESTAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "setores.h"
+
+#define INGESTAO_FILA 128     // Leituras em trânsito entre os núcleos
+#define INGESTAO_FONTES_MAX 4 // Fontes registradas simultaneamente
+#define INGESTAO_LOTE 64      // Leituras aplicadas por execução da tarefa do núcleo 1
+
+/**
+ * @struct ingestao_leitura_t
+ * @brief Leitura de um setor, carimbada pela fonte.
+ */
+typedef struct {
+    uint64_t instante_us;   // hal_tempo_us() em que a leitura foi obtida
+    float celsius;          // Temperatura lida
+    setor_id_t setor;       // Índice do setor (0 a MAX_SETORES - 1)
+    uint8_t fonte;          // Identificador devolvido por ingestao_registrar
+} ingestao_leitura_t;
+
+/**
+ * @struct ingestao_fonte_t
+ * @brief Uma fonte de leituras.
+ */
+typedef struct {
+    const char *nome;                               // Nome exibido nas estatísticas
+    bool (*iniciar)(void *ctx, uint8_t fonte);      // `false`: fonte indisponível (não é registrada)
+    void (*coletar)(void *ctx, uint64_t agora_us);  // NULL para fontes dirigidas por eventos
+    void *ctx;
+} ingestao_fonte_t;
+
+/**
+ * @struct ingestao_stats_t
+ * @brief Contadores de uma fonte (publicação no núcleo 0, aplicação no núcleo 1).
+ */
+typedef struct {
+    uint32_t publicadas;    // Leituras aceitas na fila
+    uint32_t descartadas;   // Fila cheia
+    uint32_t invalidas;     // Setor inexistente ou temperatura fora da faixa
+    uint32_t aplicadas;     // Leituras que atualizaram um setor (núcleo 1)
+    uint32_t ignoradas;     // Setor não cadastrado ou leitura mais antiga que a aplicada
+    uint32_t pior_latencia_us; // Maior intervalo entre o carimbo e a aplicação
+} ingestao_stats_t;
+
+void ingestao_init(void); // Antes de registrar as fontes e de lançar o núcleo 1
+
+// Núcleo 0: registro, coleta periódica e publicação
+int ingestao_registrar(const ingestao_fonte_t *fonte); // Identificador da fonte ou -1
+void ingestao_coletar(void);
+bool ingestao_publicar(uint8_t fonte, setor_id_t setor, float celsius, uint64_t instante_us);
+
+// Núcleo 1: consumo da fila
+bool ingestao_receber(ingestao_leitura_t *leitura);
+void ingestao_resultado(const ingestao_leitura_t *leitura, bool aplicada, uint64_t agora_us);
+
+void ingestao_print_stats(void);
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file log.c
+ * @brief Anéis de mensagens por núcleo e formatação adiada do log.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "log.h"
+
+#define LOG_NUCLEOS 2 // Um anel de mensagens por núcleo
+
+/**
+ * @struct log_registro_t
+ * @brief Uma mensagem ainda não formatada.
+ */
+typedef struct {
+    const char *formato;              // Literal: só o ponteiro é guardado
+    uint32_t instante;                // hal_tempo_us() em 32 bits
+    uint8_t nivel;
+    uint8_t n;                        // Argumentos usados
+    uint8_t textos;                   // Bit k: args[k] é a posição de uma string em `texto`
+    log_palavra_t args[LOG_ARGS_MAX];
+    char texto[LOG_TEXTOS_MAX];       // Cópias das strings, terminadas em '\0'
+} log_registro_t;
+
+/**
+ * @struct log_fila_t
+ * @brief Anel SPSC de um núcleo: o núcleo (e suas IRQs) escreve, task_log lê.
+ */
+typedef struct {
+    volatile uint32_t escrita;  // Mensagens gravadas (só o produtor escreve)
+    volatile uint32_t leitura;  // Mensagens formatadas (só task_log escreve)
+    volatile uint32_t perdidos; // Descartadas por anel cheio (só o produtor escreve)
+    log_registro_t itens[LOG_FILA];
+} log_fila_t;
+
+static log_fila_t filas[LOG_NUCLEOS];
+static uint32_t perdidos_vistos[LOG_NUCLEOS]; // Última contagem já anunciada no console
+static uint32_t descartados;
+
+static const char letras[] = { [LOG_NIVEL_ERRO] = 'E', [LOG_NIVEL_AVISO] = 'A',
+                               [LOG_NIVEL_INFO] = 'I', [LOG_NIVEL_DEPURACAO] = 'D' };
+
+void log_init(void) {
+    memset(filas, 0, sizeof(filas));
+    memset(perdidos_vistos, 0, sizeof(perdidos_vistos));
+    descartados = 0;
+}
+
+/**
+ * @brief Grava uma mensagem no anel do núcleo atual, sem formatá-la.
+ * @details Mesmo protocolo de diario_registrar(): o índice de escrita só
+ *          avança depois da barreira. Anel cheio: a mensagem é descartada.
+ *          As strings marcadas em `textos` são copiadas para a mensagem.
+ */
+void log_registrar(uint8_t nivel, const char *formato, const log_palavra_t *args, uint8_t n, unsigned textos) {
+    log_fila_t *f = &filas[hal_nucleo()];
+    uint32_t irq = hal_irq_bloquear();
+    uint32_t escrita = f->escrita;
+    if (escrita - f->leitura >= LOG_FILA) {
+        f->perdidos++;
+    } else {
+        log_registro_t *r = &f->itens[escrita % LOG_FILA];
+        r->formato = formato;
+        r->instante = (uint32_t)hal_tempo_us();
+        r->nivel = nivel;
+        r->n = n;
+        r->textos = (uint8_t)textos;
+        size_t usado = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (!(textos & (1u << i))) {
+                r->args[i] = args[i];
+                continue;
+            }
+            // Cópia truncada; sem espaço, aponta para o '\0' final
+            const char *s = args[i] ? (const char *)args[i] : "(null)";
+            size_t livre = LOG_TEXTOS_MAX - 1 - usado;
+            size_t len = 0;
+            while (len < livre && s[len]) {
+                r->texto[usado + len] = s[len];
+                len++;
+            }
+            r->texto[usado + len] = '\0';
+            r->args[i] = usado;
+            usado += len < livre ? len + 1 : len;
+        }
+        r->texto[LOG_TEXTOS_MAX - 1] = '\0';
+        hal_barreira();
+        f->escrita = escrita + 1;
+    }
+    hal_irq_restaurar(irq);
+}
+
+/**
+ * @brief Expande `formato` com os argumentos gravados.
+ * @details Cada conversão é repassada a snprintf com o tipo que o caractere de
+ *          conversão pede (modificadores de tamanho são ignorados: os
+ *          argumentos têm até 32 bits); %s usa a cópia guardada na mensagem.
+ *          Conversões sem argumento são omitidas.
+ * @return size_t Caracteres escritos em `p` (sem o terminador).
+ */
+static size_t log_expandir(char *p, size_t tamanho, const log_registro_t *r) {
+    const char *formato = r->formato;
+    const log_palavra_t *args = r->args;
+    uint8_t n = r->n;
+    size_t usados = 0;
+    uint8_t k = 0;
+    const char *c = formato;
+    while (*c && usados + 1 < tamanho) {
+        if (*c != '%') {
+            p[usados++] = *c++;
+            continue;
+        }
+        if (c[1] == '%') {
+            p[usados++] = '%';
+            c += 2;
+            continue;
+        }
+
+        char spec[16];
+        size_t s = 0;
+        spec[s++] = *c++;
+        while (*c && strchr("-+ #0123456789.hlLjzt", *c)) {
+            if (!strchr("hlLjzt", *c) && s < sizeof(spec) - 2) spec[s++] = *c;
+            c++;
+        }
+        char conversao = *c;
+        if (!conversao) break;
+        c++;
+        spec[s++] = conversao;
+        spec[s] = '\0';
+        if (k >= n) continue;
+
+        bool texto = r->textos & (1u << k);
+        log_palavra_t a = args[k++];
+        size_t livre = tamanho - usados;
+        int w;
+        switch (conversao) {
+        case 'd': case 'i': case 'c':
+            w = snprintf(p + usados, livre, spec, (int)(intptr_t)a);
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            w = snprintf(p + usados, livre, spec, (unsigned)a);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+            uint32_t bits = (uint32_t)a;
+            float v;
+            memcpy(&v, &bits, sizeof(v));
+            w = snprintf(p + usados, livre, spec, (double)v);
+            break;
+        }
+        case 's':
+            w = snprintf(p + usados, livre, spec, texto ? r->texto + a : "(string esperada)");
+            break;
+        case 'p':
+            w = snprintf(p + usados, livre, spec, (void *)a);
+            break;
+        default:
+            w = 0;
+            break;
+        }
+        if (w < 0) break;
+        usados += (size_t)w < livre ? (size_t)w : livre - 1;
+    }
+    p[usados] = '\0';
+    return usados;
+}
+
+/**
+ * @brief Formata a próxima mensagem (a mais antiga entre os anéis) em `linha`.
+ * @details Saída: "[N s.mmm] texto\n", com N a letra do nível e o instante em
+ *          segundos desde o boot. Descartes por anel cheio viram uma linha de
+ *          aviso, antes das mensagens que sobreviveram.
+ * @return bool `false` se não há mensagem pendente.
+ */
+bool log_formatar(char *linha, size_t tamanho) {
+    for (int n = 0; n < LOG_NUCLEOS; n++) {
+        uint32_t perdidos = filas[n].perdidos;
+        if (perdidos != perdidos_vistos[n]) {
+            descartados += perdidos - perdidos_vistos[n];
+            snprintf(linha, tamanho, "[A] log: %lu mensagens do nucleo %d descartadas (anel cheio)\n",
+                     (unsigned long)(perdidos - perdidos_vistos[n]), n);
+            perdidos_vistos[n] = perdidos;
+            return true;
+        }
+    }
+
+    log_fila_t *escolhida = NULL;
+    for (int n = 0; n < LOG_NUCLEOS; n++) {
+        log_fila_t *f = &filas[n];
+        if (f->leitura == f->escrita) continue;
+        if (!escolhida || (int32_t)(f->itens[f->leitura % LOG_FILA].instante -
+                                    escolhida->itens[escolhida->leitura % LOG_FILA].instante) < 0) {
+            escolhida = f;
+        }
+    }
+    if (!escolhida) return false;
+    hal_barreira(); // Índice de escrita lido antes do conteúdo
+    log_registro_t r = escolhida->itens[escolhida->leitura % LOG_FILA];
+    hal_barreira(); // Cópia concluída antes de liberar a posição ao produtor
+    escolhida->leitura++;
+
+    uint64_t agora = hal_tempo_us();
+    uint64_t ms = (agora - (uint32_t)((uint32_t)agora - r.instante)) / 1000u;
+    int prefixo = snprintf(linha, tamanho, "[%c %lu.%03lu] ",
+                           r.nivel < sizeof(letras) ? letras[r.nivel] : '?',
+                           (unsigned long)(ms / 1000u), (unsigned long)(ms % 1000u));
+    if (prefixo < 0) prefixo = 0;
+    size_t usados = (size_t)prefixo < tamanho ? (size_t)prefixo : tamanho - 1;
+    if (usados + 2 < tamanho) {
+        usados += log_expandir(linha + usados, tamanho - usados - 1, &r);
+    }
+    linha[usados++] = '\n';
+    linha[usados] = '\0';
+    return true;
+}
+
+/**
+ * @brief Escreve no console até LOG_LOTE mensagens pendentes.
+ * @details Único ponto do log que chama stdio: limitar o lote mantém a tarefa
+ *          curta mesmo quando o USB CDC está lento; o resto fica para a
+ *          próxima execução.
+ */
+void log_drenar(void) {
+    char linha[LOG_LINHA_MAX];
+    for (int i = 0; i < LOG_LOTE && log_formatar(linha, sizeof(linha)); i++) {
+        fputs(linha, stdout);
+    }
+}
+
+uint32_t log_descartados(void) {
+    return descartados;
+}
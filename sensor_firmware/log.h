@@ -0,0 +1,142 @@
+/**
+ * @file log.h
+ * @brief Log adiado: mensagens gravadas em binário em anéis na RAM e formatadas por task_log.
+ * @details LOG_ERRO, LOG_AVISO, LOG_INFO e LOG_DEPURACAO(formato, args...) não
+ *          chamam printf: gravam o ponteiro do formato, o instante e até
+ *          LOG_ARGS_MAX argumentos (uma palavra cada) no anel do núcleo atual,
+ *          como os eventos de diario.h (sem trava entre os núcleos; anel cheio
+ *          descarta e conta). task_log, a última tarefa do núcleo 0, formata até
+ *          LOG_LOTE mensagens por execução e as escreve no console: uma retenção
+ *          do USB CDC atrasa o log, nunca quem registrou a mensagem.
+ *
+ *          Níveis: LOG_NIVEL (no build, AGROGRAF_LOG_NIVEL) é o nível mais
+ *          detalhado compilado. Chamadas acima dele viram código morto: nem os
+ *          argumentos são avaliados. Com LOG_NIVEL_DEPURACAO, cada mensagem a
+ *          mais custa no chamador só a gravação no anel.
+ *
+ *          Argumentos: inteiros de até 32 bits, float/double (guardado como
+ *          float) e strings. As strings são copiadas para a mensagem no
+ *          registro (até LOG_TEXTOS_MAX bytes somados, o excedente é truncado):
+ *          task_log formata depois que o chamador retornou, quando um buffer
+ *          local ou reutilizado passado como %s já não vale. A cópia é um laço
+ *          por byte com as IRQs bloqueadas; mensagens sem string só testam a
+ *          máscara. O formato é uma linha sem '\n' (acrescentado na saída),
+ *          guardado pelo ponteiro (deve ser literal) e conferido pelo compilador
+ *          como o de printf.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define LOG_NIVEL_NENHUM 0
+#define LOG_NIVEL_ERRO 1
+#define LOG_NIVEL_AVISO 2
+#define LOG_NIVEL_INFO 3
+#define LOG_NIVEL_DEPURACAO 4
+
+#ifndef LOG_NIVEL
+#define LOG_NIVEL LOG_NIVEL_INFO
+#endif
+#ifndef LOG_FILA
+#define LOG_FILA 32          // Mensagens por núcleo aguardando task_log (potência de 2)
+#endif
+_Static_assert((LOG_FILA & (LOG_FILA - 1)) == 0, "LOG_FILA deve ser potência de 2");
+
+#define LOG_ARGS_MAX 6       // Argumentos por mensagem
+#define LOG_TEXTOS_MAX 32    // Bytes das strings copiadas por mensagem (com os terminadores)
+#define LOG_LOTE 4           // Mensagens escritas por execução de task_log
+#define LOG_LINHA_MAX 128    // Linha formatada (excedente truncado)
+
+typedef uintptr_t log_palavra_t; // Um argumento (cabe um ponteiro também no host de 64 bits)
+
+// ===== CODIFICAÇÃO DOS ARGUMENTOS (SEM CONVERSÃO DE PONTO FLUTUANTE NO CHAMADOR) =====
+static inline log_palavra_t log_float(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+static inline log_palavra_t log_double(double v) {
+    return log_float((float)v);
+}
+static inline log_palavra_t log_texto(const char *s) {
+    return (log_palavra_t)s;
+}
+static inline log_palavra_t log_ponteiro(const void *p) {
+    return (log_palavra_t)p;
+}
+static inline log_palavra_t log_inteiro(intptr_t v) {
+    return (log_palavra_t)v;
+}
+
+#define LOG_PALAVRA(x) _Generic((x),  \
+    float: log_float,                 \
+    double: log_double,               \
+    char *: log_texto,                \
+    const char *: log_texto,          \
+    void *: log_ponteiro,             \
+    const void *: log_ponteiro,       \
+    default: log_inteiro)(x)
+
+// Bit k da máscara: o argumento k é uma string (copiada no registro)
+#define LOG_TEXTO(x) _Generic((x), char *: 1u, const char *: 1u, default: 0u)
+
+// Formato, vetor de argumentos, quantidade e máscara de strings a partir de (formato, args...)
+#define LOG_CONTAR(...) LOG_CONTAR_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, excesso)
+#define LOG_CONTAR_(f, a1, a2, a3, a4, a5, a6, n, ...) n
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+#define LOG_CONCAT_(a, b) a##b
+#define LOG_PALAVRAS(...) LOG_CONCAT(LOG_PALAVRAS_, LOG_CONTAR(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_PALAVRAS_0(f) f, NULL, 0, 0u
+#define LOG_PALAVRAS_1(f, a) f, (const log_palavra_t[]){ LOG_PALAVRA(a) }, 1, LOG_TEXTO(a)
+#define LOG_PALAVRAS_2(f, a, b) \
+    f, (const log_palavra_t[]){ LOG_PALAVRA(a), LOG_PALAVRA(b) }, 2, \
+    LOG_TEXTO(a) | LOG_TEXTO(b) << 1
+#define LOG_PALAVRAS_3(f, a, b, c) \
+    f, (const log_palavra_t[]){ LOG_PALAVRA(a), LOG_PALAVRA(b), LOG_PALAVRA(c) }, 3, \
+    LOG_TEXTO(a) | LOG_TEXTO(b) << 1 | LOG_TEXTO(c) << 2
+#define LOG_PALAVRAS_4(f, a, b, c, d) \
+    f, (const log_palavra_t[]){ LOG_PALAVRA(a), LOG_PALAVRA(b), LOG_PALAVRA(c), LOG_PALAVRA(d) }, 4, \
+    LOG_TEXTO(a) | LOG_TEXTO(b) << 1 | LOG_TEXTO(c) << 2 | LOG_TEXTO(d) << 3
+#define LOG_PALAVRAS_5(f, a, b, c, d, e) \
+    f, (const log_palavra_t[]){ LOG_PALAVRA(a), LOG_PALAVRA(b), LOG_PALAVRA(c), LOG_PALAVRA(d), LOG_PALAVRA(e) }, 5, \
+    LOG_TEXTO(a) | LOG_TEXTO(b) << 1 | LOG_TEXTO(c) << 2 | LOG_TEXTO(d) << 3 | LOG_TEXTO(e) << 4
+#define LOG_PALAVRAS_6(f, a, b, c, d, e, g) \
+    f, (const log_palavra_t[]){ LOG_PALAVRA(a), LOG_PALAVRA(b), LOG_PALAVRA(c), LOG_PALAVRA(d), LOG_PALAVRA(e), LOG_PALAVRA(g) }, 6, \
+    LOG_TEXTO(a) | LOG_TEXTO(b) << 1 | LOG_TEXTO(c) << 2 | LOG_TEXTO(d) << 3 | LOG_TEXTO(e) << 4 | LOG_TEXTO(g) << 5
+
+// Nunca executada: só faz o compilador conferir formato e argumentos
+static inline void log_conferir(const char *formato, ...) __attribute__((format(printf, 1, 2)));
+static inline void log_conferir(const char *formato, ...) {
+    (void)formato;
+}
+
+#define LOG_REGISTRAR(nivel, ...)                                    \
+    do {                                                             \
+        if ((nivel) <= LOG_NIVEL) {                                  \
+            log_registrar((nivel), LOG_PALAVRAS(__VA_ARGS__));       \
+        }                                                            \
+        if (0) log_conferir(__VA_ARGS__);                            \
+    } while (0)
+
+#define LOG_ERRO(...) LOG_REGISTRAR(LOG_NIVEL_ERRO, __VA_ARGS__)
+#define LOG_AVISO(...) LOG_REGISTRAR(LOG_NIVEL_AVISO, __VA_ARGS__)
+#define LOG_INFO(...) LOG_REGISTRAR(LOG_NIVEL_INFO, __VA_ARGS__)
+#define LOG_DEPURACAO(...) LOG_REGISTRAR(LOG_NIVEL_DEPURACAO, __VA_ARGS__)
+// =====================================================================================
+
+void log_init(void); // Antes de lançar o núcleo 1
+
+// Qualquer núcleo ou IRQ (use as macros LOG_*)
+void log_registrar(uint8_t nivel, const char *formato, const log_palavra_t *args, uint8_t n, unsigned textos);
+
+// Núcleo 0
+bool log_formatar(char *linha, size_t tamanho); // Próxima mensagem, em ordem de tempo; `false` se não há
+void log_drenar(void);                          // task_log: até LOG_LOTE mensagens no console
+uint32_t log_descartados(void);                 // Mensagens perdidas por anel cheio desde o boot
+
+#endif
@@ -19,8 +19,12 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
-#define MEM_SIZE                    4000
+// Heap sized for HTTP_MAX_CONEXOES keep-alive connections: http_server.c caps
+// each connection's unacknowledged data at MEM_SIZE / (2 * HTTP_MAX_CONEXOES)
+#define MEM_SIZE                    24000
 #define MEMP_NUM_TCP_SEG            32
+// HTTP connection table (HTTP_MAX_CONEXOES) plus connections in TIME_WAIT
+#define MEMP_NUM_TCP_PCB            12
 #define MEMP_NUM_ARP_QUEUE          10
 #define PBUF_POOL_SIZE              24
 #define LWIP_ARP                    1
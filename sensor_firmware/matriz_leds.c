@@ -0,0 +1,132 @@
+/**
+ * @file matriz_leds.c
+ * @brief Quadro duplo da matriz WS2812B sobre o envio por DMA da HAL.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "matriz_leds.h"
+
+static uint32_t quadro[MATRIZ_LEDS_QTD];             // Quadro persistente (palavras HAL_LEDS_GRB)
+static uint32_t quadro_entregue[MATRIZ_LEDS_QTD];    // Último quadro entregue ao DMA (no fio ou pendente)
+static bool quadro_sujo = false;                     // `quadro` mudou desde a última apresentação
+static matriz_leds_stats_t stats;
+static uint32_t buffers[2][MATRIZ_LEDS_QTD];         // Buffers de envio: um no DMA, outro livre/pendente
+static volatile int8_t buffer_em_envio = -1;         // Buffer lido pelo DMA (-1 = nenhum)
+static volatile bool buffer_pendente = false;        // O outro buffer aguarda o fim da transferência
+static bool pronta = false;                          // PIO e DMA reservados
+
+/**
+ * @brief Callback de conclusão da HAL (contexto de IRQ): envia o quadro pendente.
+ * @details A HAL só chama este callback após o tempo de reset do WS2812B,
+ *          então o próximo quadro pode começar imediatamente.
+ */
+static void matriz_leds_concluido(void *ctx) {
+    (void)ctx;
+    if (buffer_pendente) {
+        buffer_pendente = false;
+        buffer_em_envio ^= 1;
+        hal_leds_enviar(buffers[buffer_em_envio], MATRIZ_LEDS_QTD);
+    } else {
+        buffer_em_envio = -1;
+    }
+}
+
+/**
+ * @brief Converte a posição (x, y) de um LED na sua posição na fita.
+ * @details A fita percorre a matriz em serpentina, começando pelo canto
+ *          superior direito:
+ *          linhas pares, da direita para a esquerda; ímpares, da esquerda para a direita.
+ *          Y=0: 4  3  2  1  0
+ *          Y=1: 5  6  7  8  9
+ *          Y=2: 14 13 12 11 10
+ *          Y=3: 15 16 17 18 19
+ *          Y=4: 24 23 22 21 20
+ */
+uint matriz_leds_indice(uint x, uint y) {
+    if (y % 2 == 0) {
+        return y * MATRIZ_LEDS_LARGURA + (MATRIZ_LEDS_LARGURA - 1 - x); // Da direita para a esquerda
+    }
+    return y * MATRIZ_LEDS_LARGURA + x; // Da esquerda para a direita
+}
+
+/**
+ * @brief Reserva PIO e DMA e apaga a matriz.
+ */
+bool matriz_leds_init(uint pino) {
+    pronta = hal_leds_init(pino, matriz_leds_concluido, NULL);
+    if (!pronta) {
+        return false; // A HAL já informou o erro
+    }
+    // O estado da fita no boot é desconhecido: o byte baixo de uma palavra
+    // HAL_LEDS_GRB é sempre zero, então este valor nunca coincide com um quadro
+    memset(quadro_entregue, 0xFF, sizeof(quadro_entregue));
+    memset(quadro, 0, sizeof(quadro));
+    quadro_sujo = true;
+    matriz_leds_apresentar();
+    return true;
+}
+
+void matriz_leds_definir(uint indice, uint8_t r, uint8_t g, uint8_t b) {
+    if (indice < MATRIZ_LEDS_QTD) {
+        uint32_t cor = HAL_LEDS_GRB(r, g, b);
+        if (quadro[indice] != cor) {
+            quadro[indice] = cor;
+            quadro_sujo = true;
+        }
+    }
+}
+
+void matriz_leds_limpar(void) {
+    for (uint i = 0; i < MATRIZ_LEDS_QTD; i++) {
+        if (quadro[i]) {
+            quadro[i] = 0;
+            quadro_sujo = true;
+        }
+    }
+}
+
+/**
+ * @brief Entrega o quadro atual ao DMA, ou o deixa pendente se o DMA estiver ocupado.
+ * @details Não faz nada se o quadro não mudou ou se voltou a ser igual ao
+ *          último entregue (ex.: cursor que saiu e voltou ao mesmo LED).
+ *          A cópia (100 bytes) é feita com as IRQs bloqueadas para que o
+ *          callback de conclusão nunca envie um buffer pela metade.
+ */
+void matriz_leds_apresentar(void) {
+    if (!pronta) return;
+    stats.apresentacoes++;
+    if (!quadro_sujo) return;
+    quadro_sujo = false;
+    if (memcmp(quadro, quadro_entregue, sizeof(quadro)) == 0) return;
+    memcpy(quadro_entregue, quadro, sizeof(quadro));
+    stats.enviados++;
+
+    uint32_t irq = hal_irq_bloquear();
+    if (buffer_em_envio < 0) {
+        memcpy(buffers[0], quadro, sizeof(quadro));
+        buffer_em_envio = 0;
+        hal_leds_enviar(buffers[0], MATRIZ_LEDS_QTD);
+    } else {
+        if (buffer_pendente) stats.substituidos++;
+        memcpy(buffers[buffer_em_envio ^ 1], quadro, sizeof(quadro));
+        buffer_pendente = true;
+    }
+    hal_irq_restaurar(irq);
+}
+
+bool matriz_leds_ocupada(void) {
+    return buffer_em_envio >= 0;
+}
+
+/**
+ * @brief Imprime quantas apresentações viraram transferência na matriz.
+ * @details Lida pelo núcleo 0 apenas para exibição, como as estatísticas do escalonador.
+ */
+void matriz_leds_print_stats(void) {
+    uint32_t evitadas = stats.apresentacoes - stats.enviados;
+    printf("Apresentacoes %lu, quadros enviados %lu, sem alteracao %lu, substituidos %lu\n",
+           (unsigned long)stats.apresentacoes, (unsigned long)stats.enviados,
+           (unsigned long)evitadas, (unsigned long)stats.substituidos);
+}
@@ -0,0 +1,48 @@
+/**
+ * @file matriz_leds.h
+ * @brief Matriz de LEDs WS2812B com quadro duplo e envio por DMA.
+ * @details O desenho é feito em um quadro persistente (matriz_leds_definir),
+ *          já no formato de palavra GRB que o PIO consome. matriz_leds_apresentar()
+ *          copia esse quadro para um dos dois buffers de envio e o entrega ao DMA
+ *          sem esperar: a CPU não participa dos ~750 us do quadro no fio.
+ *          Se uma transferência ainda está em andamento, o quadro fica pendente
+ *          no outro buffer e é enviado pelo callback de conclusão (IRQ); uma nova
+ *          apresentação antes disso apenas substitui o quadro pendente.
+ *
+ *          O quadro rastreia alterações: definir a cor que o LED já tem não o
+ *          suja, e apresentar um quadro limpo, ou idêntico ao último entregue
+ *          ao DMA, não gera transferência alguma. Assim as tarefas podem
+ *          redesenhar a matriz inteira a cada período sem custo no barramento.
+ *          Usada somente pelo núcleo 1 (dono dos atuadores).
+ */
+
+#ifndef MATRIZ_LEDS_H
+#define MATRIZ_LEDS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#define MATRIZ_LEDS_LARGURA 5 // Matriz 5x5 da BitDogLab
+#define MATRIZ_LEDS_ALTURA 5
+#define MATRIZ_LEDS_QTD (MATRIZ_LEDS_LARGURA * MATRIZ_LEDS_ALTURA)
+
+/**
+ * @struct matriz_leds_stats_t
+ * @brief Contadores das apresentações (escritos pelo núcleo 1).
+ */
+typedef struct {
+    uint32_t apresentacoes;   // Chamadas a matriz_leds_apresentar
+    uint32_t enviados;        // Quadros que geraram transferência (ou ficaram pendentes)
+    uint32_t substituidos;    // Quadros pendentes trocados por um mais novo antes do envio
+} matriz_leds_stats_t;
+
+uint matriz_leds_indice(uint x, uint y); // Posição na fita do LED na coluna x, linha y
+bool matriz_leds_init(uint pino);  // `false` se o PIO/DMA não puderam ser reservados
+void matriz_leds_definir(uint indice, uint8_t r, uint8_t g, uint8_t b);
+void matriz_leds_limpar(void);     // Apaga o quadro (sem enviar)
+void matriz_leds_apresentar(void); // Envia o quadro atual sem bloquear
+bool matriz_leds_ocupada(void);    // Há transferência em andamento ou pendente
+void matriz_leds_print_stats(void);
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file painel_oled.c
+ * @brief Desenho incremental do painel de status no framebuffer do OLED.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "inc/ssd1306.h"
+#include "setores.h"
+#include "painel_oled.h"
+
+// Disposição na tela (128x64)
+#define PAINEL_CELULA_PASSO 7     // Grade da matriz (5x5) no canto superior esquerdo (35x35 px)
+#define PAINEL_CELULA_LADO 6
+#define PAINEL_TEXTO_X 40         // Coluna de texto à direita da grade
+#define PAINEL_TEXTO_LARGURA 11   // Caracteres que cabem na coluna de texto
+#define PAINEL_GRAFICO_Y 40       // Gráfico nas páginas 5 e 6
+#define PAINEL_GRAFICO_ALTURA 16
+#define PAINEL_GRAFICO_ESCALA_MIN_DC 20 // Faixa mínima do gráfico (2 °C): ruído não vira serrote
+#define PAINEL_REDE_Y 56          // Última linha
+
+_Static_assert(MATRIZ_LEDS_LARGURA * PAINEL_CELULA_PASSO <= PAINEL_TEXTO_X &&
+               MATRIZ_LEDS_ALTURA * PAINEL_CELULA_PASSO <= PAINEL_GRAFICO_Y,
+               "a grade da matriz nao cabe no painel");
+
+/**
+ * @brief Elementos do painel, em ordem de prioridade de desenho.
+ */
+enum {
+    PAINEL_ALARME,
+    PAINEL_QUENTE,
+    PAINEL_GRADE,
+    PAINEL_AMBIENTE,
+    PAINEL_GRAFICO,
+    PAINEL_REDE,
+    PAINEL_NUM_ELEMENTOS
+};
+
+static uint8_t *fb;                          // Framebuffer do display (NULL antes de iniciar)
+static painel_oled_modelo_t exibido;         // Modelo já desenhado, elemento a elemento
+static uint32_t forcados;                    // Elementos a redesenhar mesmo sem mudança (bit por elemento)
+static painel_oled_stats_t stats;
+
+// Histórico do sensor onboard (décimos de °C), do mais antigo ao mais recente
+static int16_t amostras[PAINEL_GRAFICO_AMOSTRAS];
+static uint16_t amostras_qtd;
+static uint16_t amostras_inicio;             // Posição da mais antiga quando o histórico está cheio
+static uint32_t amostras_versao;             // Incrementada a cada amostra
+static uint32_t amostras_exibidas;           // Versão desenhada no gráfico
+
+// Escreve `texto` (UTF-8) em (x, y), cortado ou completado com espaços até
+// `largura` caracteres; os bytes de continuação não ocupam colunas
+static void painel_texto(int x, int y, const char *texto, int largura) {
+    char linha[2 * PAINEL_TEXTO_MAX + 1]; // Até 2 bytes por caractere (acentos, '°')
+    int n = 0, caracteres = 0;
+    for (const char *s = texto; *s && n < (int)sizeof(linha) - 1; s++) {
+        bool continuacao = ((uint8_t)*s & 0xC0) == 0x80;
+        if (!continuacao && caracteres == largura) break;
+        caracteres += !continuacao;
+        linha[n++] = *s;
+    }
+    while (caracteres < largura && n < (int)sizeof(linha) - 1) {
+        linha[n++] = ' ';
+        caracteres++;
+    }
+    linha[n] = '\0';
+    ssd1306_draw_string(fb, (int16_t)x, (int16_t)y, linha);
+}
+
+static void painel_formatar_dc(char *texto, size_t tamanho, const char *prefixo, int16_t dc) {
+    int absoluto = dc < 0 ? -dc : dc;
+    snprintf(texto, tamanho, "%s%s%d.%d°C", prefixo, dc < 0 ? "-" : "", absoluto / 10, absoluto % 10);
+}
+
+// Célula vazia: um ponto; cadastrada: contorno; em aviso: contorno com o ponto; em alarme: preenchida
+static void painel_celula(int x, int y, uint8_t estado) {
+    int x0 = x * PAINEL_CELULA_PASSO, y0 = y * PAINEL_CELULA_PASSO;
+    for (int dy = 0; dy < PAINEL_CELULA_LADO; dy++) {
+        for (int dx = 0; dx < PAINEL_CELULA_LADO; dx++) {
+            bool borda = dx == 0 || dy == 0 || dx == PAINEL_CELULA_LADO - 1 || dy == PAINEL_CELULA_LADO - 1;
+            bool centro = (dx == 2 || dx == 3) && (dy == 2 || dy == 3);
+            bool aceso = estado == PAINEL_CELULA_ALARME ||
+                         ((estado == PAINEL_CELULA_CADASTRADA || estado == PAINEL_CELULA_AVISO) && borda) ||
+                         ((estado == PAINEL_CELULA_VAZIA || estado == PAINEL_CELULA_AVISO) && centro);
+            ssd1306_set_pixel(fb, x0 + dx, y0 + dy, aceso);
+        }
+    }
+}
+
+/**
+ * @brief Monta o gráfico inteiro em um bitmap de 2 páginas e o copia com ssd1306_blit.
+ * @details A escala acompanha o mínimo e o máximo do histórico; a amostra mais
+ *          recente fica na borda direita. O blit só altera (e suja) os bytes
+ *          que mudaram.
+ */
+static void painel_grafico(void) {
+    uint8_t imagem[PAINEL_GRAFICO_ALTURA / 8][PAINEL_GRAFICO_AMOSTRAS];
+    memset(imagem, 0, sizeof(imagem));
+
+    if (amostras_qtd > 0) {
+        int16_t minimo = INT16_MAX, maximo = INT16_MIN;
+        for (uint16_t i = 0; i < amostras_qtd; i++) {
+            if (amostras[i] < minimo) minimo = amostras[i];
+            if (amostras[i] > maximo) maximo = amostras[i];
+        }
+        int faixa = maximo - minimo;
+        int base = minimo;
+        if (faixa < PAINEL_GRAFICO_ESCALA_MIN_DC) {
+            base -= (PAINEL_GRAFICO_ESCALA_MIN_DC - faixa) / 2;
+            faixa = PAINEL_GRAFICO_ESCALA_MIN_DC;
+        }
+
+        int x0 = PAINEL_GRAFICO_AMOSTRAS - amostras_qtd;
+        int anterior = -1;
+        for (uint16_t i = 0; i < amostras_qtd; i++) {
+            int16_t valor = amostras[(amostras_inicio + i) % PAINEL_GRAFICO_AMOSTRAS];
+            int y = PAINEL_GRAFICO_ALTURA - 1 - (valor - base) * (PAINEL_GRAFICO_ALTURA - 1) / faixa;
+            int de = anterior < 0 ? y : anterior; // Liga ao ponto anterior com um traço vertical
+            int y_min = de < y ? de : y, y_max = de < y ? y : de;
+            for (int yy = y_min; yy <= y_max; yy++) imagem[yy / 8][x0 + i] |= (uint8_t)(1u << (yy % 8));
+            anterior = y;
+        }
+    }
+    ssd1306_blit(fb, &imagem[0][0], PAINEL_GRAFICO_AMOSTRAS, 0, 0,
+                 PAINEL_GRAFICO_AMOSTRAS, PAINEL_GRAFICO_ALTURA, 0, PAINEL_GRAFICO_Y);
+}
+
+static bool painel_alterado(int elemento, const painel_oled_modelo_t *m) {
+    if (forcados & (1u << elemento)) return true;
+    switch (elemento) {
+        case PAINEL_ALARME:   return m->em_alarme != exibido.em_alarme || m->em_aviso != exibido.em_aviso;
+        case PAINEL_QUENTE:   return m->setor_quente != exibido.setor_quente || m->quente_dc != exibido.quente_dc;
+        case PAINEL_GRADE:    return memcmp(m->grade, exibido.grade, sizeof(m->grade)) != 0;
+        case PAINEL_AMBIENTE: return m->ambiente_dc != exibido.ambiente_dc;
+        case PAINEL_GRAFICO:  return amostras_versao != amostras_exibidas;
+        case PAINEL_REDE:     return strcmp(m->rede, exibido.rede) != 0;
+        default:              return false;
+    }
+}
+
+// Desenha um elemento e o registra como exibido
+static void painel_desenhar(int elemento, const painel_oled_modelo_t *m) {
+    char texto[PAINEL_TEXTO_MAX + 1];
+    bool forcado = forcados & (1u << elemento);
+    switch (elemento) {
+        case PAINEL_ALARME:
+            if (m->em_alarme) snprintf(texto, sizeof(texto), "Alarme %u", (unsigned)m->em_alarme);
+            else if (m->em_aviso) snprintf(texto, sizeof(texto), "Aviso %u", (unsigned)m->em_aviso);
+            else snprintf(texto, sizeof(texto), "Normal");
+            painel_texto(PAINEL_TEXTO_X, 24, texto, PAINEL_TEXTO_LARGURA);
+            exibido.em_alarme = m->em_alarme;
+            exibido.em_aviso = m->em_aviso;
+            break;
+        case PAINEL_QUENTE:
+            if (m->setor_quente < MAX_SETORES) {
+                painel_texto(PAINEL_TEXTO_X, 8, nomes_setores[m->setor_quente], PAINEL_TEXTO_LARGURA);
+                painel_formatar_dc(texto, sizeof(texto), "", m->quente_dc);
+                painel_texto(PAINEL_TEXTO_X, 16, texto, PAINEL_TEXTO_LARGURA);
+            } else {
+                painel_texto(PAINEL_TEXTO_X, 8, "Nenhum", PAINEL_TEXTO_LARGURA);
+                painel_texto(PAINEL_TEXTO_X, 16, "", PAINEL_TEXTO_LARGURA);
+            }
+            exibido.setor_quente = m->setor_quente;
+            exibido.quente_dc = m->quente_dc;
+            break;
+        case PAINEL_GRADE:
+            for (int y = 0; y < MATRIZ_LEDS_ALTURA; y++) {
+                for (int x = 0; x < MATRIZ_LEDS_LARGURA; x++) {
+                    if (forcado || m->grade[x][y] != exibido.grade[x][y]) painel_celula(x, y, m->grade[x][y]);
+                }
+            }
+            memcpy(exibido.grade, m->grade, sizeof(exibido.grade));
+            break;
+        case PAINEL_AMBIENTE:
+            painel_formatar_dc(texto, sizeof(texto), "Amb ", m->ambiente_dc);
+            painel_texto(PAINEL_TEXTO_X, 32, texto, PAINEL_TEXTO_LARGURA);
+            exibido.ambiente_dc = m->ambiente_dc;
+            break;
+        case PAINEL_GRAFICO:
+            painel_grafico();
+            amostras_exibidas = amostras_versao;
+            break;
+        case PAINEL_REDE:
+            painel_texto(0, PAINEL_REDE_Y, m->rede, PAINEL_TEXTO_MAX);
+            memcpy(exibido.rede, m->rede, sizeof(exibido.rede));
+            break;
+        default:
+            break;
+    }
+    forcados &= ~(1u << elemento);
+}
+
+/**
+ * @brief Apaga a tela, desenha as partes fixas e agenda o desenho de todos os elementos.
+ */
+void painel_oled_iniciar(ssd1306_t *display) {
+    fb = ssd1306_framebuffer(display);
+    memset(fb, 0, ssd1306_buffer_length);
+    struct render_area tela = { 0, ssd1306_width - 1, 0, ssd1306_n_pages - 1, ssd1306_buffer_length };
+    ssd1306_invalidate(display, &tela); // Escritas diretas no buffer não são rastreadas
+    painel_texto(PAINEL_TEXTO_X, 0, "Mais quente", PAINEL_TEXTO_LARGURA);
+    forcados = (1u << PAINEL_NUM_ELEMENTOS) - 1;
+}
+
+void painel_oled_amostrar(float celsius) {
+    int16_t dc = (int16_t)(celsius * 10.0f + (celsius < 0.0f ? -0.5f : 0.5f));
+    if (amostras_qtd < PAINEL_GRAFICO_AMOSTRAS) {
+        amostras[amostras_qtd++] = dc;
+    } else {
+        amostras[amostras_inicio] = dc; // Substitui a mais antiga
+        amostras_inicio = (uint16_t)((amostras_inicio + 1) % PAINEL_GRAFICO_AMOSTRAS);
+    }
+    amostras_versao++;
+}
+
+/**
+ * @brief Redesenha, em ordem de prioridade, os elementos que mudaram.
+ * @details Antes de cada elemento (a partir do segundo) confere o tempo gasto:
+ *          esgotado PAINEL_ORCAMENTO_US, os restantes continuam diferentes do
+ *          modelo exibido e são desenhados no próximo quadro.
+ */
+void painel_oled_atualizar(const painel_oled_modelo_t *modelo) {
+    if (!fb) return;
+    uint64_t inicio = hal_tempo_us();
+    uint32_t desenhados = 0;
+    for (int e = 0; e < PAINEL_NUM_ELEMENTOS; e++) {
+        if (!painel_alterado(e, modelo)) continue;
+        if (desenhados > 0 && hal_tempo_us() - inicio >= PAINEL_ORCAMENTO_US) {
+            stats.adiados++;
+            break;
+        }
+        painel_desenhar(e, modelo);
+        desenhados++;
+    }
+    if (desenhados == 0) return;
+
+    uint32_t duracao = (uint32_t)(hal_tempo_us() - inicio);
+    stats.quadros++;
+    stats.elementos += desenhados;
+    stats.ultimo_us = duracao;
+    if (duracao > stats.pior_us) stats.pior_us = duracao;
+}
+
+void painel_oled_print_stats(void) {
+    printf("Quadros %lu, elementos redesenhados %lu, adiados %lu, ultimo %lu us, pior %lu us (orcamento %d us)\n",
+           (unsigned long)stats.quadros, (unsigned long)stats.elementos, (unsigned long)stats.adiados,
+           (unsigned long)stats.ultimo_us, (unsigned long)stats.pior_us, PAINEL_ORCAMENTO_US);
+}
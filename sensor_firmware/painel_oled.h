@@ -0,0 +1,74 @@
+/**
+ * @file painel_oled.h
+ * @brief Painel de status dos setores no display OLED.
+ * @details Mostra, em uma única tela de 128x64:
+ *          - uma grade espelhando a matriz de LEDs, isto é, a janela do visor
+ *            sobre a grade de setores (vazio, cadastrado, alarme);
+ *          - o setor mais quente e sua temperatura, a quantidade de setores em
+ *            alarme e a temperatura ambiente;
+ *          - um gráfico (sparkline) das últimas leituras do sensor onboard;
+ *          - o endereço IP ou o estado do link Wi-Fi.
+ *
+ *          O painel guarda o modelo exibido: a cada quadro compara o novo
+ *          modelo com ele e redesenha apenas os elementos que mudaram (e, na
+ *          grade, apenas as células). Os elementos são desenhados em ordem de
+ *          prioridade até PAINEL_ORCAMENTO_US; o que não coube fica pendente
+ *          para o próximo quadro. O envio ao display continua com a task_oled
+ *          (ssd1306_flush_async), que só transmite as janelas alteradas.
+ *          Usado somente pelo núcleo 0.
+ */
+
+#ifndef PAINEL_OLED_H
+#define PAINEL_OLED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "inc/ssd1306_i2c.h"
+#include "setores.h"
+#include "matriz_leds.h"
+
+#define PAINEL_ORCAMENTO_US 500    // Tempo máximo de desenho por quadro
+#define PAINEL_GRAFICO_AMOSTRAS 128 // Uma coluna do display por amostra
+#define PAINEL_TEXTO_MAX 16        // Caracteres de 8 px em uma linha do display
+
+// Estado de uma célula da grade (o mesmo resumo que a matriz de LEDs exibe)
+enum {
+    PAINEL_CELULA_VAZIA = VISOR_CELULA_VAZIA,
+    PAINEL_CELULA_CADASTRADA = VISOR_CELULA_CADASTRADA,
+    PAINEL_CELULA_AVISO = VISOR_CELULA_AVISO,
+    PAINEL_CELULA_ALARME = VISOR_CELULA_ALARME
+};
+
+/**
+ * @struct painel_oled_modelo_t
+ * @brief Valores exibidos, já na resolução da tela (temperaturas em décimos de °C).
+ */
+typedef struct {
+    uint8_t grade[MATRIZ_LEDS_LARGURA][MATRIZ_LEDS_ALTURA]; // PAINEL_CELULA_* por (x, y) da matriz de LEDs
+    setor_id_t setor_quente;        // Índice do setor cadastrado mais quente (SETOR_INVALIDO = nenhum)
+    int16_t quente_dc;              // Temperatura do setor mais quente
+    uint16_t em_alarme;             // Setores em alarme
+    uint16_t em_aviso;              // Setores em aviso
+    int16_t ambiente_dc;            // Última leitura do sensor onboard
+    char rede[PAINEL_TEXTO_MAX + 1]; // Endereço IP ou estado do link
+} painel_oled_modelo_t;
+
+/**
+ * @struct painel_oled_stats_t
+ * @brief Contadores de desenho do painel.
+ */
+typedef struct {
+    uint32_t quadros;         // Quadros com ao menos um elemento alterado
+    uint32_t elementos;       // Elementos redesenhados
+    uint32_t adiados;         // Quadros que esgotaram o orçamento (restante no próximo)
+    uint32_t ultimo_us;       // Duração do último quadro com alterações
+    uint32_t pior_us;         // Pior duração observada
+} painel_oled_stats_t;
+
+void painel_oled_iniciar(ssd1306_t *display);   // Apaga a tela e desenha as partes fixas
+void painel_oled_amostrar(float celsius);       // Acrescenta uma amostra ao gráfico
+void painel_oled_atualizar(const painel_oled_modelo_t *modelo); // Desenha o que mudou
+void painel_oled_print_stats(void);
+
+#endif
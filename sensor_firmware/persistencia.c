@@ -0,0 +1,589 @@
+/**
+ * @file persistencia.c
+ * @brief Log com CRC nos últimos setores da flash: replay no boot, gravação em páginas e rodízio de blocos.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "hal.h"
+#include "historico.h"
+#include "persistencia.h"
+#include "log.h"
+
+#define PERSISTENCIA_BYTES (PERSISTENCIA_BLOCOS * HAL_FLASH_SETOR)
+#define PERSISTENCIA_MAGICA 0x474C4741u // "AGLG" (little-endian)
+#define PERSISTENCIA_APAGADO 0xFFFFu    // Tipo lido na flash apagada: fim dos registros do bloco
+#define PERSISTENCIA_ALINHAMENTO 4      // Registros começam em múltiplos de 4 bytes
+#define PERSISTENCIA_GRADE ((uint32_t)SETORES_COLUNAS << 16 | SETORES_LINHAS) // Logs de outra grade são ignorados
+#define PERSISTENCIA_SLOTS (HISTORICO_1MIN_AMOSTRAS > HISTORICO_15MIN_AMOSTRAS ? \
+                            HISTORICO_1MIN_AMOSTRAS : HISTORICO_15MIN_AMOSTRAS)
+#define PERSISTENCIA_FATIAS SETORES_PALAVRAS // Fatias de PERSISTENCIA_FATIA setores (a última pode ser menor)
+
+_Static_assert(PERSISTENCIA_BLOCOS >= 2 && PERSISTENCIA_BLOCOS <= 127, "PERSISTENCIA_BLOCOS fora da faixa");
+_Static_assert(PERSISTENCIA_FATIA == 32, "uma fatia e uma palavra de setores_bits_t");
+
+// Tipos de registro (1 a 3: formato anterior às fatias; 6: nomes, não gravados mais; ignorados no boot)
+enum {
+    REG_CADASTRO = 4,     // Cadastro de todos os setores (setores_bits_t)
+    REG_TEMPERATURAS = 5, // Temperaturas de uma fatia
+    REG_HISTORICO = 7     // Uma fatia de um agregado do histórico
+};
+
+/**
+ * @struct persistencia_bloco_t
+ * @brief Cabeçalho gravado logo após apagar um bloco.
+ */
+typedef struct {
+    uint32_t magica;      // PERSISTENCIA_MAGICA
+    uint32_t sequencia;   // Ordem dos blocos no log (maior = mais recente)
+    uint32_t apagamentos; // Vezes que o bloco foi apagado (desgaste)
+    uint32_t grade;       // PERSISTENCIA_GRADE do firmware que gravou o bloco
+    uint32_t crc;         // CRC-32 dos campos acima
+} persistencia_bloco_t;
+
+/**
+ * @struct persistencia_registro_t
+ * @brief Cabeçalho de um registro; os dados vêm em seguida.
+ */
+typedef struct {
+    uint16_t tipo;        // REG_*
+    uint16_t tamanho;     // Bytes de dados
+    uint32_t crc;         // CRC-32 de tipo, tamanho e dados
+} persistencia_registro_t;
+
+// Registros de uma fatia: na última, só os setores que existem são gravados
+typedef struct {
+    uint16_t fatia;                          // Setores [fatia * PERSISTENCIA_FATIA, ...)
+    uint16_t reservado;
+    int16_t centesimos[PERSISTENCIA_FATIA];  // Temperaturas em centésimos de °C
+} reg_temperaturas_t;
+
+typedef struct {
+    uint8_t camada;                          // HISTORICO_1MIN ou HISTORICO_15MIN
+    uint8_t reservado;
+    uint16_t fatia;
+    uint32_t k;                              // Índice da entrada na camada (continua entre boots)
+    historico_ponto_t pontos[PERSISTENCIA_FATIA];
+} reg_historico_t;
+
+_Static_assert(sizeof(persistencia_bloco_t) + 3 * sizeof(persistencia_registro_t) + sizeof(setores_bits_t) +
+               sizeof(reg_temperaturas_t) + sizeof(reg_historico_t) <= HAL_FLASH_SETOR,
+               "registros de uma fatia nao cabem em um bloco");
+
+static const uint8_t *flash;            // Região mapeada (NULL = persistência desativada)
+static uint32_t crc_tabela[256];
+static persistencia_stats_t stats;
+
+// Posição de escrita
+static int8_t cabeca = -1;              // Bloco em escrita (-1 = log vazio)
+static uint32_t ultima_sequencia;
+static uint32_t posicao;                // Próximo byte livre na região
+static uint8_t pagina[HAL_FLASH_PAGINA]; // Cópia da página de `posicao`, com os registros pendentes
+static uint32_t pagina_offset;
+static bool pagina_suja;
+static uint64_t suja_desde_us;          // Instante do primeiro registro pendente na página
+static uint64_t agora_us;               // Instante da execução atual de persistencia_processar
+static bool adiar_apagamento;           // Transição de alarme pendente: reservar não abre bloco novo
+static bool adiado;                     // Esta execução deixou registros para depois
+static uint64_t transicao_desde_us;     // Início da transição de alarme pendente (limita o adiamento)
+
+// O que está gravado e em qual bloco (-1 = em nenhum), por fatia: decide o que
+// gravar a cada execução e o que regravar ao apagar um bloco
+static setores_bits_t cadastrados_gravados;
+static int8_t bloco_cadastro;
+static int16_t centesimos_gravados[MAX_SETORES];
+static int8_t bloco_temperaturas[PERSISTENCIA_FATIAS];
+static uint64_t setores_gravados_us;
+static uint32_t slot_k[2][PERSISTENCIA_SLOTS][PERSISTENCIA_FATIAS]; // Entrada gravada em cada slot do anel (1 e 15 min)
+static int8_t slot_bloco[2][PERSISTENCIA_SLOTS][PERSISTENCIA_FATIAS];
+static uint32_t proximo_k[2];           // Próxima entrada de cada camada a gravar
+
+// Cadastro e temperaturas lidos no boot (entregues ao núcleo 1)
+static setores_bits_t cadastrados_boot;
+static int16_t centesimos_boot[MAX_SETORES];
+static bool setores_boot_validos;
+
+// ===== CRC-32 (IEEE 802.3, refletido) =====
+
+static void crc_iniciar(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; b++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_tabela[i] = c;
+    }
+}
+
+static uint32_t crc_atualizar(uint32_t crc, const void *dados, size_t n) {
+    const uint8_t *p = (const uint8_t *)dados;
+    while (n--) crc = crc_tabela[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static uint32_t crc_bloco(const persistencia_bloco_t *b) {
+    return ~crc_atualizar(~0u, b, offsetof(persistencia_bloco_t, crc));
+}
+
+static uint32_t crc_registro(const persistencia_registro_t *r, const void *dados) {
+    uint32_t crc = crc_atualizar(~0u, r, offsetof(persistencia_registro_t, crc));
+    return ~crc_atualizar(crc, dados, r->tamanho);
+}
+
+static bool bloco_valido(const persistencia_bloco_t *b) {
+    return b->magica == PERSISTENCIA_MAGICA && b->grade == PERSISTENCIA_GRADE && b->crc == crc_bloco(b);
+}
+
+static uint32_t alinhar(uint32_t n) {
+    return (n + PERSISTENCIA_ALINHAMENTO - 1) & ~(uint32_t)(PERSISTENCIA_ALINHAMENTO - 1);
+}
+
+static uint32_t capacidade_camada(uint8_t camada) {
+    return camada == HISTORICO_1MIN ? HISTORICO_1MIN_AMOSTRAS : HISTORICO_15MIN_AMOSTRAS;
+}
+
+// Primeiro setor e quantidade de setores de uma fatia
+static setor_id_t fatia_inicio(uint16_t fatia) {
+    return (setor_id_t)(fatia * PERSISTENCIA_FATIA);
+}
+
+static setor_id_t fatia_setores(uint16_t fatia) {
+    setor_id_t resto = (setor_id_t)(MAX_SETORES - fatia_inicio(fatia));
+    return resto < PERSISTENCIA_FATIA ? resto : PERSISTENCIA_FATIA;
+}
+
+// ===== ESCRITA =====
+
+// Programa a página em buffer, se houver registros pendentes nela
+static void gravar_pagina(void) {
+    if (!pagina_suja) return;
+    if (!hal_flash_programar(pagina_offset, pagina)) stats.falhas++;
+    stats.paginas++;
+    pagina_suja = false;
+}
+
+// Copia bytes para o buffer da página, programando cada página que enche
+static void escrever(const void *dados, uint32_t n) {
+    const uint8_t *p = (const uint8_t *)dados;
+    while (n) {
+        uint32_t base = posicao & ~(uint32_t)(HAL_FLASH_PAGINA - 1);
+        if (base != pagina_offset) {
+            gravar_pagina();
+            pagina_offset = base;
+            memcpy(pagina, flash + base, HAL_FLASH_PAGINA);
+        }
+        uint32_t i = posicao - base;
+        uint32_t m = HAL_FLASH_PAGINA - i < n ? HAL_FLASH_PAGINA - i : n;
+        memcpy(pagina + i, p, m);
+        if (!pagina_suja) {
+            pagina_suja = true;
+            suja_desde_us = agora_us;
+        }
+        posicao += m;
+        p += m;
+        n -= m;
+        if (i + m == HAL_FLASH_PAGINA) gravar_pagina();
+    }
+}
+
+static bool reservar(uint16_t tamanho);
+static void anexar(uint16_t tipo, const void *dados, uint16_t tamanho);
+
+static bool gravar_historico(uint8_t camada, uint32_t k, uint16_t fatia) {
+    static reg_historico_t r; // Estático: fora da pilha do núcleo 0
+    uint16_t tamanho = (uint16_t)(offsetof(reg_historico_t, pontos) + fatia_setores(fatia) * sizeof(historico_ponto_t));
+    // Bloco novo antes de montar `r`: novo_bloco regrava agregados por este mesmo buffer
+    if (!reservar(tamanho)) return false;
+    memset(&r, 0, sizeof(r));
+    r.camada = camada;
+    r.fatia = fatia;
+    r.k = k;
+    for (setor_id_t j = 0; j < fatia_setores(fatia); j++) {
+        if (!historico_ler(camada, (setor_id_t)(fatia_inicio(fatia) + j), k, &r.pontos[j])) return false; // Já saiu do anel
+    }
+    anexar(REG_HISTORICO, &r, tamanho);
+    uint32_t slot = k % capacidade_camada(camada);
+    slot_k[camada - 1][slot][fatia] = k;
+    slot_bloco[camada - 1][slot][fatia] = cabeca;
+    return true;
+}
+
+// Grava o cadastro já em cadastrados_gravados: um registro só, mesmo em 13x13 (24 bytes)
+static void gravar_cadastro(void) {
+    anexar(REG_CADASTRO, &cadastrados_gravados, sizeof(cadastrados_gravados));
+    bloco_cadastro = cabeca;
+}
+
+static uint16_t tamanho_temperaturas(uint16_t fatia) {
+    return (uint16_t)(offsetof(reg_temperaturas_t, centesimos) + fatia_setores(fatia) * sizeof(int16_t));
+}
+
+// Grava as temperaturas da fatia já em centesimos_gravados
+static void gravar_temperaturas(uint16_t fatia) {
+    reg_temperaturas_t r;
+    memset(&r, 0, sizeof(r));
+    r.fatia = fatia;
+    memcpy(r.centesimos, &centesimos_gravados[fatia_inicio(fatia)], fatia_setores(fatia) * sizeof(int16_t));
+    anexar(REG_TEMPERATURAS, &r, tamanho_temperaturas(fatia));
+    bloco_temperaturas[fatia] = cabeca;
+}
+
+/**
+ * @brief Avança o log para o próximo bloco em rodízio, apagando-o.
+ * @details O que ainda vale no bloco (cadastro, fatias de temperaturas mais
+ *          recentes, agregados ainda no anel do histórico) é regravado a partir
+ *          da RAM logo em seguida. Cabe sempre no bloco novo, pois estava todo em um bloco.
+ *          O apagamento para o núcleo 1: a duração vai para stats.apagamento_max_us.
+ * @return bool `false` se a flash falhou (a persistência é desativada).
+ */
+static bool novo_bloco(void) {
+    gravar_pagina();
+    int8_t bloco = (int8_t)((cabeca + 1) % PERSISTENCIA_BLOCOS);
+    uint32_t offset = (uint32_t)bloco * HAL_FLASH_SETOR;
+
+    persistencia_bloco_t cabecalho;
+    memcpy(&cabecalho, flash + offset, sizeof(cabecalho));
+    uint32_t apagamentos = bloco_valido(&cabecalho) ? cabecalho.apagamentos + 1 : 1;
+
+    stats.apagamentos++;
+    uint64_t inicio = hal_tempo_us();
+    bool apagou = hal_flash_apagar(offset);
+    uint32_t pausa = (uint32_t)(hal_tempo_us() - inicio);
+    if (pausa > stats.apagamento_max_us) stats.apagamento_max_us = pausa;
+    if (!apagou) {
+        stats.falhas++;
+        flash = NULL;
+        LOG_ERRO("Persistencia desativada: falha ao apagar o bloco %d", bloco);
+        return false;
+    }
+
+    cabeca = bloco;
+    posicao = offset;
+    pagina_offset = offset;
+    memset(pagina, 0xFF, sizeof(pagina));
+    pagina_suja = false;
+    cabecalho = (persistencia_bloco_t){ PERSISTENCIA_MAGICA, ++ultima_sequencia, apagamentos,
+                                            PERSISTENCIA_GRADE, 0 };
+    cabecalho.crc = crc_bloco(&cabecalho);
+    escrever(&cabecalho, sizeof(cabecalho));
+
+    // gravar_* já apontam o registro para o bloco novo (`cabeca`)
+    if (bloco_cadastro == bloco) {
+        gravar_cadastro();
+        stats.regravados++;
+    }
+    for (uint16_t f = 0; f < PERSISTENCIA_FATIAS; f++) {
+        if (bloco_temperaturas[f] == bloco) {
+            gravar_temperaturas(f);
+            stats.regravados++;
+        }
+    }
+    for (uint8_t camada = HISTORICO_1MIN; camada <= HISTORICO_15MIN; camada++) {
+        for (uint32_t j = 0; j < capacidade_camada(camada); j++) {
+            for (uint16_t f = 0; f < PERSISTENCIA_FATIAS; f++) {
+                if (slot_bloco[camada - 1][j][f] != bloco) continue;
+                slot_bloco[camada - 1][j][f] = -1;
+                if (gravar_historico(camada, slot_k[camada - 1][j][f], f)) stats.regravados++;
+            }
+        }
+    }
+    return true;
+}
+
+// Abre blocos novos até caber um registro de `tamanho` bytes no atual;
+// com o apagamento adiado, só confere se cabe (`false` marca `adiado`)
+static bool reservar(uint16_t tamanho) {
+    uint32_t ocupado = alinhar(sizeof(persistencia_registro_t) + tamanho);
+    while (cabeca < 0 || posicao + ocupado > (uint32_t)(cabeca + 1) * HAL_FLASH_SETOR) {
+        if (adiar_apagamento) {
+            adiado = true;
+            return false;
+        }
+        if (!novo_bloco()) return false;
+    }
+    return true;
+}
+
+// Anexa um registro ao log, abrindo um bloco novo se não couber no atual
+static void anexar(uint16_t tipo, const void *dados, uint16_t tamanho) {
+    static const uint8_t enchimento[PERSISTENCIA_ALINHAMENTO - 1] = { 0xFF, 0xFF, 0xFF };
+    uint32_t ocupado = alinhar(sizeof(persistencia_registro_t) + tamanho);
+    if (!reservar(tamanho)) return;
+    persistencia_registro_t r = { tipo, tamanho, 0 };
+    r.crc = crc_registro(&r, dados);
+    escrever(&r, sizeof(r));
+    escrever(dados, tamanho);
+    escrever(enchimento, ocupado - sizeof(r) - tamanho);
+    stats.registros++;
+}
+
+// ===== REPLAY NO BOOT =====
+
+// Aplica um registro válido lido do bloco `bloco`; fatias fora da grade ou de tamanho errado são ignoradas
+static void aplicar(int8_t bloco, const persistencia_registro_t *r, const uint8_t *dados) {
+    if (r->tipo == REG_CADASTRO && r->tamanho == sizeof(setores_bits_t)) {
+        memcpy(&cadastrados_gravados, dados, sizeof(cadastrados_gravados));
+        if (MAX_SETORES % PERSISTENCIA_FATIA) { // Bits acima de MAX_SETORES
+            cadastrados_gravados.palavras[SETORES_PALAVRAS - 1] &= (1u << (MAX_SETORES % PERSISTENCIA_FATIA)) - 1;
+        }
+        bloco_cadastro = bloco;
+        return;
+    }
+    if (r->tamanho < sizeof(uint32_t)) return;
+    uint16_t fatia;
+    memcpy(&fatia, dados + (r->tipo == REG_HISTORICO ? offsetof(reg_historico_t, fatia) : 0), sizeof(fatia));
+    if (fatia >= PERSISTENCIA_FATIAS) return;
+    setor_id_t inicio = fatia_inicio(fatia), n = fatia_setores(fatia);
+
+    if (r->tipo == REG_TEMPERATURAS &&
+        r->tamanho == offsetof(reg_temperaturas_t, centesimos) + n * sizeof(int16_t)) {
+        memcpy(&centesimos_gravados[inicio], dados + offsetof(reg_temperaturas_t, centesimos), n * sizeof(int16_t));
+        bloco_temperaturas[fatia] = bloco;
+    } else if (r->tipo == REG_HISTORICO &&
+               r->tamanho == offsetof(reg_historico_t, pontos) + n * sizeof(historico_ponto_t)) {
+        static reg_historico_t h;
+        memcpy(&h, dados, r->tamanho);
+        if (h.camada != HISTORICO_1MIN && h.camada != HISTORICO_15MIN) return;
+        int c = h.camada - 1;
+        uint32_t slot = h.k % capacidade_camada(h.camada);
+        if (slot_bloco[c][slot][fatia] >= 0 && (int32_t)(slot_k[c][slot][fatia] - h.k) > 0) return; // Já há uma entrada mais nova
+        historico_restaurar_entrada(h.camada, h.k, inicio, n, h.pontos);
+        slot_k[c][slot][fatia] = h.k;
+        slot_bloco[c][slot][fatia] = bloco;
+        if (proximo_k[c] == 0 || (int32_t)(h.k + 1 - proximo_k[c]) > 0) proximo_k[c] = h.k + 1;
+    }
+}
+
+/**
+ * @brief Lê os registros de um bloco até o fim (flash apagada) ou até um registro inválido.
+ * @return uint32_t Posição após o último registro válido; o fim do bloco se
+ *         o restante não estiver apagado (escrita interrompida).
+ */
+static uint32_t ler_bloco(int8_t bloco) {
+    uint32_t p = (uint32_t)bloco * HAL_FLASH_SETOR + sizeof(persistencia_bloco_t);
+    uint32_t fim = (uint32_t)(bloco + 1) * HAL_FLASH_SETOR;
+    while (p + sizeof(persistencia_registro_t) <= fim) {
+        persistencia_registro_t r;
+        memcpy(&r, flash + p, sizeof(r));
+        if (r.tipo == PERSISTENCIA_APAGADO) break;
+        uint32_t ocupado = alinhar(sizeof(r) + r.tamanho);
+        if (p + ocupado > fim || crc_registro(&r, flash + p + sizeof(r)) != r.crc) {
+            stats.corrompidos++;
+            return fim;
+        }
+        aplicar(bloco, &r, flash + p + sizeof(r));
+        stats.restaurados++;
+        p += ocupado;
+    }
+    for (uint32_t i = p; i < fim; i++) {
+        if (flash[i] != 0xFF) return fim;
+    }
+    return p;
+}
+
+/**
+ * @brief Lê o log e restaura o histórico; guarda o cadastro para o núcleo 1.
+ * @details Chamada no boot, depois de historico_init e antes de lançar o núcleo 1.
+ * @return bool `false` se a região da flash não está disponível (persistência desativada).
+ */
+bool persistencia_iniciar(void) {
+    uint64_t inicio = hal_tempo_us();
+    memset(&stats, 0, sizeof(stats));
+    crc_iniciar();
+    cabeca = -1;
+    ultima_sequencia = 0;
+    memset(&cadastrados_gravados, 0, sizeof(cadastrados_gravados));
+    memset(centesimos_gravados, 0, sizeof(centesimos_gravados));
+    bloco_cadastro = -1;
+    memset(bloco_temperaturas, -1, sizeof(bloco_temperaturas));
+    memset(slot_bloco, -1, sizeof(slot_bloco));
+    memset(proximo_k, 0, sizeof(proximo_k));
+    pagina_suja = false;
+    adiar_apagamento = false;
+
+    flash = hal_flash_regiao(PERSISTENCIA_BYTES);
+    if (!flash) {
+        printf("Persistencia desativada: regiao da flash indisponivel\n");
+        return false;
+    }
+
+    // Blocos válidos em ordem de sequência (inserção: no máximo PERSISTENCIA_BLOCOS)
+    int8_t ordem[PERSISTENCIA_BLOCOS];
+    uint32_t sequencia[PERSISTENCIA_BLOCOS];
+    int n = 0;
+    for (int8_t b = 0; b < PERSISTENCIA_BLOCOS; b++) {
+        persistencia_bloco_t cabecalho;
+        memcpy(&cabecalho, flash + (uint32_t)b * HAL_FLASH_SETOR, sizeof(cabecalho));
+        if (!bloco_valido(&cabecalho)) continue;
+        int j = n++;
+        while (j > 0 && sequencia[j - 1] > cabecalho.sequencia) {
+            ordem[j] = ordem[j - 1];
+            sequencia[j] = sequencia[j - 1];
+            j--;
+        }
+        ordem[j] = b;
+        sequencia[j] = cabecalho.sequencia;
+    }
+    for (int i = 0; i < n; i++) {
+        posicao = ler_bloco(ordem[i]);
+        cabeca = ordem[i];
+        ultima_sequencia = sequencia[i];
+    }
+    if (cabeca >= 0) {
+        pagina_offset = posicao & ~(uint32_t)(HAL_FLASH_PAGINA - 1);
+        memcpy(pagina, flash + pagina_offset, HAL_FLASH_PAGINA);
+    }
+
+    // Camadas do histórico: fatias de slots sem a entrada esperada ficam sem dado
+    static historico_ponto_t vazio[PERSISTENCIA_FATIA];
+    for (int i = 0; i < PERSISTENCIA_FATIA; i++) {
+        vazio[i] = (historico_ponto_t){ HISTORICO_SEM_DADO, HISTORICO_SEM_DADO, HISTORICO_SEM_DADO };
+    }
+    for (uint8_t camada = HISTORICO_1MIN; camada <= HISTORICO_15MIN; camada++) {
+        uint32_t total = proximo_k[camada - 1];
+        if (total == 0) continue;
+        historico_restaurar(camada, total);
+        uint32_t cap = capacidade_camada(camada);
+        for (uint32_t j = 1; j < cap && j <= total; j++) {
+            uint32_t k = total - j;
+            uint32_t slot = k % cap;
+            for (uint16_t f = 0; f < PERSISTENCIA_FATIAS; f++) {
+                if (slot_bloco[camada - 1][slot][f] < 0 || slot_k[camada - 1][slot][f] != k) {
+                    historico_restaurar_entrada(camada, k, fatia_inicio(f), fatia_setores(f), vazio);
+                }
+            }
+        }
+    }
+
+    cadastrados_boot = cadastrados_gravados;
+    memcpy(centesimos_boot, centesimos_gravados, sizeof(centesimos_boot));
+    setores_boot_validos = bloco_cadastro >= 0;
+    stats.replay_us = (uint32_t)(hal_tempo_us() - inicio);
+    return true;
+}
+
+/**
+ * @brief Cadastro e temperaturas lidos no boot (núcleo 1, após clearSystem).
+ * @return bool `false` se o log não tinha cadastro gravado.
+ */
+bool persistencia_setores_restaurados(setores_modelo_t *modelo) {
+    if (!setores_boot_validos) return false;
+    SETORES_BITS_PARA_CADA(&cadastrados_boot, i) {
+        setores_modelo_temperatura(modelo, i, centesimos_boot[i] / 100.0f);
+        setores_modelo_cadastro(modelo, i, true);
+    }
+    return true;
+}
+
+// ===== NÚCLEO 0: GRAVAÇÃO DAS MUDANÇAS =====
+
+static int16_t centesimos(float celsius) {
+    float c = celsius * 100.0f;
+    c += c >= 0.0f ? 0.5f : -0.5f;
+    if (c > 32767.0f) return 32767;
+    if (c < -32768.0f) return -32768;
+    return (int16_t)c;
+}
+
+/**
+ * @brief Anexa ao log o que mudou e programa a página pendente há mais de PERSISTENCIA_ATRASO_MS.
+ * @details Chamada periodicamente pelo núcleo 0 com o snapshot mais recente.
+ *          Cada fatia de temperaturas é comparada com a última gravada e só as
+ *          diferentes vão ao log. Um cadastro novo vai depois das temperaturas
+ *          das fatias que mudou: como uma queda corta só o fim do log, o boot
+ *          vê o cadastro antigo ou o novo inteiro, nunca uma mistura.
+ *
+ *          Com uma transição de alarme pendente no snapshot (há menos de
+ *          PERSISTENCIA_ADIAMENTO_MAX_S), nenhum bloco é apagado: a execução
+ *          para no primeiro registro que não cabe no bloco atual, sem marcá-lo
+ *          como gravado, e a seguinte recomeça dali.
+ */
+void persistencia_processar(const setores_snapshot_t *estado, uint64_t agora) {
+    if (!flash) return;
+    agora_us = agora;
+    if (!estado->transicao_pendente) transicao_desde_us = agora_us;
+    adiar_apagamento = estado->transicao_pendente &&
+                       agora_us - transicao_desde_us < (uint64_t)PERSISTENCIA_ADIAMENTO_MAX_S * 1000000u;
+    adiado = false;
+
+    // Temperaturas no checkpoint, ou as de uma fatia cujo cadastro mudou; o cadastro, assim que muda
+    bool checkpoint = agora_us - setores_gravados_us >= (uint64_t)PERSISTENCIA_CHECKPOINT_S * 1000000u;
+    bool cadastro_mudou = bloco_cadastro < 0 ||
+                          memcmp(&estado->modelo.cadastrados, &cadastrados_gravados, sizeof(cadastrados_gravados)) != 0;
+    bool gravou = false;
+    for (uint16_t f = 0; f < PERSISTENCIA_FATIAS && flash && !adiado; f++) {
+        setor_id_t inicio = fatia_inicio(f);
+        bool temperaturas_mudaram = false;
+        for (setor_id_t j = 0; j < fatia_setores(f); j++) {
+            temperaturas_mudaram |= centesimos(estado->modelo.temperaturas[inicio + j]) != centesimos_gravados[inicio + j];
+        }
+        if (temperaturas_mudaram &&
+            (checkpoint || estado->modelo.cadastrados.palavras[f] != cadastrados_gravados.palavras[f]) &&
+            reservar(tamanho_temperaturas(f))) {
+            for (setor_id_t j = 0; j < fatia_setores(f); j++) {
+                centesimos_gravados[inicio + j] = centesimos(estado->modelo.temperaturas[inicio + j]);
+            }
+            gravar_temperaturas(f);
+            gravou = true;
+        }
+    }
+    if (gravou && checkpoint && !adiado) setores_gravados_us = agora_us;
+    if (cadastro_mudou && flash && !adiado && reservar(sizeof(setores_bits_t))) {
+        cadastrados_gravados = estado->modelo.cadastrados;
+        gravar_cadastro();
+    }
+
+    for (uint8_t camada = HISTORICO_1MIN; camada <= HISTORICO_15MIN && flash && !adiado; camada++) {
+        uint32_t inicio, fim;
+        historico_intervalo(camada, &inicio, &fim);
+        uint32_t *k = &proximo_k[camada - 1];
+        if ((int32_t)(inicio - *k) > 0) *k = inicio; // Entradas que saíram do anel sem serem gravadas
+        while (*k != fim && flash) {
+            uint32_t slot = *k % capacidade_camada(camada);
+            for (uint16_t f = 0; f < PERSISTENCIA_FATIAS && flash && !adiado; f++) {
+                // Fatias já gravadas antes de um adiamento não se repetem
+                if (slot_bloco[camada - 1][slot][f] >= 0 && slot_k[camada - 1][slot][f] == *k) continue;
+                gravar_historico(camada, *k, f);
+            }
+            if (adiado) break;
+            (*k)++;
+        }
+    }
+    if (adiado) stats.adiamentos++;
+
+    if (flash && pagina_suja && agora_us - suja_desde_us >= (uint64_t)PERSISTENCIA_ATRASO_MS * 1000u) {
+        gravar_pagina();
+    }
+}
+
+void persistencia_ler_stats(persistencia_stats_t *s) {
+    *s = stats;
+}
+
+/**
+ * @brief Imprime o estado do log, o desgaste dos blocos e os contadores.
+ */
+void persistencia_print_stats(void) {
+    if (!flash) {
+        printf("Persistencia desativada\n");
+        return;
+    }
+    uint32_t min = UINT32_MAX, max = 0;
+    for (int b = 0; b < PERSISTENCIA_BLOCOS; b++) {
+        persistencia_bloco_t cabecalho;
+        memcpy(&cabecalho, flash + (uint32_t)b * HAL_FLASH_SETOR, sizeof(cabecalho));
+        uint32_t a = bloco_valido(&cabecalho) ? cabecalho.apagamentos : 0;
+        if (a < min) min = a;
+        if (a > max) max = a;
+    }
+    printf("Log: %d blocos de %d bytes, bloco atual %d (sequencia %lu, %lu bytes livres)\n",
+           PERSISTENCIA_BLOCOS, HAL_FLASH_SETOR, cabeca, (unsigned long)ultima_sequencia,
+           cabeca < 0 ? 0ul : (unsigned long)((uint32_t)(cabeca + 1) * HAL_FLASH_SETOR - posicao));
+    printf("Desgaste: %lu a %lu apagamentos por bloco\n", (unsigned long)min, (unsigned long)max);
+    printf("Boot: %lu registros restaurados em %lu us, %lu blocos com registro interrompido\n",
+           (unsigned long)stats.restaurados, (unsigned long)stats.replay_us, (unsigned long)stats.corrompidos);
+    printf("Desde o boot: registros %lu, regravados %lu, paginas %lu, apagamentos %lu, falhas %lu\n",
+           (unsigned long)stats.registros, (unsigned long)stats.regravados, (unsigned long)stats.paginas,
+           (unsigned long)stats.apagamentos, (unsigned long)stats.falhas);
+    printf("Apagamentos: maior pausa %lu us; %lu execucoes adiadas por transicao de alarme\n",
+           (unsigned long)stats.apagamento_max_us, (unsigned long)stats.adiamentos);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file persistencia.h
+ * @brief Persistência do cadastro, das temperaturas e do histórico na flash.
+ * @details Log estruturado nos últimos PERSISTENCIA_BLOCOS setores de 4 KB da
+ *          flash. Cada setor (bloco) começa com um cabeçalho numerado em
+ *          sequência; os registros são anexados em ordem, cada um com CRC-32.
+ *          O boot percorre os blocos em ordem de sequência uma única vez e
+ *          restaura o último cadastro/temperaturas e os agregados de 1 e 15
+ *          minutos do histórico, antes de lançar o núcleo 1. Os nomes dos
+ *          setores não são gravados: só mudam no boot (nomes padrão).
+ *
+ *          Fatias: temperaturas e agregados vão em registros de
+ *          PERSISTENCIA_FATIA setores consecutivos (uma palavra de setores_bits_t),
+ *          de modo que o tamanho de um registro não depende da grade. Só as fatias
+ *          que mudaram são gravadas. O cadastro (um bit por setor, 24 bytes em 13x13) vai
+ *          inteiro em um registro, depois das temperaturas que mudou: uma queda
+ *          no meio da gravação restaura o cadastro anterior ou o novo, nunca uma
+ *          mistura; as temperaturas das fatias já gravadas podem ser as novas.
+ *
+ *          Escrita (somente núcleo 0, por persistencia_processar):
+ *          - os registros vão para um buffer do tamanho da página da flash e a
+ *            página é programada quando enche ou PERSISTENCIA_ATRASO_MS depois
+ *            do primeiro registro pendente (várias gravações, uma programação);
+ *          - um bloco só é apagado quando o log avança para ele, sempre o
+ *            seguinte em rodízio (o mais antigo): todos os blocos se desgastam
+ *            por igual. Antes, o que ainda vale nele (último cadastro e
+ *            temperaturas, agregados ainda no anel do histórico) é regravado a
+ *            partir da RAM;
+ *          - o cadastro é gravado assim que muda; temperaturas, no máximo a cada
+ *            PERSISTENCIA_CHECKPOINT_S; cada agregado do histórico, quando fecha.
+ *
+ *          Um registro interrompido por falta de energia falha no CRC e é
+ *          descartado, junto com o restante do bloco; a escrita recomeça em um
+ *          bloco novo.
+ *
+ *          Pausa do núcleo 1: apagar um bloco para os dois núcleos (45 ms
+ *          típicos, até 400 ms na W25Q16JV), uma vez a cada ~4 KB gravados.
+ *          Enquanto o snapshot indica uma transição de alarme pendente, o log
+ *          só grava o que cabe no bloco atual e deixa o resto para depois,
+ *          por até PERSISTENCIA_ADIAMENTO_MAX_S. A maior pausa medida fica em
+ *          persistencia_stats_t.
+ */
+
+#ifndef PERSISTENCIA_H
+#define PERSISTENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "setores.h"
+#include "historico.h"
+
+#define PERSISTENCIA_FATIA 32           // Setores por registro (uma palavra de setores_bits_t)
+
+// Pior caso do que o log mantém vivo: cadastro e temperaturas de todas as fatias
+// e os agregados ainda no anel (8 bytes de cabeçalho e 4 a 8 de campos por registro)
+#define PERSISTENCIA_VIVOS_BYTES                                                                   \
+    (8 + SETORES_PALAVRAS * (4 + 12) + MAX_SETORES * 2 +                                           \
+     (HISTORICO_1MIN_AMOSTRAS + HISTORICO_15MIN_AMOSTRAS - 2) *                                    \
+         (SETORES_PALAVRAS * 16 + MAX_SETORES * 6))
+// Setores de 4 KB no fim da flash: metade do log fica livre para registros
+// novos entre dois apagamentos do mesmo bloco (64 KB até 30 setores, 164 KB em 13x13)
+#define PERSISTENCIA_BLOCOS_VIVOS (2 * PERSISTENCIA_VIVOS_BYTES / 4096 + 2)
+#define PERSISTENCIA_BLOCOS (PERSISTENCIA_BLOCOS_VIVOS > 16 ? PERSISTENCIA_BLOCOS_VIVOS : 16)
+#define PERSISTENCIA_ATRASO_MS 2000     // Tempo máximo de um registro no buffer da página
+#define PERSISTENCIA_CHECKPOINT_S 60    // Intervalo mínimo entre gravações só de temperaturas
+#define PERSISTENCIA_ADIAMENTO_MAX_S 60 // Maior adiamento de um apagamento por transição de alarme pendente
+
+/**
+ * @struct persistencia_stats_t
+ * @brief Contadores do log na flash.
+ */
+typedef struct {
+    uint32_t replay_us;           // Duração da leitura do log no boot
+    uint32_t restaurados;         // Registros válidos lidos no boot
+    uint32_t corrompidos;         // Blocos com registro inválido (interrompido) no boot
+    uint32_t registros;           // Registros gravados desde o boot
+    uint32_t regravados;          // Registros copiados de um bloco antes de apagá-lo
+    uint32_t paginas;             // Programações de página
+    uint32_t apagamentos;         // Blocos apagados desde o boot
+    uint32_t apagamento_max_us;   // Maior pausa de um apagamento (núcleo 1 parado)
+    uint32_t adiamentos;          // Execuções que deixaram registros para depois de uma transição de alarme
+    uint32_t falhas;              // Operações de flash que falharam
+} persistencia_stats_t;
+
+// Boot (núcleo 0, antes de lançar o núcleo 1 e depois de historico_init)
+bool persistencia_iniciar(void);
+bool persistencia_setores_restaurados(setores_modelo_t *modelo);
+
+// Núcleo 0, periodicamente: grava as mudanças do estado e do histórico
+void persistencia_processar(const setores_snapshot_t *estado, uint64_t agora_us);
+void persistencia_print_stats(void);
+void persistencia_ler_stats(persistencia_stats_t *s);
+
+#endif
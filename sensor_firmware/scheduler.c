@@ -0,0 +1,139 @@
+/**
+ * @file scheduler.c
+ * @brief Implementação do escalonador cooperativo do AgroGraf.
+ */
+
+#include <stdio.h>
+#include "hal.h"
+#include "scheduler.h"
+
+/**
+ * @brief Inicializa o escalonador com uma tabela de tarefas.
+ * @param sched Escalonador a ser inicializado.
+ * @param tarefas Tabela de tarefas (deve permanecer válida durante a execução).
+ * @param num_tarefas Número de entradas na tabela.
+ * @details Todas as tarefas são liberadas imediatamente no primeiro tick.
+ */
+void scheduler_init(scheduler_t *sched, scheduler_task_t *tarefas, size_t num_tarefas) {
+    sched->tarefas = tarefas;
+    sched->num_tarefas = num_tarefas;
+    sched->executando = false;
+    uint64_t agora = hal_tempo_us();
+    for (size_t i = 0; i < num_tarefas; i++) {
+        tarefas[i].proxima_execucao_us = agora;
+    }
+    scheduler_reset_stats(sched);
+}
+
+/**
+ * @brief Executa uma passada sobre a tabela, rodando as tarefas vencidas.
+ * @param sched Escalonador.
+ * @return bool `true` se ao menos uma tarefa foi executada.
+ * @details Mede a duração de cada execução e o atraso de liberação. Se uma
+ *          tarefa perdeu mais de um período (por exemplo, após uma tarefa lenta),
+ *          o próximo prazo é realinhado ao instante atual em vez de disparar
+ *          várias execuções em rajada.
+ */
+bool scheduler_tick(scheduler_t *sched) {
+    bool executou = false;
+    for (size_t i = 0; i < sched->num_tarefas; i++) {
+        scheduler_task_t *t = &sched->tarefas[i];
+        if (!t->habilitada) continue;
+
+        uint64_t inicio = hal_tempo_us();
+        if (inicio < t->proxima_execucao_us) continue; // Ainda não venceu
+
+        uint32_t atraso = (uint32_t)(inicio - t->proxima_execucao_us);
+        if (atraso > t->pior_atraso_us) t->pior_atraso_us = atraso;
+
+        t->funcao(t->ctx);
+
+        uint32_t duracao = (uint32_t)(hal_tempo_us() - inicio);
+        t->ultima_duracao_us = duracao;
+        if (duracao > t->pior_duracao_us) t->pior_duracao_us = duracao;
+        t->execucoes++;
+
+        // Agenda a próxima liberação mantendo a fase, salvo se ficou para trás
+        t->proxima_execucao_us += t->periodo_us;
+        if (t->proxima_execucao_us <= inicio) {
+            t->proxima_execucao_us = inicio + t->periodo_us;
+        }
+        executou = true;
+    }
+    return executou;
+}
+
+/**
+ * @brief Laço principal do escalonador; retorna apenas após scheduler_stop().
+ * @details Entre ticks, o núcleo aguarda (WFE) até o próximo prazo ou até
+ *          um evento/interrupção, evitando consumo desnecessário.
+ */
+void scheduler_run(scheduler_t *sched) {
+    sched->executando = true;
+    while (sched->executando) {
+        if (scheduler_tick(sched) || !sched->executando) continue;
+
+        // Calcula o prazo mais próximo entre as tarefas habilitadas
+        uint64_t proximo = UINT64_MAX;
+        for (size_t i = 0; i < sched->num_tarefas; i++) {
+            const scheduler_task_t *t = &sched->tarefas[i];
+            if (t->habilitada && t->proxima_execucao_us < proximo) {
+                proximo = t->proxima_execucao_us;
+            }
+        }
+        if (proximo != UINT64_MAX && proximo > hal_tempo_us()) {
+            hal_aguardar_ate_us(proximo);
+        }
+    }
+}
+
+/**
+ * @brief Solicita o término de scheduler_run() (pode ser chamado de uma tarefa).
+ */
+void scheduler_stop(scheduler_t *sched) {
+    sched->executando = false;
+}
+
+/**
+ * @brief Habilita ou desabilita uma tarefa.
+ * @details Ao ser habilitada, a tarefa é liberada imediatamente no próximo tick.
+ */
+void scheduler_set_enabled(scheduler_t *sched, scheduler_task_t *tarefa, bool habilitada) {
+    (void)sched;
+    if (habilitada && !tarefa->habilitada) {
+        tarefa->proxima_execucao_us = hal_tempo_us();
+    }
+    tarefa->habilitada = habilitada;
+}
+
+/**
+ * @brief Zera as estatísticas de todas as tarefas.
+ */
+void scheduler_reset_stats(scheduler_t *sched) {
+    for (size_t i = 0; i < sched->num_tarefas; i++) {
+        scheduler_task_t *t = &sched->tarefas[i];
+        t->execucoes = 0;
+        t->ultima_duracao_us = 0;
+        t->pior_duracao_us = 0;
+        t->pior_atraso_us = 0;
+    }
+}
+
+/**
+ * @brief Imprime no terminal serial uma tabela com as estatísticas das tarefas.
+ */
+void scheduler_print_stats(const scheduler_t *sched) {
+    printf("%-10s %9s %10s %9s %9s %10s\n",
+           "Tarefa", "Periodo", "Execucoes", "Ultima", "Pior", "Atraso max");
+    for (size_t i = 0; i < sched->num_tarefas; i++) {
+        const scheduler_task_t *t = &sched->tarefas[i];
+        printf("%-10s %7luus %10lu %7luus %7luus %8luus%s\n",
+               t->nome,
+               (unsigned long)t->periodo_us,
+               (unsigned long)t->execucoes,
+               (unsigned long)t->ultima_duracao_us,
+               (unsigned long)t->pior_duracao_us,
+               (unsigned long)t->pior_atraso_us,
+               t->habilitada ? "" : " (desabilitada)");
+    }
+}
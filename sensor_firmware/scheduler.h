@@ -0,0 +1,71 @@
+/**
+ * @file scheduler.h
+ * @brief Escalonador cooperativo baseado em ticks para o AgroGraf.
+ * @details Cada tarefa possui um período próprio e é executada até o fim
+ *          (run-to-completion) quando seu prazo vence. O escalonador mede a
+ *          duração de cada execução e guarda o pior caso observado (WCET),
+ *          permitindo verificar que a latência do alarme permanece limitada.
+ *          Nenhuma tarefa pode bloquear: entradas do usuário, pausas e esperas
+ *          devem ser implementadas como máquinas de estado.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Assinatura da função executada por uma tarefa.
+ * @param ctx Ponteiro de contexto registrado junto com a tarefa.
+ */
+typedef void (*scheduler_task_fn_t)(void *ctx);
+
+/**
+ * @struct scheduler_task_t
+ * @brief Descreve uma tarefa periódica e suas estatísticas de execução.
+ */
+typedef struct {
+    const char *nome;               // Nome exibido nas estatísticas
+    scheduler_task_fn_t funcao;     // Função da tarefa
+    void *ctx;                      // Contexto repassado à função
+    uint32_t periodo_us;            // Período de ativação em microssegundos
+    bool habilitada;                // Tarefas desabilitadas não são executadas
+
+    // Estado interno e estatísticas (preenchidos pelo escalonador)
+    uint64_t proxima_execucao_us;   // Instante da próxima liberação
+    uint32_t execucoes;             // Número de execuções
+    uint32_t ultima_duracao_us;     // Duração da última execução
+    uint32_t pior_duracao_us;       // Pior duração observada (WCET medido)
+    uint32_t pior_atraso_us;        // Maior atraso entre a liberação e o início
+} scheduler_task_t;
+
+/**
+ * @brief Inicializador estático de uma tarefa.
+ */
+#define SCHEDULER_TASK(nome_, funcao_, ctx_, periodo_ms_, habilitada_) \
+    { .nome = (nome_), .funcao = (funcao_), .ctx = (ctx_),               \
+      .periodo_us = (uint32_t)(periodo_ms_) * 1000u, .habilitada = (habilitada_) }
+
+/**
+ * @struct scheduler_t
+ * @brief Conjunto de tarefas gerenciado pelo escalonador.
+ * @details A ordem da tabela define a prioridade: quando várias tarefas vencem
+ *          no mesmo tick, as primeiras da tabela executam antes.
+ */
+typedef struct {
+    scheduler_task_t *tarefas;
+    size_t num_tarefas;
+    volatile bool executando;
+} scheduler_t;
+
+void scheduler_init(scheduler_t *sched, scheduler_task_t *tarefas, size_t num_tarefas);
+bool scheduler_tick(scheduler_t *sched);
+void scheduler_run(scheduler_t *sched);
+void scheduler_stop(scheduler_t *sched);
+void scheduler_set_enabled(scheduler_t *sched, scheduler_task_t *tarefa, bool habilitada);
+void scheduler_reset_stats(scheduler_t *sched);
+void scheduler_print_stats(const scheduler_t *sched);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file sensores_adc.c
+ * @brief Sobreamostragem e média móvel por canal sobre o anel de amostras do ADC.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "sensores_adc.h"
+
+// Amostras que o DMA pode gravar enquanto o anel é consumido: o processamento
+// nunca lê as posições que estão para ser sobrescritas
+#define SENSORES_ADC_MARGEM 32
+#define SENSORES_ADC_FRACAO 8 // Bits fracionários da média móvel
+
+typedef struct {
+    uint8_t sobreamostragem_log2;
+    uint8_t suavizacao_log2;
+    uint16_t acumuladas;    // Amostras na soma atual
+    uint32_t soma;
+    uint32_t filtrado;      // Média móvel, 12 bits inteiros + SENSORES_ADC_FRACAO
+} sensores_adc_filtro_t;
+
+static sensores_adc_filtro_t filtros[SENSORES_ADC_CANAIS];
+static uint8_t ordem[SENSORES_ADC_CANAIS]; // Canais na ordem do rodízio (crescente)
+static uint8_t qtd_canais;
+static uint8_t posicao;                    // Posição em `ordem` da próxima amostra a consumir
+static uint32_t consumidas;                // Amostras do anel já consumidas (módulo 2^32)
+static sensores_adc_stats_t stats;
+static bool ativo = false;
+
+bool sensores_adc_iniciar(const sensores_adc_canal_cfg_t *canais, size_t quantidade,
+                          uint32_t amostras_por_segundo) {
+    uint32_t mascara = 0;
+    memset(filtros, 0, sizeof(filtros));
+    for (size_t i = 0; i < quantidade; i++) {
+        uint c = canais[i].canal;
+        if (c >= SENSORES_ADC_CANAIS || canais[i].sobreamostragem_log2 > 8) return false;
+        filtros[c].sobreamostragem_log2 = canais[i].sobreamostragem_log2;
+        filtros[c].suavizacao_log2 = canais[i].suavizacao_log2;
+        filtros[c].filtrado = (uint32_t)hal_adc_ler(c) << SENSORES_ADC_FRACAO; // Valor inicial
+        mascara |= 1u << c;
+    }
+    qtd_canais = 0;
+    for (uint c = 0; c < SENSORES_ADC_CANAIS; c++) {
+        if (mascara & (1u << c)) ordem[qtd_canais++] = (uint8_t)c;
+    }
+    posicao = 0;
+    consumidas = 0;
+    ativo = hal_adc_continuo_iniciar(mascara, amostras_por_segundo);
+    if (!ativo) printf("ERRO: Aquisicao continua do ADC nao iniciada\n");
+    return ativo;
+}
+
+/**
+ * @brief Consome as amostras gravadas desde a última chamada.
+ * @details O canal de cada amostra vem da posição no rodízio, acompanhada aqui
+ *          (o anel guarda apenas o valor de 12 bits).
+ */
+void sensores_adc_processar(void) {
+    if (!ativo) return;
+    const volatile uint16_t *anel = hal_adc_continuo_anel();
+    uint32_t total = hal_adc_continuo_total();
+    uint32_t novas = total - consumidas;
+
+    if (novas > HAL_ADC_ANEL_AMOSTRAS - SENSORES_ADC_MARGEM) {
+        // Atraso maior que o anel: descarta as mais antigas, mantendo o rodízio
+        uint32_t descartar = novas - (HAL_ADC_ANEL_AMOSTRAS - SENSORES_ADC_MARGEM);
+        consumidas += descartar;
+        posicao = (uint8_t)((posicao + descartar % qtd_canais) % qtd_canais);
+        stats.perdidas += descartar;
+        novas -= descartar;
+    }
+
+    for (uint32_t i = 0; i < novas; i++) {
+        uint16_t amostra = anel[consumidas++ % HAL_ADC_ANEL_AMOSTRAS];
+        uint c = ordem[posicao];
+        if (++posicao == qtd_canais) posicao = 0;
+
+        sensores_adc_filtro_t *f = &filtros[c];
+        f->soma += amostra & 0x0FFFu; // Bits 12-15 são o flag de erro do FIFO
+        if (++f->acumuladas < (1u << f->sobreamostragem_log2)) continue;
+
+        // Média decimada já com SENSORES_ADC_FRACAO bits fracionários
+        uint32_t media = (f->soma << SENSORES_ADC_FRACAO) >> f->sobreamostragem_log2;
+        f->soma = 0;
+        f->acumuladas = 0;
+        int32_t delta = (int32_t)media - (int32_t)f->filtrado;
+        f->filtrado = (uint32_t)((int32_t)f->filtrado + (delta >> f->suavizacao_log2));
+        stats.decimadas[c]++;
+    }
+    stats.processadas += novas;
+}
+
+uint16_t sensores_adc_ler(uint canal) {
+    if (canal >= SENSORES_ADC_CANAIS) return 0;
+    return (uint16_t)((filtros[canal].filtrado + (1u << (SENSORES_ADC_FRACAO - 1))) >> SENSORES_ADC_FRACAO);
+}
+
+uint16_t sensores_adc_ler_q4(uint canal) {
+    if (canal >= SENSORES_ADC_CANAIS) return 0;
+    return (uint16_t)(filtros[canal].filtrado >> (SENSORES_ADC_FRACAO - 4));
+}
+
+void sensores_adc_print_stats(void) {
+    printf("Amostras processadas %lu, perdidas %lu\n",
+           (unsigned long)stats.processadas, (unsigned long)stats.perdidas);
+    for (uint i = 0; i < qtd_canais; i++) {
+        uint c = ordem[i];
+        printf("Canal %u: %lu medias (x%u), valor %u.%02u\n", c,
+               (unsigned long)stats.decimadas[c], 1u << filtros[c].sobreamostragem_log2,
+               sensores_adc_ler_q4(c) >> 4, ((sensores_adc_ler_q4(c) & 0xFu) * 100u) >> 4);
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * @file sensores_adc.h
+ * @brief Aquisição contínua e filtragem dos canais analógicos (joystick e sensor onboard).
+ * @details O ADC converte em rodízio livre os canais configurados e o DMA grava
+ *          as amostras em um anel (hal_adc_continuo_*), sem a CPU e sem as
+ *          esperas de ~2 us por leitura de hal_adc_ler. sensores_adc_processar()
+ *          consome as amostras novas do anel e, para cada canal:
+ *          - acumula 2^sobreamostragem_log2 amostras e as reduz a uma média
+ *            (sobreamostragem com decimação, ganha resolução e reduz o ruído);
+ *          - aplica a média decimada a uma média móvel exponencial de peso
+ *            2^-suavizacao_log2, mantida com 8 bits fracionários.
+ *
+ *          Quem usa os valores lê apenas o último valor filtrado do canal, sem
+ *          acessar o ADC. Se o processamento atrasar além do anel, as amostras
+ *          sobrescritas são descartadas e contadas. Usado somente pelo núcleo 1.
+ */
+
+#ifndef SENSORES_ADC_H
+#define SENSORES_ADC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hal.h"
+
+#define SENSORES_ADC_CANAIS 5 // Canais do ADC do RP2040 (4 = sensor interno)
+
+/**
+ * @struct sensores_adc_canal_cfg_t
+ * @brief Filtragem de um canal.
+ */
+typedef struct {
+    uint8_t canal;                 // Canal do ADC (0-4)
+    uint8_t sobreamostragem_log2;  // Amostras por média decimada = 2^n (0-8)
+    uint8_t suavizacao_log2;       // Peso da nova média na média móvel = 2^-n (0 = sem suavização)
+} sensores_adc_canal_cfg_t;
+
+/**
+ * @struct sensores_adc_stats_t
+ * @brief Contadores do processamento (escritos pelo núcleo 1).
+ */
+typedef struct {
+    uint32_t processadas;   // Amostras consumidas do anel
+    uint32_t perdidas;      // Amostras sobrescritas antes de serem consumidas
+    uint32_t decimadas[SENSORES_ADC_CANAIS]; // Médias decimadas por canal
+} sensores_adc_stats_t;
+
+// Lê cada canal uma vez (valor inicial dos filtros) e inicia a aquisição contínua.
+// `amostras_por_segundo` é a taxa total do ADC, dividida entre os canais.
+bool sensores_adc_iniciar(const sensores_adc_canal_cfg_t *canais, size_t quantidade,
+                          uint32_t amostras_por_segundo);
+void sensores_adc_processar(void);          // Consome as amostras novas do anel
+uint16_t sensores_adc_ler(uint canal);      // Último valor filtrado, 12 bits
+uint16_t sensores_adc_ler_q4(uint canal);   // Último valor filtrado com 4 bits fracionários
+void sensores_adc_print_stats(void);
+
+#endif
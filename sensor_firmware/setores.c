@@ -0,0 +1,282 @@
+/**
+ * @file setores.c
+ * @brief Modelo dos setores com conjuntos de bits, fila de comandos e snapshot (seqlock) entre os núcleos.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "setores.h"
+#include "diario.h"
+
+#define SETORES_FILA_COMANDOS 16 // Capacidade da fila de comandos núcleo 0 -> 1
+#define SETORES_FILA_EVENTOS 64  // Capacidade da fila de eventos núcleo 1 -> 0 (um "limpar" gera até 2 por setor)
+
+char nomes_setores[MAX_SETORES][SETOR_NOME_MAX]; // Array para armazenar nomes dos setores
+
+static hal_fila_t fila_comandos;            // Fila de comandos (segura entre núcleos e IRQs)
+static setores_snapshot_t snapshot;         // Último estado publicado pelo núcleo 1
+static volatile uint32_t snapshot_seq = 0;  // Seqlock: ímpar durante a escrita
+static hal_fila_t fila_eventos;             // Deltas do estado (núcleo 1 -> 0)
+static volatile bool eventos_perdidos;      // A fila de eventos encheu: leitores devem ressincronizar
+static float temperatura_notificada[MAX_SETORES]; // Última temperatura anunciada (núcleo 1)
+
+// ===== CONJUNTOS DE SETORES =====
+
+bool setores_bits_algum(const setores_bits_t *b) {
+    uint32_t algum = 0;
+    for (int p = 0; p < SETORES_PALAVRAS; p++) algum |= b->palavras[p];
+    return algum != 0;
+}
+
+uint16_t setores_bits_contar(const setores_bits_t *b) {
+    uint16_t n = 0;
+    for (int p = 0; p < SETORES_PALAVRAS; p++) n += (uint16_t)__builtin_popcount(b->palavras[p]);
+    return n;
+}
+
+/**
+ * @brief Primeiro setor do conjunto com índice >= `desde`.
+ * @details Pula palavras vazias inteiras; dentro da palavra, __builtin_ctz
+ *          (no Pico, a rotina da ROM, pois o Cortex-M0+ não tem CLZ/CTZ).
+ * @return setor_id_t O setor, ou SETOR_INVALIDO se não há mais nenhum.
+ */
+setor_id_t setores_bits_proximo(const setores_bits_t *b, setor_id_t desde) {
+    if (desde >= MAX_SETORES) return SETOR_INVALIDO;
+    int p = desde / 32;
+    uint32_t palavra = b->palavras[p] & (~0u << (desde % 32));
+    while (!palavra) {
+        if (++p == SETORES_PALAVRAS) return SETOR_INVALIDO;
+        palavra = b->palavras[p];
+    }
+    return (setor_id_t)(p * 32 + __builtin_ctz(palavra));
+}
+
+/**
+ * @brief Informa se algum setor do intervalo [inicio, fim) está no conjunto.
+ * @details Testa palavra a palavra, com máscaras nas pontas (trecho de uma
+ *          linha da grade, no visor).
+ */
+bool setores_bits_algum_entre(const setores_bits_t *b, setor_id_t inicio, setor_id_t fim) {
+    while (inicio < fim) {
+        int p = inicio / 32;
+        uint32_t mascara = ~0u << (inicio % 32);
+        uint32_t fim_palavra = (uint32_t)(p + 1) * 32;
+        if (fim < fim_palavra) mascara &= ~0u >> (fim_palavra - fim);
+        if (b->palavras[p] & mascara) return true;
+        inicio = (setor_id_t)fim_palavra;
+    }
+    return false;
+}
+
+// ===== MODELO DOS SETORES =====
+
+// Instante das avaliações de alarme (as durações das regras são em ms)
+static uint32_t setores_agora_ms(void) {
+    return (uint32_t)(hal_tempo_us() / 1000u);
+}
+
+/**
+ * @brief Descadastra todos os setores e define a temperatura de todos.
+ */
+void setores_modelo_limpar(setores_modelo_t *m, float temperatura) {
+    for (int i = 0; i < MAX_SETORES; i++) {
+        m->temperaturas[i] = temperatura;
+        alarmes_reiniciar(m, (setor_id_t)i);
+    }
+    memset(&m->cadastrados, 0, sizeof(m->cadastrados));
+}
+
+/**
+ * @brief Escreve a temperatura de um setor e avalia a regra de alarme dele.
+ */
+void setores_modelo_temperatura(setores_modelo_t *m, setor_id_t i, float celsius) {
+    m->temperaturas[i] = celsius;
+    if (setores_cadastrado(m, i)) alarmes_avaliar(m, i, setores_agora_ms());
+}
+
+/**
+ * @brief Cadastra ou descadastra um setor; o alarme recomeça do nível normal.
+ */
+void setores_modelo_cadastro(setores_modelo_t *m, setor_id_t i, bool cadastrado) {
+    if (cadastrado == setores_cadastrado(m, i)) return;
+    setores_bits_definir(&m->cadastrados, i, cadastrado);
+    diario_registrar(DIARIO_CADASTRO, i, cadastrado, m->temperaturas[i]);
+    alarmes_reiniciar(m, i);
+    if (cadastrado) alarmes_avaliar(m, i, setores_agora_ms());
+}
+
+// ===== TROCA ENTRE OS NÚCLEOS =====
+
+/**
+ * @brief Inicializa a fila de comandos. Deve ser chamada antes de lançar o núcleo 1.
+ */
+void setores_init(void) {
+    hal_fila_init(&fila_comandos, sizeof(setor_cmd_t), SETORES_FILA_COMANDOS);
+    hal_fila_init(&fila_eventos, sizeof(setor_evento_t), SETORES_FILA_EVENTOS);
+    memset(&snapshot, 0, sizeof(snapshot));
+    memset(temperatura_notificada, 0, sizeof(temperatura_notificada));
+    snapshot_seq = 0;
+    eventos_perdidos = false;
+    alarmes_init(); // Regra padrão em todos os setores
+    diario_init();  // Os dois núcleos registram eventos a partir daqui
+}
+
+/**
+ * @brief Envia um comando ao núcleo 1 sem bloquear.
+ * @return bool `false` se a fila estiver cheia (comando descartado).
+ * @details Pode ser chamada do menu serial ou dos callbacks do lwIP.
+ */
+bool setores_enviar_comando(setor_cmd_tipo_t tipo, setor_id_t setor, float valor) {
+    setor_cmd_t cmd = { .tipo = (uint8_t)tipo, .setor = setor, .valor = valor };
+    return hal_fila_adicionar(&fila_comandos, &cmd);
+}
+
+/**
+ * @brief Envia ao núcleo 1 uma nova regra de alarme para `setor` (SETOR_INVALIDO = todos).
+ * @return bool `false` se a fila estiver cheia.
+ */
+bool setores_enviar_regra(setor_id_t setor, const alarme_regra_t *regra) {
+    setor_cmd_t cmd = { .tipo = SETOR_CMD_DEFINIR_REGRA, .setor = setor, .regra = *regra };
+    return hal_fila_adicionar(&fila_comandos, &cmd);
+}
+
+/**
+ * @brief Retira o próximo comando pendente (núcleo 1).
+ * @return bool `true` se havia um comando.
+ */
+bool setores_receber_comando(setor_cmd_t *cmd) {
+    return hal_fila_remover(&fila_comandos, cmd);
+}
+
+/**
+ * @brief Enfileira um evento; se a fila estiver cheia, sinaliza a perda.
+ */
+static void setores_emitir(setor_evt_tipo_t tipo, int setor, const setores_snapshot_t *estado) {
+    setor_evento_t evento = {
+        .tipo = (uint8_t)tipo,
+        .setor = (setor_id_t)setor,
+        .cadastrado = setores_cadastrado(&estado->modelo, (setor_id_t)setor),
+        .alarme = setores_em_alarme(&estado->modelo, (setor_id_t)setor),
+        .temperatura = estado->modelo.temperaturas[setor],
+    };
+    if (tipo == SETOR_EVT_BUZZER) evento.alarme = estado->buzzer_ativo;
+    if (!hal_fila_adicionar(&fila_eventos, &evento)) {
+        eventos_perdidos = true;
+    }
+}
+
+/**
+ * @brief Compara o estado a publicar com o último publicado e gera os eventos.
+ * @details Executada pelo núcleo 1 (único escritor de `snapshot`). Variações de
+ *          temperatura menores que SETORES_HISTERESE_C em relação à última
+ *          anunciada não geram evento, de modo que o ruído não chega aos clientes.
+ *          Só são visitados os setores cadastrados antes ou agora: nos demais
+ *          nada pode ter mudado (o alarme é subconjunto do cadastro).
+ */
+static void setores_gerar_eventos(const setores_snapshot_t *novo) {
+    const setores_modelo_t *antes = &snapshot.modelo, *agora = &novo->modelo;
+    setores_bits_t visitar;
+    for (int p = 0; p < SETORES_PALAVRAS; p++) {
+        visitar.palavras[p] = antes->cadastrados.palavras[p] | agora->cadastrados.palavras[p];
+    }
+    SETORES_BITS_PARA_CADA(&visitar, i) {
+        float variacao = agora->temperaturas[i] - temperatura_notificada[i];
+        if (setores_cadastrado(agora, i) != setores_cadastrado(antes, i)) {
+            setores_emitir(SETOR_EVT_CADASTRO, i, novo);
+        } else if (setores_em_alarme(agora, i) != setores_em_alarme(antes, i)) {
+            setores_emitir(SETOR_EVT_ALARME, i, novo);
+        } else if (setores_cadastrado(agora, i) && (variacao >= SETORES_HISTERESE_C || variacao <= -SETORES_HISTERESE_C)) {
+            setores_emitir(SETOR_EVT_TEMPERATURA, i, novo);
+            diario_registrar(DIARIO_TEMPERATURA, i, 0, agora->temperaturas[i]); // Mesmo filtro dos clientes /events
+        } else {
+            continue;
+        }
+        temperatura_notificada[i] = agora->temperaturas[i]; // Todo evento leva a temperatura atual
+    }
+    if (novo->buzzer_ativo != snapshot.buzzer_ativo) {
+        setores_emitir(SETOR_EVT_BUZZER, 0, novo);
+    }
+}
+
+/**
+ * @brief Publica um novo estado dos setores (somente o núcleo 1 escreve).
+ * @param origem Estado a publicar; seu campo `versao` é atualizado.
+ * @details O escritor nunca espera: os leitores é que repetem a cópia caso
+ *          ela coincida com uma publicação. As diferenças em relação ao estado
+ *          anterior são enfileiradas como eventos antes da cópia.
+ */
+void setores_publicar(setores_snapshot_t *origem) {
+    setores_gerar_eventos(origem);
+    origem->versao++;
+    snapshot_seq++;   // Ímpar: escrita em andamento
+    hal_barreira();
+    memcpy(&snapshot, origem, sizeof(snapshot));
+    hal_barreira();
+    snapshot_seq++;   // Par: snapshot consistente
+}
+
+/**
+ * @brief Obtém uma cópia consistente do último estado publicado (núcleo 0).
+ * @param destino Recebe a cópia.
+ */
+void setores_ler_snapshot(setores_snapshot_t *destino) {
+    uint32_t inicio, fim;
+    do {
+        do {
+            inicio = snapshot_seq;
+        } while (inicio & 1u); // Aguarda o fim de uma escrita em andamento
+        hal_barreira();
+        memcpy(destino, &snapshot, sizeof(snapshot));
+        hal_barreira();
+        fim = snapshot_seq;
+    } while (inicio != fim);
+}
+
+/**
+ * @brief Retira o próximo evento publicado pelo núcleo 1 (núcleo 0).
+ * @return bool `true` se havia um evento.
+ */
+bool setores_receber_evento(setor_evento_t *evento) {
+    return hal_fila_remover(&fila_eventos, evento);
+}
+
+/**
+ * @brief Informa (e limpa) se eventos foram descartados por fila cheia (núcleo 0).
+ * @details Nesse caso os consumidores devem se ressincronizar pelo snapshot.
+ */
+bool setores_eventos_perdidos(void) {
+    if (!eventos_perdidos) return false;
+    eventos_perdidos = false;
+    return true;
+}
+
+/**
+ * @brief Pede ao núcleo 1 que limpe o sistema (menu serial e rota HTTP).
+ * @details A resposta ao operador vai por printf: não depende de LOG_NIVEL.
+ */
+void solicitar_limpeza(void) {
+    if (setores_enviar_comando(SETOR_CMD_LIMPAR, 0, 0.0f)) {
+        printf("Sistema AgroGraf limpo.\n");
+    } else {
+        printf("Fila de comandos cheia: limpeza nao realizada.\n");
+    }
+}
+
+/**
+ * @brief Pede ao núcleo 1 que volte os setores em alerta para a temperatura ambiente.
+ * @details Usado pela confirmação no menu serial e pela rota HTTP "/reset_alarms".
+ *          Os setores afetados são informados ao operador (printf, como em
+ *          solicitar_limpeza) a partir do snapshot atual.
+ */
+void solicitar_reset_alertas(void) {
+    static setores_snapshot_t estado; // Estático: cresce com MAX_SETORES
+    setores_ler_snapshot(&estado);
+    if (!setores_enviar_comando(SETOR_CMD_RESETAR_ALERTAS, 0, 0.0f)) {
+        printf("Fila de comandos cheia: equipamentos nao acionados.\n");
+        return;
+    }
+    SETORES_BITS_PARA_CADA(&estado.modelo.alarmes, i) {
+        printf("Equipamentos acionados no %s - temp. controlada (%.2f C).\n", nomes_setores[i], estado.temperatura_ambiente);
+    }
+}
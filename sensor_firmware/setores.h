@@ -0,0 +1,214 @@
+/**
+ * @file setores.h
+ * @brief Troca de estado dos setores entre os dois núcleos do RP2040.
+ * @details O núcleo 1 é o único dono do modelo de setores (cadastro,
+ *          temperaturas, alarme e atuadores). O núcleo 0 (Wi-Fi/HTTP, menu
+ *          serial e OLED) nunca altera esse modelo diretamente:
+ *          - pedidos de alteração seguem por uma fila de comandos (núcleo 0 -> 1);
+ *          - o estado publicado pelo núcleo 1 é lido como um snapshot protegido
+ *            por seqlock (núcleo 1 -> 0). O escritor nunca espera pelos leitores,
+ *            de modo que um cliente HTTP lento não atrasa o alarme;
+ *          - a cada publicação, as diferenças em relação ao estado anterior
+ *            viram eventos (cadastro, temperatura fora da histerese, alarme,
+ *            buzzer) em uma fila núcleo 1 -> 0, consumida pelo stream /events.
+ *
+ *          O modelo (setores_modelo_t) guarda as temperaturas em um array e o
+ *          cadastro, os avisos e os alarmes em conjuntos de bits. Avisos e
+ *          alarmes são mantidos a cada escrita (setores_modelo_temperatura/
+ *          cadastro), pelas regras de alarmes.h, de modo que "algum setor em
+ *          alarme?", "quantos?" e "quais?" são respondidos pelos bits, sem
+ *          varrer e comparar temperaturas.
+ */
+
+#ifndef SETORES_H
+#define SETORES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "visor.h"
+#include "alarmes.h"
+
+// Dimensões da grade de setores, definidas no build (CMake: AGROGRAF_SETORES_COLUNAS
+// e AGROGRAF_SETORES_LINHAS). O modelo não depende da matriz de LEDs, que exibe
+// uma janela da grade (visor.h).
+#ifndef SETORES_COLUNAS
+#define SETORES_COLUNAS 5
+#endif
+#ifndef SETORES_LINHAS
+#define SETORES_LINHAS 5
+#endif
+#define MAX_SETORES (SETORES_COLUNAS * SETORES_LINHAS) // Setores do modelo (índice = y * SETORES_COLUNAS + x)
+#define SETORES_SUPORTADOS 169 // Maior grade aceita (ex.: 13x13), com o histórico mínimo (historico.h) na RAM do Pico
+#define SETOR_INVALIDO 0xFFFFu // Índice que não corresponde a setor algum
+#define SETOR_NOME_MAX 30      // Tamanho máximo do nome de um setor (com o '\0')
+#define SETORES_HISTERESE_C 0.5f // Variação mínima de temperatura que gera um evento
+#define SETORES_ALARME_C 100.0f  // Limite crítico da regra de alarme padrão (alarmes.h)
+#define SETORES_PALAVRAS ((MAX_SETORES + 31) / 32) // Palavras de 32 bits de um conjunto de setores
+
+_Static_assert(SETORES_COLUNAS >= 1 && SETORES_LINHAS >= 1 && MAX_SETORES <= SETORES_SUPORTADOS,
+               "dimensoes da grade de setores fora da faixa (ate SETORES_SUPORTADOS setores)");
+
+typedef uint16_t setor_id_t; // Índice de um setor (0 a MAX_SETORES - 1)
+
+// Nomes dos setores: definidos no boot, antes de lançar o núcleo 1, e apenas lidos depois
+extern char nomes_setores[MAX_SETORES][SETOR_NOME_MAX];
+
+// Posição (x, y) de um setor na grade e vice-versa
+static inline setor_id_t setor_indice(int x, int y) {
+    return (setor_id_t)(y * SETORES_COLUNAS + x);
+}
+
+static inline int setor_coluna(setor_id_t setor) {
+    return setor % SETORES_COLUNAS;
+}
+
+static inline int setor_linha(setor_id_t setor) {
+    return setor / SETORES_COLUNAS;
+}
+
+// ===== CONJUNTOS DE SETORES =====
+
+/**
+ * @struct setores_bits_t
+ * @brief Conjunto de setores: bit (i % 32) da palavra i / 32 = setor i.
+ * @details Bits acima de MAX_SETORES ficam sempre em zero.
+ */
+typedef struct {
+    uint32_t palavras[SETORES_PALAVRAS];
+} setores_bits_t;
+
+static inline bool setores_bits_tem(const setores_bits_t *b, setor_id_t i) {
+    return (b->palavras[i / 32] >> (i % 32)) & 1u;
+}
+
+static inline void setores_bits_definir(setores_bits_t *b, setor_id_t i, bool valor) {
+    uint32_t bit = 1u << (i % 32);
+    if (valor) b->palavras[i / 32] |= bit;
+    else b->palavras[i / 32] &= ~bit;
+}
+
+bool setores_bits_algum(const setores_bits_t *b);                           // Conjunto não vazio
+uint16_t setores_bits_contar(const setores_bits_t *b);                      // Quantidade de setores (popcount)
+setor_id_t setores_bits_proximo(const setores_bits_t *b, setor_id_t desde); // Primeiro >= desde, ou SETOR_INVALIDO
+bool setores_bits_algum_entre(const setores_bits_t *b, setor_id_t inicio, setor_id_t fim); // Algum em [inicio, fim)
+
+// Percorre os setores do conjunto em ordem crescente (o conjunto pode mudar durante o laço)
+#define SETORES_BITS_PARA_CADA(b, i)                                          \
+    for (setor_id_t i = setores_bits_proximo((b), 0); i != SETOR_INVALIDO; \
+         i = setores_bits_proximo((b), (setor_id_t)(i + 1)))
+
+// ===== MODELO DOS SETORES =====
+
+/**
+ * @struct setores_modelo_t
+ * @brief Temperaturas, cadastro e alarme de todos os setores.
+ * @details Escrito apenas pelas funções setores_modelo_*, que avaliam a regra
+ *          do setor (alarmes.h) e mantêm `avisos` e `alarmes`. O núcleo 1 é
+ *          dono do modelo; o núcleo 0 lê a cópia publicada no snapshot.
+ */
+typedef struct setores_modelo {
+    float temperaturas[MAX_SETORES]; // Temperatura de cada setor (°C)
+    setores_bits_t cadastrados;      // Setores cadastrados
+    setores_bits_t avisos;           // Setores em ALARME_AVISO (subconjunto de `cadastrados`)
+    setores_bits_t alarmes;          // Setores em ALARME_CRITICO (subconjunto de `cadastrados`)
+} setores_modelo_t;
+
+void setores_modelo_limpar(setores_modelo_t *m, float temperatura);                // Nenhum cadastrado, todos em `temperatura`
+void setores_modelo_temperatura(setores_modelo_t *m, setor_id_t i, float celsius);
+void setores_modelo_cadastro(setores_modelo_t *m, setor_id_t i, bool cadastrado);
+
+static inline bool setores_cadastrado(const setores_modelo_t *m, setor_id_t i) {
+    return setores_bits_tem(&m->cadastrados, i);
+}
+
+static inline bool setores_em_alarme(const setores_modelo_t *m, setor_id_t i) {
+    return setores_bits_tem(&m->alarmes, i);
+}
+
+static inline bool setores_em_aviso(const setores_modelo_t *m, setor_id_t i) {
+    return setores_bits_tem(&m->avisos, i);
+}
+
+/**
+ * @struct setores_snapshot_t
+ * @brief Cópia consistente do estado dos setores publicada pelo núcleo 1.
+ * @details Leva uma cópia do modelo do núcleo 1, com os conjuntos de cadastro
+ *          e de alarme já calculados. O tamanho cresce com MAX_SETORES; com
+ *          grades grandes, as cópias ficam em variáveis estáticas, não na pilha
+ *          (2 KB por núcleo no Pico).
+ */
+typedef struct {
+    uint32_t versao;                      // Incrementada a cada publicação
+    setores_modelo_t modelo;              // Temperaturas, cadastro e alarme
+    bool buzzer_ativo;                    // Estado do buzzer
+    bool modo_cadastro;                   // Núcleo 1 está no modo de cadastro (joystick)
+    bool transicao_pendente;              // Mudança de nível de alarme aguardando a duração mínima
+    float temperatura_ambiente;           // Última leitura do sensor onboard
+    visor_t visor;                        // Janela da grade exibida na matriz de LEDs
+} setores_snapshot_t;
+
+/**
+ * @enum setor_cmd_tipo_t
+ * @brief Comandos enviados pelo núcleo 0 ao núcleo 1.
+ */
+typedef enum {
+    SETOR_CMD_DEFINIR_TEMPERATURA, // Define a temperatura de `setor` para `valor`
+    SETOR_CMD_LIMPAR,              // Equivale a clearSystem()
+    SETOR_CMD_RESETAR_ALERTAS,     // Volta setores em alerta para a temperatura ambiente
+    SETOR_CMD_MODO_CADASTRO,       // Entra no modo de cadastro via joystick
+    SETOR_CMD_DEFINIR_REGRA,       // Troca a regra de alarme de `setor` (SETOR_INVALIDO = todos)
+    SETOR_CMD_ENCERRAR             // Apaga LEDs/buzzer e encerra o núcleo 1
+} setor_cmd_tipo_t;
+
+/**
+ * @struct setor_cmd_t
+ * @brief Comando na fila entre os núcleos.
+ */
+typedef struct {
+    uint8_t tipo;     // setor_cmd_tipo_t
+    setor_id_t setor; // Índice do setor (quando aplicável)
+    union {
+        float valor;          // Valor do comando (quando aplicável)
+        alarme_regra_t regra; // SETOR_CMD_DEFINIR_REGRA
+    };
+} setor_cmd_t;
+
+/**
+ * @enum setor_evt_tipo_t
+ * @brief Tipos de evento (delta) publicados pelo núcleo 1.
+ */
+typedef enum {
+    SETOR_EVT_CADASTRO,     // Setor cadastrado ou removido
+    SETOR_EVT_TEMPERATURA,  // Temperatura variou mais que SETORES_HISTERESE_C
+    SETOR_EVT_ALARME,       // Alarme do setor ativado ou desativado
+    SETOR_EVT_BUZZER        // Buzzer ligado ou desligado (`setor` não se aplica)
+} setor_evt_tipo_t;
+
+/**
+ * @struct setor_evento_t
+ * @brief Estado de um setor no momento do evento (valores absolutos, não incrementos).
+ */
+typedef struct {
+    uint8_t tipo;           // setor_evt_tipo_t
+    uint8_t cadastrado;     // Setor cadastrado
+    setor_id_t setor;       // Índice do setor (0 a MAX_SETORES - 1)
+    uint8_t alarme;         // Setor em alarme (SETOR_EVT_BUZZER: buzzer ativo)
+    float temperatura;      // Temperatura do setor
+} setor_evento_t;
+
+void setores_init(void);
+
+// Núcleo 0: envio de comandos e leitura do snapshot
+bool setores_enviar_comando(setor_cmd_tipo_t tipo, setor_id_t setor, float valor);
+bool setores_enviar_regra(setor_id_t setor, const alarme_regra_t *regra);
+void setores_ler_snapshot(setores_snapshot_t *destino);
+void solicitar_limpeza(void);
+void solicitar_reset_alertas(void);
+bool setores_receber_evento(setor_evento_t *evento);
+bool setores_eventos_perdidos(void);
+
+// Núcleo 1: recebimento de comandos e publicação do snapshot
+bool setores_receber_comando(setor_cmd_t *cmd);
+void setores_publicar(setores_snapshot_t *origem);
+
+#endif
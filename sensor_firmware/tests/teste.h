@@ -0,0 +1,37 @@
+/**
+ * @file teste.h
+ * @brief Verificações dos testes de host (ctest): cada falha é relatada e contada, sem abortar.
+ * @details Os testes são executáveis do build de host com o firmware sem o main
+ *          (AGROGRAF_SEM_MAIN). main() termina com `return TESTE_FIM();`: código
+ *          de saída 0 se nenhuma verificação falhou.
+ */
+
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+
+static int teste_falhas;
+
+#define TESTE_VERIFICAR(cond)                                                   \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            teste_falhas++;                                                     \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);  \
+        }                                                                       \
+    } while (0)
+
+#define TESTE_IGUAL(obtido, esperado)                                                   \
+    do {                                                                                \
+        long teste_o = (long)(obtido), teste_e = (long)(esperado);                      \
+        if (teste_o != teste_e) {                                                       \
+            teste_falhas++;                                                             \
+            fprintf(stderr, "%s:%d: %s = %ld, esperado %ld\n", __FILE__, __LINE__,      \
+                    #obtido, teste_o, teste_e);                                         \
+        }                                                                               \
+    } while (0)
+
+#define TESTE_FIM() \
+    (teste_falhas ? (fprintf(stderr, "%d verificacao(oes) falharam\n", teste_falhas), 1) : 0)
+
+#endif
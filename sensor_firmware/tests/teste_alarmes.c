@@ -0,0 +1,170 @@
+/**
+ * @file teste_alarmes.c
+ * @brief Regras de alarme (alarmes.c): histerese, duração mínima, taxa de subida e validação.
+ * @details O tempo é passado explicitamente a alarmes_avaliar/alarmes_processar,
+ *          como faz o núcleo 1, então os cenários não dependem do relógio.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "setores.h"
+#include "alarmes.h"
+#include "http_server.h"
+#include "teste.h"
+
+static setores_modelo_t modelo;
+static char resposta[4096];
+
+static void preparar(void) {
+    setores_init(); // Regra padrão, diário e fila de comandos
+    setores_modelo_limpar(&modelo, 25.0f);
+    for (setor_id_t i = 0; i < 4; i++) setores_bits_definir(&modelo.cadastrados, i, true);
+}
+
+static alarme_nivel_t nivel(setor_id_t i) {
+    if (setores_em_alarme(&modelo, i)) return ALARME_CRITICO;
+    if (setores_em_aviso(&modelo, i)) return ALARME_AVISO;
+    return ALARME_NORMAL;
+}
+
+// Nova temperatura do setor no instante `ms`, como em setores_modelo_temperatura
+static alarme_nivel_t ler(setor_id_t i, float celsius, uint32_t ms) {
+    modelo.temperaturas[i] = celsius;
+    alarmes_avaliar(&modelo, i, ms);
+    return nivel(i);
+}
+
+static void regra(setor_id_t i, float subida_c_min, uint32_t duracao_ms) {
+    alarme_regra_t r = alarme_regra_padrao;
+    r.subida_c_min = subida_c_min;
+    r.duracao_ms = duracao_ms;
+    alarmes_definir_regra(&modelo, i, &r, 0);
+}
+
+// Padrão: aviso 90, crítico 100, histerese 1. Cada nível só cai 1 °C abaixo do limite.
+static void teste_histerese(void) {
+    preparar();
+    TESTE_IGUAL(ler(0, 100.5f, 0), ALARME_CRITICO);
+    TESTE_IGUAL(ler(0, 99.5f, 10), ALARME_CRITICO);
+    TESTE_IGUAL(ler(0, 99.0f, 20), ALARME_AVISO);   // Não está mais acima de 100 - 1
+    TESTE_IGUAL(ler(0, 99.5f, 30), ALARME_AVISO);   // Voltar a subir abaixo do limite não religa
+    TESTE_IGUAL(ler(0, 89.5f, 40), ALARME_AVISO);
+    TESTE_IGUAL(ler(0, 88.9f, 50), ALARME_NORMAL);
+    TESTE_IGUAL(ler(0, 89.5f, 60), ALARME_NORMAL);
+    TESTE_IGUAL(ler(0, 90.1f, 70), ALARME_AVISO);
+}
+
+// Duração mínima de 5 s: o nível só muda depois de o candidato se manter o prazo todo
+static void teste_duracao(void) {
+    preparar();
+    regra(0, 0.0f, 5000);
+    TESTE_IGUAL(ler(0, 95.0f, 0), ALARME_NORMAL);      // Candidato AVISO desde 0
+    TESTE_IGUAL(ler(0, 105.0f, 3000), ALARME_NORMAL);  // Candidato vira CRITICO: prazo recomeça em 3000
+    TESTE_VERIFICAR(!alarmes_processar(&modelo, 5500)); // AVISO teria vencido em 5000
+    TESTE_IGUAL(nivel(0), ALARME_NORMAL);
+    TESTE_VERIFICAR(!alarmes_processar(&modelo, 7999));
+    TESTE_IGUAL(nivel(0), ALARME_NORMAL);
+    TESTE_VERIFICAR(alarmes_processar(&modelo, 8000));
+    TESTE_IGUAL(nivel(0), ALARME_CRITICO);
+
+    // Voltar ao nível aceito cancela o candidato; a próxima queda conta do zero
+    TESTE_IGUAL(ler(0, 95.0f, 10000), ALARME_CRITICO); // Candidato AVISO desde 10000
+    TESTE_IGUAL(ler(0, 101.0f, 12000), ALARME_CRITICO);
+    TESTE_IGUAL(ler(0, 95.0f, 14000), ALARME_CRITICO); // Candidato AVISO desde 14000
+    TESTE_VERIFICAR(!alarmes_processar(&modelo, 16000));
+    TESTE_IGUAL(nivel(0), ALARME_CRITICO);
+    TESTE_VERIFICAR(alarmes_processar(&modelo, 19000));
+    TESTE_IGUAL(nivel(0), ALARME_AVISO);
+
+    // Um setor sem mudança pendente não é revisto
+    TESTE_IGUAL(ler(1, 50.0f, 0), ALARME_NORMAL);
+    TESTE_VERIFICAR(!alarmes_processar(&modelo, 60000));
+}
+
+// Subida acima de 2 °C/min gera aviso; sem leituras novas ele expira em 2 janelas
+static void teste_subida(void) {
+    preparar();
+    regra(0, 2.0f, 0);
+    regra(1, 2.0f, 0);
+
+    TESTE_IGUAL(ler(0, 30.0f, 0), ALARME_NORMAL);      // Referência da janela
+    TESTE_IGUAL(ler(0, 40.0f, 5000), ALARME_NORMAL);   // Janela incompleta: não mede
+    TESTE_IGUAL(ler(0, 31.0f, ALARMES_JANELA_SUBIDA_MS), ALARME_AVISO); // 6 °C/min
+    uint32_t ref = ALARMES_JANELA_SUBIDA_MS;
+    TESTE_VERIFICAR(!alarmes_processar(&modelo, ref + 2 * ALARMES_JANELA_SUBIDA_MS - 1));
+    TESTE_IGUAL(nivel(0), ALARME_AVISO);
+    TESTE_VERIFICAR(alarmes_processar(&modelo, ref + 2 * ALARMES_JANELA_SUBIDA_MS));
+    TESTE_IGUAL(nivel(0), ALARME_NORMAL);
+
+    // Abaixo da taxa: 0,2 °C em 10 s = 1,2 °C/min
+    TESTE_IGUAL(ler(1, 30.0f, 0), ALARME_NORMAL);
+    TESTE_IGUAL(ler(1, 30.2f, ALARMES_JANELA_SUBIDA_MS), ALARME_NORMAL);
+
+    // Uma janela seguinte sem subida desfaz o aviso na própria leitura
+    TESTE_IGUAL(ler(1, 31.2f, 2 * ALARMES_JANELA_SUBIDA_MS), ALARME_AVISO);
+    TESTE_IGUAL(ler(1, 31.2f, 3 * ALARMES_JANELA_SUBIDA_MS), ALARME_NORMAL);
+}
+
+static void teste_regra_valida(void) {
+    TESTE_VERIFICAR(alarmes_regra_valida(&alarme_regra_padrao));
+    float invalidos[] = { NAN, INFINITY, -INFINITY };
+    for (size_t k = 0; k < sizeof(invalidos) / sizeof(invalidos[0]); k++) {
+        float *campos[4];
+        alarme_regra_t r;
+        for (int c = 0; c < 4; c++) {
+            r = alarme_regra_padrao;
+            campos[0] = &r.aviso_c;
+            campos[1] = &r.critico_c;
+            campos[2] = &r.histerese_c;
+            campos[3] = &r.subida_c_min;
+            *campos[c] = invalidos[k];
+            if (alarmes_regra_valida(&r)) {
+                teste_falhas++;
+                fprintf(stderr, "regra aceita com o campo %d = %f\n", c, (double)invalidos[k]);
+            }
+        }
+    }
+}
+
+// Código de status de GET `caminho`
+static int status_http(const char *caminho) {
+    char requisicao[256];
+    snprintf(requisicao, sizeof(requisicao), "GET %s HTTP/1.1\r\nHost: teste\r\n\r\n", caminho);
+    if (http_server_gerar_resposta(requisicao, resposta, sizeof(resposta)) == 0) return -1;
+    int status = -1;
+    sscanf(resposta, "HTTP/1.%*d %d", &status);
+    return status;
+}
+
+static void teste_rota_definir(void) {
+    preparar();
+    const char *invalidas[] = {
+        "/api/alarms/set?sector=1&aviso=nan",
+        "/api/alarms/set?sector=1&critico=inf",
+        "/api/alarms/set?sector=1&critico=infinity",
+        "/api/alarms/set?sector=1&aviso=-inf",
+        "/api/alarms/set?sector=1&histerese=nan",
+        "/api/alarms/set?sector=1&histerese=inf",
+        "/api/alarms/set?sector=1&subida=NAN",
+        "/api/alarms/set?sector=1&subida=inf",
+        "/api/alarms/set?aviso=nan",
+        "/api/alarms/set?sector=0&aviso=80",             // Setores começam em 1
+    };
+    for (size_t k = 0; k < sizeof(invalidas) / sizeof(invalidas[0]); k++) {
+        int status = status_http(invalidas[k]);
+        if (status != 400) {
+            teste_falhas++;
+            fprintf(stderr, "%s: status %d, esperado 400\n", invalidas[k], status);
+        }
+    }
+    TESTE_IGUAL(status_http("/api/alarms/set?sector=1&aviso=80&critico=95"), 200);
+}
+
+int main(void) {
+    teste_histerese();
+    teste_duracao();
+    teste_subida();
+    teste_regra_valida();
+    teste_rota_definir();
+    return TESTE_FIM();
+}
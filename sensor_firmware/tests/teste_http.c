@@ -0,0 +1,142 @@
+/**
+ * @file teste_http.c
+ * @brief GET /api/sectors e /api/sectors.bin (http_server.c): corpo em pedaços e Content-Length.
+ * @details As respostas são geradas sem rede por http_server_gerar_resposta, que
+ *          percorre as mesmas etapas das conexões TCP. O estado é publicado com
+ *          setores_publicar, como faz o núcleo 1. Os setores escolhidos ficam no
+ *          início, no meio e no fim da grade, de modo que o corpo ocupa vários pedaços.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "setores.h"
+#include "http_server.h"
+#include "teste.h"
+
+static setores_snapshot_t estado; // Estático: cresce com MAX_SETORES
+static char resposta[64 * 1024];
+
+static const setor_id_t escolhidos[] = { 0, MAX_SETORES / 2, MAX_SETORES - 1 };
+#define ESCOLHIDOS (sizeof(escolhidos) / sizeof(escolhidos[0]))
+
+static void publicar(void) {
+    setores_init();
+    memset(&estado, 0, sizeof(estado));
+    setores_modelo_limpar(&estado.modelo, 25.0f);
+    for (unsigned k = 0; k < ESCOLHIDOS; k++) {
+        setores_modelo_cadastro(&estado.modelo, escolhidos[k], true);
+        setores_modelo_temperatura(&estado.modelo, escolhidos[k], k == 1 ? 120.5f : 20.25f + (float)k);
+    }
+    setores_publicar(&estado);
+}
+
+/**
+ * @brief GET `caminho`; devolve o início do corpo e seu tamanho em `corpo_len`.
+ * @return long Content-Length do cabeçalho, ou -1 se ausente.
+ */
+static long obter(const char *caminho, const char **corpo, size_t *corpo_len) {
+    char requisicao[128];
+    snprintf(requisicao, sizeof(requisicao), "GET %s HTTP/1.1\r\nHost: teste\r\n\r\n", caminho);
+    size_t total = http_server_gerar_resposta(requisicao, resposta, sizeof(resposta) - 1);
+    TESTE_VERIFICAR(total > 0 && total < sizeof(resposta) - 1);
+    resposta[total < sizeof(resposta) ? total : sizeof(resposta) - 1] = '\0';
+
+    const char *fim = strstr(resposta, "\r\n\r\n");
+    const char *campo = strstr(resposta, "Content-Length: ");
+    TESTE_VERIFICAR(fim && campo && campo < fim);
+    if (!fim || !campo) return -1;
+    *corpo = fim + 4;
+    *corpo_len = total - (size_t)(*corpo - resposta);
+    return strtol(campo + 16, NULL, 10);
+}
+
+static unsigned contar(const char *texto, const char *trecho) {
+    unsigned n = 0;
+    for (const char *p = strstr(texto, trecho); p; p = strstr(p + 1, trecho)) n++;
+    return n;
+}
+
+static void teste_json(void) {
+    publicar();
+    const char *corpo;
+    size_t len;
+    long tamanho = obter("/api/sectors", &corpo, &len);
+    TESTE_IGUAL(tamanho, len);
+    TESTE_VERIFICAR(len > 512); // Mais de um pedaço, mesmo na grade padrão
+    TESTE_VERIFICAR(strncmp(corpo, "{\"v\":1,\"b\":", 11) == 0);
+    TESTE_VERIFICAR(len >= 2 && strcmp(corpo + len - 2, "]}") == 0);
+    TESTE_IGUAL(strlen(corpo), len);
+    TESTE_IGUAL(contar(corpo, "{\"i\":"), MAX_SETORES);
+    TESTE_IGUAL(contar(corpo, "\"c\":1"), ESCOLHIDOS);
+    TESTE_IGUAL(contar(corpo, "},{"), MAX_SETORES - 1); // Sem vírgula sobrando entre os pedaços
+
+    char esperado[64];
+    snprintf(esperado, sizeof(esperado), "{\"i\":1,\"c\":1,\"t\":20.25,\"a\":0}");
+    TESTE_VERIFICAR(strstr(corpo, esperado) != NULL);
+    snprintf(esperado, sizeof(esperado), "{\"i\":%d,\"c\":1,\"t\":120.50,\"a\":1}", MAX_SETORES / 2 + 1);
+    TESTE_VERIFICAR(strstr(corpo, esperado) != NULL);
+    snprintf(esperado, sizeof(esperado), "{\"i\":%d,\"c\":1,\"t\":22.25,\"a\":0}]}", MAX_SETORES);
+    TESTE_VERIFICAR(strstr(corpo, esperado) != NULL);
+
+    // O snapshot compartilhado é liberado no fim da resposta: a seguinte vê a nova versão
+    setores_publicar(&estado);
+    obter("/api/sectors", &corpo, &len);
+    TESTE_VERIFICAR(strncmp(corpo, "{\"v\":2,", 7) == 0);
+}
+
+static unsigned ler16(const char *p) {
+    return (uint8_t)p[0] | (unsigned)(uint8_t)p[1] << 8;
+}
+
+static void teste_binario(void) {
+    publicar();
+    const char *corpo;
+    size_t len;
+    long tamanho = obter("/api/sectors.bin", &corpo, &len);
+    TESTE_IGUAL(tamanho, HTTP_API_BIN_TAMANHO);
+    TESTE_IGUAL(len, HTTP_API_BIN_TAMANHO);
+    if (len != HTTP_API_BIN_TAMANHO) return;
+
+    TESTE_IGUAL((uint8_t)corpo[0], HTTP_API_BIN_MAGIC0);
+    TESTE_IGUAL((uint8_t)corpo[1], HTTP_API_BIN_MAGIC1);
+    TESTE_IGUAL((uint8_t)corpo[2], HTTP_API_BIN_VERSAO);
+    TESTE_IGUAL(ler16(corpo + 4), 1); // Versão do snapshot
+    TESTE_IGUAL(ler16(corpo + 8), MAX_SETORES);
+    TESTE_IGUAL(ler16(corpo + 10), SETORES_COLUNAS);
+
+    unsigned cadastrados = 0;
+    for (setor_id_t i = 0; i < MAX_SETORES; i++) {
+        const char *r = corpo + 12 + 4 * i;
+        if (r[2] & HTTP_API_BIN_CADASTRADO) cadastrados++;
+        TESTE_IGUAL(r[3], 0);
+    }
+    TESTE_IGUAL(cadastrados, ESCOLHIDOS);
+
+    const char *ultimo = corpo + 12 + 4 * (MAX_SETORES - 1);
+    TESTE_IGUAL((int16_t)ler16(ultimo), 2225);
+    TESTE_IGUAL((uint8_t)ultimo[2], HTTP_API_BIN_CADASTRADO);
+    const char *meio = corpo + 12 + 4 * (MAX_SETORES / 2);
+    TESTE_IGUAL((int16_t)ler16(meio), 12050);
+    TESTE_VERIFICAR(meio[2] & HTTP_API_BIN_ALARME);
+}
+
+// A página lê o mesmo snapshot compartilhado: só os setores cadastrados aparecem
+static void teste_pagina(void) {
+    publicar();
+    char requisicao[] = "GET / HTTP/1.0\r\n\r\n";
+    size_t total = http_server_gerar_resposta(requisicao, resposta, sizeof(resposta) - 1);
+    TESTE_VERIFICAR(total > 0 && total < sizeof(resposta) - 1);
+    resposta[total < sizeof(resposta) ? total : sizeof(resposta) - 1] = '\0';
+    TESTE_IGUAL(contar(resposta, "<li id='s"), ESCOLHIDOS);
+    char item[32];
+    snprintf(item, sizeof(item), "<li id='s%d'>", MAX_SETORES);
+    TESTE_VERIFICAR(strstr(resposta, item) != NULL);
+    TESTE_IGUAL(contar(resposta, "<b>(ALERTA!)</b>"), 1);
+}
+
+int main(void) {
+    teste_json();
+    teste_binario();
+    teste_pagina();
+    return TESTE_FIM();
+}
@@ -0,0 +1,270 @@
+/**
+ * @file teste_persistencia.c
+ * @brief Log na flash (persistencia.c): registro interrompido, rodízio, apagamento adiado e log de outra grade.
+ * @details Usa a flash simulada do host (hal_sim.h). Cada "boot" é
+ *          historico_init() + persistencia_iniciar() sobre a mesma região, como
+ *          depois de um reset; o tempo é passado explicitamente. Os setores
+ *          usados ficam no início, no meio (MEIO) e no fim (ULTIMO) da grade: na
+ *          grade 13x13 o estado ocupa várias fatias de PERSISTENCIA_FATIA setores.
+ */
+
+#include <string.h>
+#include "hal.h"
+#include "hal_sim.h"
+#include "setores.h"
+#include "historico.h"
+#include "persistencia.h"
+#include "teste.h"
+
+#define S_US 1000000ull
+#define MEIO (MAX_SETORES / 2)
+#define ULTIMO (MAX_SETORES - 1)
+
+static setores_snapshot_t estado;       // O que o núcleo 0 entrega a persistencia_processar
+static setores_modelo_t restaurado;     // O que o núcleo 1 recebe no boot
+static persistencia_stats_t stats;
+
+static void apagar_flash(void) {
+    hal_flash_regiao(PERSISTENCIA_BLOCOS * HAL_FLASH_SETOR);
+    for (uint32_t b = 0; b < PERSISTENCIA_BLOCOS; b++) hal_flash_apagar(b * HAL_FLASH_SETOR);
+}
+
+// Reset: RAM zerada, replay do log; `restaurado` recebe o cadastro lido
+static bool reiniciar(void) {
+    historico_init();
+    TESTE_VERIFICAR(persistencia_iniciar());
+    persistencia_ler_stats(&stats);
+    setores_modelo_limpar(&restaurado, 0.0f);
+    return persistencia_setores_restaurados(&restaurado);
+}
+
+static void definir_estado(const setor_id_t *cadastrados, size_t n, float base) {
+    memset(&estado, 0, sizeof(estado));
+    for (size_t k = 0; k < n; k++) {
+        setores_bits_definir(&estado.modelo.cadastrados, cadastrados[k], true);
+        estado.modelo.temperaturas[cadastrados[k]] = base + (float)k * 0.25f;
+    }
+}
+
+// Anexa o estado e programa a página pendente (passado PERSISTENCIA_ATRASO_MS)
+static void gravar(uint64_t t_s) {
+    persistencia_processar(&estado, t_s * S_US);
+    persistencia_processar(&estado, (t_s + PERSISTENCIA_ATRASO_MS / 1000 + 1) * S_US);
+}
+
+static bool cadastro_igual(const setor_id_t *cadastrados, size_t n) {
+    setores_bits_t esperado;
+    memset(&esperado, 0, sizeof(esperado));
+    for (size_t k = 0; k < n; k++) setores_bits_definir(&esperado, cadastrados[k], true);
+    return memcmp(&esperado, &restaurado.cadastrados, sizeof(esperado)) == 0;
+}
+
+static bool restaurado_igual(const setor_id_t *cadastrados, size_t n, float base) {
+    for (size_t k = 0; k < n; k++) {
+        if (restaurado.temperaturas[cadastrados[k]] != base + (float)k * 0.25f) return false;
+    }
+    return cadastro_igual(cadastrados, n);
+}
+
+// Queda de energia durante a gravação do cadastro B: o boot volta ao cadastro A
+// inteiro (em 13x13, B muda três fatias; temperaturas de B já gravadas podem sobreviver)
+static void teste_registro_interrompido(void) {
+    static const setor_id_t a[] = { 0, ULTIMO }, b[] = { MEIO }, c[] = { 1, MEIO + 1 };
+    apagar_flash();
+    TESTE_VERIFICAR(!reiniciar());
+
+    definir_estado(a, 2, 21.5f);
+    gravar(1);
+
+    definir_estado(b, 1, 30.0f);
+    persistencia_processar(&estado, 10 * S_US);  // Registro de B na página em buffer
+    hal_sim_flash_interromper();
+    persistencia_processar(&estado, 20 * S_US);  // Programação cortada no meio de B
+
+    TESTE_VERIFICAR(reiniciar());
+    TESTE_VERIFICAR(cadastro_igual(a, 2));
+    TESTE_IGUAL(stats.corrompidos, 1);
+
+    // A escrita recomeça depois do bloco interrompido e o próximo boot a encontra
+    definir_estado(c, 2, 18.0f);
+    gravar(30);
+    TESTE_VERIFICAR(reiniciar());
+    TESTE_VERIFICAR(restaurado_igual(c, 2, 18.0f));
+    TESTE_IGUAL(stats.corrompidos, 1);
+}
+
+// Pontos de todas as entradas [inicio, fim) de uma camada
+typedef struct {
+    uint32_t inicio, fim;
+    historico_ponto_t pontos[HISTORICO_15MIN_AMOSTRAS > HISTORICO_1MIN_AMOSTRAS ?
+                             HISTORICO_15MIN_AMOSTRAS : HISTORICO_1MIN_AMOSTRAS][MAX_SETORES];
+} camada_t;
+
+static void copiar_camada(uint8_t camada, camada_t *c) {
+    memset(c, 0, sizeof(*c));
+    historico_intervalo(camada, &c->inicio, &c->fim);
+    for (uint32_t k = c->inicio; k != c->fim; k++) {
+        for (setor_id_t i = 0; i < MAX_SETORES; i++) {
+            historico_ler(camada, i, k, &c->pontos[k - c->inicio][i]);
+        }
+    }
+}
+
+// O log dá várias voltas só com agregados do histórico: cadastro, temperaturas e os
+// agregados ainda no anel sobrevivem por regravação ao apagar o bloco onde estavam
+static void teste_rodizio(void) {
+    static const setor_id_t cadastro[] = { 0, MEIO, ULTIMO };
+    static setores_modelo_t amostrado; // Temperaturas variando só para o histórico
+    static camada_t antes[2], depois[2];
+
+    apagar_flash();
+    reiniciar();
+    definir_estado(cadastro, 3, 25.0f);
+    amostrado = estado.modelo;
+
+    uint64_t t = 1;
+    for (uint32_t amostra = 0; stats.apagamentos <= 2 * PERSISTENCIA_BLOCOS; amostra++) {
+        t += HISTORICO_PERIODO_BRUTO_S;
+        for (size_t k = 0; k < 3; k++) {
+            amostrado.temperaturas[cadastro[k]] = 20.0f + (float)((amostra * (k + 3)) % 97) * 0.5f;
+        }
+        historico_amostrar(&amostrado, t * S_US);
+        persistencia_processar(&estado, t * S_US);
+        persistencia_ler_stats(&stats);
+        if (amostra > 100000) break; // Sem rodízio: falha abaixo
+    }
+    gravar(t + 1);
+    persistencia_ler_stats(&stats);
+    TESTE_VERIFICAR(stats.apagamentos > 2 * PERSISTENCIA_BLOCOS);
+    TESTE_VERIFICAR(stats.regravados > 0);
+    TESTE_IGUAL(stats.falhas, 0);
+    copiar_camada(HISTORICO_1MIN, &antes[0]);
+    copiar_camada(HISTORICO_15MIN, &antes[1]);
+    TESTE_VERIFICAR(antes[0].fim - antes[0].inicio == HISTORICO_1MIN_AMOSTRAS - 1);
+
+    TESTE_VERIFICAR(reiniciar());
+    TESTE_VERIFICAR(restaurado_igual(cadastro, 3, 25.0f));
+    TESTE_IGUAL(stats.corrompidos, 0);
+    copiar_camada(HISTORICO_1MIN, &depois[0]);
+    copiar_camada(HISTORICO_15MIN, &depois[1]);
+    for (int c = 0; c < 2; c++) {
+        TESTE_IGUAL(depois[c].inicio, antes[c].inicio);
+        TESTE_IGUAL(depois[c].fim, antes[c].fim);
+        TESTE_VERIFICAR(memcmp(depois[c].pontos, antes[c].pontos, sizeof(antes[c].pontos)) == 0);
+    }
+}
+
+// Cadastros alternados com uma transição de alarme pendente, até o bloco atual
+// encher; devolve o índice do último estado entregue
+static int encher_com_transicao(uint64_t *t_us) {
+    static const setor_id_t a[] = { 0, ULTIMO }, b[] = { MEIO };
+    int i = 0;
+    for (persistencia_ler_stats(&stats); stats.adiamentos == 0 && i < 10000; i++) {
+        definir_estado(i % 2 ? b : a, i % 2 ? 1 : 2, 10.0f + (float)i);
+        estado.transicao_pendente = true;
+        *t_us += 1000;
+        persistencia_processar(&estado, *t_us);
+        persistencia_ler_stats(&stats);
+    }
+    return i - 1;
+}
+
+// Nenhum bloco é apagado (o núcleo 1 pararia) durante uma transição de alarme
+// pendente: o que não coube vai ao log quando ela termina ou depois de
+// PERSISTENCIA_ADIAMENTO_MAX_S, e o boot vê o último estado
+static void teste_apagamento_adiado(void) {
+    static const setor_id_t a[] = { 0, ULTIMO }, b[] = { MEIO };
+    apagar_flash();
+    reiniciar();
+    definir_estado(a, 2, 5.0f);
+    gravar(1);
+    persistencia_ler_stats(&stats);
+    uint32_t apagamentos = stats.apagamentos;
+
+    uint64_t t_us = 5 * S_US;
+    int ultimo = encher_com_transicao(&t_us);
+    TESTE_VERIFICAR(stats.adiamentos > 0);
+    TESTE_IGUAL(stats.apagamentos, apagamentos);
+    persistencia_processar(&estado, t_us += S_US);
+    persistencia_ler_stats(&stats);
+    TESTE_IGUAL(stats.apagamentos, apagamentos);
+
+    estado.transicao_pendente = false; // Transição aceita ou desfeita
+    gravar(t_us / S_US + 1);
+    persistencia_ler_stats(&stats);
+    TESTE_IGUAL(stats.apagamentos, apagamentos + 1);
+    TESTE_VERIFICAR(reiniciar());
+    TESTE_VERIFICAR(ultimo % 2 ? restaurado_igual(b, 1, 10.0f + (float)ultimo)
+                               : restaurado_igual(a, 2, 10.0f + (float)ultimo));
+
+    // Transição que não termina: o apagamento espera no máximo PERSISTENCIA_ADIAMENTO_MAX_S
+    t_us = 100 * S_US;
+    definir_estado(a, 2, 5.0f);
+    gravar(t_us / S_US);
+    t_us += 10 * S_US;
+    persistencia_ler_stats(&stats);
+    apagamentos = stats.apagamentos;
+    uint64_t inicio_us = t_us;
+    ultimo = encher_com_transicao(&t_us);
+    TESTE_IGUAL(stats.apagamentos, apagamentos);
+    persistencia_processar(&estado, inicio_us + (uint64_t)PERSISTENCIA_ADIAMENTO_MAX_S * S_US + S_US);
+    persistencia_ler_stats(&stats);
+    TESTE_IGUAL(stats.apagamentos, apagamentos + 1);
+    TESTE_IGUAL(stats.falhas, 0);
+}
+
+// ===== CABEÇALHO DE BLOCO (MESMO FORMATO DE persistencia.c) =====
+typedef struct {
+    uint32_t magica, sequencia, apagamentos, grade, crc;
+} cabecalho_t;
+
+static uint32_t crc32(const void *dados, size_t n) {
+    const uint8_t *p = (const uint8_t *)dados;
+    uint32_t crc = ~0u;
+    while (n--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+    }
+    return ~crc;
+}
+
+// Blocos gravados por um firmware com outra grade são ignorados no boot
+static void teste_outra_grade(void) {
+    static const setor_id_t a[] = { 1, ULTIMO }, b[] = { MEIO };
+    apagar_flash();
+    reiniciar();
+    definir_estado(a, 2, 40.0f);
+    gravar(1);
+    TESTE_VERIFICAR(reiniciar()); // Com a grade certa, o log vale
+
+    // Reescreve os cabeçalhos como se uma grade 6x4 tivesse gravado o log
+    uint8_t *regiao = hal_sim_flash();
+    int adulterados = 0;
+    for (uint32_t bloco = 0; bloco < PERSISTENCIA_BLOCOS; bloco++) {
+        cabecalho_t *c = (cabecalho_t *)(regiao + bloco * HAL_FLASH_SETOR);
+        if (c->magica != 0x474C4741u || c->crc != crc32(c, offsetof(cabecalho_t, crc))) continue;
+        TESTE_IGUAL(c->grade, (uint32_t)SETORES_COLUNAS << 16 | SETORES_LINHAS);
+        c->grade = 6u << 16 | 4u;
+        c->crc = crc32(c, offsetof(cabecalho_t, crc));
+        adulterados++;
+    }
+    TESTE_VERIFICAR(adulterados > 0);
+
+    TESTE_VERIFICAR(!reiniciar());
+    TESTE_IGUAL(stats.restaurados, 0);
+
+    // Um log novo começa sobre os blocos ignorados
+    definir_estado(b, 1, 12.0f);
+    gravar(10);
+    TESTE_VERIFICAR(reiniciar());
+    TESTE_VERIFICAR(restaurado_igual(b, 1, 12.0f));
+}
+
+int main(void) {
+    setores_init(); // Regras de alarme usadas por persistencia_setores_restaurados
+    teste_registro_interrompido();
+    teste_rodizio();
+    teste_apagamento_adiado();
+    teste_outra_grade();
+    return TESTE_FIM();
+}
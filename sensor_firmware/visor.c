@@ -0,0 +1,116 @@
+/**
+ * @file visor.c
+ * @brief Rolagem, zoom e resumo por LED da janela da grade de setores.
+ */
+
+#include "setores.h"
+#include "matriz_leds.h"
+#include "visor.h"
+
+#define VISOR_ZOOM_MAX_X ((SETORES_COLUNAS + MATRIZ_LEDS_LARGURA - 1) / MATRIZ_LEDS_LARGURA)
+#define VISOR_ZOOM_MAX_Y ((SETORES_LINHAS + MATRIZ_LEDS_ALTURA - 1) / MATRIZ_LEDS_ALTURA)
+#define VISOR_ZOOM_MAX (VISOR_ZOOM_MAX_X > VISOR_ZOOM_MAX_Y ? VISOR_ZOOM_MAX_X : VISOR_ZOOM_MAX_Y)
+
+_Static_assert(VISOR_ZOOM_MAX <= UINT8_MAX, "grade grande demais para o zoom do visor");
+
+// Maior origem que ainda preenche a matriz (0 se a janela cobre a dimensão inteira)
+static int visor_limite(int setores, int leds, int zoom) {
+    int coberto = leds * zoom;
+    return setores > coberto ? setores - coberto : 0;
+}
+
+// Mantém a origem dentro da grade; devolve `true` se a janela mudou
+static bool visor_limitar(visor_t *v, int x, int y) {
+    int max_x = visor_limite(SETORES_COLUNAS, MATRIZ_LEDS_LARGURA, v->zoom);
+    int max_y = visor_limite(SETORES_LINHAS, MATRIZ_LEDS_ALTURA, v->zoom);
+    if (x < 0) x = 0;
+    if (x > max_x) x = max_x;
+    if (y < 0) y = 0;
+    if (y > max_y) y = max_y;
+    bool mudou = x != v->x || y != v->y;
+    v->x = (uint16_t)x;
+    v->y = (uint16_t)y;
+    return mudou;
+}
+
+void visor_iniciar(visor_t *v) {
+    v->x = 0;
+    v->y = 0;
+    v->zoom = 1;
+}
+
+uint8_t visor_zoom_max(void) {
+    return VISOR_ZOOM_MAX;
+}
+
+bool visor_rolavel(void) {
+    return SETORES_COLUNAS > MATRIZ_LEDS_LARGURA || SETORES_LINHAS > MATRIZ_LEDS_ALTURA;
+}
+
+bool visor_mover(visor_t *v, int dx, int dy) {
+    return visor_limitar(v, v->x + dx * v->zoom, v->y + dy * v->zoom);
+}
+
+/**
+ * @brief Rola a janela o mínimo necessário para que o setor (x, y) apareça.
+ * @return bool `true` se a janela mudou.
+ */
+bool visor_seguir(visor_t *v, int x, int y) {
+    int largura = MATRIZ_LEDS_LARGURA * v->zoom, altura = MATRIZ_LEDS_ALTURA * v->zoom;
+    int nx = v->x, ny = v->y;
+    if (x < nx) nx = x;
+    else if (x >= nx + largura) nx = x - largura + 1;
+    if (y < ny) ny = y;
+    else if (y >= ny + altura) ny = y - altura + 1;
+    return visor_limitar(v, nx, ny);
+}
+
+/**
+ * @brief Passa ao próximo zoom, mantendo o centro da janela sempre que possível.
+ * @return bool `true` se a janela mudou (sempre, exceto quando a grade cabe na matriz).
+ */
+bool visor_proximo_zoom(visor_t *v) {
+    if (VISOR_ZOOM_MAX == 1) return false;
+    int cx = v->x + MATRIZ_LEDS_LARGURA * v->zoom / 2;
+    int cy = v->y + MATRIZ_LEDS_ALTURA * v->zoom / 2;
+    v->zoom = v->zoom >= VISOR_ZOOM_MAX ? 1 : v->zoom + 1;
+    visor_limitar(v, cx - MATRIZ_LEDS_LARGURA * v->zoom / 2, cy - MATRIZ_LEDS_ALTURA * v->zoom / 2);
+    return true;
+}
+
+/**
+ * @brief LED da matriz (lx, ly) que exibe o setor (x, y).
+ * @return bool `false` se o setor está fora da janela.
+ */
+bool visor_led_do_setor(const visor_t *v, int x, int y, int *lx, int *ly) {
+    if (x < v->x || y < v->y) return false;
+    int cx = (x - v->x) / v->zoom, cy = (y - v->y) / v->zoom;
+    if (cx >= MATRIZ_LEDS_LARGURA || cy >= MATRIZ_LEDS_ALTURA) return false;
+    *lx = cx;
+    *ly = cy;
+    return true;
+}
+
+/**
+ * @brief Estado resumido do bloco de setores exibido no LED (lx, ly).
+ * @details Cada linha do bloco é um intervalo contínuo de índices: testa os
+ *          conjuntos de alarme e de cadastro do modelo palavra a palavra.
+ *          Partes do bloco fora da grade contam como vazias.
+ */
+uint8_t visor_celula(const visor_t *v, int lx, int ly, const setores_modelo_t *m) {
+    int x0 = v->x + lx * v->zoom, y0 = v->y + ly * v->zoom;
+    int x1 = x0 + v->zoom, y1 = y0 + v->zoom;
+    if (x1 > SETORES_COLUNAS) x1 = SETORES_COLUNAS;
+    if (y1 > SETORES_LINHAS) y1 = SETORES_LINHAS;
+    uint8_t celula = VISOR_CELULA_VAZIA;
+    if (x0 >= x1) return celula;
+    for (int y = y0; y < y1; y++) {
+        setor_id_t inicio = setor_indice(x0, y), fim = setor_indice(x1, y);
+        if (setores_bits_algum_entre(&m->alarmes, inicio, fim)) return VISOR_CELULA_ALARME;
+        if (setores_bits_algum_entre(&m->avisos, inicio, fim)) celula = VISOR_CELULA_AVISO;
+        else if (celula == VISOR_CELULA_VAZIA && setores_bits_algum_entre(&m->cadastrados, inicio, fim)) {
+            celula = VISOR_CELULA_CADASTRADA;
+        }
+    }
+    return celula;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file visor.h
+ * @brief Janela da grade de setores exibida na matriz de LEDs (rolagem e zoom).
+ * @details A grade de setores (SETORES_COLUNAS x SETORES_LINHAS, definida no
+ *          build) pode ser maior que a matriz física (MATRIZ_LEDS_LARGURA x
+ *          MATRIZ_LEDS_ALTURA). O visor define qual parte dela aparece:
+ *          - `x`, `y`: setor exibido no LED do canto superior esquerdo;
+ *          - `zoom`: cada LED resume um bloco de zoom x zoom setores, na cor do
+ *            pior estado do bloco (alarme > aviso > cadastrado > vazio).
+ *          Com zoom = visor_zoom_max() a grade inteira cabe na matriz.
+ *
+ *          O núcleo 1 é dono do visor (joystick) e o publica no snapshot; o
+ *          painel do OLED espelha a mesma janela com visor_celula().
+ */
+
+#ifndef VISOR_H
+#define VISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct setores_modelo; // setores.h (que inclui este arquivo)
+
+// Estado de uma célula (um LED) da janela
+enum {
+    VISOR_CELULA_VAZIA,
+    VISOR_CELULA_CADASTRADA,
+    VISOR_CELULA_AVISO,
+    VISOR_CELULA_ALARME
+};
+
+/**
+ * @struct visor_t
+ * @brief Janela atual da grade (coordenadas em setores).
+ */
+typedef struct {
+    uint16_t x;      // Coluna do setor no canto superior esquerdo
+    uint16_t y;      // Linha do setor no canto superior esquerdo
+    uint8_t zoom;    // Setores por LED em cada eixo (1 = um setor por LED)
+} visor_t;
+
+void visor_iniciar(visor_t *v);                      // Zoom 1, na origem da grade
+uint8_t visor_zoom_max(void);                        // Menor zoom que mostra a grade inteira
+bool visor_rolavel(void);                            // A grade não cabe na matriz com zoom 1
+bool visor_mover(visor_t *v, int dx, int dy);        // Desloca a janela em LEDs (limitada à grade)
+bool visor_seguir(visor_t *v, int x, int y);         // Rola até o setor (x, y) ficar visível
+bool visor_proximo_zoom(visor_t *v);                 // 1, 2, ..., visor_zoom_max(), 1, ...
+bool visor_led_do_setor(const visor_t *v, int x, int y, int *lx, int *ly); // LED que exibe o setor
+uint8_t visor_celula(const visor_t *v, int lx, int ly, const struct setores_modelo *m); // VISOR_CELULA_*
+
+#endif